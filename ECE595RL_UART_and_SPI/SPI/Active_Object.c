@@ -0,0 +1,379 @@
+/**
+ * @file Active_Object.c
+ * @brief Source code for the Active_Object framework.
+ *
+ * This file contains the function definitions for the Active_Object framework.
+ * The queues are circular buffers of events. Ready has one bit per priority whose active object has events,
+ * so the scheduler finds the next event without looking at the empty queues. The framework finds the parent of a
+ * state by sending it ACTIVE_OBJECT_SIGNAL_EMPTY, so the hierarchy is only written in the states themselves.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Active_Object.h"
+
+#ifndef ACTIVE_OBJECT_HOST
+#include "msp.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/Trace.h"
+#else
+#define TRACE_TASK_BEGIN(id)
+#define TRACE_TASK_END(id)
+#define TRACE_QUEUE_POST(id, count)
+#define TRACE_QUEUE_CONSUME(id, count)
+#endif
+
+// Trace identifier of an active object
+#define TRACE_ID(ao)    (TRACE_ID_ACTIVE_OBJECT + (ao)->priority - 1)
+
+// Active object of each priority (index 0 is not used)
+static Active_Object *Active_Objects[ACTIVE_OBJECT_MAX_PRIORITY + 1];
+static volatile uint32_t Ready;
+
+// Running timers
+static Active_Object_Timer *Timers;
+
+static const Active_Object_Event Reserved_Events[ACTIVE_OBJECT_SIGNAL_USER] = {
+    {ACTIVE_OBJECT_SIGNAL_EMPTY, 0},
+    {ACTIVE_OBJECT_SIGNAL_ENTRY, 0},
+    {ACTIVE_OBJECT_SIGNAL_EXIT, 0},
+    {ACTIVE_OBJECT_SIGNAL_INIT, 0}
+};
+
+#ifdef ACTIVE_OBJECT_HOST
+static uint32_t Lock()
+{
+    return 0;
+}
+
+static void Unlock(uint32_t section)
+{
+    (void)section;
+}
+#else
+static uint32_t Lock()
+{
+    return Critical_Section_Enter();
+}
+
+static void Unlock(uint32_t section)
+{
+    Critical_Section_Exit(section);
+}
+#endif
+
+uint8_t Active_Object_Top(Active_Object *me, const Active_Object_Event *e)
+{
+    (void)me;
+    (void)e;
+
+    return ACTIVE_OBJECT_RETURN_IGNORED;
+}
+
+/**
+ * @brief Sends a reserved signal (ENTRY, EXIT or INIT) to a state.
+ */
+static uint8_t Trigger(Active_Object *me, Active_Object_State state, uint16_t signal)
+{
+    return state(me, &Reserved_Events[signal]);
+}
+
+/**
+ * @brief Returns the parent of a state, or 0 for Active_Object_Top.
+ */
+static Active_Object_State Parent_Of(Active_Object *me, Active_Object_State state)
+{
+    me->next = 0;
+    Trigger(me, state, ACTIVE_OBJECT_SIGNAL_EMPTY);
+
+    return me->next;
+}
+
+/**
+ * @brief Follows the initial transitions from a state down to a leaf state, which becomes the current state.
+ */
+static void Enter_Leaf(Active_Object *me, Active_Object_State state)
+{
+    Active_Object_State path[ACTIVE_OBJECT_MAX_NESTING];
+    Active_Object_State target;
+    Active_Object_State s;
+    uint8_t n;
+
+    while (Trigger(me, state, ACTIVE_OBJECT_SIGNAL_INIT) == ACTIVE_OBJECT_RETURN_TRANSITION)
+    {
+        // The target is a state inside the current one: enter the states in between, from the outside in
+        target = me->next;
+        for (n = 0, s = target; (s != state) && (n < ACTIVE_OBJECT_MAX_NESTING); s = Parent_Of(me, s))
+        {
+            path[n++] = s;
+        }
+        while (n > 0)
+        {
+            Trigger(me, path[--n], ACTIVE_OBJECT_SIGNAL_ENTRY);
+        }
+        state = target;
+    }
+
+    me->state = state;
+}
+
+/**
+ * @brief Runs a transition from the state that handled the event (source) to the target.
+ *        The states below the source have already been exited.
+ */
+static void Transition(Active_Object *me, Active_Object_State source, Active_Object_State target)
+{
+    // Parents of the target, from the closest one up to Active_Object_Top
+    Active_Object_State parents[ACTIVE_OBJECT_MAX_NESTING + 1];
+    Active_Object_State s;
+    uint8_t count;
+    uint8_t i = 0;
+
+    for (count = 0, s = Parent_Of(me, target); s && (count <= ACTIVE_OBJECT_MAX_NESTING); s = Parent_Of(me, s))
+    {
+        parents[count++] = s;
+    }
+
+    // Exit the source, then its parents until one of them also contains the target
+    Trigger(me, source, ACTIVE_OBJECT_SIGNAL_EXIT);
+    for (s = Parent_Of(me, source); s; s = Parent_Of(me, s))
+    {
+        for (i = 0; (i < count) && (parents[i] != s); i++);
+        if (i < count)
+        {
+            break;
+        }
+        Trigger(me, s, ACTIVE_OBJECT_SIGNAL_EXIT);
+    }
+
+    // Enter the parents of the target that are below the common parent (parents[i]), then the target
+    while (i > 0)
+    {
+        Trigger(me, parents[--i], ACTIVE_OBJECT_SIGNAL_ENTRY);
+    }
+    Trigger(me, target, ACTIVE_OBJECT_SIGNAL_ENTRY);
+
+    Enter_Leaf(me, target);
+}
+
+/**
+ * @brief Runs the state machine of an active object for one event.
+ */
+static void Dispatch(Active_Object *me, const Active_Object_Event *e)
+{
+    Active_Object_State source = me->state;
+    Active_Object_State target;
+    Active_Object_State s;
+    uint8_t result;
+
+    // The event goes up the hierarchy until a state handles it. Active_Object_Top ignores it.
+    while ((result = source(me, e)) == ACTIVE_OBJECT_RETURN_SUPER)
+    {
+        source = me->next;
+    }
+
+    if (result == ACTIVE_OBJECT_RETURN_TRANSITION)
+    {
+        // Exit the states from the current leaf state up to the state that handled the event
+        target = me->next;
+        for (s = me->state; s != source; s = Parent_Of(me, s))
+        {
+            Trigger(me, s, ACTIVE_OBJECT_SIGNAL_EXIT);
+        }
+        Transition(me, source, target);
+    }
+}
+
+int Active_Object_Start(Active_Object *ao, uint8_t priority, Active_Object_Event *queue, uint8_t queue_length,
+                        Active_Object_State initial)
+{
+    Active_Object_State path[ACTIVE_OBJECT_MAX_NESTING];
+    Active_Object_State s;
+    uint8_t n;
+
+    if ((priority == 0) || (priority > ACTIVE_OBJECT_MAX_PRIORITY) || Active_Objects[priority])
+    {
+        return ACTIVE_OBJECT_ERROR_PRIORITY;
+    }
+
+    ao->queue = queue;
+    ao->queue_length = queue_length;
+    ao->head = 0;
+    ao->tail = 0;
+    ao->count = 0;
+    ao->max_count = 0;
+    ao->priority = priority;
+    ao->dropped = 0;
+
+    // Registered first, so that the entry actions can post events to the active object
+    Active_Objects[priority] = ao;
+
+    // Enter the states from Active_Object_Top down to the initial state
+    for (n = 0, s = initial; (s != Active_Object_Top) && (n < ACTIVE_OBJECT_MAX_NESTING); s = Parent_Of(ao, s))
+    {
+        path[n++] = s;
+    }
+    while (n > 0)
+    {
+        Trigger(ao, path[--n], ACTIVE_OBJECT_SIGNAL_ENTRY);
+    }
+
+    Enter_Leaf(ao, initial);
+
+    return 0;
+}
+
+int Active_Object_Post(Active_Object *ao, uint16_t signal, uint16_t parameter)
+{
+    uint32_t section = Lock();
+
+    if (ao->count == ao->queue_length)
+    {
+        ao->dropped++;
+        Unlock(section);
+        return ACTIVE_OBJECT_ERROR_FULL;
+    }
+
+    ao->queue[ao->head].signal = signal;
+    ao->queue[ao->head].parameter = parameter;
+    ao->head = (ao->head + 1 == ao->queue_length) ? 0 : ao->head + 1;
+    ao->count++;
+    if (ao->count > ao->max_count)
+    {
+        ao->max_count = ao->count;
+    }
+    Ready |= (1 << ao->priority);
+    TRACE_QUEUE_POST(TRACE_ID(ao), ao->count);
+
+    Unlock(section);
+    return 0;
+}
+
+uint8_t Active_Object_Run_Once()
+{
+    Active_Object_Event e;
+    Active_Object *ao;
+    uint32_t section = Lock();
+    uint8_t priority;
+
+    for (priority = ACTIVE_OBJECT_MAX_PRIORITY; (priority > 0) && !(Ready & (1 << priority)); priority--);
+
+    if (priority == 0)
+    {
+        Unlock(section);
+        return 0;
+    }
+
+    ao = Active_Objects[priority];
+    e = ao->queue[ao->tail];
+    ao->tail = (ao->tail + 1 == ao->queue_length) ? 0 : ao->tail + 1;
+    ao->count--;
+    if (ao->count == 0)
+    {
+        Ready &= ~(1 << priority);
+    }
+    TRACE_QUEUE_CONSUME(TRACE_ID(ao), ao->count);
+    Unlock(section);
+
+    // Run to completion, with the interrupts enabled
+    TRACE_TASK_BEGIN(TRACE_ID(ao));
+    Dispatch(ao, &e);
+    TRACE_TASK_END(TRACE_ID(ao));
+
+    return 1;
+}
+
+void Active_Object_Run()
+{
+    while(1)
+    {
+        if (!Active_Object_Run_Once())
+        {
+#ifndef ACTIVE_OBJECT_HOST
+            // PRIMASK holds off the interrupts between the check and WFI. An interrupt that becomes pending
+            // still wakes up the CPU, and its handler runs as soon as PRIMASK is cleared.
+            __disable_irq();
+            if (Ready == 0)
+            {
+                __WFI();
+            }
+            __enable_irq();
+#endif
+        }
+    }
+}
+
+void Active_Object_Timer_Init(Active_Object_Timer *timer, Active_Object *target, uint16_t signal, uint16_t parameter)
+{
+    timer->target = target;
+    timer->event.signal = signal;
+    timer->event.parameter = parameter;
+    timer->remaining = 0;
+    timer->period = 0;
+    timer->next = 0;
+}
+
+void Active_Object_Timer_Start(Active_Object_Timer *timer, uint32_t ticks, uint32_t period)
+{
+    uint32_t section = Lock();
+
+    // A stopped timer is not in the list
+    if (timer->remaining == 0)
+    {
+        timer->next = Timers;
+        Timers = timer;
+    }
+
+    timer->remaining = (ticks > 0) ? ticks : 1;
+    timer->period = period;
+
+    Unlock(section);
+}
+
+void Active_Object_Timer_Stop(Active_Object_Timer *timer)
+{
+    Active_Object_Timer **link;
+    uint32_t section = Lock();
+
+    if (timer->remaining)
+    {
+        for (link = &Timers; *link; link = &(*link)->next)
+        {
+            if (*link == timer)
+            {
+                *link = timer->next;
+                break;
+            }
+        }
+        timer->remaining = 0;
+    }
+
+    Unlock(section);
+}
+
+void Active_Object_Tick()
+{
+    Active_Object_Timer **link = &Timers;
+    Active_Object_Timer *timer;
+    uint32_t section = Lock();
+
+    while ((timer = *link) != 0)
+    {
+        if (--timer->remaining == 0)
+        {
+            Active_Object_Post(timer->target, timer->event.signal, timer->event.parameter);
+
+            // A single event timer leaves the list
+            if (timer->period == 0)
+            {
+                *link = timer->next;
+                continue;
+            }
+            timer->remaining = timer->period;
+        }
+        link = &timer->next;
+    }
+
+    Unlock(section);
+}
@@ -0,0 +1,337 @@
+/**
+ * @file Block_Log.c
+ * @brief Source code for the Block_Log driver.
+ *
+ * This file contains the function definitions for the Block_Log driver.
+ * It buffers an append-only log in RAM and writes it to a block device in aligned chunks.
+ * It does not use any peripheral, so it can also be compiled on a computer with a simulated device.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <string.h>
+#include "../inc/Block_Log.h"
+#include "../inc/CRC16.h"
+
+static const Block_Log_Device *Device;
+
+// Blocks Chunk_Start to Chunk_Start + BLOCK_LOG_CHUNK_BLOCKS - 1 of the device
+static uint8_t Buffer[BLOCK_LOG_CHUNK_BLOCKS * BLOCK_LOG_BLOCK_SIZE];
+
+static uint32_t Log_ID;
+static uint32_t Chunk_Start;    // Multiple of BLOCK_LOG_CHUNK_BLOCKS
+static uint32_t Block;          // Block being filled
+static uint32_t Run_Start;      // First block written since Block_Log_Format or Block_Log_Mount
+static uint16_t Used;           // Payload bytes in the block being filled
+static uint8_t Dirty;           // 1 if blocks Dirty_From to Block have changed since they were written
+static uint32_t Dirty_From;
+static uint32_t Bytes;
+static uint32_t Blocks_Written;
+static uint32_t Writes;
+
+static void Put_U16(uint8_t *data, uint16_t value)
+{
+    data[0] = value & 0xFF;
+    data[1] = value >> 8;
+}
+
+static void Put_U32(uint8_t *data, uint32_t value)
+{
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+    data[2] = (value >> 16) & 0xFF;
+    data[3] = (value >> 24) & 0xFF;
+}
+
+static uint32_t Get_U32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/**
+ * @brief CRC of the first 14 bytes of the header and of the used payload bytes
+ */
+static uint16_t Block_CRC(const uint8_t *data, uint16_t used)
+{
+    return CRC16_Compute(CRC16_Compute(CRC16_INITIAL_VALUE, data, 14), &data[BLOCK_LOG_HEADER_SIZE], used);
+}
+
+static void Write_Header(uint8_t *data, uint32_t index, uint16_t used)
+{
+    Put_U32(&data[0], BLOCK_LOG_MAGIC);
+    Put_U32(&data[4], Log_ID);
+    Put_U32(&data[8], index);
+    Put_U16(&data[12], (index == Run_Start) ? (used | BLOCK_LOG_RUN_START) : used);
+    Put_U16(&data[14], Block_CRC(data, used));
+}
+
+/**
+ * @brief Checks the header of a block read from the device.
+ *
+ * @return Number of used payload bytes, or -1 if the block does not belong to the log.
+ */
+static int Check_Header(const uint8_t *data, uint32_t index)
+{
+    uint16_t used = (data[12] | (data[13] << 8)) & ~BLOCK_LOG_RUN_START;
+
+    if ((Get_U32(&data[0]) != BLOCK_LOG_MAGIC) || (Get_U32(&data[4]) != Log_ID) || (Get_U32(&data[8]) != index))
+    {
+        return -1;
+    }
+
+    if ((used > BLOCK_LOG_PAYLOAD_SIZE) ||
+        ((data[14] | (data[15] << 8)) != Block_CRC(data, used)))
+    {
+        return -1;
+    }
+
+    return used;
+}
+
+static uint8_t *Block_Buffer(uint32_t block)
+{
+    return &Buffer[(block - Chunk_Start) * BLOCK_LOG_BLOCK_SIZE];
+}
+
+/**
+ * @brief Sets the position of the next byte and the chunk that holds it.
+ */
+static void Seek(uint32_t block, uint16_t used)
+{
+    Block = block;
+    Used = used;
+    Chunk_Start = block - (block % BLOCK_LOG_CHUNK_BLOCKS);
+    Dirty = 0;
+}
+
+int Block_Log_Format(const Block_Log_Device *device)
+{
+    Device = 0;
+
+    // Use the next log_id so that the blocks of the previous log are not valid
+    if (device->read_block(0, Buffer) < 0)
+    {
+        return BLOCK_LOG_ERROR_DEVICE;
+    }
+    Log_ID = Get_U32(&Buffer[4]);
+    if (Check_Header(Buffer, 0) < 0)
+    {
+        Log_ID = 0;
+    }
+    Log_ID++;
+    Run_Start = 1;
+
+    memset(Buffer, 0xFF, BLOCK_LOG_BLOCK_SIZE);
+    Write_Header(Buffer, 0, 0);
+    if (device->write_blocks(0, Buffer, 1) < 0)
+    {
+        return BLOCK_LOG_ERROR_DEVICE;
+    }
+
+    Bytes = 0;
+    Blocks_Written = 1;
+    Writes = 1;
+    Seek(1, 0);
+    Device = device;
+
+    return 0;
+}
+
+int Block_Log_Mount(const Block_Log_Device *device)
+{
+    uint32_t low;
+    uint32_t high;
+    uint32_t middle;
+
+    Device = 0;
+
+    if (device->read_block(0, Buffer) < 0)
+    {
+        return BLOCK_LOG_ERROR_DEVICE;
+    }
+    Log_ID = Get_U32(&Buffer[4]);
+    if (Check_Header(Buffer, 0) < 0)
+    {
+        return BLOCK_LOG_ERROR_NO_LOG;
+    }
+
+    // Find the first block that is not valid: blocks before low are valid, block high is not (or is the end of the device)
+    low = 1;
+    high = device->block_count;
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+        if (device->read_block(middle, Buffer) < 0)
+        {
+            return BLOCK_LOG_ERROR_DEVICE;
+        }
+        if (Check_Header(Buffer, middle) >= 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    // Start a new run in the next block, so that a record cut off by a reset is not continued
+    Bytes = 0;
+    Blocks_Written = 0;
+    Writes = 0;
+    Seek(low, 0);
+    Run_Start = low;
+
+    Device = device;
+
+    return 0;
+}
+
+int Block_Log_Flush()
+{
+    uint32_t last;
+    uint32_t block;
+
+    if (Device == 0)
+    {
+        return BLOCK_LOG_ERROR_NOT_MOUNTED;
+    }
+
+    if (!Dirty)
+    {
+        return 0;
+    }
+
+    // The block being filled is only written if it holds bytes
+    last = (Used > 0) ? Block : (Block - 1);
+
+    for (block = Dirty_From; block <= last; block++)
+    {
+        Write_Header(Block_Buffer(block), block, (block == Block) ? Used : BLOCK_LOG_PAYLOAD_SIZE);
+    }
+
+    if (Device->write_blocks(Dirty_From, Block_Buffer(Dirty_From), last - Dirty_From + 1) < 0)
+    {
+        return BLOCK_LOG_ERROR_DEVICE;
+    }
+
+    Blocks_Written += last - Dirty_From + 1;
+    Writes++;
+    Dirty = 0;
+
+    return 0;
+}
+
+int Block_Log_Append(const void *data, uint32_t length)
+{
+    const uint8_t *bytes = data;
+    uint32_t count;
+    int result;
+
+    if (Device == 0)
+    {
+        return BLOCK_LOG_ERROR_NOT_MOUNTED;
+    }
+
+    while(length > 0)
+    {
+        if (Block >= Device->block_count)
+        {
+            return BLOCK_LOG_ERROR_FULL;
+        }
+
+        if (!Dirty)
+        {
+            Dirty = 1;
+            Dirty_From = Block;
+        }
+
+        count = BLOCK_LOG_PAYLOAD_SIZE - Used;
+        if (count > length)
+        {
+            count = length;
+        }
+        memcpy(Block_Buffer(Block) + BLOCK_LOG_HEADER_SIZE + Used, bytes, count);
+        bytes += count;
+        length -= count;
+        Used += count;
+        Bytes += count;
+
+        if (Used == BLOCK_LOG_PAYLOAD_SIZE)
+        {
+            Block++;
+            Used = 0;
+
+            // Write the whole chunk and start filling the next one
+            if ((Block - Chunk_Start) == BLOCK_LOG_CHUNK_BLOCKS)
+            {
+                result = Block_Log_Flush();
+                if (result < 0)
+                {
+                    Block--;
+                    Used = BLOCK_LOG_PAYLOAD_SIZE;
+                    return result;
+                }
+                Chunk_Start = Block;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int Block_Log_Append_Record(uint8_t type, const void *data, uint32_t length)
+{
+    uint8_t header[BLOCK_LOG_RECORD_HEADER_SIZE];
+    uint32_t space;
+    int result;
+
+    if (Device == 0)
+    {
+        return BLOCK_LOG_ERROR_NOT_MOUNTED;
+    }
+
+    if (length > 0xFFFF)
+    {
+        return BLOCK_LOG_ERROR_LENGTH;
+    }
+
+    space = (Block < Device->block_count) ? ((Device->block_count - Block) * BLOCK_LOG_PAYLOAD_SIZE - Used) : 0;
+    if ((BLOCK_LOG_RECORD_HEADER_SIZE + length) > space)
+    {
+        return BLOCK_LOG_ERROR_FULL;
+    }
+
+    header[0] = BLOCK_LOG_RECORD_SYNC;
+    header[1] = type;
+    Put_U16(&header[2], length);
+
+    result = Block_Log_Append(header, BLOCK_LOG_RECORD_HEADER_SIZE);
+    if (result < 0)
+    {
+        return result;
+    }
+
+    return Block_Log_Append(data, length);
+}
+
+void Block_Log_Get_Stats(Block_Log_Stats *stats)
+{
+    memset(stats, 0, sizeof(Block_Log_Stats));
+    if (Device == 0)
+    {
+        return;
+    }
+
+    stats->log_id = Log_ID;
+    stats->blocks = (Used > 0) ? (Block + 1) : Block;
+    stats->block_count = Device->block_count;
+    stats->bytes = Bytes;
+    if (Dirty)
+    {
+        stats->buffered = (Block - Dirty_From) * BLOCK_LOG_PAYLOAD_SIZE + Used;
+    }
+    stats->blocks_written = Blocks_Written;
+    stats->writes = Writes;
+}
@@ -29,24 +29,16 @@
  */
 
 #include "../inc/Bumper_Sensors.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/Interrupt_Priority.h"
 
 void Bumper_Sensors_Init(void(*task)(uint8_t))
 {
     // Store the user-defined task function for use during interrupt handling
     Bumper_Task = task;
 
-    // Configure the following pins as GPIO pins: P4.7 - P4.5, P4.3, P4.2, and P4.0
-    P4->SEL0 &= ~0xED;
-    P4->SEL1 &= ~0xED;
-
-    // Set the following pins as input: P4.7 - P4.5, P4.3, P4.2, and P4.0
-    P4->DIR &= ~0xED;
-
-    // Enable pull-up resistors on the following pins: P4.7 - P4.5, P4.3, P4.2, and P4.0
-    P4->REN |= 0xED;
-
-    // Ensure that the pins are pulled up: P4.7 - P4.5, P4.3, P4.2, and P4.0
-    P4->OUT |= 0xED;
+    // Configure the following pins as GPIO inputs with pull-up resistors: P4.7 - P4.5, P4.3, P4.2, and P4.0
+    PIN_MAP_CONFIGURE(PIN_GROUP_BUMPER_SENSORS);
 
     // Interrupt Edge Select: High-to-Low Transition
     // Configure the pins to use falling edge event triggers: P4.7 - P4.5, P4.3, P4.2, and P4.0
@@ -58,8 +50,8 @@ void Bumper_Sensors_Init(void(*task)(uint8_t))
     // Enable interrupts on the following pins: P4.7 - P4.5, P4.3, P4.2, and P4.0
     P4->IE |= 0xED;
 
-    // Set the priority of the interrupts (IRQ 38) to 0 (section 2.4.3.20)
-    NVIC->IP[9] = (NVIC->IP[9] & 0xFF0FFFFF);
+    // Set the priority of the interrupts (IRQ 38) (section 2.4.3.20)
+    NVIC->IP[38] = (INTERRUPT_PRIORITY_BUMPER_SENSORS << 5);
 
     // Enable Interrupt 38 in NVIC (section 2.4.3.2)
     // Bit 6 corresponds to IRQ 38
@@ -0,0 +1,24 @@
+/**
+ * @file Coroutine.c
+ * @brief Source code for the Coroutine tick counter.
+ *
+ * This file contains the function definitions for the tick counter used by COROUTINE_DELAY.
+ * The counter is one aligned 32-bit word, so it is read and written without a critical section.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Coroutine.h"
+
+static volatile uint32_t Ticks;
+
+void Coroutine_Tick()
+{
+    Ticks++;
+}
+
+uint32_t Coroutine_Get_Ticks()
+{
+    return Ticks;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file Critical_Section.c
+ * @brief Source code for the Critical_Section driver.
+ *
+ * This file contains the function definitions for the Critical_Section driver.
+ * The state returned by Critical_Section_Enter holds the previous BASEPRI in bits 7-0 and the previous PRIMASK in bit 8,
+ * so it is 0 only for the outermost section, which is the one that is timed.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Critical_Section.h"
+
+#define STATE_BASEPRI_MASK  0xFF
+#define STATE_PRIMASK       0x100
+
+#ifdef CRITICAL_SECTION_AUDIT
+static uint32_t Section_Start;
+static uint8_t Section_Priority;
+static Critical_Section_Stats Stats;
+#endif
+
+uint32_t Critical_Section_Enter()
+{
+    return Critical_Section_Enter_Priority(CRITICAL_SECTION_PRIORITY);
+}
+
+uint32_t Critical_Section_Enter_Priority(uint8_t priority)
+{
+    uint32_t state = __get_BASEPRI() | (__get_PRIMASK() ? STATE_PRIMASK : 0);
+    uint32_t basepri = (uint32_t)priority << 5;
+
+    // BASEPRI = 0 does not mask anything, so priority 0 needs PRIMASK.
+    // A nested section only raises the mask: a lower BASEPRI value masks more interrupts.
+    if (priority == 0)
+    {
+        __disable_irq();
+    }
+    else if (((state & STATE_BASEPRI_MASK) == 0) || (basepri < (state & STATE_BASEPRI_MASK)))
+    {
+        // Cortex-M4 r0p1 erratum 837070: an interrupt can still be taken just after the BASEPRI write,
+        // so the write is done with PRIMASK set
+        __disable_irq();
+        __set_BASEPRI(basepri);
+        __set_PRIMASK((state & STATE_PRIMASK) ? 1 : 0);
+    }
+
+#ifdef CRITICAL_SECTION_AUDIT
+    if (state == 0)
+    {
+        Section_Priority = priority;
+        Section_Start = DWT->CYCCNT;
+    }
+#endif
+
+    return state;
+}
+
+void Critical_Section_Exit(uint32_t state)
+{
+#ifdef CRITICAL_SECTION_AUDIT
+    uint32_t cycles;
+
+    // The statistics are only changed by the outermost section, while the interrupts are still masked
+    if (state == 0)
+    {
+        cycles = DWT->CYCCNT - Section_Start;
+        Stats.sections++;
+        Stats.total_cycles += cycles;
+        if (cycles > Stats.max_cycles)
+        {
+            Stats.max_cycles = cycles;
+            Stats.max_priority = Section_Priority;
+        }
+    }
+#endif
+
+    __set_BASEPRI(state & STATE_BASEPRI_MASK);
+    __set_PRIMASK((state & STATE_PRIMASK) ? 1 : 0);
+}
+
+void Critical_Section_Get_Stats(Critical_Section_Stats *stats)
+{
+#ifdef CRITICAL_SECTION_AUDIT
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = Stats;
+    __set_PRIMASK(primask);
+#else
+    stats->sections = 0;
+    stats->total_cycles = 0;
+    stats->max_cycles = 0;
+    stats->max_priority = 0;
+#endif
+}
+
+void Critical_Section_Clear_Stats()
+{
+#ifdef CRITICAL_SECTION_AUDIT
+    uint32_t primask = __get_PRIMASK();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    __disable_irq();
+    Stats.sections = 0;
+    Stats.total_cycles = 0;
+    Stats.max_cycles = 0;
+    Stats.max_priority = 0;
+    __set_PRIMASK(primask);
+#endif
+}
@@ -0,0 +1,164 @@
+/**
+ * @file EUSCI_A0_UART.c
+ * @brief Source code for the EUSCI_A0_UART driver.
+ *
+ * This file contains the function definitions for the EUSCI_A0_UART driver.
+ * The functions are implemented on top of the EUSCI_A_UART driver.
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
+ * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @note The pins P1.2 and P1.3 are used for UART communication via USB.
+ *
+ * @author Aaron Nanas
+ *
+ */
+
+#include "../inc/EUSCI_A0_UART.h"
+
+void EUSCI_A0_UART_Init()
+{
+    // 115200 baud, 8 data bits, no parity, 1 stop bit, LSB first
+    EUSCI_A_UART_Init(EUSCI_A0_UART_PORT, &EUSCI_A_UART_DEFAULT_CONFIG);
+}
+
+char EUSCI_A0_UART_InChar()
+{
+    return (char)EUSCI_A_UART_InChar(EUSCI_A0_UART_PORT);
+}
+
+void EUSCI_A0_UART_OutChar(char letter)
+{
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, letter);
+}
+
+void EUSCI_A0_UART_InString(char *bufPt, uint16_t max)
+{
+    EUSCI_A_UART_InString(EUSCI_A0_UART_PORT, bufPt, max);
+}
+
+void EUSCI_A0_UART_OutString(char *pt)
+{
+    EUSCI_A_UART_OutString(EUSCI_A0_UART_PORT, pt);
+}
+
+uint32_t EUSCI_A0_UART_InUDec()
+{
+    return EUSCI_A_UART_InUDec(EUSCI_A0_UART_PORT);
+}
+
+void EUSCI_A0_UART_OutUDec(uint32_t n)
+{
+    EUSCI_A_UART_OutUDec(EUSCI_A0_UART_PORT, n);
+}
+
+void EUSCI_A0_UART_OutSDec(int32_t n)
+{
+    EUSCI_A_UART_OutSDec(EUSCI_A0_UART_PORT, n);
+}
+
+void EUSCI_A0_UART_OutUFix(uint32_t n)
+{
+    EUSCI_A_UART_OutUFix(EUSCI_A0_UART_PORT, n);
+}
+
+uint32_t EUSCI_A0_UART_InUHex()
+{
+    return EUSCI_A_UART_InUHex(EUSCI_A0_UART_PORT);
+}
+
+int EUSCI_A0_UART_InNumber(uint8_t format, uint8_t decimals, uint32_t *value)
+{
+    return EUSCI_A_UART_InNumber(EUSCI_A0_UART_PORT, format, decimals, value);
+}
+
+void EUSCI_A0_UART_OutUHex(uint32_t number)
+{
+    EUSCI_A_UART_OutUHex(EUSCI_A0_UART_PORT, number);
+}
+
+int EUSCI_A0_UART_Open(const char *path, unsigned flags, int llv_fd)
+{
+    EUSCI_A0_UART_Init();
+    return 0;
+}
+
+int EUSCI_A0_UART_Close(int dev_fd)
+{
+    return 0;
+}
+int EUSCI_A0_UART_Read(int dev_fd, char *buf, unsigned count)
+{
+    // Receive char from the serial terminal
+    char ch = EUSCI_A0_UART_InChar();
+
+    // Return by reference
+    *buf = ch;
+
+    // Output the received char from the serial terminal
+    EUSCI_A0_UART_OutChar(ch);
+
+    return 1;
+}
+
+int EUSCI_A0_UART_Write(int dev_fd, const char *buf, unsigned count)
+{
+    unsigned int num = count;
+
+    while(num)
+    {
+        if(*buf == 10)
+        {
+            EUSCI_A0_UART_OutChar(13);
+        }
+        EUSCI_A0_UART_OutChar(*buf);
+        buf++;
+        num--;
+    }
+    return count;
+}
+
+off_t EUSCI_A0_UART_LSeek(int dev_fd, off_t ioffset, int origin)
+{
+    return 0;
+}
+
+int EUSCI_A0_UART_Unlink(const char * path)
+{
+    return 0;
+}
+
+int EUSCI_A0_UART_Rename(const char *old_name, const char *new_name)
+{
+    return 0;
+}
+
+void EUSCI_A0_UART_Init_Printf()
+{
+    int ret_val;
+    FILE *fptr;
+
+    EUSCI_A0_UART_Init();
+
+    ret_val = add_device("uart", _SSA,
+                         EUSCI_A0_UART_Open,
+                         EUSCI_A0_UART_Close,
+                         EUSCI_A0_UART_Read,
+                         EUSCI_A0_UART_Write, EUSCI_A0_UART_LSeek,
+                         EUSCI_A0_UART_Unlink,
+                         EUSCI_A0_UART_Rename);
+
+    // Return if there is an error
+    if (ret_val) return;
+
+    fptr = fopen("uart","w");
+
+    // Return if there is an error
+    if (fptr == 0) return;
+
+    // Redirect stdout to UART
+    freopen("uart:", "w", stdout);
+
+    // Turn off buffering for stdout
+    setvbuf(stdout, NULL, _IONBF, 0);
+}
@@ -18,11 +18,23 @@
  */
 
 #include "../inc/EUSCI_A3_SPI.h"
+#include "../inc/Register_Fields.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/DMA.h"
+
+static uint8_t Discard_Byte;
+
+// DMA channels of EUSCI_A3_SPI_Write_Start, or DMA_ERROR_BUSY until they are allocated
+static int DMA_TX_Channel = DMA_ERROR_BUSY;
+static int DMA_RX_Channel = DMA_ERROR_BUSY;
+
+// Function called from the DMA interrupt handler at the end of a transfer
+static void (*Completion_Callback)(void);
 
 void EUSCI_A3_SPI_Init()
 {
     // Hold the EUSCI_A3 module in reset mode
-    EUSCI_A3->CTLW0 |= 0x01;
+    EUSCI_A3->CTLW0 |= EUSCI_A_CTLW0_SWRST;
 
 //     CTWL0 Register Configuration
 //
@@ -39,24 +51,25 @@ void EUSCI_A3_SPI_Init()
 //       5-2        Reserved     0x0        Reserved
 //       1          UCSTEM       0x1        UCSTE pin is used to generate signal for 4-wire slave
 //       0          UCSWRST      0x1        eUSCI logic held in reset state
-    EUSCI_A3->CTLW0 |= 0xAD83;
+    EUSCI_A3->CTLW0 = EUSCI_A_CTLW0_CKPH | EUSCI_A_CTLW0_MSB | EUSCI_A_CTLW0_MST | REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 2)
+                      | EUSCI_A_CTLW0_SYNC | REGISTER_FIELD(EUSCI_A_CTLW0_SSEL, 2) | EUSCI_A_CTLW0_STEM | EUSCI_A_CTLW0_SWRST;
 
     // Set the baud rate. The clock frequency used is 1 MHz.
     // N = (Clock Frequency) / (Baud Rate) = (12,000,000 / 1,000,000)
-    // N = 3
-    EUSCI_A3->BRW |= 12;
+    // N = 12 (the build fails if SMCLK is changed to a frequency that is not a multiple of 1 MHz)
+    EUSCI_A3->BRW = EUSCI_A3_SPI_BRW(1000000)
+                    + REGISTER_CHECK(EUSCI_A3_SPI_SMCLK_FREQUENCY / EUSCI_A3_SPI_BRW(1000000) == 1000000);
 
     // Configure P9.4, P9.5, and P9.7 pins as primary module function
-    P9->SEL0 |= 0xB0;
-    P9->SEL1 &= ~0xB0;
+    PIN_MAP_CONFIGURE(PIN_GROUP_EUSCI_A3_SPI_4_PIN);
 
     // Clear the software reset bit to enable the EUSCI_A3 module
-    EUSCI_A3->CTLW0 &= ~0x01;
+    EUSCI_A3->CTLW0 &= ~EUSCI_A_CTLW0_SWRST;
 
     // Ensure that the following interrupts are disabled:
     // - Receive Interrupt
     // - Transmit Interrupt
-    EUSCI_A3->IE &= ~0x03;
+    EUSCI_A3->IE &= ~(EUSCI_A_IE_RXIE | EUSCI_A_IE_TXIE);
 }
 
 void EUSCI_A3_SPI_Command_Write(uint8_t command)
@@ -79,3 +92,135 @@ void EUSCI_A3_SPI_Data_Write(uint8_t data)
     // Write the data byte to the transmit buffer
     EUSCI_A3->TXBUF = data;
 }
+
+void EUSCI_A3_SPI_Configure(uint32_t clock_frequency, uint8_t mode)
+{
+    uint16_t ctlw0 = EUSCI_A_CTLW0_MSB | EUSCI_A_CTLW0_MST | REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 0) | EUSCI_A_CTLW0_SYNC
+                     | REGISTER_FIELD(EUSCI_A_CTLW0_SSEL, 2) | EUSCI_A_CTLW0_SWRST;
+    uint32_t brw = EUSCI_A3_SPI_BRW(clock_frequency);
+
+    // Hold the EUSCI_A3 module in reset mode
+    EUSCI_A3->CTLW0 |= EUSCI_A_CTLW0_SWRST;
+
+//     CTWL0 Register Configuration
+//
+//      Bit(s)      Field       Value       Description
+//      -----       -----       -----       -----------
+//       15         UCCKPH       mode       1 = data is captured on the first edge (CPHA = 0)
+//       14         UCCKPL       mode       1 = clock is high when inactive (CPOL = 1)
+//       13         UCMSB        0x1        MSB first
+//       12         UC7BIT       0x0        8-bit data
+//       11         UCMST        0x1        Master mode is selected
+//       10-9       UCMODEx      0x0        3-pin SPI (chip-select is a GPIO pin driven by software)
+//       8          UCSYNC       0x1        Synchronous mode
+//       7-6        UCSSELx      0x2        eUSCI clock source is SMCLK
+//       5-2        Reserved     0x0        Reserved
+//       1          UCSTEM       0x0        UCSTE is not used in 3-pin mode
+//       0          UCSWRST      0x1        eUSCI logic held in reset state
+    if ((mode & 0x01) == 0) ctlw0 |= EUSCI_A_CTLW0_CKPH;
+    if (mode & 0x02) ctlw0 |= EUSCI_A_CTLW0_CKPL;
+    EUSCI_A3->CTLW0 = ctlw0;
+
+    // Set the clock divider: f(SCLK) = SMCLK / BRW
+    if (brw == 0)
+    {
+        brw = 1;
+    }
+    EUSCI_A3->BRW = (uint16_t)brw;
+
+    // Configure P9.5 and P9.7 pins as primary module function.
+    // P9.4 (UCA3STE) is left to the caller, which can use it as a GPIO chip-select.
+    PIN_MAP_CONFIGURE(PIN_GROUP_EUSCI_A3_SPI);
+
+    // Clear the software reset bit to enable the EUSCI_A3 module
+    EUSCI_A3->CTLW0 &= ~EUSCI_A_CTLW0_SWRST;
+
+    // Ensure that the following interrupts are disabled:
+    // - Receive Interrupt
+    // - Transmit Interrupt
+    EUSCI_A3->IE &= ~(EUSCI_A_IE_RXIE | EUSCI_A_IE_TXIE);
+}
+
+void EUSCI_A3_SPI_Write(const uint8_t *data, uint16_t length)
+{
+    uint16_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        // Wait until UCA3TXBUF is empty, so that the next byte is ready while the previous one is being shifted
+        while((EUSCI_A3->IFG & 0x0002) == 0x0000);
+
+        EUSCI_A3->TXBUF = data[i];
+    }
+
+    // UCBUSY - Wait until the last byte has been shifted out
+    while((EUSCI_A3->STATW & 0x0001) == 0x0001);
+}
+
+static void DMA_Complete(uint8_t channel)
+{
+    // The receive channel has received the last byte of the transfer and has been disabled by the controller
+    if (Completion_Callback)
+    {
+        Completion_Callback();
+    }
+}
+
+int EUSCI_A3_SPI_Write_Start(const uint8_t *data, uint16_t length)
+{
+    if (EUSCI_A3_SPI_Is_Busy())
+    {
+        return EUSCI_A3_SPI_ERROR_BUSY;
+    }
+
+    if ((length == 0) || (length > EUSCI_A3_SPI_DMA_MAX_LENGTH))
+    {
+        return EUSCI_A3_SPI_ERROR_LENGTH;
+    }
+
+    // Reserve DMA channel 6 (UCA3TXIFG) and DMA channel 7 (UCA3RXIFG).
+    // The completion of the receive channel (the last received byte) calls DMA_Complete.
+    if (DMA_TX_Channel < 0)
+    {
+        DMA_TX_Channel = DMA_Allocate(DMA_TRIGGER_EUSCI_A3_TX);
+    }
+    if (DMA_RX_Channel < 0)
+    {
+        DMA_RX_Channel = DMA_Allocate(DMA_TRIGGER_EUSCI_A3_RX);
+        if (DMA_RX_Channel >= 0)
+        {
+            DMA_Set_Callback(DMA_RX_Channel, DMA_Complete, EUSCI_A3_SPI_PRIORITY);
+        }
+    }
+    if ((DMA_TX_Channel < 0) || (DMA_RX_Channel < 0))
+    {
+        return EUSCI_A3_SPI_ERROR_DMA;
+    }
+
+    // Receive channel: there is no MISO pin, so the received bytes are only counted
+    DMA_Set_Transfer(DMA_Primary(DMA_RX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_DST_FIXED | DMA_MODE_BASIC,
+                     &EUSCI_A3->RXBUF, &Discard_Byte, length);
+
+    // Transmit channel: UCTXIFG is set while TXBUF is empty, so it is triggered as soon as it is enabled
+    DMA_Set_Transfer(DMA_Primary(DMA_TX_Channel), DMA_SIZE_8 | DMA_DST_FIXED | DMA_MODE_BASIC,
+                     data, &EUSCI_A3->TXBUF, length);
+
+    // Clear UCRXIFG so that the receive channel is only triggered by the bytes of this transfer,
+    // and enable the receive channel before the transmit channel starts the transfer
+    (void)EUSCI_A3->RXBUF;
+    DMA_Enable(DMA_RX_Channel);
+    DMA_Enable(DMA_TX_Channel);
+
+    return 0;
+}
+
+void EUSCI_A3_SPI_Set_Callback(void (*callback)(void))
+{
+    Completion_Callback = callback;
+}
+
+uint8_t EUSCI_A3_SPI_Is_Busy()
+{
+    // The receive channel is disabled by the controller after the last byte has been received
+    return ((DMA_RX_Channel >= 0) && DMA_Is_Enabled(DMA_RX_Channel)) ? 1 : 0;
+}
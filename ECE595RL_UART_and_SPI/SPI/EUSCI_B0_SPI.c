@@ -0,0 +1,378 @@
+/**
+ * @file EUSCI_B0_SPI.c
+ * @brief Source code for the EUSCI_B0_SPI driver.
+ *
+ * This file contains the function definitions for the EUSCI_B0_SPI driver.
+ * It provides full-duplex SPI master transfers with blocking, interrupt-driven and DMA backends.
+ *  - P1.5 (SCLK)
+ *  - P1.6 (MOSI, Master Out Slave In)
+ *  - P1.7 (MISO, Master In Slave Out)
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI) and the DMA controller,
+ * refer to the eUSCI SPI Mode (25) and DMA (11) sections of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/EUSCI_B0_SPI.h"
+#include "../inc/Register_Fields.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/DMA.h"
+#include "../inc/Trace.h"
+
+static const uint8_t Fill_Byte = EUSCI_B0_SPI_FILL_BYTE;
+static uint8_t Discard_Byte;
+
+// DMA channels of the DMA backend, or DMA_ERROR_BUSY if they could not be allocated
+static int DMA_TX_Channel = DMA_ERROR_BUSY;
+static int DMA_RX_Channel = DMA_ERROR_BUSY;
+
+static uint32_t Clock_Frequency;
+static uint8_t Backend = EUSCI_B0_SPI_BLOCKING;
+
+// State of the transfer in progress with the IRQ backend
+static const uint8_t *IRQ_TX;
+static uint8_t *IRQ_RX;
+static uint16_t IRQ_Length;
+static uint16_t IRQ_TX_Index;
+static uint16_t IRQ_RX_Index;
+static volatile uint8_t IRQ_Busy;
+
+// Function called from the interrupt handler at the end of an IRQ transfer
+static void (*Completion_Callback)(void);
+
+static void DMA_Complete(uint8_t channel);
+
+void EUSCI_B0_SPI_Init(uint32_t clock_frequency, uint8_t mode)
+{
+    EUSCI_B0_SPI_Configure(clock_frequency, mode);
+
+    // Configure P1.5, P1.6 and P1.7 as primary module function
+    PIN_MAP_CONFIGURE(PIN_GROUP_EUSCI_B0_SPI);
+
+    // Interrupts are only enabled while an IRQ transfer is in progress
+    EUSCI_B0->IE &= ~0x03;
+
+    // Set the priority of the interrupt and enable it in the NVIC
+    // EUSCIB0 is IRQ 20 (section 2.4.3.20)
+    NVIC->IP[20] = (EUSCI_B0_SPI_PRIORITY << 5);
+    NVIC->ISER[0] = (1 << 20);
+
+    // Reserve DMA channel 0 (UCB0TXIFG0) and DMA channel 1 (UCB0RXIFG0) for the DMA backend.
+    // The completion of the receive channel (the last received byte of a DMA transfer) calls DMA_Complete.
+    if (DMA_TX_Channel < 0)
+    {
+        DMA_TX_Channel = DMA_Allocate(DMA_TRIGGER_EUSCI_B0_TX);
+    }
+    if (DMA_RX_Channel < 0)
+    {
+        DMA_RX_Channel = DMA_Allocate(DMA_TRIGGER_EUSCI_B0_RX);
+        if (DMA_RX_Channel >= 0)
+        {
+            DMA_Set_Callback(DMA_RX_Channel, DMA_Complete, EUSCI_B0_SPI_PRIORITY);
+        }
+    }
+
+    Backend = EUSCI_B0_SPI_BLOCKING;
+    IRQ_Busy = 0;
+}
+
+void EUSCI_B0_SPI_Configure(uint32_t clock_frequency, uint8_t mode)
+{
+    uint16_t ctlw0 = EUSCI_B_CTLW0_MSB | EUSCI_B_CTLW0_MST | REGISTER_FIELD(EUSCI_B_CTLW0_MODE, 0) | EUSCI_B_CTLW0_SYNC
+                     | REGISTER_FIELD(EUSCI_B_CTLW0_SSEL, 2) | EUSCI_B_CTLW0_SWRST;
+    uint32_t brw = EUSCI_B0_SPI_BRW(clock_frequency);
+
+    // Hold the EUSCI_B0 module in reset mode
+    EUSCI_B0->CTLW0 |= EUSCI_B_CTLW0_SWRST;
+
+    // CTLW0 Register Configuration
+    //
+    //  Bit(s)      Field       Value       Description
+    //  -----       -----       -----       -----------
+    //   15         UCCKPH      mode        1 = data is captured on the first edge (CPHA = 0)
+    //   14         UCCKPL      mode        1 = clock is high when inactive (CPOL = 1)
+    //   13         UCMSB       0x1         MSB first
+    //   12         UC7BIT      0x0         8-bit data
+    //   11         UCMST       0x1         Master mode is selected
+    //   10-9       UCMODEx     0x0         3-pin SPI
+    //   8          UCSYNC      0x1         Synchronous mode
+    //   7-6        UCSSELx     0x2         eUSCI clock source is SMCLK
+    //   5-2        Reserved    0x0         Reserved
+    //   1          UCSTEM      0x0         UCSTE is not used in 3-pin mode
+    //   0          UCSWRST     0x1         eUSCI logic held in reset state
+    if ((mode & 0x01) == 0) ctlw0 |= EUSCI_B_CTLW0_CKPH;
+    if (mode & 0x02) ctlw0 |= EUSCI_B_CTLW0_CKPL;
+    EUSCI_B0->CTLW0 = ctlw0;
+
+    // Set the clock divider: f(SCLK) = SMCLK / BRW
+    if (brw == 0)
+    {
+        brw = 1;
+    }
+    EUSCI_B0->BRW = (uint16_t)brw;
+    Clock_Frequency = EUSCI_B0_SPI_SMCLK_FREQUENCY / brw;
+
+    // Clear the software reset bit to enable the EUSCI_B0 module
+    EUSCI_B0->CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+}
+
+uint32_t EUSCI_B0_SPI_Get_Clock_Frequency()
+{
+    return Clock_Frequency;
+}
+
+void EUSCI_B0_SPI_Set_Backend(uint8_t backend)
+{
+    EUSCI_B0_SPI_Wait();
+    Backend = backend;
+}
+
+void EUSCI_B0_SPI_Set_Callback(void (*callback)(void))
+{
+    Completion_Callback = callback;
+}
+
+/**
+ * @brief Transfers bytes by polling, keeping one byte in TXBUF while the previous one is being shifted.
+ */
+static void Transfer_Blocking(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    uint16_t i;
+    uint8_t data;
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    // Discard a byte left in RXBUF by a previous transfer
+    data = (uint8_t)EUSCI_B0->RXBUF;
+
+    EUSCI_B0->TXBUF = tx ? tx[0] : EUSCI_B0_SPI_FILL_BYTE;
+
+    for (i = 1; i <= length; i++)
+    {
+        if (i < length)
+        {
+            // UCTXIFG - Wait until the previous byte has moved to the shift register
+            while((EUSCI_B0->IFG & 0x0002) == 0x0000);
+            EUSCI_B0->TXBUF = tx ? tx[i] : EUSCI_B0_SPI_FILL_BYTE;
+        }
+
+        // UCRXIFG - Wait until byte i - 1 has been received
+        while((EUSCI_B0->IFG & 0x0001) == 0x0000);
+        data = (uint8_t)EUSCI_B0->RXBUF;
+        if (rx)
+        {
+            rx[i - 1] = data;
+        }
+    }
+}
+
+/**
+ * @brief Starts a transfer where the EUSCIB0 interrupt handler writes each byte after the previous one is received.
+ */
+static void Transfer_IRQ_Start(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    IRQ_TX = tx;
+    IRQ_RX = rx;
+    IRQ_Length = length;
+    IRQ_TX_Index = 1;
+    IRQ_RX_Index = 0;
+    IRQ_Busy = 1;
+
+    // Discard a byte left in RXBUF by a previous transfer, then enable the receive interrupt
+    (void)EUSCI_B0->RXBUF;
+    EUSCI_B0->IE |= 0x01;
+
+    EUSCI_B0->TXBUF = tx ? tx[0] : EUSCI_B0_SPI_FILL_BYTE;
+}
+
+void EUSCIB0_IRQHandler(void)
+{
+    uint8_t data;
+
+    TRACE_ISR_ENTER(TRACE_ID_EUSCI_B0_SPI);
+
+    // UCRXIFG - A byte has been received
+    if (EUSCI_B0->IFG & 0x0001)
+    {
+        data = (uint8_t)EUSCI_B0->RXBUF;
+        if (IRQ_RX)
+        {
+            IRQ_RX[IRQ_RX_Index] = data;
+        }
+        IRQ_RX_Index++;
+
+        if (IRQ_TX_Index < IRQ_Length)
+        {
+            EUSCI_B0->TXBUF = IRQ_TX ? IRQ_TX[IRQ_TX_Index] : EUSCI_B0_SPI_FILL_BYTE;
+            IRQ_TX_Index++;
+        }
+        else
+        {
+            EUSCI_B0->IE &= ~0x01;
+            IRQ_Busy = 0;
+            if (Completion_Callback)
+            {
+                Completion_Callback();
+            }
+        }
+    }
+
+    TRACE_ISR_EXIT(TRACE_ID_EUSCI_B0_SPI);
+}
+
+static void DMA_Complete(uint8_t channel)
+{
+    // The receive channel has received the last byte of the transfer and has been disabled by the controller
+    if (Completion_Callback)
+    {
+        Completion_Callback();
+    }
+}
+
+/**
+ * @brief Starts a transfer where the receive channel reads every received byte and the transmit channel writes
+ *        every byte. UCTXIFG is set while TXBUF is empty, so the transmit channel is triggered as soon as it is enabled.
+ */
+static void Transfer_DMA_Start(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    // Receive channel: moves RXBUF to the receive buffer, or discards the received bytes
+    if (rx)
+    {
+        DMA_Set_Transfer(DMA_Primary(DMA_RX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_MODE_BASIC,
+                         &EUSCI_B0->RXBUF, rx, length);
+    }
+    else
+    {
+        DMA_Set_Transfer(DMA_Primary(DMA_RX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_DST_FIXED | DMA_MODE_BASIC,
+                         &EUSCI_B0->RXBUF, &Discard_Byte, length);
+    }
+
+    // Transmit channel: moves every byte to TXBUF, or the fill byte. The CPU does not write TXBUF,
+    // otherwise its write and the first write of the channel would both go to an empty TXBUF.
+    if (tx)
+    {
+        DMA_Set_Transfer(DMA_Primary(DMA_TX_Channel), DMA_SIZE_8 | DMA_DST_FIXED | DMA_MODE_BASIC,
+                         tx, &EUSCI_B0->TXBUF, length);
+    }
+    else
+    {
+        DMA_Set_Transfer(DMA_Primary(DMA_TX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_DST_FIXED | DMA_MODE_BASIC,
+                         &Fill_Byte, &EUSCI_B0->TXBUF, length);
+    }
+
+    // Clear UCRXIFG so that the receive channel is only triggered by the bytes of this transfer,
+    // and enable the receive channel before the transmit channel starts the transfer
+    (void)EUSCI_B0->RXBUF;
+    DMA_Enable(DMA_RX_Channel);
+    DMA_Enable(DMA_TX_Channel);
+}
+
+int EUSCI_B0_SPI_Transfer_Start(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    if (EUSCI_B0_SPI_Is_Busy())
+    {
+        return EUSCI_B0_SPI_ERROR_BUSY;
+    }
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    switch(Backend)
+    {
+        case EUSCI_B0_SPI_IRQ:
+        {
+            Transfer_IRQ_Start(tx, rx, length);
+            break;
+        }
+
+        case EUSCI_B0_SPI_DMA:
+        {
+            if ((DMA_TX_Channel < 0) || (DMA_RX_Channel < 0))
+            {
+                return EUSCI_B0_SPI_ERROR_DMA;
+            }
+            if (length > EUSCI_B0_SPI_DMA_MAX_LENGTH)
+            {
+                return EUSCI_B0_SPI_ERROR_LENGTH;
+            }
+            Transfer_DMA_Start(tx, rx, length);
+            break;
+        }
+
+        default:
+        {
+            Transfer_Blocking(tx, rx, length);
+            break;
+        }
+    }
+
+    return 0;
+}
+
+int EUSCI_B0_SPI_Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    uint16_t chunk;
+    int result;
+
+    if (EUSCI_B0_SPI_Is_Busy())
+    {
+        return EUSCI_B0_SPI_ERROR_BUSY;
+    }
+
+    while(length)
+    {
+        chunk = length;
+        if ((Backend == EUSCI_B0_SPI_DMA) && (chunk > EUSCI_B0_SPI_DMA_MAX_LENGTH))
+        {
+            chunk = EUSCI_B0_SPI_DMA_MAX_LENGTH;
+        }
+
+        // Nothing was started (no free DMA channels, or a length error): there is nothing to wait for
+        result = EUSCI_B0_SPI_Transfer_Start(tx, rx, chunk);
+        if (result < 0)
+        {
+            return result;
+        }
+        EUSCI_B0_SPI_Wait();
+
+        if (tx)
+        {
+            tx += chunk;
+        }
+        if (rx)
+        {
+            rx += chunk;
+        }
+        length -= chunk;
+    }
+
+    return 0;
+}
+
+uint8_t EUSCI_B0_SPI_Is_Busy()
+{
+    if (IRQ_Busy)
+    {
+        return 1;
+    }
+
+    // The receive channel is disabled by the controller after the last byte has been received
+    if ((Backend == EUSCI_B0_SPI_DMA) && (DMA_RX_Channel >= 0) && DMA_Is_Enabled(DMA_RX_Channel))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+void EUSCI_B0_SPI_Wait()
+{
+    while(EUSCI_B0_SPI_Is_Busy());
+}
@@ -0,0 +1,298 @@
+/**
+ * @file EUSCI_B2_SPI_Slave.c
+ * @brief Source code for the EUSCI_B2_SPI_Slave driver.
+ *
+ * This file contains the function definitions for the EUSCI_B2_SPI_Slave driver.
+ * It receives chip-select framed transactions from an external SPI master into two DMA buffers.
+ *  - P3.4 (CS, GPIO with interrupt)
+ *  - P3.5 (SCLK)
+ *  - P3.6 (SIMO, Slave In Master Out)
+ *  - P3.7 (SOMI, Slave Out Master In)
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI) and the DMA controller,
+ * refer to the eUSCI SPI Mode (25) and DMA (11) sections of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/EUSCI_B2_SPI_Slave.h"
+#include "../inc/Register_Fields.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/DMA.h"
+#include "../inc/Critical_Section.h"
+
+#define CS_BIT      0x10
+#define SOMI_BIT    0x80
+
+// DMA channels, or DMA_ERROR_BUSY until they are allocated
+static int DMA_TX_Channel = DMA_ERROR_BUSY;
+static int DMA_RX_Channel = DMA_ERROR_BUSY;
+
+static const uint8_t Fill_Byte = EUSCI_B2_SPI_SLAVE_FILL_BYTE;
+static uint8_t Discard_Byte;
+
+// Receive buffers. RX_Length is -1 while a buffer is free, otherwise the length of the transaction it holds.
+static uint8_t RX_Buffer[2][EUSCI_B2_SPI_SLAVE_MAX_LENGTH];
+static volatile int16_t RX_Length[2];
+static uint8_t Write_Index;     // Buffer that receives the next transaction
+static uint8_t Read_Index;      // Oldest buffer holding a transaction
+
+static const uint8_t *Response;
+static uint16_t Response_Length;
+
+// State of the transaction in progress
+static volatile uint8_t Transaction_Active;
+static uint8_t Transaction_Stored;
+static uint32_t Transaction_Start;
+
+static EUSCI_B2_SPI_Slave_Stats Stats;
+
+int EUSCI_B2_SPI_Slave_Init(uint8_t mode)
+{
+    uint16_t ctlw0 = EUSCI_B_CTLW0_MSB | REGISTER_FIELD(EUSCI_B_CTLW0_MODE, 0) | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_SWRST;
+
+    // Reserve DMA channel 4 (UCB2TXIFG0) and DMA channel 5 (UCB2RXIFG0)
+    if (DMA_TX_Channel < 0)
+    {
+        DMA_TX_Channel = DMA_Allocate(DMA_TRIGGER_EUSCI_B2_TX);
+    }
+    if (DMA_RX_Channel < 0)
+    {
+        DMA_RX_Channel = DMA_Allocate(DMA_TRIGGER_EUSCI_B2_RX);
+    }
+    if ((DMA_TX_Channel < 0) || (DMA_RX_Channel < 0))
+    {
+        return EUSCI_B2_SPI_SLAVE_ERROR_DMA;
+    }
+
+    // Hold the EUSCI_B2 module in reset mode
+    EUSCI_B2->CTLW0 |= EUSCI_B_CTLW0_SWRST;
+
+    // CTLW0 Register Configuration
+    //
+    //  Bit(s)      Field       Value       Description
+    //  -----       -----       -----       -----------
+    //   15         UCCKPH      mode        1 = data is captured on the first edge (CPHA = 0)
+    //   14         UCCKPL      mode        1 = clock is high when inactive (CPOL = 1)
+    //   13         UCMSB       0x1         MSB first
+    //   12         UC7BIT      0x0         8-bit data
+    //   11         UCMST       0x0         Slave mode is selected
+    //   10-9       UCMODEx     0x0         3-pin SPI (CS is handled by the PORT3 interrupt)
+    //   8          UCSYNC      0x1         Synchronous mode
+    //   7-6        UCSSELx     0x0         Not used in slave mode (the clock is generated by the master)
+    //   5-2        Reserved    0x0         Reserved
+    //   1          UCSTEM      0x0         UCSTE is not used in 3-pin mode
+    //   0          UCSWRST     0x1         eUSCI logic held in reset state until CS goes low
+    if ((mode & 0x01) == 0) ctlw0 |= EUSCI_B_CTLW0_CKPH;
+    if (mode & 0x02) ctlw0 |= EUSCI_B_CTLW0_CKPL;
+    EUSCI_B2->CTLW0 = ctlw0;
+
+    // Configure P3.5 (SCLK) and P3.6 (SIMO) as primary module function.
+    // P3.7 (SOMI) is a high impedance input until a transaction starts.
+    PIN_MAP_CONFIGURE(PIN_GROUP_EUSCI_B2_SPI_SLAVE);
+
+    // Configure P3.4 (CS) as a GPIO input with a pull-up resistor and a falling edge interrupt
+    P3->IES |= CS_BIT;
+    P3->IFG &= ~CS_BIT;
+
+    // Stop the DMA channels. The receive channel has the high priority, because a late receive loses data.
+    DMA_Disable(DMA_TX_Channel);
+    DMA_Disable(DMA_RX_Channel);
+    DMA_Set_High_Priority(DMA_RX_Channel, 1);
+
+    RX_Length[0] = -1;
+    RX_Length[1] = -1;
+    Write_Index = 0;
+    Read_Index = 0;
+    Response = 0;
+    Response_Length = 0;
+    Transaction_Active = 0;
+    Stats.transactions = 0;
+    Stats.bytes = 0;
+    Stats.dropped_transactions = 0;
+    Stats.overruns = 0;
+    Stats.active_cycles = 0;
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Set the priority of the interrupt and enable it in the NVIC
+    // PORT3 is IRQ 37
+    NVIC->IP[37] = (EUSCI_B2_SPI_SLAVE_PRIORITY << 5);
+    NVIC->ISER[1] = (1 << 5);
+
+    P3->IE |= CS_BIT;
+
+    // Start with CS already low if the master is in the middle of a transaction
+    if ((P3->IN & CS_BIT) == 0)
+    {
+        P3->IFG |= CS_BIT;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Called when CS goes low. Arms the DMA channels while EUSCI_B2 is in reset, then releases it
+ *        and enables the transmit channel, which is triggered by UCTXIFG (set while TXBUF is empty)
+ *        and loads every response byte, including the first one.
+ */
+static void Transaction_Begin()
+{
+    const uint8_t *response = Response;
+    uint16_t response_length = Response_Length;
+
+    Transaction_Start = DWT->CYCCNT;
+    Transaction_Active = 1;
+
+    // Receive channel: store the received bytes into the next free buffer, or discard them if both buffers are full
+    if (RX_Length[Write_Index] < 0)
+    {
+        Transaction_Stored = 1;
+        DMA_Set_Transfer(DMA_Primary(DMA_RX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_MODE_BASIC,
+                         &EUSCI_B2->RXBUF, RX_Buffer[Write_Index], EUSCI_B2_SPI_SLAVE_MAX_LENGTH);
+    }
+    else
+    {
+        Transaction_Stored = 0;
+        DMA_Set_Transfer(DMA_Primary(DMA_RX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_DST_FIXED | DMA_MODE_BASIC,
+                         &EUSCI_B2->RXBUF, &Discard_Byte, EUSCI_B2_SPI_SLAVE_MAX_LENGTH);
+    }
+
+    // Transmit channel: transmit the response, or the fill byte
+    if (response && (response_length > 0))
+    {
+        DMA_Set_Transfer(DMA_Primary(DMA_TX_Channel), DMA_SIZE_8 | DMA_DST_FIXED | DMA_MODE_BASIC,
+                         response, &EUSCI_B2->TXBUF, response_length);
+    }
+    else
+    {
+        DMA_Set_Transfer(DMA_Primary(DMA_TX_Channel), DMA_SIZE_8 | DMA_SRC_FIXED | DMA_DST_FIXED | DMA_MODE_BASIC,
+                         &Fill_Byte, &EUSCI_B2->TXBUF, EUSCI_B2_SPI_SLAVE_MAX_LENGTH);
+    }
+
+    DMA_Enable(DMA_RX_Channel);
+
+    // Drive SOMI and release EUSCI_B2 from reset
+    P3->SEL0 |= SOMI_BIT;
+    EUSCI_B2->CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+
+    // UCTXIFG is set after the reset, so the transmit channel loads the first byte as soon as it is enabled.
+    // The CPU does not write TXBUF, otherwise its write and the first write of the channel would race.
+    DMA_Enable(DMA_TX_Channel);
+}
+
+/**
+ * @brief Called when CS goes high. Stops EUSCI_B2, counts the received bytes and hands the buffer to the application.
+ */
+static void Transaction_End()
+{
+    uint16_t received;
+    uint8_t overrun = 0;
+
+    // UCRXIFG or UCOE after the receive channel is done means that more bytes were sent than fit in the buffer
+    if (!DMA_Is_Enabled(DMA_RX_Channel))
+    {
+        received = EUSCI_B2_SPI_SLAVE_MAX_LENGTH;
+        if ((EUSCI_B2->IFG & 0x0001) || (EUSCI_B2->STATW & 0x0020))
+        {
+            overrun = 1;
+        }
+    }
+    else
+    {
+        // The controller writes the remaining number of transfers minus one back to the control word
+        received = EUSCI_B2_SPI_SLAVE_MAX_LENGTH - DMA_Get_Remaining(DMA_RX_Channel);
+    }
+
+    // Hold EUSCI_B2 in reset (SCLK is ignored until the next transaction) and release SOMI
+    EUSCI_B2->CTLW0 |= EUSCI_B_CTLW0_SWRST;
+    P3->SEL0 &= ~SOMI_BIT;
+    DMA_Disable(DMA_TX_Channel);
+    DMA_Disable(DMA_RX_Channel);
+
+    Stats.active_cycles += DWT->CYCCNT - Transaction_Start;
+    if (overrun)
+    {
+        Stats.overruns++;
+    }
+
+    if (Transaction_Stored)
+    {
+        RX_Length[Write_Index] = received;
+        Write_Index ^= 1;
+        Stats.transactions++;
+        Stats.bytes += received;
+    }
+    else
+    {
+        Stats.dropped_transactions++;
+    }
+
+    Transaction_Active = 0;
+}
+
+void PORT3_IRQHandler(void)
+{
+    P3->IFG &= ~CS_BIT;
+
+    // The edge select is changed before the level is checked, so an edge that happens meanwhile sets the flag again
+    if (!Transaction_Active && ((P3->IN & CS_BIT) == 0))
+    {
+        P3->IES &= ~CS_BIT;
+        P3->IFG &= ~CS_BIT;
+        Transaction_Begin();
+    }
+
+    if (Transaction_Active && (P3->IN & CS_BIT))
+    {
+        P3->IES |= CS_BIT;
+        P3->IFG &= ~CS_BIT;
+        Transaction_End();
+    }
+}
+
+int EUSCI_B2_SPI_Slave_Get_Transaction(const uint8_t **data)
+{
+    int length = RX_Length[Read_Index];
+
+    if (length >= 0)
+    {
+        *data = RX_Buffer[Read_Index];
+    }
+
+    return length;
+}
+
+void EUSCI_B2_SPI_Slave_Release_Transaction()
+{
+    if (RX_Length[Read_Index] >= 0)
+    {
+        RX_Length[Read_Index] = -1;
+        Read_Index ^= 1;
+    }
+}
+
+void EUSCI_B2_SPI_Slave_Set_Response(const uint8_t *response, uint16_t length)
+{
+    uint32_t section;
+
+    if (length > EUSCI_B2_SPI_SLAVE_MAX_LENGTH)
+    {
+        length = EUSCI_B2_SPI_SLAVE_MAX_LENGTH;
+    }
+
+    section = Critical_Section_Enter_Priority(EUSCI_B2_SPI_SLAVE_PRIORITY);
+    Response = response;
+    Response_Length = length;
+    Critical_Section_Exit(section);
+}
+
+void EUSCI_B2_SPI_Slave_Get_Stats(EUSCI_B2_SPI_Slave_Stats *stats)
+{
+    uint32_t section = Critical_Section_Enter_Priority(EUSCI_B2_SPI_SLAVE_PRIORITY);
+    *stats = Stats;
+    Critical_Section_Exit(section);
+}
@@ -35,6 +35,9 @@
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/Nokia5110_LCD.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/Memory_Block.h"
+#include "../inc/Trace.h"
 
 const uint8_t ASCII[][5] = {
    {0x00, 0x00, 0x00, 0x00, 0x00} // 20
@@ -136,51 +139,20 @@ const uint8_t ASCII[][5] = {
   ,{0x1f, 0x24, 0x7c, 0x24, 0x1f} // 7f UT sign
 };
 
+// The Nokia 5110 LCD on SPI_BUS_A3: SCE on P9.4, 1 MHz, mode 0
+static const SPI_Bus_Device Nokia5110_Device = {SPI_BUS_A3, 9, 0x10, 1000000, SPI_BUS_MODE_0};
+
+// Character column of the cursor, used by the stream sink to end a row at '\n'
+static uint8_t Cursor_Column = 0;
+
 void Nokia5110_SPI_Init()
 {
-    // Hold the EUSCI_A3 module in reset mode
-    EUSCI_A3->CTLW0 |= 0x01;
-
-// CTWL0 Register Configuration
-//
-//  Bit(s)      Field       Value       Description
-//  -----       -----       -----       -----------
-//   15         UCCKPH       0x1        Data is captured on the first edge and changed on the following edge
-//   14         UCCKPL       0x0        Clock is low when inactive
-//   13         UCMSB        0x1        MSB first
-//   12         UC7BIT       0x0        8-bit data
-//   11         UCMST        0x1        Master mode is selected
-//   10-9       UCMODEx      0x2        4-pin SPI with active low UCSTE
-//   8          UCSYNC       0x1        Synchronous mode
-//   7-6        UCSSELx      0x2        eUSCI clock source is SMCLK
-//   5-2        Reserved     0x0        Reserved
-//   1          UCSTEM       0x1        UCSTE pin is used to generate signal for 4-wire slave
-//   0          UCSWRST      0x1        eUSCI logic held in reset state
-    EUSCI_A3->CTLW0 |= 0xAD83;
-
-    // Set the baud rate. The clock frequency used is 1 MHz.
-    // N = (Clock Frequency) / (Baud Rate) = (12,000,000 / 1,000,000)
-    // N = 12
-    EUSCI_A3->BRW |= 12;
-
-    // Configure P9.4, P9.5, and P9.7 pins as primary module function
-    P9->SEL0 |= 0xB0;
-    P9->SEL1 &= ~0xB0;
-
-    // Configure P9.3 (Reset) and P9.6 (Data/Command) pins as GPIO pins
-    P9->SEL0 &= ~(RESET_BIT | DC_BIT);
-    P9->SEL1 &= ~(RESET_BIT | DC_BIT);
-
-    // Set the direction of the P9.3 and P9.6 as output
-    P9->DIR |= (RESET_BIT | DC_BIT);
-
-    // Clear the software reset bit to enable the EUSCI_A3 module
-    EUSCI_A3->CTLW0 &= ~0x01;
-
-    // Ensure that the following interrupts are disabled:
-    // - Receive Interrupt
-    // - Transmit Interrupt
-    EUSCI_A3->IE &= ~0x03;
+    // Configure EUSCI_A3 (P9.5 and P9.7) and the SCE chip-select pin (P9.4)
+    SPI_Bus_Init(SPI_BUS_A3);
+    SPI_Bus_Add_Device(&Nokia5110_Device);
+
+    // Configure P9.3 (Reset) and P9.6 (Data/Command) pins as GPIO outputs
+    PIN_MAP_CONFIGURE(PIN_GROUP_NOKIA5110_CONTROL);
 }
 
 void Nokia5110_SPI_Data_Command_Bit_Out(uint8_t data_command_select)
@@ -257,159 +229,128 @@ void Nokia5110_Init()
 
 void Nokia5110_Command_Write(uint8_t command)
 {
-    // UCBUSY - Wait until SPI is not busy
-    while((EUSCI_A3->STATW & 0x0001) == 0x0001);
-
     // Set the Data/Command output pin to 0 to indicate that the transmitted byte is a command byte
     Nokia5110_SPI_Data_Command_Bit_Out(0x00);
 
-    // Write the command byte to the transmit buffer
-    EUSCI_A3->TXBUF = command;
-
-    // UCBUSY - Wait until SPI is not busy
-    while((EUSCI_A3->STATW & 0x0001) == 0x0001);
+    // Transmit the command byte and wait until it has been shifted out
+    SPI_Bus_Transfer(&Nokia5110_Device, &command, 0, 1);
 }
 
 void Nokia5110_Data_Write(uint8_t data)
 {
-    // Wait until UCA3TXBUF is empty
-    while((EUSCI_A3->IFG & 0x0002) == 0x0000);
+    Nokia5110_Data_Write_Buffer(&data, 1);
+}
 
-    // Set the Data/Command output pin to 1 to indicate that the transmitted byte is a data byte
+void Nokia5110_Data_Write_Buffer(const uint8_t *data, uint16_t length)
+{
+    // Set the Data/Command output pin to 1 to indicate that the transmitted bytes are data bytes
     Nokia5110_SPI_Data_Command_Bit_Out(0x01);
 
-    // Write the data byte to the transmit buffer
-    EUSCI_A3->TXBUF = data;
+    // Transmit the data bytes and wait until they have been shifted out
+    SPI_Bus_Transfer(&Nokia5110_Device, data, 0, length);
 }
 
-void Nokia5110_OutChar(char data)
+/**
+ * @brief Sends the seven columns of one character. SCE must be held and D/C set to data by the caller.
+ */
+static void Nokia5110_Draw_Character(char data)
 {
-    // Blank vertical line padding
-    Nokia5110_Data_Write(0x00);
+    uint8_t columns[7];
+
+    // Characters without a glyph are drawn as spaces
+    if (((uint8_t)data < 0x20) || ((uint8_t)data > 0x7F))
+    {
+        data = ' ';
+    }
+
+    // Blank vertical line padding on both sides
+    columns[0] = 0x00;
     for(int i = 0; i < 5; i = i + 1)
     {
-        Nokia5110_Data_Write(ASCII[data - 0x20][i]);
+        columns[i + 1] = ASCII[data - 0x20][i];
     }
-    // Blank vertical line padding
-    Nokia5110_Data_Write(0x00);
+    columns[6] = 0x00;
+
+    SPI_Bus_Transfer_Hold(&Nokia5110_Device, columns, 0, 7);
+
+    Cursor_Column = Cursor_Column + 1;
+    if (Cursor_Column >= NOKIA5110_CHARACTERS_PER_ROW)
+    {
+        Cursor_Column = 0;
+    }
+}
+
+void Nokia5110_OutChar(char data)
+{
+    Nokia5110_SPI_Data_Command_Bit_Out(0x01);
+    Nokia5110_Draw_Character(data);
+    SPI_Bus_Release(&Nokia5110_Device);
 }
 
 void Nokia5110_OutString(char *ptr)
 {
+    // Keep SCE low for the whole string. D/C stays high because only data bytes are sent.
+    Nokia5110_SPI_Data_Command_Bit_Out(0x01);
     while(*ptr)
     {
-        Nokia5110_OutChar((unsigned char)*ptr);
+        Nokia5110_Draw_Character(*ptr);
         ptr = ptr + 1;
     }
+    SPI_Bus_Release(&Nokia5110_Device);
 }
 
-void Nokia5110_OutUDec(uint16_t n)
+static uint32_t Nokia5110_Sink_Write(Stream *stream, const char *data, uint32_t length)
 {
-    if (n < 10)
-    {
-        Nokia5110_OutString("    ");
-        Nokia5110_OutChar(n + '0'); /* n is between 0 and 9 */
-    }
-    else if (n < 100)
-    {
-        Nokia5110_OutString("   ");
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
-    }
-    else if (n < 1000)
-    {
-        Nokia5110_OutString("  ");
-        Nokia5110_OutChar(n/100 + '0'); /* hundreds digit */
-        n = n%100;
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
-    }
-    else if (n < 10000)
-    {
-        Nokia5110_OutChar(' ');
-        Nokia5110_OutChar(n/1000 + '0'); /* thousands digit */
-        n = n%1000;
-        Nokia5110_OutChar(n/100 + '0'); /* hundreds digit */
-        n = n%100;
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
-    }
-    else
+    uint32_t i;
+
+    Nokia5110_SPI_Data_Command_Bit_Out(0x01);
+    for (i = 0; i < length; i++)
     {
-        Nokia5110_OutChar(n/10000 + '0'); /* ten-thousands digit */
-        n = n%10000;
-        Nokia5110_OutChar(n/1000 + '0'); /* thousands digit */
-        n = n%1000;
-        Nokia5110_OutChar(n/100 + '0'); /* hundreds digit */
-        n = n%100;
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
+        if (data[i] == '\n')
+        {
+            // Blank the rest of the row. The display wraps to the next row by itself, and a row that has
+            // just been filled (column 0) already ends at the next row.
+            while (Cursor_Column != 0)
+            {
+                Nokia5110_Draw_Character(' ');
+            }
+        }
+        else
+        {
+            Nokia5110_Draw_Character(data[i]);
+        }
     }
+    SPI_Bus_Release(&Nokia5110_Device);
+
+    return length;
+}
+
+static const Stream_Interface Nokia5110_Sink_Interface = {Nokia5110_Sink_Write, 0, 0, 0};
+
+static Stream Nokia5110_Sink = {&Nokia5110_Sink_Interface};
+
+Stream *Nokia5110_Get_Stream()
+{
+    return &Nokia5110_Sink;
+}
+
+void Nokia5110_OutUDec(uint16_t n)
+{
+    Stream_Put_UDec(&Nokia5110_Sink, n, 5);
 }
 
 void Nokia5110_OutSDec(int16_t n)
 {
-  char sign=' ';
-  if(n<0){
-    sign = '-';
-    n =  -n; // positive now
-  }
-  if(n < 10){
-    Nokia5110_OutString("    ");
-    Nokia5110_OutChar(sign);
-    Nokia5110_OutChar(n+'0'); /* n is between 0 and 9 */
-  } else if(n<100){
-    Nokia5110_OutString("   ");
-    Nokia5110_OutChar(sign);
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  } else if(n<1000){
-    Nokia5110_OutString("  ");
-    Nokia5110_OutChar(sign);
-    Nokia5110_OutChar(n/100+'0'); /* hundreds digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }
-  else if(n<10000){
-    Nokia5110_OutChar(' ');
-    Nokia5110_OutChar(sign);
-    Nokia5110_OutChar(n/1000+'0'); /* thousands digit */
-    n = n%1000;
-    Nokia5110_OutChar(n/100+'0'); /* hundreds digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }
-  else {
-    Nokia5110_OutChar(sign);
-    Nokia5110_OutChar(n/10000+'0'); /* ten-thousands digit */
-    n = n%10000;
-    Nokia5110_OutChar(n/1000+'0'); /* thousands digit */
-    n = n%1000;
-    Nokia5110_OutChar(n/100+'0'); /* hundreds digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* tens digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }
+    Stream_Put_SDec(&Nokia5110_Sink, n, 6);
 }
 
 void Nokia5110_OutUFix1(uint16_t n)
 {
-  char message[5];
-  if(n>999)n=999;
-  if(n>=100){  // 100 to 999
-    message[0] = (n/100+'0'); /* tens digit */
-    n = n%100; //the rest
-  }else { // 0 to 99
-    message[0] = ' '; /* n is between 0.0 and 9.9 */
-  }
-  message[1] = (n/10+'0'); /* ones digit */
-  n = n%10; //the rest
-  message[2] = '.';
-  message[3] = (n+'0'); /* tenths digit */
-  message[4] = 0;
-  Nokia5110_OutString(message);
+    if (n > 999)
+    {
+        n = 999;
+    }
+    Stream_Put_UFix(&Nokia5110_Sink, n, 1, 4);
 }
 
 void Nokia5110_OutSFix1(int32_t n)
@@ -468,22 +409,7 @@ void Nokia5110_OutUHex7(uint8_t n)
 
 void Nokia5110_OutUDec16(uint32_t n)
 {
-  Nokia5110_OutChar(' ');
-  if(n>=100){
-    Nokia5110_OutChar(n/100+'0'); /* 100 digit */
-    n = n%100;
-    Nokia5110_OutChar(n/10+'0'); /* 10 digit */
-    Nokia5110_OutChar(n%10+'0'); /* ones digit */
-  }else{
-    Nokia5110_OutChar(' ');
-    if(n>=10){
-      Nokia5110_OutChar(n/10+'0'); /* 10 digit */
-      Nokia5110_OutChar(n%10+'0'); /* ones digit */
-    }else{
-      Nokia5110_OutChar(' ');
-      Nokia5110_OutChar(n+'0'); /* ones digit */
-    }
-  }
+    Stream_Put_UDec(&Nokia5110_Sink, n, 4);
 }
 
 void Nokia5110_OutUDec2(uint32_t n)
@@ -510,31 +436,53 @@ void Nokia5110_SetCursor(uint8_t newX, uint8_t newY)
         return;
     }
     // Multiply newX by 7 because each character is 7 columns wide
+    Nokia5110_Write_Burst(newX*7, newY, 0, 0);
+    Cursor_Column = newX;
+}
+
+void Nokia5110_Write_Burst(uint8_t column, uint8_t bank, const uint8_t *data, uint16_t length)
+{
+    uint8_t commands[2];
 
-    // Setting bit 7 updates X-position
-    Nokia5110_Command_Write(0x80 | (newX*7));
+    // Setting bit 7 updates X-position, setting bit 6 updates Y-position
+    commands[0] = 0x80 | column;
+    commands[1] = 0x40 | bank;
 
-    // Setting bit 6 updates Y-position
-    Nokia5110_Command_Write(0x40 | newY);
+    TRACE_TASK_BEGIN(TRACE_ID_NOKIA5110);
+
+    // Both commands are sent back to back with SCE held low. The transfer returns after the last bit
+    // has been shifted out, so D/C can be changed for the data run without releasing SCE.
+    Nokia5110_SPI_Data_Command_Bit_Out(0x00);
+    SPI_Bus_Transfer_Hold(&Nokia5110_Device, commands, 0, 2);
+
+    if (length > 0)
+    {
+        Nokia5110_SPI_Data_Command_Bit_Out(0x01);
+        SPI_Bus_Transfer_Hold(&Nokia5110_Device, data, 0, length);
+    }
+
+    SPI_Bus_Release(&Nokia5110_Device);
+
+    TRACE_TASK_END(TRACE_ID_NOKIA5110);
 }
 
 void Nokia5110_Clear()
 {
-    for (int i = 0; i < (MAX_X*MAX_Y/8); i = i + 1)
+    static const uint8_t blank_row[MAX_X] = {0};
+
+    for (int i = 0; i < (MAX_Y/8); i = i + 1)
     {
-        Nokia5110_Data_Write(0x00);
+        Nokia5110_Data_Write_Buffer(blank_row, MAX_X);
     }
     Nokia5110_SetCursor(0, 0);
 }
 
 void Nokia5110_DrawFullImage(const uint8_t *ptr)
 {
-    Nokia5110_SetCursor(0, 0);
-    for (int i = 0; i < (MAX_X*MAX_Y/8); i = i + 1)
-    {
-        Nokia5110_Data_Write(ptr[i]);
-    }
+    Nokia5110_Write_Burst(0, 0, ptr, MAX_X*MAX_Y/8);
 }
+// Aligned to a word so that Memory_Block_Fill clears it with word stores only
+#pragma DATA_ALIGN(Screen, 4)
 uint8_t Screen[SCREENW*SCREENH/8]; // buffer stores the next image to be printed on the screen
 
 void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t threshold){
@@ -595,11 +543,7 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
 
 void Nokia5110_ClearBuffer()
 {
-    int i;
-    for(i=0; i<SCREENW*SCREENH/8; i=i+1)
-    {
-        Screen[i] = 0;              // clear buffer
-    }
+    Memory_Block_Fill(Screen, 0, sizeof(Screen));
 }
 
 void Nokia5110_DisplayBuffer()
@@ -618,3 +562,63 @@ void Nokia5110_SetPxl(uint32_t i, uint32_t j)
 {
   Screen[84*(i>>3) + j] |= Masks[i&0x07];
 }
+
+// Transaction of the Nokia5110 coroutines: one of them runs at a time
+static SPI_Bus_Transaction Async_Transaction;
+
+/**
+ * @brief Submits the transaction of the Nokia5110 coroutines. D/C must be set by the caller.
+ */
+static void Nokia5110_Submit_Async(const uint8_t *data, uint16_t length, uint8_t flags)
+{
+    Async_Transaction.device = &Nokia5110_Device;
+    Async_Transaction.tx = data;
+    Async_Transaction.rx = 0;
+    Async_Transaction.length = length;
+    Async_Transaction.flags = flags;
+    Async_Transaction.callback = 0;
+    Async_Transaction.context = 0;
+    SPI_Bus_Submit(&Async_Transaction);
+}
+
+uint8_t Nokia5110_Init_Async(Coroutine *co)
+{
+    // Same commands as Nokia5110_Config, sent in one transaction
+    static const uint8_t config_commands[6] = {0x21, CONTRAST, 0x04, 0x14, 0x20, 0x0C};
+
+    COROUTINE_BEGIN(co);
+
+    Nokia5110_SPI_Init();
+
+    // Active Low Reset
+    Nokia5110_SPI_Reset_Bit_Out(0);
+    COROUTINE_DELAY(co, 2);
+    Nokia5110_SPI_Reset_Bit_Out(1);
+
+    Nokia5110_SPI_Data_Command_Bit_Out(0x00);
+    Nokia5110_Submit_Async(config_commands, sizeof(config_commands), 0);
+    COROUTINE_AWAIT_SPI(co, &Async_Transaction);
+
+    COROUTINE_END(co);
+}
+
+uint8_t Nokia5110_DisplayBuffer_Async(Coroutine *co)
+{
+    // Cursor to column 0 and bank 0
+    static const uint8_t home_commands[2] = {0x80, 0x40};
+
+    COROUTINE_BEGIN(co);
+
+    // Same burst as Nokia5110_Write_Burst: D/C is changed while SCE is held, after the commands are shifted out
+    Nokia5110_SPI_Data_Command_Bit_Out(0x00);
+    Nokia5110_Submit_Async(home_commands, sizeof(home_commands), SPI_BUS_KEEP_CS);
+    COROUTINE_AWAIT_SPI(co, &Async_Transaction);
+
+    Nokia5110_SPI_Data_Command_Bit_Out(0x01);
+    Nokia5110_Submit_Async(Screen, sizeof(Screen), 0);
+    COROUTINE_AWAIT_SPI(co, &Async_Transaction);
+
+    Cursor_Column = 0;
+
+    COROUTINE_END(co);
+}
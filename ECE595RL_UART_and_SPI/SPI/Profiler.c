@@ -0,0 +1,216 @@
+/**
+ * @file Profiler.c
+ * @brief Source code for the Profiler driver.
+ *
+ * This file contains the function definitions for the Profiler driver.
+ * T32_INT1_IRQHandler is in Profiler_Handler.asm: it finds the stack frame that the CPU pushed on entry (on MSP
+ * or PSP, as told by bit 2 of EXC_RETURN in LR) and passes the stacked PC (offset 24) and LR (offset 20) to
+ * Profiler_Record. It is written in assembly because the stack frame is only at a known offset from SP before
+ * anything is pushed, which a C function cannot guarantee.
+ *
+ * For more information regarding Timer32,
+ * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Profiler.h"
+#include "../inc/CRC16.h"
+
+// Timer32 module 1 interrupt (T32_INT1): interrupt 25 in NVIC
+#define PROFILER_IRQ    25
+
+// The bucket indexes are sent as 16-bit values, and 0xFFFF ends a histogram
+typedef char Profiler_Num_Buckets_Fits_16_Bits[(PROFILER_NUM_BUCKETS < 0xFFFF) ? 1 : -1];
+
+static uint16_t PC_Histogram[PROFILER_NUM_BUCKETS];
+#ifdef PROFILER_SAMPLE_LR
+static uint16_t LR_Histogram[PROFILER_NUM_BUCKETS];
+#endif
+
+static uint32_t Sample_Rate;
+static uint32_t Samples;
+static uint32_t Outside_Samples;
+static uint8_t Saturated;
+
+void Profiler_Record(uint32_t pc, uint32_t lr);
+
+/**
+ * @brief Counts one sample. Called by T32_INT1_IRQHandler (Profiler_Handler.asm), which jumps to it with EXC_RETURN
+ *        still in LR, so the return from this function is the return from the interrupt.
+ */
+void Profiler_Record(uint32_t pc, uint32_t lr)
+{
+    uint32_t offset = pc - PROFILER_CODE_START;
+
+    // Any write clears the interrupt
+    TIMER32_1->INTCLR = 0;
+
+    Samples++;
+    if (offset < PROFILER_CODE_SIZE)
+    {
+        if (++PC_Histogram[offset >> PROFILER_BUCKET_SHIFT] == 0xFFFF)
+        {
+            Saturated = 1;
+        }
+    }
+    else
+    {
+        Outside_Samples++;
+    }
+
+#ifdef PROFILER_SAMPLE_LR
+    // Bit 0 of LR is the Thumb bit. An EXC_RETURN value (interrupted handler) is outside of the range.
+    offset = (lr & ~1) - PROFILER_CODE_START;
+    if (offset < PROFILER_CODE_SIZE)
+    {
+        if (++LR_Histogram[offset >> PROFILER_BUCKET_SHIFT] == 0xFFFF)
+        {
+            Saturated = 1;
+        }
+    }
+#else
+    (void)lr;
+#endif
+
+    if (Saturated)
+    {
+        TIMER32_1->CONTROL &= ~TIMER32_CONTROL_ENABLE;
+    }
+}
+
+int Profiler_Init(uint32_t sample_rate)
+{
+    if ((sample_rate == 0) || (sample_rate > PROFILER_MAX_SAMPLE_RATE))
+    {
+        return PROFILER_ERROR_RATE;
+    }
+
+    Sample_Rate = sample_rate;
+
+    // Stopped, 32-bit, periodic mode, no prescaler, interrupt enabled
+    TIMER32_1->CONTROL = 0;
+    TIMER32_1->LOAD = (PROFILER_CPU_FREQUENCY / sample_rate) - 1;
+    TIMER32_1->INTCLR = 0;
+    TIMER32_1->CONTROL = TIMER32_CONTROL_SIZE | TIMER32_CONTROL_MODE | TIMER32_CONTROL_IE;
+
+    Profiler_Clear();
+
+    // Set the priority of the interrupt and enable it in the NVIC
+    NVIC->IP[PROFILER_IRQ] = (INTERRUPT_PRIORITY_PROFILER << 5);
+    NVIC->ISER[0] = (1 << PROFILER_IRQ);
+
+    return 0;
+}
+
+void Profiler_Start()
+{
+    if (!Saturated)
+    {
+        TIMER32_1->CONTROL |= TIMER32_CONTROL_ENABLE;
+    }
+}
+
+void Profiler_Stop()
+{
+    // The interrupt has a higher priority than the caller, so it is not in progress here.
+    // A sample that is already pending is dropped.
+    TIMER32_1->CONTROL &= ~TIMER32_CONTROL_ENABLE;
+    TIMER32_1->INTCLR = 0;
+    NVIC->ICPR[0] = (1 << PROFILER_IRQ);
+}
+
+void Profiler_Clear()
+{
+    uint32_t i;
+
+    for (i = 0; i < PROFILER_NUM_BUCKETS; i++)
+    {
+        PC_Histogram[i] = 0;
+#ifdef PROFILER_SAMPLE_LR
+        LR_Histogram[i] = 0;
+#endif
+    }
+
+    Samples = 0;
+    Outside_Samples = 0;
+    Saturated = 0;
+}
+
+static uint16_t Out_U16_CRC(Stream *stream, uint16_t value, uint16_t crc)
+{
+    Stream_Put_U16_LE(stream, value);
+    crc = CRC16_Update(crc, value & 0xFF);
+    return CRC16_Update(crc, value >> 8);
+}
+
+/**
+ * @brief Sends the buckets of a histogram that are not zero, then the end marker. Returns the number of bytes sent.
+ */
+static uint32_t Stream_Histogram(Stream *stream, const uint16_t *histogram, uint16_t *crc)
+{
+    uint32_t bytes = 2;
+    uint16_t i;
+
+    for (i = 0; i < PROFILER_NUM_BUCKETS; i++)
+    {
+        if (histogram[i])
+        {
+            *crc = Out_U16_CRC(stream, i, *crc);
+            *crc = Out_U16_CRC(stream, histogram[i], *crc);
+            bytes += 4;
+        }
+    }
+    *crc = Out_U16_CRC(stream, 0xFFFF, *crc);
+
+    return bytes;
+}
+
+uint32_t Profiler_Stream()
+{
+    uint32_t bytes = 25;
+    uint16_t crc = CRC16_INITIAL_VALUE;
+    Stream *stream = EUSCI_A_UART_Get_Stream(EUSCI_A0_UART_PORT);
+    uint8_t flags = Saturated ? PROFILER_FLAG_SATURATED : 0;
+
+#ifdef PROFILER_SAMPLE_LR
+    flags |= PROFILER_FLAG_LR;
+#endif
+
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, 'P');
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, 'F');
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, PROFILER_STREAM_VERSION);
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, PROFILER_BUCKET_SHIFT);
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, flags);
+    Stream_Put_U32_LE(stream, PROFILER_CODE_START);
+    Stream_Put_U32_LE(stream, PROFILER_NUM_BUCKETS);
+    Stream_Put_U32_LE(stream, Sample_Rate);
+    Stream_Put_U32_LE(stream, Samples);
+    Stream_Put_U32_LE(stream, Outside_Samples);
+
+    bytes += Stream_Histogram(stream, PC_Histogram, &crc);
+#ifdef PROFILER_SAMPLE_LR
+    bytes += Stream_Histogram(stream, LR_Histogram, &crc);
+#endif
+
+    Stream_Put_U16_LE(stream, crc);
+
+    return bytes + 2;
+}
+
+uint8_t Profiler_Poll()
+{
+    if ((EUSCI_A_UART_RX_Available(EUSCI_A0_UART_PORT) == 0)
+        || (EUSCI_A_UART_InChar(EUSCI_A0_UART_PORT) != PROFILER_CMD_READ))
+    {
+        return 0;
+    }
+
+    Profiler_Stop();
+    Profiler_Stream();
+    Profiler_Clear();
+    Profiler_Start();
+
+    return 1;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file SD_Card.c
+ * @brief Source code for the SD_Card driver.
+ *
+ * This file contains the function definitions for the SD_Card driver.
+ * It implements the SPI mode protocol of SD cards on top of the SPI_Bus driver:
+ *  - Every command starts a new chip-select cycle, and the command, its response and its data blocks
+ *    are sent with the chip-select held (SPI_Bus_Transfer_Hold)
+ *  - After the chip-select is released, one more byte is clocked so that the card releases DO
+ *  - Timeouts are measured with the DWT cycle counter
+ *
+ * For more information regarding the SPI mode of SD cards, refer to the SD Specifications
+ * Part 1 Physical Layer Simplified Specification, Section 7 (SPI Mode)
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/SD_Card.h"
+
+// Commands (refer to Section 7.3.1.3 of the SD Physical Layer Simplified Specification)
+#define CMD0    0       // GO_IDLE_STATE
+#define CMD8    8       // SEND_IF_COND
+#define CMD9    9       // SEND_CSD
+#define CMD16   16      // SET_BLOCKLEN
+#define CMD17   17      // READ_SINGLE_BLOCK
+#define CMD24   24      // WRITE_BLOCK
+#define CMD25   25      // WRITE_MULTIPLE_BLOCK
+#define CMD55   55      // APP_CMD
+#define CMD58   58      // READ_OCR
+#define ACMD23  23      // SET_WR_BLK_ERASE_COUNT
+#define ACMD41  41      // SD_SEND_OP_COND
+
+// R1 response bits
+#define R1_IDLE             0x01
+#define R1_ILLEGAL_COMMAND  0x04
+
+// Data tokens
+#define TOKEN_START_BLOCK           0xFE    // CMD17 and CMD24
+#define TOKEN_START_MULTIPLE_BLOCK  0xFC    // CMD25
+#define TOKEN_STOP_TRAN             0xFD    // End of CMD25
+#define DATA_RESPONSE_MASK          0x1F
+#define DATA_RESPONSE_ACCEPTED      0x05
+
+// Timeouts in milliseconds
+#define INIT_TIMEOUT_MS     1000
+#define READ_TIMEOUT_MS     100
+#define WRITE_TIMEOUT_MS    500
+
+#define CYCLES_PER_MS       48000
+
+// The chip-select is set by SD_Card_Init
+static SPI_Bus_Device SD_Card_Device = {SPI_BUS_B0, 0, 0, SD_CARD_INIT_CLOCK_FREQUENCY, SPI_BUS_MODE_0};
+
+// Same bus settings without a chip-select, to clock the card while it is not selected
+static SPI_Bus_Device SD_Card_Idle_Device = {SPI_BUS_B0, 0, 0, SD_CARD_INIT_CLOCK_FREQUENCY, SPI_BUS_MODE_0};
+
+static uint32_t Block_Count;
+static uint8_t High_Capacity;   // 1 if the card uses block addresses (SDHC and SDXC), 0 if it uses byte addresses
+
+static uint8_t Receive_Byte()
+{
+    uint8_t data;
+
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, 0, &data, 1);
+
+    return data;
+}
+
+static void Deselect()
+{
+    static const uint8_t fill = 0xFF;
+
+    SPI_Bus_Release(&SD_Card_Device);
+    SPI_Bus_Transfer(&SD_Card_Idle_Device, &fill, 0, 1);
+}
+
+/**
+ * @brief Waits until the card stops holding DO low (busy).
+ */
+static int Wait_Ready(uint32_t timeout_ms)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    while(Receive_Byte() != 0xFF)
+    {
+        if ((DWT->CYCCNT - start) >= (timeout_ms * CYCLES_PER_MS))
+        {
+            return SD_CARD_ERROR_TIMEOUT;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Sends a command and returns its R1 response, leaving the chip-select asserted.
+ *        Only CMD0 and CMD8 need a valid CRC in SPI mode.
+ */
+static int Command(uint8_t index, uint32_t argument, uint8_t crc)
+{
+    uint8_t frame[6];
+    uint8_t response;
+    int i;
+
+    // Each command starts with a new chip-select cycle
+    Deselect();
+
+    if ((index != CMD0) && (Wait_Ready(WRITE_TIMEOUT_MS) < 0))
+    {
+        return SD_CARD_ERROR_TIMEOUT;
+    }
+
+    frame[0] = 0x40 | index;
+    frame[1] = (argument >> 24) & 0xFF;
+    frame[2] = (argument >> 16) & 0xFF;
+    frame[3] = (argument >> 8) & 0xFF;
+    frame[4] = argument & 0xFF;
+    frame[5] = crc | 0x01;
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, frame, 0, 6);
+
+    // The response follows within 8 bytes and starts with a 0 bit
+    for (i = 0; i < 8; i++)
+    {
+        response = Receive_Byte();
+        if ((response & 0x80) == 0)
+        {
+            return response;
+        }
+    }
+
+    return SD_CARD_ERROR_TIMEOUT;
+}
+
+static int App_Command(uint8_t index, uint32_t argument)
+{
+    int response = Command(CMD55, 0, 0);
+
+    if ((response < 0) || (response & ~R1_IDLE))
+    {
+        return (response < 0) ? response : SD_CARD_ERROR_COMMAND;
+    }
+
+    return Command(index, argument, 0);
+}
+
+/**
+ * @brief Waits for the start block token and receives a data block with its CRC (which is not checked).
+ */
+static int Receive_Data(uint8_t *data, uint16_t length)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint8_t crc[2];
+    uint8_t token;
+
+    while((token = Receive_Byte()) == 0xFF)
+    {
+        if ((DWT->CYCCNT - start) >= (READ_TIMEOUT_MS * CYCLES_PER_MS))
+        {
+            return SD_CARD_ERROR_TIMEOUT;
+        }
+    }
+
+    if (token != TOKEN_START_BLOCK)
+    {
+        return SD_CARD_ERROR_READ;
+    }
+
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, 0, data, length);
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, 0, crc, 2);
+
+    return 0;
+}
+
+/**
+ * @brief Sends one data block with a dummy CRC and checks the data response.
+ */
+static int Send_Data(uint8_t token, const uint8_t *data)
+{
+    static const uint8_t crc[2] = {0xFF, 0xFF};
+    uint8_t start[2];
+
+    // One byte gap before the token
+    start[0] = 0xFF;
+    start[1] = token;
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, start, 0, 2);
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, data, 0, SD_CARD_BLOCK_SIZE);
+    SPI_Bus_Transfer_Hold(&SD_Card_Device, crc, 0, 2);
+
+    if ((Receive_Byte() & DATA_RESPONSE_MASK) != DATA_RESPONSE_ACCEPTED)
+    {
+        return SD_CARD_ERROR_WRITE;
+    }
+
+    return Wait_Ready(WRITE_TIMEOUT_MS);
+}
+
+static void Set_Clock_Frequency(uint32_t clock_frequency)
+{
+    SD_Card_Device.clock_frequency = clock_frequency;
+    SD_Card_Idle_Device.clock_frequency = clock_frequency;
+    SPI_Bus_Update_Device(&SD_Card_Device);
+    SPI_Bus_Update_Device(&SD_Card_Idle_Device);
+}
+
+/**
+ * @brief Reads the CSD register and computes the number of blocks.
+ */
+static int Read_Capacity()
+{
+    uint8_t csd[16];
+    uint32_t c_size;
+    uint8_t shift;
+    int result;
+
+    result = Command(CMD9, 0, 0);
+    if (result != 0)
+    {
+        return (result < 0) ? result : SD_CARD_ERROR_COMMAND;
+    }
+
+    result = Receive_Data(csd, 16);
+    if (result < 0)
+    {
+        return result;
+    }
+
+    if ((csd[0] >> 6) == 1)
+    {
+        // CSD version 2.0: capacity = (C_SIZE + 1) * 512 KB
+        c_size = ((uint32_t)(csd[7] & 0x3F) << 16) | ((uint32_t)csd[8] << 8) | csd[9];
+        Block_Count = (c_size + 1) << 10;
+    }
+    else
+    {
+        // CSD version 1.0: capacity = (C_SIZE + 1) * 2^(C_SIZE_MULT + 2) * 2^READ_BL_LEN
+        c_size = ((uint32_t)(csd[6] & 0x03) << 10) | ((uint32_t)csd[7] << 2) | (csd[8] >> 6);
+        shift = (((csd[9] & 0x03) << 1) | (csd[10] >> 7)) + 2 + (csd[5] & 0x0F) - 9;
+        Block_Count = (c_size + 1) << shift;
+    }
+
+    return 0;
+}
+
+static int Initialize()
+{
+    static const uint8_t fill[10] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint8_t ocr[4];
+    uint8_t version_2 = 0;
+    uint32_t start;
+    int response;
+    int i;
+
+    // At least 74 clock cycles with the chip-select high after power up
+    Clock_Delay1ms(1);
+    SPI_Bus_Transfer(&SD_Card_Idle_Device, fill, 0, sizeof(fill));
+
+    // CMD0 with the chip-select low switches the card to SPI mode
+    for (i = 0; i < 10; i++)
+    {
+        response = Command(CMD0, 0, 0x95);
+        if (response == R1_IDLE)
+        {
+            break;
+        }
+    }
+    if (response != R1_IDLE)
+    {
+        return SD_CARD_ERROR_NO_CARD;
+    }
+
+    // CMD8 is only accepted by cards that comply with version 2.00 or later of the specification
+    response = Command(CMD8, 0x000001AA, 0x87);
+    if (response < 0)
+    {
+        return response;
+    }
+    if ((response & R1_ILLEGAL_COMMAND) == 0)
+    {
+        SPI_Bus_Transfer_Hold(&SD_Card_Device, 0, ocr, 4);
+        if (((ocr[2] & 0x0F) != 0x01) || (ocr[3] != 0xAA))
+        {
+            return SD_CARD_ERROR_VOLTAGE;
+        }
+        version_2 = 1;
+    }
+
+    // ACMD41 starts the initialization, with HCS set if the host supports high capacity cards
+    start = DWT->CYCCNT;
+    do
+    {
+        response = App_Command(ACMD41, version_2 ? 0x40000000 : 0);
+        if (response < 0)
+        {
+            return response;
+        }
+        if ((DWT->CYCCNT - start) >= (INIT_TIMEOUT_MS * CYCLES_PER_MS))
+        {
+            return SD_CARD_ERROR_TIMEOUT;
+        }
+    } while(response == R1_IDLE);
+
+    if (response != 0)
+    {
+        return SD_CARD_ERROR_COMMAND;
+    }
+
+    // The CCS bit of the OCR tells whether the card uses block addresses
+    High_Capacity = 0;
+    if (version_2)
+    {
+        if (Command(CMD58, 0, 0) != 0)
+        {
+            return SD_CARD_ERROR_COMMAND;
+        }
+        SPI_Bus_Transfer_Hold(&SD_Card_Device, 0, ocr, 4);
+        High_Capacity = (ocr[0] & 0x40) ? 1 : 0;
+    }
+
+    if (!High_Capacity && (Command(CMD16, SD_CARD_BLOCK_SIZE, 0) != 0))
+    {
+        return SD_CARD_ERROR_COMMAND;
+    }
+
+    Set_Clock_Frequency(SD_CARD_CLOCK_FREQUENCY);
+
+    return Read_Capacity();
+}
+
+int SD_Card_Init(uint8_t cs_port, uint8_t cs_bit)
+{
+    int result;
+
+    // Enable the DWT cycle counter used for the timeouts
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Block_Count = 0;
+    SD_Card_Device.cs_port = cs_port;
+    SD_Card_Device.cs_bit = cs_bit;
+    Set_Clock_Frequency(SD_CARD_INIT_CLOCK_FREQUENCY);
+    SPI_Bus_Add_Device(&SD_Card_Device);
+
+    result = Initialize();
+    Deselect();
+
+    if (result < 0)
+    {
+        Block_Count = 0;
+    }
+
+    return result;
+}
+
+uint32_t SD_Card_Get_Block_Count()
+{
+    return Block_Count;
+}
+
+int SD_Card_Read_Block(uint32_t block, uint8_t *data)
+{
+    int result;
+
+    if (Block_Count == 0)
+    {
+        return SD_CARD_ERROR_NOT_READY;
+    }
+
+    if (block >= Block_Count)
+    {
+        return SD_CARD_ERROR_RANGE;
+    }
+
+    result = Command(CMD17, High_Capacity ? block : (block * SD_CARD_BLOCK_SIZE), 0);
+    if (result == 0)
+    {
+        result = Receive_Data(data, SD_CARD_BLOCK_SIZE);
+    }
+    else if (result > 0)
+    {
+        result = SD_CARD_ERROR_COMMAND;
+    }
+
+    Deselect();
+
+    return result;
+}
+
+int SD_Card_Write_Blocks(uint32_t block, const uint8_t *data, uint16_t count)
+{
+    // The card starts the busy signal one byte after the stop token
+    static const uint8_t stop[2] = {TOKEN_STOP_TRAN, 0xFF};
+    uint32_t address = High_Capacity ? block : (block * SD_CARD_BLOCK_SIZE);
+    int result;
+    int error;
+
+    if (Block_Count == 0)
+    {
+        return SD_CARD_ERROR_NOT_READY;
+    }
+
+    if ((count == 0) || (block >= Block_Count) || (count > (Block_Count - block)))
+    {
+        return SD_CARD_ERROR_RANGE;
+    }
+
+    if (count == 1)
+    {
+        result = Command(CMD24, address, 0);
+        if (result == 0)
+        {
+            result = Send_Data(TOKEN_START_BLOCK, data);
+        }
+    }
+    else
+    {
+        // Tell the card how many blocks follow so that it can pre-erase them (optional, errors are ignored)
+        App_Command(ACMD23, count);
+
+        result = Command(CMD25, address, 0);
+        if (result == 0)
+        {
+            while(count--)
+            {
+                result = Send_Data(TOKEN_START_MULTIPLE_BLOCK, data);
+                if (result < 0)
+                {
+                    break;
+                }
+                data += SD_CARD_BLOCK_SIZE;
+            }
+
+            // The stop token ends the transfer also after an error
+            SPI_Bus_Transfer_Hold(&SD_Card_Device, stop, 0, 2);
+            error = Wait_Ready(WRITE_TIMEOUT_MS);
+            if (result == 0)
+            {
+                result = error;
+            }
+        }
+    }
+
+    if (result > 0)
+    {
+        result = SD_CARD_ERROR_COMMAND;
+    }
+
+    Deselect();
+
+    return result;
+}
@@ -0,0 +1,383 @@
+/**
+ * @file SPI_Bus.c
+ * @brief Source code for the SPI_Bus driver.
+ *
+ * This file contains the function definitions for the SPI_Bus driver.
+ * It queues transactions for several devices per eUSCI module, drives the chip-select of each device
+ * and reloads the clock frequency and mode only when the device changes.
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
+ * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/SPI_Bus.h"
+#include "../inc/Critical_Section.h"
+
+/**
+ * @brief Registers of one GPIO port used for chip-select pins.
+ */
+typedef struct
+{
+    volatile uint8_t *out;
+    volatile uint8_t *dir;
+    volatile uint8_t *sel0;
+    volatile uint8_t *sel1;
+} SPI_Bus_CS_Port_Map;
+
+static const SPI_Bus_CS_Port_Map CS_Port_Map[10] = {
+    // OUT          DIR             SEL0            SEL1
+    {&P1->OUT,      &P1->DIR,       &P1->SEL0,      &P1->SEL1},
+    {&P2->OUT,      &P2->DIR,       &P2->SEL0,      &P2->SEL1},
+    {&P3->OUT,      &P3->DIR,       &P3->SEL0,      &P3->SEL1},
+    {&P4->OUT,      &P4->DIR,       &P4->SEL0,      &P4->SEL1},
+    {&P5->OUT,      &P5->DIR,       &P5->SEL0,      &P5->SEL1},
+    {&P6->OUT,      &P6->DIR,       &P6->SEL0,      &P6->SEL1},
+    {&P7->OUT,      &P7->DIR,       &P7->SEL0,      &P7->SEL1},
+    {&P8->OUT,      &P8->DIR,       &P8->SEL0,      &P8->SEL1},
+    {&P9->OUT,      &P9->DIR,       &P9->SEL0,      &P9->SEL1},
+    {&P10->OUT,     &P10->DIR,      &P10->SEL0,     &P10->SEL1}
+};
+
+/**
+ * @brief State of one bus.
+ */
+typedef struct
+{
+    SPI_Bus_Transaction *head;          // Queue of transactions that have not been started
+    SPI_Bus_Transaction *tail;
+    SPI_Bus_Transaction *active;        // Transaction in progress
+    const SPI_Bus_Device *configured;   // Device whose clock frequency and mode are loaded in the eUSCI module
+    const SPI_Bus_Device *owner;        // Device that keeps its chip-select asserted (SPI_BUS_KEEP_CS)
+    SPI_Bus_Stats stats;
+} SPI_Bus_State;
+
+static SPI_Bus_State Bus_State[SPI_BUS_NUM_BUSES];
+
+static void CS_Assert(const SPI_Bus_Device *device)
+{
+    if (device->cs_bit)
+    {
+        *CS_Port_Map[device->cs_port - 1].out &= ~device->cs_bit;
+    }
+}
+
+static void CS_Deassert(const SPI_Bus_Device *device)
+{
+    if (device->cs_bit)
+    {
+        *CS_Port_Map[device->cs_port - 1].out |= device->cs_bit;
+    }
+}
+
+/**
+ * @brief Removes the next transaction to start from the queue. While a device owns the bus,
+ *        only its own transactions are eligible. Must be called with interrupts disabled.
+ */
+static SPI_Bus_Transaction *Dequeue(SPI_Bus_State *state)
+{
+    SPI_Bus_Transaction *previous = 0;
+    SPI_Bus_Transaction *transaction = state->head;
+
+    if (state->owner)
+    {
+        while(transaction && (transaction->device != state->owner))
+        {
+            previous = transaction;
+            transaction = transaction->next;
+        }
+    }
+
+    if (transaction)
+    {
+        if (previous)
+        {
+            previous->next = transaction->next;
+        }
+        else
+        {
+            state->head = transaction->next;
+        }
+
+        if (state->tail == transaction)
+        {
+            state->tail = previous;
+        }
+    }
+
+    return transaction;
+}
+
+static void Complete(SPI_Bus_State *state, SPI_Bus_Transaction *transaction)
+{
+    if (transaction->flags & SPI_BUS_KEEP_CS)
+    {
+        state->owner = transaction->device;
+    }
+    else
+    {
+        CS_Deassert(transaction->device);
+        state->owner = 0;
+    }
+
+    state->stats.transactions++;
+    state->stats.bytes += transaction->length;
+    state->active = 0;
+    transaction->status = SPI_BUS_DONE;
+
+    if (transaction->callback)
+    {
+        transaction->callback(transaction);
+    }
+}
+
+/**
+ * @brief Starts queued transactions until the queue is empty or one is running in the background.
+ */
+static void Run(uint8_t bus)
+{
+    SPI_Bus_State *state = &Bus_State[bus];
+    SPI_Bus_Transaction *transaction;
+    const SPI_Bus_Device *device;
+    uint32_t section;
+
+    while(1)
+    {
+        section = Critical_Section_Enter();
+        if (state->active)
+        {
+            // Another caller is running the queue
+            transaction = 0;
+        }
+        else
+        {
+            transaction = Dequeue(state);
+            state->active = transaction;
+        }
+        Critical_Section_Exit(section);
+
+        if (transaction == 0)
+        {
+            return;
+        }
+
+        device = transaction->device;
+        if (state->configured != device)
+        {
+            if (bus == SPI_BUS_A3)
+            {
+                EUSCI_A3_SPI_Configure(device->clock_frequency, device->mode);
+            }
+            else
+            {
+                EUSCI_B0_SPI_Configure(device->clock_frequency, device->mode);
+            }
+            state->configured = device;
+            state->stats.reconfigurations++;
+        }
+
+        CS_Assert(device);
+
+        if ((bus == SPI_BUS_B0) && (transaction->length > 0))
+        {
+            // Long transfers use DMA. Short ones use the interrupt handler, which needs less setup.
+            if ((transaction->length >= SPI_BUS_DMA_THRESHOLD) && (transaction->length <= EUSCI_B0_SPI_DMA_MAX_LENGTH))
+            {
+                EUSCI_B0_SPI_Set_Backend(EUSCI_B0_SPI_DMA);
+            }
+            else
+            {
+                EUSCI_B0_SPI_Set_Backend(EUSCI_B0_SPI_IRQ);
+            }
+
+            // The next transaction is started by B0_Transfer_Complete.
+            // The interrupt handler is used if the DMA channels are taken by another driver.
+            if (EUSCI_B0_SPI_Transfer_Start(transaction->tx, transaction->rx, transaction->length) == EUSCI_B0_SPI_ERROR_DMA)
+            {
+                EUSCI_B0_SPI_Set_Backend(EUSCI_B0_SPI_IRQ);
+                EUSCI_B0_SPI_Transfer_Start(transaction->tx, transaction->rx, transaction->length);
+            }
+            return;
+        }
+
+        if (transaction->length > 0)
+        {
+            // The next transaction is started by A3_Transfer_Complete. The transfer is run by polling
+            // if it is too long for one DMA transfer, or if the DMA channels are taken by another driver.
+            if (EUSCI_A3_SPI_Write_Start(transaction->tx, transaction->length) == 0)
+            {
+                return;
+            }
+            EUSCI_A3_SPI_Write(transaction->tx, transaction->length);
+        }
+        Complete(state, transaction);
+    }
+}
+
+static void A3_Transfer_Complete(void)
+{
+    Complete(&Bus_State[SPI_BUS_A3], Bus_State[SPI_BUS_A3].active);
+    Run(SPI_BUS_A3);
+}
+
+static void B0_Transfer_Complete(void)
+{
+    Complete(&Bus_State[SPI_BUS_B0], Bus_State[SPI_BUS_B0].active);
+    Run(SPI_BUS_B0);
+}
+
+void SPI_Bus_Init(uint8_t bus)
+{
+    SPI_Bus_State *state = &Bus_State[bus];
+
+    state->head = 0;
+    state->tail = 0;
+    state->active = 0;
+    state->configured = 0;
+    state->owner = 0;
+    state->stats.transactions = 0;
+    state->stats.bytes = 0;
+    state->stats.reconfigurations = 0;
+
+    if (bus == SPI_BUS_A3)
+    {
+        EUSCI_A3_SPI_Configure(1000000, SPI_BUS_MODE_0);
+        EUSCI_A3_SPI_Set_Callback(A3_Transfer_Complete);
+    }
+    else
+    {
+        EUSCI_B0_SPI_Init(1000000, SPI_BUS_MODE_0);
+        EUSCI_B0_SPI_Set_Backend(EUSCI_B0_SPI_IRQ);
+        EUSCI_B0_SPI_Set_Callback(B0_Transfer_Complete);
+    }
+}
+
+void SPI_Bus_Add_Device(const SPI_Bus_Device *device)
+{
+    const SPI_Bus_CS_Port_Map *port;
+
+    if (device->cs_bit == 0)
+    {
+        return;
+    }
+
+    port = &CS_Port_Map[device->cs_port - 1];
+
+    *port->out |= device->cs_bit;
+    *port->sel0 &= ~device->cs_bit;
+    *port->sel1 &= ~device->cs_bit;
+    *port->dir |= device->cs_bit;
+}
+
+void SPI_Bus_Update_Device(const SPI_Bus_Device *device)
+{
+    uint32_t section = Critical_Section_Enter();
+    if (Bus_State[device->bus].configured == device)
+    {
+        Bus_State[device->bus].configured = 0;
+    }
+    Critical_Section_Exit(section);
+}
+
+int SPI_Bus_Submit(SPI_Bus_Transaction *transaction)
+{
+    const SPI_Bus_Device *device = transaction->device;
+    SPI_Bus_State *state;
+    uint32_t section;
+
+    if (device->bus >= SPI_BUS_NUM_BUSES)
+    {
+        return SPI_BUS_ERROR_BUS;
+    }
+
+    // EUSCI_A3 has no MISO pin and no fill byte, so it can only transmit a buffer
+    if ((device->bus == SPI_BUS_A3) && (transaction->rx || !transaction->tx))
+    {
+        return SPI_BUS_ERROR_NO_MISO;
+    }
+
+    if (transaction->status == SPI_BUS_PENDING)
+    {
+        return SPI_BUS_ERROR_PENDING;
+    }
+
+    state = &Bus_State[device->bus];
+    transaction->status = SPI_BUS_PENDING;
+    transaction->next = 0;
+
+    section = Critical_Section_Enter();
+    if (state->tail)
+    {
+        state->tail->next = transaction;
+    }
+    else
+    {
+        state->head = transaction;
+    }
+    state->tail = transaction;
+    Critical_Section_Exit(section);
+
+    Run(device->bus);
+
+    return 0;
+}
+
+/**
+ * @brief Submits a transaction and waits until it is complete.
+ */
+static int Transfer(const SPI_Bus_Device *device, const uint8_t *tx, uint8_t *rx, uint16_t length, uint8_t flags)
+{
+    SPI_Bus_Transaction transaction;
+    int result;
+
+    transaction.device = device;
+    transaction.tx = tx;
+    transaction.rx = rx;
+    transaction.length = length;
+    transaction.flags = flags;
+    transaction.callback = 0;
+    transaction.context = 0;
+    transaction.status = SPI_BUS_DONE;
+
+    result = SPI_Bus_Submit(&transaction);
+    if (result < 0)
+    {
+        return result;
+    }
+
+    while(transaction.status == SPI_BUS_PENDING);
+
+    return 0;
+}
+
+int SPI_Bus_Transfer(const SPI_Bus_Device *device, const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    return Transfer(device, tx, rx, length, 0);
+}
+
+int SPI_Bus_Transfer_Hold(const SPI_Bus_Device *device, const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    return Transfer(device, tx, rx, length, SPI_BUS_KEEP_CS);
+}
+
+void SPI_Bus_Release(const SPI_Bus_Device *device)
+{
+    // A transaction without data only deasserts the chip-select
+    static const uint8_t none = 0;
+
+    Transfer(device, &none, 0, 0, 0);
+}
+
+uint8_t SPI_Bus_Is_Busy(uint8_t bus)
+{
+    return (Bus_State[bus].active || Bus_State[bus].head) ? 1 : 0;
+}
+
+void SPI_Bus_Get_Stats(uint8_t bus, SPI_Bus_Stats *stats)
+{
+    uint32_t section = Critical_Section_Enter();
+    *stats = Bus_State[bus].stats;
+    Critical_Section_Exit(section);
+}
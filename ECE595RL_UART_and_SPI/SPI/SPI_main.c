@@ -11,6 +11,11 @@
  *       - P9.5 (SCLK)
  *       - P9.7 (MOSI, Master Out Slave In)
  *  - Nokia5110_LCD: Used to interface with the Nokia 5110 LCD
+ *  - EUSCI_B0_SPI: Full-duplex SPI on P1.5 (SCLK), P1.6 (MOSI) and P1.7 (MISO), used for the loopback soak test.
+ *    The results are printed to the serial terminal using EUSCI_A0_UART.
+ *  - SPI_Bus: Shares EUSCI_A3 and EUSCI_B0 between several devices, each with its own GPIO chip-select, clock and mode.
+ *  - EUSCI_B2_SPI_Slave: Receives transactions from an external SPI master on P3.4 to P3.7 (refer to tools/spi_stream_master.py).
+ *  - SD_Card and Block_Log: Record timestamped samples on an SD card on EUSCI_B0 (CS P2.6), read later with tools/block_log_reader.py.
  *
  * @author Michael Granberry, Abdullah Hendy, Aaron Nanas
  *
@@ -20,10 +25,22 @@
 #include "msp.h"
 #include "../inc/Clock.h"
 #include "../inc/GPIO.h"
+#include "../inc/Pin_Map.h"
 
 // Comment or uncomment the lines to choose the SPI driver
 //#define USE_SPI_TEST 1
 #define USE_NOKIA_LCD 1
+//#define USE_SPI_LOOPBACK_SOAK 1
+//#define USE_SPI_BUS 1
+//#define USE_NOKIA_BURST_TIMING 1
+//#define USE_SPI_SLAVE_STREAM 1
+//#define USE_SD_LOGGER 1
+//#define USE_ACTIVE_OBJECT_COUNTER 1
+//#define USE_COROUTINE_LCD 1
+//#define USE_TRACE_TIMELINE 1      // Also add TRACE_ENABLE to the predefined symbols of the project
+
+// Uncomment with USE_NOKIA_LCD to sample the counter demo with the Profiler (read it with tools/profiler.py)
+//#define PROFILE_NOKIA_LCD 1
 
 #ifdef USE_SPI_TEST
 #include "../inc/EUSCI_A3_SPI.h"
@@ -33,8 +50,69 @@
 #include "../inc/Nokia5110_LCD.h"
 #endif
 
+#ifdef PROFILE_NOKIA_LCD
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Profiler.h"
+#endif
+
+#ifdef USE_SPI_LOOPBACK_SOAK
+#include "../inc/EUSCI_B0_SPI.h"
+#include "../inc/EUSCI_A0_UART.h"
+#endif
+
+#ifdef USE_SPI_BUS
+#include "../inc/SPI_Bus.h"
+#include "../inc/Nokia5110_LCD.h"
+#endif
+
+#ifdef USE_NOKIA_BURST_TIMING
+#include "../inc/Nokia5110_LCD.h"
+#endif
+
+#ifdef USE_SPI_SLAVE_STREAM
+#include "../inc/EUSCI_B2_SPI_Slave.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/CRC16.h"
+#endif
+
+#ifdef USE_SD_LOGGER
+#include "../inc/SD_Card.h"
+#include "../inc/Block_Log.h"
+#include "../inc/EUSCI_A0_UART.h"
+#endif
+
+#ifdef USE_ACTIVE_OBJECT_COUNTER
+#include "../inc/Nokia5110_LCD.h"
+#include "../inc/SysTick_Interrupt.h"
+#include "../inc/Active_Object.h"
+#endif
+
+#ifdef USE_COROUTINE_LCD
+#include "../inc/Nokia5110_LCD.h"
+#include "../inc/SysTick_Interrupt.h"
+#include "../inc/Coroutine.h"
+#endif
+
+#ifdef USE_TRACE_TIMELINE
+#include "../inc/Nokia5110_LCD.h"
+#include "../inc/SysTick_Interrupt.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Trace.h"
+
+// A define in this file would not reach the drivers, whose trace points would stay empty
+#ifndef TRACE_ENABLE
+#error "USE_TRACE_TIMELINE needs TRACE_ENABLE in the predefined symbols of the project (--define=TRACE_ENABLE)"
+#endif
+#endif
+
 #ifdef USE_NOKIA_LCD
 
+// Pins of the demo. The build fails if two groups use the same pin
+// (for example PIN_GROUP_PMOD_8LD, which would take P9 from the LCD).
+#define NOKIA_LCD_DEMO_PINS(X, port) \
+    PIN_GROUP_LED1(X, port) \
+    PIN_GROUP_BUTTONS(X, port) \
+    PIN_GROUP_NOKIA5110_LCD(X, port)
 
 /**
  * @brief The Change_Counter_Speed returns a delay value based on the status of the user buttons.
@@ -127,6 +205,9 @@ int main()
     // Initialize the 48 MHz Clock
     Clock_Init48MHz();
 
+    // Configure the pins of P1 and P9 with one write per register
+    PIN_MAP_INIT(NOKIA_LCD_DEMO_PINS);
+
     // Initialize the built-in red LED
     LED1_Init();
 
@@ -156,8 +237,18 @@ int main()
     // Turn on the red LED
     LED1_Output(RED_LED_ON);
 
+#ifdef PROFILE_NOKIA_LCD
+    // 997 Hz instead of 1 kHz, so that the samples do not lock to the 1 ms steps of Clock_Delay1ms
+    EUSCI_A0_UART_Init();
+    Profiler_Init(997);
+    Profiler_Start();
+#endif
+
     while(1)
     {
+#ifdef PROFILE_NOKIA_LCD
+        Profiler_Poll();
+#endif
 
 //        counter = counter + 1;
 //        Nokia5110_SetCursor(0, 3);
@@ -179,3 +270,1101 @@ int main()
     }
 }
 #endif
+
+#ifdef USE_SPI_LOOPBACK_SOAK
+#define SOAK_BUFFER_LENGTH  1024
+#define SOAK_ITERATIONS     64
+
+uint8_t SOAK_TX_Buffer[SOAK_BUFFER_LENGTH];
+uint8_t SOAK_RX_Buffer[SOAK_BUFFER_LENGTH];
+
+// SPI clock frequencies tested: SMCLK (12 MHz) divided by 12, 6, 4, 3, 2 and 1
+const uint32_t SOAK_Clock_Frequencies[6] = {1000000, 2000000, 3000000, 4000000, 6000000, 12000000};
+
+const char *SOAK_Backend_Names[3] = {"Blocking", "IRQ", "DMA"};
+
+// State of the PRBS-15 generator (x^15 + x^14 + 1)
+uint16_t PRBS_State = 0x7FFF;
+
+/**
+ * @brief The PRBS15_Next_Byte function returns the next eight bits of a PRBS-15 sequence.
+ *
+ * @param None
+ *
+ * @return The next byte of the sequence.
+ */
+uint8_t PRBS15_Next_Byte()
+{
+    uint8_t data = 0;
+    uint16_t bit;
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        bit = ((PRBS_State >> 14) ^ (PRBS_State >> 13)) & 0x01;
+        PRBS_State = ((PRBS_State << 1) | bit) & 0x7FFF;
+        data = (data << 1) | bit;
+    }
+    return data;
+}
+
+/**
+ * @brief The SPI_PRBS_Loopback_Soak function transfers PRBS data over EUSCI_B0 and checks that it is received unchanged.
+ *
+ * This function is used to test the SPI transfer API in a loop-back test fashion (P1.6 connected to P1.7).
+ * For each clock frequency and each backend, SOAK_ITERATIONS buffers of SOAK_BUFFER_LENGTH bytes are transferred.
+ * The throughput is computed from the DWT cycle counter over the transfers only, and is also given as a percentage
+ * of the SPI clock frequency divided by 8 (the throughput without gaps between bytes).
+ *
+ * @param None
+ *
+ * @return Total number of byte errors.
+ */
+uint32_t SPI_PRBS_Loopback_Soak()
+{
+    uint32_t total_errors = 0;
+    uint32_t byte_errors;
+    uint32_t bit_errors;
+    uint32_t cycles;
+    uint32_t start;
+    uint32_t throughput;
+    uint32_t clock_frequency;
+    uint8_t difference;
+    int clock_index;
+    int backend;
+    int iteration;
+    int i;
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    printf("   Clock  Backend   Throughput   Bus use  Byte errors  Bit errors\n");
+
+    for (clock_index = 0; clock_index < 6; clock_index++)
+    {
+        for (backend = EUSCI_B0_SPI_BLOCKING; backend <= EUSCI_B0_SPI_DMA; backend++)
+        {
+            EUSCI_B0_SPI_Init(SOAK_Clock_Frequencies[clock_index], EUSCI_B0_SPI_MODE_0);
+            EUSCI_B0_SPI_Set_Backend(backend);
+            clock_frequency = EUSCI_B0_SPI_Get_Clock_Frequency();
+
+            byte_errors = 0;
+            bit_errors = 0;
+            cycles = 0;
+
+            for (iteration = 0; iteration < SOAK_ITERATIONS; iteration++)
+            {
+                for (i = 0; i < SOAK_BUFFER_LENGTH; i++)
+                {
+                    SOAK_TX_Buffer[i] = PRBS15_Next_Byte();
+                    SOAK_RX_Buffer[i] = ~SOAK_TX_Buffer[i];
+                }
+
+                start = DWT->CYCCNT;
+                EUSCI_B0_SPI_Transfer(SOAK_TX_Buffer, SOAK_RX_Buffer, SOAK_BUFFER_LENGTH);
+                cycles += DWT->CYCCNT - start;
+
+                for (i = 0; i < SOAK_BUFFER_LENGTH; i++)
+                {
+                    difference = SOAK_TX_Buffer[i] ^ SOAK_RX_Buffer[i];
+                    if (difference)
+                    {
+                        byte_errors++;
+                        while(difference)
+                        {
+                            bit_errors += difference & 0x01;
+                            difference >>= 1;
+                        }
+                    }
+                }
+            }
+
+            // Bytes per second = bytes / (cycles / 48 MHz)
+            throughput = (uint32_t)(((uint64_t)SOAK_BUFFER_LENGTH * SOAK_ITERATIONS * 48000000) / cycles);
+
+            printf("%8lu  %-8s  %7lu B/s  %6lu %%  %11lu  %10lu\n",
+                   (unsigned long)clock_frequency, SOAK_Backend_Names[backend], (unsigned long)throughput,
+                   (unsigned long)((uint64_t)throughput * 800 / clock_frequency),
+                   (unsigned long)byte_errors, (unsigned long)bit_errors);
+
+            total_errors += byte_errors;
+        }
+    }
+
+    return total_errors;
+}
+
+int main()
+{
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    printf("\nStart of SPI PRBS Loopback Soak Test (connect P1.6 to P1.7)\n");
+    printf("------------------------------------------------------------\n");
+
+    // Turn on the red LED if no errors were detected
+    if (SPI_PRBS_Loopback_Soak() == 0)
+    {
+        LED1_Output(RED_LED_ON);
+    }
+
+    printf("------------------------------------------------------------\n");
+    printf("End of SPI PRBS Loopback Soak Test\n");
+
+    while(1);
+}
+#endif
+
+#ifdef USE_SPI_BUS
+#define BUS_TEST_TRANSACTIONS   8
+#define BUS_TEST_LENGTH         64
+
+// Two devices on SPI_BUS_B0 with different settings. P1.6 (MOSI) is connected to P1.7 (MISO),
+// so each device receives what it transmits. The Nokia 5110 LCD is on SPI_BUS_A3.
+const SPI_Bus_Device Flash_Device = {SPI_BUS_B0, 2, 0x10, 6000000, SPI_BUS_MODE_0};    // CS on P2.4
+const SPI_Bus_Device SD_Device = {SPI_BUS_B0, 2, 0x20, 1000000, SPI_BUS_MODE_3};       // CS on P2.5
+
+// Pins of the demo. The chip-selects are outputs deasserted high.
+#define SPI_BUS_DEMO_PINS(X, port) \
+    PIN_GROUP_LED1(X, port) \
+    PIN_GROUP_EUSCI_B0_SPI(X, port) \
+    X(port, 2, 0x30, PIN_GPIO_OUTPUT_HIGH) \
+    PIN_GROUP_NOKIA5110_LCD(X, port)
+
+SPI_Bus_Transaction Bus_Test_Transactions[BUS_TEST_TRANSACTIONS];
+uint8_t Bus_Test_TX[BUS_TEST_TRANSACTIONS][BUS_TEST_LENGTH];
+uint8_t Bus_Test_RX[BUS_TEST_TRANSACTIONS][BUS_TEST_LENGTH];
+
+/**
+ * @brief The SPI_Bus_Test function queues transactions for the two SPI_BUS_B0 devices and checks the received data.
+ *
+ * When interleaved is 0, the first half of the transactions is for Flash_Device and the second half is for SD_Device,
+ * so the bus is only reconfigured when the device changes. When interleaved is 1, the devices alternate.
+ *
+ * @param interleaved 0 to group the transactions by device, 1 to alternate the devices.
+ *
+ * @return Number of bytes received with an error.
+ */
+uint32_t SPI_Bus_Test(uint8_t interleaved)
+{
+    SPI_Bus_Transaction *transaction;
+    uint32_t errors = 0;
+    int i;
+    int j;
+
+    for (i = 0; i < BUS_TEST_TRANSACTIONS; i++)
+    {
+        transaction = &Bus_Test_Transactions[i];
+        if (interleaved)
+        {
+            transaction->device = (i & 0x01) ? &SD_Device : &Flash_Device;
+        }
+        else
+        {
+            transaction->device = (i < (BUS_TEST_TRANSACTIONS / 2)) ? &Flash_Device : &SD_Device;
+        }
+
+        for (j = 0; j < BUS_TEST_LENGTH; j++)
+        {
+            Bus_Test_TX[i][j] = (uint8_t)(i * 37 + j);
+            Bus_Test_RX[i][j] = 0;
+        }
+
+        transaction->tx = Bus_Test_TX[i];
+        transaction->rx = Bus_Test_RX[i];
+        transaction->length = BUS_TEST_LENGTH;
+        transaction->flags = 0;
+        transaction->callback = 0;
+
+        SPI_Bus_Submit(transaction);
+    }
+
+    // The transactions run back to back in the EUSCIB0 interrupt handler
+    while(SPI_Bus_Is_Busy(SPI_BUS_B0));
+
+    for (i = 0; i < BUS_TEST_TRANSACTIONS; i++)
+    {
+        for (j = 0; j < BUS_TEST_LENGTH; j++)
+        {
+            if (Bus_Test_RX[i][j] != Bus_Test_TX[i][j])
+            {
+                errors++;
+            }
+        }
+    }
+
+    return errors;
+}
+
+int main()
+{
+    SPI_Bus_Stats stats;
+    uint32_t reconfigurations;
+    uint32_t errors;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Configure the pins of P1, P2 and P9 with one write per register
+    PIN_MAP_INIT(SPI_BUS_DEMO_PINS);
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize the Nokia 5110 LCD (SPI_BUS_A3)
+    Nokia5110_Init();
+    Nokia5110_Clear();
+
+    // Initialize SPI_BUS_B0 and its devices
+    SPI_Bus_Init(SPI_BUS_B0);
+    SPI_Bus_Add_Device(&Flash_Device);
+    SPI_Bus_Add_Device(&SD_Device);
+
+    // Grouped by device
+    errors = SPI_Bus_Test(0);
+    SPI_Bus_Get_Stats(SPI_BUS_B0, &stats);
+    reconfigurations = stats.reconfigurations;
+
+    Nokia5110_SetCursor(0, 0);
+    Nokia5110_OutString("Grouped");
+    Nokia5110_SetCursor(0, 1);
+    Nokia5110_OutString("Cfg");
+    Nokia5110_OutUDec(reconfigurations);
+    Nokia5110_SetCursor(0, 2);
+    Nokia5110_OutString("Err");
+    Nokia5110_OutUDec(errors);
+
+    // Alternating devices
+    errors += SPI_Bus_Test(1);
+    SPI_Bus_Get_Stats(SPI_BUS_B0, &stats);
+
+    Nokia5110_SetCursor(0, 3);
+    Nokia5110_OutString("Interleaved");
+    Nokia5110_SetCursor(0, 4);
+    Nokia5110_OutString("Cfg");
+    Nokia5110_OutUDec(stats.reconfigurations - reconfigurations);
+    Nokia5110_SetCursor(0, 5);
+    Nokia5110_OutString("Err");
+    Nokia5110_OutUDec(errors);
+
+    // Turn on the red LED if no errors were detected
+    if (errors == 0)
+    {
+        LED1_Output(RED_LED_ON);
+    }
+
+    while(1);
+}
+#endif
+
+#ifdef USE_NOKIA_BURST_TIMING
+// Bytes sent per screen update: two cursor commands and one row of data for each of the six banks
+#define TIMING_BYTES_PER_UPDATE     ((2 + MAX_X) * (MAX_Y / 8))
+
+// SPI clock frequency of the Nokia 5110 LCD in Hz (refer to Nokia5110_SPI_Init)
+#define TIMING_SPI_FREQUENCY        1000000
+
+uint8_t Timing_Pattern[MAX_Y / 8][MAX_X];
+
+// SCE of the Nokia 5110 LCD on P9.4 (refer to Nokia5110_Device in Nokia5110_LCD.c)
+#define TIMING_SCE_BIT              0x10
+
+/**
+ * @brief The Baseline_Command_Write function is a copy of Nokia5110_Command_Write before the SPI bus manager.
+ *
+ * It waits on UCBUSY before and after writing the command byte to UCA3TXBUF.
+ *
+ * @param command The command byte to send.
+ *
+ * @return None
+ */
+static void Baseline_Command_Write(uint8_t command)
+{
+    // UCBUSY - Wait until SPI is not busy
+    while((EUSCI_A3->STATW & 0x0001) == 0x0001);
+
+    // Set the Data/Command output pin to 0 to indicate that the transmitted byte is a command byte
+    Nokia5110_SPI_Data_Command_Bit_Out(0x00);
+
+    // Write the command byte to the transmit buffer
+    EUSCI_A3->TXBUF = command;
+
+    // UCBUSY - Wait until SPI is not busy
+    while((EUSCI_A3->STATW & 0x0001) == 0x0001);
+}
+
+/**
+ * @brief The Baseline_Data_Write function is a copy of Nokia5110_Data_Write before the SPI bus manager.
+ *
+ * It waits until UCA3TXBUF is empty and writes the data byte to it.
+ *
+ * @param data The data byte to send.
+ *
+ * @return None
+ */
+static void Baseline_Data_Write(uint8_t data)
+{
+    // Wait until UCA3TXBUF is empty
+    while((EUSCI_A3->IFG & 0x0002) == 0x0000);
+
+    // Set the Data/Command output pin to 1 to indicate that the transmitted byte is a data byte
+    Nokia5110_SPI_Data_Command_Bit_Out(0x01);
+
+    // Write the data byte to the transmit buffer
+    EUSCI_A3->TXBUF = data;
+}
+
+/**
+ * @brief The Update_Bytewise function updates the screen with the byte loop of the original driver.
+ *
+ * Every byte goes through Baseline_Command_Write or Baseline_Data_Write, which poll UCBUSY and UCTXIFG.
+ * The original driver let EUSCI_A3 drive SCE in 4-pin mode. SCE is now a GPIO owned by the SPI bus
+ * manager, so it is held low here for the whole update, which costs no extra CPU time per byte.
+ * EUSCI_A3 is left configured for the LCD (1 MHz, mode 0) by Nokia5110_Init.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Update_Bytewise()
+{
+    P9->OUT &= ~TIMING_SCE_BIT;
+    for (int bank = 0; bank < (MAX_Y / 8); bank = bank + 1)
+    {
+        Baseline_Command_Write(0x80);
+        Baseline_Command_Write(0x40 | bank);
+        for (int i = 0; i < MAX_X; i = i + 1)
+        {
+            Baseline_Data_Write(Timing_Pattern[bank][i]);
+        }
+    }
+
+    // UCBUSY - Wait until the last data byte has been shifted out
+    while((EUSCI_A3->STATW & 0x0001) == 0x0001);
+    P9->OUT |= TIMING_SCE_BIT;
+}
+
+/**
+ * @brief The Update_Burst function updates the screen with one chip-select burst per bank.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Update_Burst()
+{
+    for (int bank = 0; bank < (MAX_Y / 8); bank = bank + 1)
+    {
+        Nokia5110_Write_Burst(0, bank, Timing_Pattern[bank], MAX_X);
+    }
+}
+
+/**
+ * @brief The Measure_Bus_Utilization function measures the fraction of time during which SCLK is running.
+ *
+ * The time needed to shift TIMING_BYTES_PER_UPDATE bytes at TIMING_SPI_FREQUENCY is divided by the
+ * time measured with the DWT cycle counter for the whole update.
+ *
+ * @param update Pointer to the function that updates the screen.
+ *
+ * @return Bus utilization in tenths of a percent.
+ */
+uint32_t Measure_Bus_Utilization(void (*update)(void))
+{
+    uint32_t start;
+    uint32_t cycles;
+
+    start = DWT->CYCCNT;
+    update();
+    cycles = DWT->CYCCNT - start;
+
+    // (bytes * 8 bits * 48 MHz / SPI frequency) cycles of shifting, out of the measured cycles
+    return (uint32_t)(((uint64_t)TIMING_BYTES_PER_UPDATE * 8 * 48000000 * 1000) / ((uint64_t)TIMING_SPI_FREQUENCY * cycles));
+}
+
+/**
+ * @brief The Print_Utilization function prints a utilization in tenths of a percent, for example "   97.5%".
+ *
+ * @param utilization Bus utilization in tenths of a percent.
+ *
+ * @return None
+ */
+void Print_Utilization(uint32_t utilization)
+{
+    Nokia5110_OutUDec(utilization / 10);
+    Nokia5110_OutChar('.');
+    Nokia5110_OutChar('0' + (utilization % 10));
+    Nokia5110_OutChar('%');
+}
+
+int main()
+{
+    uint32_t bytewise;
+    uint32_t burst;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize the Nokia 5110 LCD
+    Nokia5110_Init();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Checkerboard pattern
+    for (int bank = 0; bank < (MAX_Y / 8); bank = bank + 1)
+    {
+        for (int i = 0; i < MAX_X; i = i + 1)
+        {
+            Timing_Pattern[bank][i] = (i & 0x04) ? 0x0F : 0xF0;
+        }
+    }
+
+    bytewise = Measure_Bus_Utilization(Update_Bytewise);
+    burst = Measure_Bus_Utilization(Update_Burst);
+
+    // Show the results
+    Nokia5110_Clear();
+    Nokia5110_SetCursor(0, 0);
+    Nokia5110_OutString("SPI bus use");
+    Nokia5110_SetCursor(0, 1);
+    Nokia5110_OutString("Bytewise");
+    Nokia5110_SetCursor(0, 2);
+    Print_Utilization(bytewise);
+    Nokia5110_SetCursor(0, 4);
+    Nokia5110_OutString("Burst");
+    Nokia5110_SetCursor(0, 5);
+    Print_Utilization(burst);
+
+    // Turn on the red LED
+    LED1_Output(RED_LED_ON);
+
+    while(1);
+}
+#endif
+
+#ifdef USE_SPI_SLAVE_STREAM
+// Each transaction from tools/spi_stream_master.py holds a 32-bit sequence number, the payload
+// and a CRC-16/CCITT (initial value 0xFFFF) of the sequence number and payload, all little-endian.
+#define STREAM_HEADER_LENGTH    4
+#define STREAM_CRC_LENGTH       2
+
+// Response transmitted during the next transaction: 'S', last sequence number received, CRC errors and lost sequence numbers
+uint8_t Stream_Response[13];
+
+void Stream_Put_U32(uint8_t *data, uint32_t value)
+{
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+    data[2] = (value >> 16) & 0xFF;
+    data[3] = (value >> 24) & 0xFF;
+}
+
+int main()
+{
+    EUSCI_B2_SPI_Slave_Stats stats;
+    const uint8_t *data;
+    int length;
+    uint32_t sequence;
+    uint32_t expected = 0;
+    uint32_t crc_errors = 0;
+    uint32_t lost = 0;
+    uint32_t last_report;
+    uint32_t last_bytes = 0;
+    uint16_t crc;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Initialize the SPI slave (mode 0, as spidev uses by default)
+    if (EUSCI_B2_SPI_Slave_Init(EUSCI_B2_SPI_SLAVE_MODE_0) < 0)
+    {
+        printf("DMA channels 4 and 5 are not available\n");
+        while(1);
+    }
+
+    Stream_Response[0] = 'S';
+    EUSCI_B2_SPI_Slave_Set_Response(Stream_Response, sizeof(Stream_Response));
+
+    printf("\nSPI slave stream receiver (CS P3.4, SCLK P3.5, SIMO P3.6, SOMI P3.7)\n");
+
+    last_report = DWT->CYCCNT;
+
+    while(1)
+    {
+        length = EUSCI_B2_SPI_Slave_Get_Transaction(&data);
+        if (length >= (STREAM_HEADER_LENGTH + STREAM_CRC_LENGTH))
+        {
+            crc = data[length - 2] | (data[length - 1] << 8);
+            if (CRC16_Compute(CRC16_INITIAL_VALUE, data, length - STREAM_CRC_LENGTH) != crc)
+            {
+                crc_errors++;
+            }
+            else
+            {
+                sequence = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+                if (sequence != expected)
+                {
+                    lost += sequence - expected;
+                }
+                expected = sequence + 1;
+
+                // Update the response in place. A transaction in progress may transmit a mix of old and new values.
+                Stream_Put_U32(&Stream_Response[1], sequence);
+                Stream_Put_U32(&Stream_Response[5], crc_errors);
+                Stream_Put_U32(&Stream_Response[9], lost);
+            }
+        }
+        if (length >= 0)
+        {
+            EUSCI_B2_SPI_Slave_Release_Transaction();
+        }
+
+        // Report once per second
+        if ((DWT->CYCCNT - last_report) >= 48000000)
+        {
+            last_report += 48000000;
+            EUSCI_B2_SPI_Slave_Get_Stats(&stats);
+            printf("%lu B/s, %lu transactions, %lu dropped, %lu overruns, %lu CRC errors, %lu lost\n",
+                   (unsigned long)(stats.bytes - last_bytes), (unsigned long)stats.transactions,
+                   (unsigned long)stats.dropped_transactions, (unsigned long)stats.overruns,
+                   (unsigned long)crc_errors, (unsigned long)lost);
+            last_bytes = stats.bytes;
+            LED1_Output((stats.dropped_transactions || crc_errors || lost) ? RED_LED_ON : RED_LED_OFF);
+        }
+    }
+}
+#endif
+
+#ifdef USE_SD_LOGGER
+// Record types, decoded by tools/block_log_reader.py --decode 1:<IIII --decode 2:<II
+#define LOG_RECORD_SAMPLE       1   // Timestamp, sequence number, cycles of the previous append and maximum so far
+#define LOG_RECORD_RUN_START    2   // Blocks used by the log when the run starts and SD card size in blocks
+
+#define LOG_DURATION_S          10
+
+// The SD card chip-select is P2.6
+#define SD_CARD_CS_PORT         2
+#define SD_CARD_CS_BIT          0x40
+
+Block_Log_Device SD_Card_Log_Device = {0, SD_Card_Read_Block, SD_Card_Write_Blocks};
+
+int main()
+{
+    Block_Log_Stats stats;
+    uint32_t sample[4];
+    uint32_t start;
+    uint32_t last_report;
+    uint32_t append_start;
+    uint32_t append_cycles = 0;
+    uint32_t max_append_cycles = 0;
+    uint32_t sequence = 0;
+    uint32_t bytes = 0;
+    int result;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Initialize the SD card on EUSCI_B0 (SCLK P1.5, MOSI P1.6, MISO P1.7, CS P2.6)
+    SPI_Bus_Init(SPI_BUS_B0);
+    result = SD_Card_Init(SD_CARD_CS_PORT, SD_CARD_CS_BIT);
+    if (result < 0)
+    {
+        printf("\nSD card error %d\n", result);
+        LED1_Output(RED_LED_ON);
+        while(1);
+    }
+    SD_Card_Log_Device.block_count = SD_Card_Get_Block_Count();
+    printf("\nSD card: %lu blocks\n", (unsigned long)SD_Card_Log_Device.block_count);
+
+    // Continue the log of the previous run, or start a new one
+    result = Block_Log_Mount(&SD_Card_Log_Device);
+    if (result == BLOCK_LOG_ERROR_NO_LOG)
+    {
+        printf("No log found, formatting\n");
+        result = Block_Log_Format(&SD_Card_Log_Device);
+    }
+    if (result < 0)
+    {
+        printf("Log error %d\n", result);
+        LED1_Output(RED_LED_ON);
+        while(1);
+    }
+
+    Block_Log_Get_Stats(&stats);
+    printf("Log %lu: %lu of %lu blocks used\n", (unsigned long)stats.log_id,
+           (unsigned long)stats.blocks, (unsigned long)stats.block_count);
+
+    sample[0] = stats.blocks;
+    sample[1] = SD_Card_Log_Device.block_count;
+    Block_Log_Append_Record(LOG_RECORD_RUN_START, sample, 8);
+
+    // Log samples as fast as possible. Most appends only copy the record, but one in about 200 writes a 4 KB chunk.
+    start = DWT->CYCCNT;
+    last_report = start;
+    while((DWT->CYCCNT - start) < (LOG_DURATION_S * 48000000))
+    {
+        sample[0] = DWT->CYCCNT;
+        sample[1] = sequence++;
+        sample[2] = append_cycles;
+        sample[3] = max_append_cycles;
+
+        append_start = DWT->CYCCNT;
+        result = Block_Log_Append_Record(LOG_RECORD_SAMPLE, sample, sizeof(sample));
+        append_cycles = DWT->CYCCNT - append_start;
+        if (append_cycles > max_append_cycles)
+        {
+            max_append_cycles = append_cycles;
+        }
+        if (result < 0)
+        {
+            printf("Log error %d\n", result);
+            break;
+        }
+
+        // Report once per second
+        if ((DWT->CYCCNT - last_report) >= 48000000)
+        {
+            last_report += 48000000;
+            Block_Log_Get_Stats(&stats);
+            printf("%lu B/s, %lu records, longest append %lu us\n", (unsigned long)(stats.bytes - bytes),
+                   (unsigned long)sequence, (unsigned long)(max_append_cycles / 48));
+            bytes = stats.bytes;
+        }
+    }
+
+    result = Block_Log_Flush();
+    Block_Log_Get_Stats(&stats);
+    printf("Done (%d): log %lu, %lu bytes, %lu blocks in %lu writes\n", result, (unsigned long)stats.log_id,
+           (unsigned long)stats.bytes, (unsigned long)stats.blocks_written, (unsigned long)stats.writes);
+
+    LED1_Output((result < 0) ? RED_LED_ON : RED_LED_OFF);
+
+    while(1);
+}
+#endif
+
+#ifdef USE_ACTIVE_OBJECT_COUNTER
+#define COUNTER_SAMPLE_MS       20          // Buttons sampling period
+#define COUNTER_NORMAL_MS       1000
+#define COUNTER_FAST_MS         200
+#define COUNTER_SLOW_MS         3000
+
+// Same pins as the Nokia 5110 counter demo
+#define ACTIVE_OBJECT_DEMO_PINS(X, port) \
+    PIN_GROUP_LED1(X, port) \
+    PIN_GROUP_BUTTONS(X, port) \
+    PIN_GROUP_NOKIA5110_LCD(X, port)
+
+enum
+{
+    BUTTONS_SAMPLE_SIGNAL = ACTIVE_OBJECT_SIGNAL_USER,
+    BUTTONS_CHANGED_SIGNAL,                 // parameter: status of the buttons (Get_Buttons_Status)
+    COUNTER_TIMEOUT_SIGNAL
+};
+
+/**
+ * @brief Reports the status of the buttons to the counter when it has been the same for two samples.
+ */
+typedef struct
+{
+    Active_Object super;
+    Active_Object_Timer sample_timer;
+    uint8_t last_sample;
+    uint8_t reported;
+} Buttons_Active_Object;
+
+/**
+ * @brief Counts on the LCD. The delay between two counts depends on the state (Normal, Fast or Slow), selected by the buttons.
+ *
+ *  Counting                    Counts on COUNTER_TIMEOUT_SIGNAL, selects the speed on BUTTONS_CHANGED_SIGNAL
+ *   +- Normal (initial)        Buttons 0x00 or 0x12
+ *   +- Fast                    Buttons 0x10
+ *   +- Slow                    Buttons 0x02
+ */
+typedef struct
+{
+    Active_Object super;
+    Active_Object_Timer count_timer;
+    uint32_t count;
+} Counter_Active_Object;
+
+static Buttons_Active_Object Buttons_AO;
+static Counter_Active_Object Counter_AO;
+static Active_Object_Event Buttons_Queue[4];
+static Active_Object_Event Counter_Queue[8];
+
+void SysTick_Handler(void)
+{
+    Active_Object_Tick();
+}
+
+static uint8_t Buttons_Sampling(Active_Object *me, const Active_Object_Event *e)
+{
+    Buttons_Active_Object *buttons = (Buttons_Active_Object *)me;
+    uint8_t sample;
+
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:
+        {
+            buttons->last_sample = Get_Buttons_Status();
+            buttons->reported = buttons->last_sample;
+            Active_Object_Timer_Start(&buttons->sample_timer, COUNTER_SAMPLE_MS, COUNTER_SAMPLE_MS);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+
+        case BUTTONS_SAMPLE_SIGNAL:
+        {
+            sample = Get_Buttons_Status();
+            if ((sample == buttons->last_sample) && (sample != buttons->reported))
+            {
+                buttons->reported = sample;
+                Active_Object_Post(&Counter_AO.super, BUTTONS_CHANGED_SIGNAL, sample);
+            }
+            buttons->last_sample = sample;
+            return ACTIVE_OBJECT_HANDLED();
+        }
+    }
+
+    return ACTIVE_OBJECT_SUPER(Active_Object_Top);
+}
+
+static uint8_t Counter_Normal(Active_Object *me, const Active_Object_Event *e);
+static uint8_t Counter_Fast(Active_Object *me, const Active_Object_Event *e);
+static uint8_t Counter_Slow(Active_Object *me, const Active_Object_Event *e);
+
+/**
+ * @brief Entry action of the speed states: starts the count timer and shows the delay.
+ */
+static void Counter_Set_Delay(Counter_Active_Object *counter, uint16_t delay)
+{
+    Active_Object_Timer_Start(&counter->count_timer, delay, delay);
+    Nokia5110_SetCursor(0, 5);
+    Nokia5110_OutString("Delay=");
+    Nokia5110_OutUDec(delay);
+}
+
+static uint8_t Counter_Counting(Active_Object *me, const Active_Object_Event *e)
+{
+    Counter_Active_Object *counter = (Counter_Active_Object *)me;
+
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:
+        {
+            Nokia5110_Clear();
+            Nokia5110_SetCursor(0, 1);
+            Nokia5110_OutString("Counter");
+            Nokia5110_SetCursor(0, 3);
+            Nokia5110_OutUDec(counter->count);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+
+        case ACTIVE_OBJECT_SIGNAL_INIT:
+        {
+            return ACTIVE_OBJECT_TRANSITION(Counter_Normal);
+        }
+
+        case COUNTER_TIMEOUT_SIGNAL:
+        {
+            counter->count++;
+            Nokia5110_SetCursor(0, 3);
+            Nokia5110_OutUDec(counter->count);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+
+        case BUTTONS_CHANGED_SIGNAL:
+        {
+            switch(e->parameter)
+            {
+                case 0x10:  return ACTIVE_OBJECT_TRANSITION(Counter_Fast);
+                case 0x02:  return ACTIVE_OBJECT_TRANSITION(Counter_Slow);
+                default:    return ACTIVE_OBJECT_TRANSITION(Counter_Normal);
+            }
+        }
+    }
+
+    return ACTIVE_OBJECT_SUPER(Active_Object_Top);
+}
+
+static uint8_t Counter_Normal(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:
+        {
+            Counter_Set_Delay((Counter_Active_Object *)me, COUNTER_NORMAL_MS);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+
+        case ACTIVE_OBJECT_SIGNAL_EXIT:
+        {
+            Active_Object_Timer_Stop(&((Counter_Active_Object *)me)->count_timer);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+    }
+
+    return ACTIVE_OBJECT_SUPER(Counter_Counting);
+}
+
+static uint8_t Counter_Fast(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:
+        {
+            Counter_Set_Delay((Counter_Active_Object *)me, COUNTER_FAST_MS);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+
+        case ACTIVE_OBJECT_SIGNAL_EXIT:
+        {
+            Active_Object_Timer_Stop(&((Counter_Active_Object *)me)->count_timer);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+    }
+
+    return ACTIVE_OBJECT_SUPER(Counter_Counting);
+}
+
+static uint8_t Counter_Slow(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:
+        {
+            Counter_Set_Delay((Counter_Active_Object *)me, COUNTER_SLOW_MS);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+
+        case ACTIVE_OBJECT_SIGNAL_EXIT:
+        {
+            Active_Object_Timer_Stop(&((Counter_Active_Object *)me)->count_timer);
+            return ACTIVE_OBJECT_HANDLED();
+        }
+    }
+
+    return ACTIVE_OBJECT_SUPER(Counter_Counting);
+}
+
+int main()
+{
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Configure the pins of P1 and P9 with one write per register
+    PIN_MAP_INIT(ACTIVE_OBJECT_DEMO_PINS);
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize the buttons
+    Buttons_Init();
+
+    // Initialize the Nokia 5110 LCD
+    Nokia5110_Init();
+    Nokia5110_Set_Contrast(250);
+
+    // The counter has the higher priority: a count is never delayed by the sampling of the buttons
+    Active_Object_Timer_Init(&Counter_AO.count_timer, &Counter_AO.super, COUNTER_TIMEOUT_SIGNAL, 0);
+    Active_Object_Start(&Counter_AO.super, 2, Counter_Queue, 8, Counter_Counting);
+    Active_Object_Timer_Init(&Buttons_AO.sample_timer, &Buttons_AO.super, BUTTONS_SAMPLE_SIGNAL, 0);
+    Active_Object_Start(&Buttons_AO.super, 1, Buttons_Queue, 4, Buttons_Sampling);
+
+    // 1 ms ticks for the timers
+    SysTick_Interrupt_Init(SYSTICK_INT_NUM_CLK_CYCLES, SYSTICK_INT_PRIORITY);
+
+    // Turn on the red LED
+    LED1_Output(RED_LED_ON);
+
+    // The CPU sleeps between the events
+    Active_Object_Run();
+}
+#endif
+
+#ifdef USE_COROUTINE_LCD
+#define BALL_FRAME_MS           50
+
+#define COROUTINE_DEMO_PINS(X, port) \
+    PIN_GROUP_LED1(X, port) \
+    PIN_GROUP_NOKIA5110_LCD(X, port)
+
+void SysTick_Handler(void)
+{
+    Coroutine_Tick();
+}
+
+/**
+ * @brief Blinks the red LED. It keeps blinking while the LCD coroutine waits for the LCD.
+ */
+static uint8_t Blink_Coroutine(Coroutine *co)
+{
+    COROUTINE_BEGIN(co);
+
+    while(1)
+    {
+        LED1_Output(RED_LED_ON);
+        COROUTINE_DELAY(co, 100);
+        LED1_Output(RED_LED_OFF);
+        COROUTINE_DELAY(co, 900);
+    }
+
+    COROUTINE_END(co);
+}
+
+/**
+ * @brief Initializes the LCD, then bounces a ball on the screen by redrawing the whole RAM buffer for each frame.
+ */
+static uint8_t Ball_Coroutine(Coroutine *co)
+{
+    // Kept across the waits
+    static Coroutine lcd;
+    static int8_t x = 0;
+    static int8_t y = 0;
+    static int8_t dx = 1;
+    static int8_t dy = 1;
+
+    COROUTINE_BEGIN(co);
+
+    COROUTINE_AWAIT_CALL(co, &lcd, Nokia5110_Init_Async(&lcd));
+
+    while(1)
+    {
+        Nokia5110_ClearBuffer();
+        Nokia5110_SetPxl(y, x);
+        Nokia5110_SetPxl(y, x + 1);
+        Nokia5110_SetPxl(y + 1, x);
+        Nokia5110_SetPxl(y + 1, x + 1);
+        COROUTINE_AWAIT_CALL(co, &lcd, Nokia5110_DisplayBuffer_Async(&lcd));
+
+        if ((x + dx < 0) || (x + dx > MAX_X - 2))
+        {
+            dx = -dx;
+        }
+        if ((y + dy < 0) || (y + dy > MAX_Y - 2))
+        {
+            dy = -dy;
+        }
+        x = x + dx;
+        y = y + dy;
+
+        COROUTINE_DELAY(co, BALL_FRAME_MS);
+    }
+
+    COROUTINE_END(co);
+}
+
+int main()
+{
+    Coroutine blink = {0};
+    Coroutine ball = {0};
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Configure the pins of P1 and P9 with one write per register
+    PIN_MAP_INIT(COROUTINE_DEMO_PINS);
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // 1 ms ticks for COROUTINE_DELAY
+    SysTick_Interrupt_Init(SYSTICK_INT_NUM_CLK_CYCLES, SYSTICK_INT_PRIORITY);
+
+    // The coroutines take turns: each call runs one of them until it waits
+    while(1)
+    {
+        Blink_Coroutine(&blink);
+        Ball_Coroutine(&ball);
+    }
+}
+#endif
+
+#ifdef USE_TRACE_TIMELINE
+#define TRACE_SYSTICK_CYCLES    480000      // 10 ms, so that the buffer holds several frames
+#define TRACE_ID_MAIN_LOOP      TRACE_ID_USER
+#define TRACE_ID_FRAME          (TRACE_ID_USER + 1)
+
+#define TRACE_DEMO_PINS(X, port) \
+    PIN_GROUP_LED1(X, port) \
+    PIN_GROUP_NOKIA5110_LCD(X, port)
+
+void SysTick_Handler(void)
+{
+    TRACE_ISR_ENTER(TRACE_ID_SYSTICK);
+    P1->OUT ^= 0x01;
+    TRACE_ISR_EXIT(TRACE_ID_SYSTICK);
+}
+
+int main()
+{
+    uint16_t frame = 0;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Configure the pins of P1 and P9 with one write per register
+    PIN_MAP_INIT(TRACE_DEMO_PINS);
+
+    // Initialize the built-in red LED, toggled by SysTick
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART for the status lines and tools/trace_to_chrome.py
+    EUSCI_A0_UART_Init();
+
+    // Initialize the Nokia 5110 LCD
+    Nokia5110_Init();
+
+    Trace_Init();
+    Trace_Set_Name(TRACE_ID_MAIN_LOOP, "Main_Loop");
+    Trace_Set_Name(TRACE_ID_FRAME, "Frame");
+
+    SysTick_Interrupt_Init(TRACE_SYSTICK_CYCLES, SYSTICK_INT_PRIORITY);
+
+    // Each frame is sent over EUSCI_A0 (interrupt driven) and drawn on the LCD (blocking bursts),
+    // so the timeline shows how the UART interrupts interleave with the LCD transfers
+    while(1)
+    {
+        TRACE_TASK_BEGIN(TRACE_ID_MAIN_LOOP);
+        TRACE_MARKER(TRACE_ID_FRAME, frame);
+
+        EUSCI_A_UART_OutString(EUSCI_A0_UART_PORT, "Frame ");
+        EUSCI_A_UART_OutUDec(EUSCI_A0_UART_PORT, frame);
+        EUSCI_A_UART_OutString(EUSCI_A0_UART_PORT, "\r\n");
+
+        Nokia5110_ClearBuffer();
+        Nokia5110_SetPxl(frame % MAX_Y, frame % MAX_X);
+        Nokia5110_DisplayBuffer();
+        frame++;
+
+        TRACE_TASK_END(TRACE_ID_MAIN_LOOP);
+
+        Clock_Delay1ms(20);
+        Trace_Poll();
+    }
+}
+#endif
@@ -0,0 +1,748 @@
+/**
+ * @file AES256_Link.c
+ * @brief Source code for the AES256_Link driver.
+ *
+ * This file contains the function definitions for the AES256_Link driver.
+ * It provides an encrypted and authenticated framing layer over the EUSCI_A2 UART
+ * using the AES256 accelerator of the MSP432 in AES-CCM mode (NIST SP 800-38C).
+ *
+ * For more information regarding the AES256 accelerator and the DMA controller,
+ * refer to the AES256 Accelerator (22) and DMA (11) sections of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @note Assumes that EUSCI_A2_UART_Init() has been called. P3.2 is used for UART RX while P3.3 is used for UART TX.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <stdio.h>
+#include "../inc/AES256_Link.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/DMA.h"
+
+// CCM flags for B0: no associated data, M = 8 ((8 - 2) / 2 = 3 in bits 5-3), L = 2 (L - 1 = 1 in bits 2-0)
+#define CCM_B0_FLAGS        0x19
+
+// CCM flags for the counter blocks A_i: L = 2
+#define CCM_A_FLAGS         0x01
+
+// Maximum number of counter blocks (A0 for the tag and A1 to A15 for the payload)
+#define MAX_COUNTER_BLOCKS  ((AES256_LINK_MAX_PAYLOAD / 16) + 1)
+
+// DMA channels fed by the AES256 triggers, or DMA_ERROR_BUSY if they are used by another driver
+static int DMA_Output_Channel = DMA_ERROR_BUSY;
+static int DMA_Input_Channel = DMA_ERROR_BUSY;
+
+// Counter blocks and keystream for one frame. Both are accessed as half-words by the DMA channels.
+#pragma DATA_ALIGN(Counter_Blocks, 4)
+static uint8_t Counter_Blocks[MAX_COUNTER_BLOCKS * 16];
+#pragma DATA_ALIGN(Keystream, 4)
+static uint8_t Keystream[MAX_COUNTER_BLOCKS * 16];
+
+static uint8_t Link_Salt[AES256_LINK_SALT_LENGTH];
+static uint32_t TX_Frame_Counter_High;
+static uint32_t TX_Frame_Counter_Low;
+static uint32_t RX_Frame_Counter_High;
+static uint32_t RX_Frame_Counter_Low;
+static uint8_t RX_Frame_Received;
+
+// Expanded key for the software AES-256 baseline (15 round keys)
+static uint8_t Round_Keys[240];
+
+static const uint8_t SBOX[256] = {
+    0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+    0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+    0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+    0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+    0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+    0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+    0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+    0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+    0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+    0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+    0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+    0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+    0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+    0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+    0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+    0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+static const uint8_t RCON[7] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40};
+
+static uint8_t xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+static void Software_Key_Expansion(const uint8_t *key)
+{
+    uint8_t temp[4];
+    uint8_t t;
+    int i;
+
+    for (i = 0; i < 32; i++)
+    {
+        Round_Keys[i] = key[i];
+    }
+
+    // Nk = 8 words, 60 words in total for Nr = 14 rounds
+    for (i = 8; i < 60; i++)
+    {
+        temp[0] = Round_Keys[4*(i-1) + 0];
+        temp[1] = Round_Keys[4*(i-1) + 1];
+        temp[2] = Round_Keys[4*(i-1) + 2];
+        temp[3] = Round_Keys[4*(i-1) + 3];
+
+        if ((i % 8) == 0)
+        {
+            // RotWord, SubWord, and XOR with Rcon
+            t = temp[0];
+            temp[0] = SBOX[temp[1]] ^ RCON[(i/8) - 1];
+            temp[1] = SBOX[temp[2]];
+            temp[2] = SBOX[temp[3]];
+            temp[3] = SBOX[t];
+        }
+        else if ((i % 8) == 4)
+        {
+            temp[0] = SBOX[temp[0]];
+            temp[1] = SBOX[temp[1]];
+            temp[2] = SBOX[temp[2]];
+            temp[3] = SBOX[temp[3]];
+        }
+
+        Round_Keys[4*i + 0] = Round_Keys[4*(i-8) + 0] ^ temp[0];
+        Round_Keys[4*i + 1] = Round_Keys[4*(i-8) + 1] ^ temp[1];
+        Round_Keys[4*i + 2] = Round_Keys[4*(i-8) + 2] ^ temp[2];
+        Round_Keys[4*i + 3] = Round_Keys[4*(i-8) + 3] ^ temp[3];
+    }
+}
+
+void AES256_Link_Software_Encrypt_Block(const uint8_t *input, uint8_t *output)
+{
+    uint8_t s[16];
+    uint8_t t[16];
+    int round;
+    int i;
+
+    for (i = 0; i < 16; i++)
+    {
+        s[i] = input[i] ^ Round_Keys[i];
+    }
+
+    for (round = 1; round <= 14; round++)
+    {
+        // SubBytes and ShiftRows. The state is stored column by column.
+        for (i = 0; i < 16; i++)
+        {
+            t[i] = SBOX[s[(i + 4*(i & 0x03)) & 0x0F]];
+        }
+
+        // MixColumns is skipped in the last round
+        if (round < 14)
+        {
+            for (i = 0; i < 16; i += 4)
+            {
+                uint8_t a0 = t[i];
+                uint8_t a1 = t[i+1];
+                uint8_t a2 = t[i+2];
+                uint8_t a3 = t[i+3];
+                uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+                t[i]   = a0 ^ all ^ xtime(a0 ^ a1);
+                t[i+1] = a1 ^ all ^ xtime(a1 ^ a2);
+                t[i+2] = a2 ^ all ^ xtime(a2 ^ a3);
+                t[i+3] = a3 ^ all ^ xtime(a3 ^ a0);
+            }
+        }
+
+        for (i = 0; i < 16; i++)
+        {
+            s[i] = t[i] ^ Round_Keys[16*round + i];
+        }
+    }
+
+    for (i = 0; i < 16; i++)
+    {
+        output[i] = s[i];
+    }
+}
+
+void AES256_Link_Init(const uint8_t *key, const uint8_t *salt)
+{
+    int i;
+
+    // Reset the AES256 accelerator
+    AES256->CTL0 = 0x0080;
+
+    // AESCMEN = 0, AESKLx = 0x2 (256-bit key), AESCMx = 0x0 (ECB), AESOPx = 0x0 (encryption)
+    AES256->CTL0 = 0x0008;
+
+    // Write the key as 16 half-words. The lower byte of each half-word is the first byte.
+    for (i = 0; i < 16; i++)
+    {
+        AES256->KEY = (uint16_t)key[2*i] | ((uint16_t)key[2*i + 1] << 8);
+    }
+
+    // AESKEYWR - Wait until the key has been written
+    while((AES256->STAT & 0x0002) == 0x0000);
+
+    Software_Key_Expansion(key);
+
+    for (i = 0; i < AES256_LINK_SALT_LENGTH; i++)
+    {
+        Link_Salt[i] = salt[i];
+    }
+
+    TX_Frame_Counter_High = 0;
+    TX_Frame_Counter_Low = 0;
+    RX_Frame_Counter_High = 0;
+    RX_Frame_Counter_Low = 0;
+    RX_Frame_Received = 0;
+
+    // Reserve DMA channel 0 (AESTRIGGER0) and DMA channel 1 (AESTRIGGER1) for the keystream
+    if (DMA_Output_Channel < 0)
+    {
+        DMA_Output_Channel = DMA_Allocate(DMA_TRIGGER_AES256_OUTPUT);
+    }
+    if (DMA_Input_Channel < 0)
+    {
+        DMA_Input_Channel = DMA_Allocate(DMA_TRIGGER_AES256_INPUT);
+    }
+}
+
+static void AES256_Write_Block(volatile uint16_t *reg, const uint8_t *input)
+{
+    int i;
+    for (i = 0; i < 16; i += 2)
+    {
+        *reg = (uint16_t)input[i] | ((uint16_t)input[i + 1] << 8);
+    }
+}
+
+static void AES256_Read_Block(uint8_t *output)
+{
+    int i;
+    uint16_t data;
+
+    // AESBUSY - Wait until the AES256 accelerator is not busy
+    while((AES256->STAT & 0x0001) == 0x0001);
+
+    for (i = 0; i < 16; i += 2)
+    {
+        data = AES256->DOUT;
+        output[i] = (uint8_t)data;
+        output[i + 1] = (uint8_t)(data >> 8);
+    }
+}
+
+void AES256_Link_Encrypt_Block(const uint8_t *input, uint8_t *output)
+{
+    AES256_Write_Block(&AES256->DIN, input);
+    AES256_Read_Block(output);
+}
+
+static void Build_Nonce(uint8_t *nonce)
+{
+    int i;
+
+    for (i = 0; i < AES256_LINK_SALT_LENGTH; i++)
+    {
+        nonce[i] = Link_Salt[i];
+    }
+
+    // The frame counter is stored in big-endian order
+    for (i = 0; i < 4; i++)
+    {
+        nonce[AES256_LINK_SALT_LENGTH + i] = (uint8_t)(TX_Frame_Counter_High >> (24 - 8*i));
+        nonce[AES256_LINK_SALT_LENGTH + 4 + i] = (uint8_t)(TX_Frame_Counter_Low >> (24 - 8*i));
+    }
+
+    TX_Frame_Counter_Low = TX_Frame_Counter_Low + 1;
+    if (TX_Frame_Counter_Low == 0)
+    {
+        TX_Frame_Counter_High = TX_Frame_Counter_High + 1;
+    }
+}
+
+static void Build_B0(const uint8_t *nonce, uint8_t length, uint8_t *b0)
+{
+    int i;
+    b0[0] = CCM_B0_FLAGS;
+    for (i = 0; i < AES256_LINK_NONCE_LENGTH; i++)
+    {
+        b0[1 + i] = nonce[i];
+    }
+    b0[14] = 0x00;
+    b0[15] = length;
+}
+
+static uint8_t Build_Counter_Blocks(const uint8_t *nonce, uint8_t length)
+{
+    uint8_t block_count = ((length + 15) / 16) + 1;
+    uint8_t *block;
+    int i;
+    int j;
+
+    for (i = 0; i < block_count; i++)
+    {
+        block = &Counter_Blocks[16*i];
+        block[0] = CCM_A_FLAGS;
+        for (j = 0; j < AES256_LINK_NONCE_LENGTH; j++)
+        {
+            block[1 + j] = nonce[j];
+        }
+        block[14] = 0x00;
+        block[15] = (uint8_t)i;
+    }
+
+    return block_count;
+}
+
+/**
+ * @brief Starts the encryption of the counter blocks by the AES256 accelerator fed by DMA channels 0 and 1.
+ *
+ * The AES256 accelerator raises AES trigger 1 when it is ready for the next input block and AES trigger 0
+ * when an output block is ready. Each trigger moves one block of 8 half-words.
+ * If the channels are used by another driver, the CPU feeds the accelerator instead.
+ */
+static void Keystream_DMA_Start(uint8_t block_count)
+{
+    uint32_t transfers = 8 * (uint32_t)block_count;
+    int i;
+
+    if ((DMA_Output_Channel < 0) || (DMA_Input_Channel < 0))
+    {
+        for (i = 0; i < block_count; i++)
+        {
+            AES256_Link_Encrypt_Block(&Counter_Blocks[16*i], &Keystream[16*i]);
+        }
+        return;
+    }
+
+    // Output channel: reads AESADOUT into the keystream buffer, one block (8 half-words) per trigger
+    DMA_Set_Transfer(DMA_Primary(DMA_Output_Channel), DMA_SIZE_16 | DMA_SRC_FIXED | DMA_ARBITRATE(3) | DMA_MODE_BASIC,
+                     &AES256->DOUT, Keystream, transfers);
+
+    // Input channel: writes the counter blocks into AESADIN
+    DMA_Set_Transfer(DMA_Primary(DMA_Input_Channel), DMA_SIZE_16 | DMA_DST_FIXED | DMA_ARBITRATE(3) | DMA_MODE_BASIC,
+                     Counter_Blocks, &AES256->DIN, transfers);
+
+    DMA_Enable(DMA_Output_Channel);
+    DMA_Enable(DMA_Input_Channel);
+
+    // AESCMEN = 1 (DMA cipher mode), AESKLx = 0x2 (256-bit key), AESCMx = 0x0 (ECB), AESOPx = 0x0 (encryption)
+    AES256->CTL0 = 0x8008;
+
+    // Writing the block count starts the DMA cipher mode operation
+    AES256->CTL1 = block_count;
+}
+
+static void Keystream_DMA_Wait()
+{
+    // The channels are disabled by the controller when the cycle completes
+    if ((DMA_Output_Channel >= 0) && (DMA_Input_Channel >= 0))
+    {
+        while(DMA_Is_Enabled(DMA_Output_Channel) || DMA_Is_Enabled(DMA_Input_Channel));
+    }
+
+    // AESBUSY - Wait until the last block has been processed
+    while((AES256->STAT & 0x0001) == 0x0001);
+
+    // Return to CPU-fed ECB encryption for the CBC-MAC
+    AES256->CTL0 = 0x0008;
+}
+
+static void Software_Keystream(uint8_t block_count)
+{
+    int i;
+    for (i = 0; i < block_count; i++)
+    {
+        AES256_Link_Software_Encrypt_Block(&Counter_Blocks[16*i], &Keystream[16*i]);
+    }
+}
+
+static void Software_CBC_MAC(const uint8_t *b0, const uint8_t *plaintext, uint8_t length, uint8_t *mac)
+{
+    uint8_t block[16];
+    int offset;
+    int i;
+
+    AES256_Link_Software_Encrypt_Block(b0, mac);
+
+    for (offset = 0; offset < length; offset += 16)
+    {
+        for (i = 0; i < 16; i++)
+        {
+            block[i] = mac[i] ^ (((offset + i) < length) ? plaintext[offset + i] : 0x00);
+        }
+        AES256_Link_Software_Encrypt_Block(block, mac);
+    }
+}
+
+/**
+ * @brief Feeds one payload block into the running CBC-MAC through AESAXDIN.
+ *
+ * AESAXDIN XORs the written data with the current state of the accelerator and starts the encryption
+ * of the result. The final block is zero-padded.
+ */
+static void Hardware_CBC_MAC_Update(const uint8_t *plaintext, uint8_t remaining)
+{
+    uint8_t block[16];
+    int i;
+
+    for (i = 0; i < 16; i++)
+    {
+        block[i] = (i < remaining) ? plaintext[i] : 0x00;
+    }
+
+    // AESBUSY - Wait until the previous block has been processed
+    while((AES256->STAT & 0x0001) == 0x0001);
+
+    AES256_Write_Block(&AES256->XDIN, block);
+}
+
+static void Hardware_CBC_MAC(const uint8_t *b0, const uint8_t *plaintext, uint8_t length, uint8_t *mac)
+{
+    int offset;
+
+    AES256_Write_Block(&AES256->DIN, b0);
+
+    for (offset = 0; offset < length; offset += 16)
+    {
+        Hardware_CBC_MAC_Update(&plaintext[offset], (uint8_t)(length - offset));
+    }
+
+    AES256_Read_Block(mac);
+}
+
+static int Seal(const uint8_t *plaintext, uint8_t length, uint8_t *frame, uint8_t use_hardware)
+{
+    uint8_t b0[16];
+    uint8_t mac[16];
+    uint8_t *nonce = &frame[2];
+    uint8_t block_count;
+    int i;
+
+    if (length > AES256_LINK_MAX_PAYLOAD)
+    {
+        return AES256_LINK_ERROR_LENGTH;
+    }
+
+    frame[0] = AES256_LINK_SYNC;
+    frame[1] = length;
+    Build_Nonce(nonce);
+    Build_B0(nonce, length, b0);
+    block_count = Build_Counter_Blocks(nonce, length);
+
+    if (use_hardware)
+    {
+        Keystream_DMA_Start(block_count);
+        Keystream_DMA_Wait();
+        Hardware_CBC_MAC(b0, plaintext, length, mac);
+    }
+    else
+    {
+        Software_Keystream(block_count);
+        Software_CBC_MAC(b0, plaintext, length, mac);
+    }
+
+    // The payload is encrypted with the keystream blocks S1, S2, ...
+    for (i = 0; i < length; i++)
+    {
+        frame[AES256_LINK_HEADER_LENGTH + i] = plaintext[i] ^ Keystream[16 + i];
+    }
+
+    // The tag is encrypted with the keystream block S0
+    for (i = 0; i < AES256_LINK_TAG_LENGTH; i++)
+    {
+        frame[AES256_LINK_HEADER_LENGTH + length + i] = mac[i] ^ Keystream[i];
+    }
+
+    return AES256_LINK_HEADER_LENGTH + length + AES256_LINK_TAG_LENGTH;
+}
+
+int AES256_Link_Seal(const uint8_t *plaintext, uint8_t length, uint8_t *frame)
+{
+    return Seal(plaintext, length, frame, 1);
+}
+
+int AES256_Link_Seal_Software(const uint8_t *plaintext, uint8_t length, uint8_t *frame)
+{
+    return Seal(plaintext, length, frame, 0);
+}
+
+int AES256_Link_Open(const uint8_t *frame, uint16_t frame_length, uint8_t *plaintext)
+{
+    const uint8_t *nonce = &frame[2];
+    uint8_t b0[16];
+    uint8_t mac[16];
+    uint8_t length;
+    uint8_t block_count;
+    uint8_t difference = 0;
+    uint8_t reflected = 1;
+    uint32_t counter_high = 0;
+    uint32_t counter_low = 0;
+    int i;
+
+    if ((frame_length < (AES256_LINK_HEADER_LENGTH + AES256_LINK_TAG_LENGTH)) || (frame[0] != AES256_LINK_SYNC))
+    {
+        return AES256_LINK_ERROR_FORMAT;
+    }
+
+    length = frame[1];
+    if ((length > AES256_LINK_MAX_PAYLOAD) || (frame_length != (AES256_LINK_HEADER_LENGTH + length + AES256_LINK_TAG_LENGTH)))
+    {
+        return AES256_LINK_ERROR_LENGTH;
+    }
+
+    // Reject frames that carry the local salt: they were sent by this end and reflected back
+    for (i = 0; i < AES256_LINK_SALT_LENGTH; i++)
+    {
+        if (nonce[i] != Link_Salt[i])
+        {
+            reflected = 0;
+        }
+    }
+    if (reflected)
+    {
+        return AES256_LINK_ERROR_REFLECTED;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        counter_high = (counter_high << 8) | nonce[AES256_LINK_SALT_LENGTH + i];
+        counter_low = (counter_low << 8) | nonce[AES256_LINK_SALT_LENGTH + 4 + i];
+    }
+
+    // Reject frames that do not advance the frame counter
+    if (RX_Frame_Received && ((counter_high < RX_Frame_Counter_High) ||
+        ((counter_high == RX_Frame_Counter_High) && (counter_low <= RX_Frame_Counter_Low))))
+    {
+        return AES256_LINK_ERROR_REPLAY;
+    }
+
+    block_count = Build_Counter_Blocks(nonce, length);
+    Keystream_DMA_Start(block_count);
+    Keystream_DMA_Wait();
+
+    for (i = 0; i < length; i++)
+    {
+        plaintext[i] = frame[AES256_LINK_HEADER_LENGTH + i] ^ Keystream[16 + i];
+    }
+
+    Build_B0(nonce, length, b0);
+    Hardware_CBC_MAC(b0, plaintext, length, mac);
+
+    // Compare the tags in constant time
+    for (i = 0; i < AES256_LINK_TAG_LENGTH; i++)
+    {
+        difference |= (mac[i] ^ Keystream[i]) ^ frame[AES256_LINK_HEADER_LENGTH + length + i];
+    }
+
+    if (difference != 0)
+    {
+        for (i = 0; i < length; i++)
+        {
+            plaintext[i] = 0x00;
+        }
+        return AES256_LINK_ERROR_TAG;
+    }
+
+    RX_Frame_Counter_High = counter_high;
+    RX_Frame_Counter_Low = counter_low;
+    RX_Frame_Received = 1;
+
+    return length;
+}
+
+int AES256_Link_Send(const uint8_t *plaintext, uint8_t length)
+{
+    uint8_t nonce[AES256_LINK_NONCE_LENGTH];
+    uint8_t b0[16];
+    uint8_t mac[16];
+    uint8_t block_count;
+    int offset;
+    int i;
+
+    if (length > AES256_LINK_MAX_PAYLOAD)
+    {
+        return AES256_LINK_ERROR_LENGTH;
+    }
+
+    Build_Nonce(nonce);
+    Build_B0(nonce, length, b0);
+    block_count = Build_Counter_Blocks(nonce, length);
+
+    // Generate the keystream while the header is being transmitted
+    Keystream_DMA_Start(block_count);
+
+    EUSCI_A2_UART_OutChar(AES256_LINK_SYNC);
+    EUSCI_A2_UART_OutChar(length);
+    for (i = 0; i < AES256_LINK_NONCE_LENGTH; i++)
+    {
+        EUSCI_A2_UART_OutChar(nonce[i]);
+    }
+
+    Keystream_DMA_Wait();
+
+    // Start the CBC-MAC with B0
+    AES256_Write_Block(&AES256->DIN, b0);
+
+    // Each block is fed into the CBC-MAC before its ciphertext is transmitted,
+    // so the AES256 accelerator runs while the UART shifts out the block
+    for (offset = 0; offset < length; offset += 16)
+    {
+        Hardware_CBC_MAC_Update(&plaintext[offset], (uint8_t)(length - offset));
+
+        for (i = offset; (i < (offset + 16)) && (i < length); i++)
+        {
+            EUSCI_A2_UART_OutChar(plaintext[i] ^ Keystream[16 + i]);
+        }
+    }
+
+    AES256_Read_Block(mac);
+
+    for (i = 0; i < AES256_LINK_TAG_LENGTH; i++)
+    {
+        EUSCI_A2_UART_OutChar(mac[i] ^ Keystream[i]);
+    }
+
+    return AES256_LINK_HEADER_LENGTH + length + AES256_LINK_TAG_LENGTH;
+}
+
+int AES256_Link_Receive(uint8_t *plaintext)
+{
+    static uint8_t frame[AES256_LINK_MAX_FRAME];
+    uint16_t frame_length;
+    int i;
+
+    // Wait for the start of a frame
+    while(EUSCI_A2_UART_InChar() != AES256_LINK_SYNC);
+
+    frame[0] = AES256_LINK_SYNC;
+    frame[1] = EUSCI_A2_UART_InChar();
+
+    if (frame[1] > AES256_LINK_MAX_PAYLOAD)
+    {
+        return AES256_LINK_ERROR_LENGTH;
+    }
+
+    frame_length = AES256_LINK_HEADER_LENGTH + frame[1] + AES256_LINK_TAG_LENGTH;
+    for (i = 2; i < frame_length; i++)
+    {
+        frame[i] = EUSCI_A2_UART_InChar();
+    }
+
+    return AES256_Link_Open(frame, frame_length, plaintext);
+}
+
+static void Cycle_Counter_Init()
+{
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+int AES256_Link_Benchmark()
+{
+    // FIPS-197 Appendix C.3 (AES-256) known-answer vector
+    static const uint8_t fips_key[32] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+    };
+    static const uint8_t fips_plaintext[16] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+    };
+    static const uint8_t fips_ciphertext[16] = {
+        0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF, 0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89
+    };
+    static const uint8_t salt[AES256_LINK_SALT_LENGTH] = {0x52, 0x53, 0x4C, 0x4B, 0x01};
+    static const uint8_t peer_salt[AES256_LINK_SALT_LENGTH] = {0x52, 0x53, 0x4C, 0x4B, 0x02};
+
+    static uint8_t payload[AES256_LINK_MAX_PAYLOAD];
+    static uint8_t hardware_frame[AES256_LINK_MAX_FRAME];
+    static uint8_t software_frame[AES256_LINK_MAX_FRAME];
+    static uint8_t decrypted[AES256_LINK_MAX_PAYLOAD];
+
+    uint8_t output[16];
+    uint32_t start;
+    uint32_t hardware_cycles;
+    uint32_t software_cycles;
+    uint32_t plaintext_cycles;
+    uint32_t link_cycles;
+    int frame_length;
+    int result = 0;
+    int i;
+
+    AES256_Link_Init(fips_key, salt);
+    Cycle_Counter_Init();
+
+    AES256_Link_Encrypt_Block(fips_plaintext, output);
+    for (i = 0; i < 16; i++)
+    {
+        if (output[i] != fips_ciphertext[i]) result = -1;
+    }
+    printf("FIPS-197 AES-256 (hardware): %s\n", (result == 0) ? "PASS" : "FAIL");
+
+    AES256_Link_Software_Encrypt_Block(fips_plaintext, output);
+    for (i = 0; i < 16; i++)
+    {
+        if (output[i] != fips_ciphertext[i]) result = -1;
+    }
+    printf("FIPS-197 AES-256 (software): %s\n", (result == 0) ? "PASS" : "FAIL");
+
+    for (i = 0; i < AES256_LINK_MAX_PAYLOAD; i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+
+    // Seal the same payload with the same frame counter using both implementations
+    AES256_Link_Init(fips_key, salt);
+    start = DWT->CYCCNT;
+    frame_length = AES256_Link_Seal(payload, AES256_LINK_MAX_PAYLOAD, hardware_frame);
+    hardware_cycles = DWT->CYCCNT - start;
+
+    AES256_Link_Init(fips_key, salt);
+    start = DWT->CYCCNT;
+    AES256_Link_Seal_Software(payload, AES256_LINK_MAX_PAYLOAD, software_frame);
+    software_cycles = DWT->CYCCNT - start;
+
+    for (i = 0; i < frame_length; i++)
+    {
+        if (hardware_frame[i] != software_frame[i]) result = -1;
+    }
+    printf("CCM frame (hardware vs. software): %s\n", (result == 0) ? "PASS" : "FAIL");
+
+    // The sender keeps its own salt, so the frame is refused as reflected. The receiver has the other salt.
+    if (AES256_Link_Open(hardware_frame, frame_length, decrypted) != AES256_LINK_ERROR_REFLECTED) result = -1;
+    AES256_Link_Init(fips_key, peer_salt);
+    if (AES256_Link_Open(hardware_frame, frame_length, decrypted) != AES256_LINK_MAX_PAYLOAD) result = -1;
+    for (i = 0; i < AES256_LINK_MAX_PAYLOAD; i++)
+    {
+        if (decrypted[i] != payload[i]) result = -1;
+    }
+    if (AES256_Link_Open(hardware_frame, frame_length, decrypted) != AES256_LINK_ERROR_REPLAY) result = -1;
+    printf("CCM open, reflection and replay checks: %s\n", (result == 0) ? "PASS" : "FAIL");
+
+    // Transmit the payload as plaintext, then as an encrypted frame
+    start = DWT->CYCCNT;
+    for (i = 0; i < AES256_LINK_MAX_PAYLOAD; i++)
+    {
+        EUSCI_A2_UART_OutChar(payload[i]);
+    }
+    EUSCI_A_UART_Flush(EUSCI_A2_UART_PORT);
+    plaintext_cycles = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    AES256_Link_Send(payload, AES256_LINK_MAX_PAYLOAD);
+    EUSCI_A_UART_Flush(EUSCI_A2_UART_PORT);
+    link_cycles = DWT->CYCCNT - start;
+
+    printf("Seal %u bytes (hardware): %u cycles\n", AES256_LINK_MAX_PAYLOAD, hardware_cycles);
+    printf("Seal %u bytes (software): %u cycles\n", AES256_LINK_MAX_PAYLOAD, software_cycles);
+    printf("Send %u bytes (plaintext): %u cycles\n", AES256_LINK_MAX_PAYLOAD, plaintext_cycles);
+    printf("Send %u bytes (frame, %d bytes on the wire): %u cycles\n", AES256_LINK_MAX_PAYLOAD, frame_length, link_cycles);
+
+    return result;
+}
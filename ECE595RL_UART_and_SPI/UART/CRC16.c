@@ -0,0 +1,33 @@
+/**
+ * @file CRC16.c
+ * @brief Source code for the CRC16 library.
+ *
+ * This file contains the function definitions for the CRC16 library.
+ * The CRC is computed one bit at a time, which needs no table in flash.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/CRC16.h"
+
+uint16_t CRC16_Update(uint16_t crc, uint8_t data)
+{
+    int bit;
+
+    crc ^= (uint16_t)data << 8;
+    for (bit = 0; bit < 8; bit++)
+    {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+}
+
+uint16_t CRC16_Compute(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    while(length--)
+    {
+        crc = CRC16_Update(crc, *data++);
+    }
+    return crc;
+}
@@ -44,6 +44,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/Clock.h"
+#include "../inc/Register_Fields.h"
 
 uint32_t ClockFrequency = 3000000; // cycles/second
 //static uint32_t SubsystemFrequency = 3000000; // cycles/second
@@ -102,12 +103,11 @@ void Clock_Init48MHz(void){
   PJ->SEL1 &= ~0x0C;                    // configure built-in 48 MHz crystal for HFXT operation
 //  PJDIR |= 0x08;                      // make PJ.3 HFXTOUT (unnecessary)
 //  PJDIR &= ~0x04;                     // make PJ.2 HFXTIN (unnecessary)
-  CS->KEY = 0x695A;                     // unlock CS module for register access
-  CS->CTL2 = (CS->CTL2&~0x00700000) |   // clear HFXTFREQ bit field
-           0x00600000 |                 // configure for 48 MHz external crystal
-           0x00010000 |                 // HFXT oscillator drive selection for crystals >4 MHz
-           0x01000000;                  // enable HFXT
-  CS->CTL2 &= ~0x02000000;              // disable high-frequency crystal bypass
+  CS->KEY = CS_KEY_VAL;                 // unlock CS module for register access
+  REGISTER_MODIFY(CS->CTL2, CS_CTL2_HFXTFREQ_MASK | CS_CTL2_HFXTBYPASS,  // clear HFXTFREQ bit field and disable high-frequency crystal bypass
+           REGISTER_FIELD(CS_CTL2_HFXTFREQ, 6) |    // configure for 48 MHz external crystal
+           CS_CTL2_HFXTDRIVE |          // HFXT oscillator drive selection for crystals >4 MHz
+           CS_CTL2_HFXT_EN);            // enable HFXT
   // wait for the HFXT clock to stabilize
   while(CS->IFG&0x00000002){
     CS->CLRIFG = 0x00000002;              // clear the HFXT oscillator interrupt flag
@@ -120,11 +120,11 @@ void Clock_Init48MHz(void){
   FLCTL->BANK0_RDCTL = (FLCTL->BANK0_RDCTL&~0x0000F000)|FLCTL_BANK0_RDCTL_WAIT_2;
   // configure for 2 wait states (minimum for 48 MHz operation) for flash Bank 1
   FLCTL->BANK1_RDCTL = (FLCTL->BANK1_RDCTL&~0x0000F000)|FLCTL_BANK1_RDCTL_WAIT_2;
-  CS->CTL1 = 0x20000000 |               // configure for SMCLK divider /4
-           0x00100000 |                 // configure for HSMCLK divider /2
-           0x00000200 |                 // configure for ACLK sourced from REFOCLK
-           0x00000050 |                 // configure for SMCLK and HSMCLK sourced from HFXTCLK
-           0x00000005;                  // configure for MCLK sourced from HFXTCLK
+  CS->CTL1 = REGISTER_FIELD(CS_CTL1_DIVS, 2) |  // configure for SMCLK divider /4
+           REGISTER_FIELD(CS_CTL1_DIVHS, 1) |   // configure for HSMCLK divider /2
+           REGISTER_FIELD(CS_CTL1_SELA, 2) |    // configure for ACLK sourced from REFOCLK
+           REGISTER_FIELD(CS_CTL1_SELS, 5) |    // configure for SMCLK and HSMCLK sourced from HFXTCLK
+           REGISTER_FIELD(CS_CTL1_SELM, 5);     // configure for MCLK sourced from HFXTCLK
   CS->KEY = 0;                          // lock CS module from unintended access
   ClockFrequency = 48000000;
 //  SubsystemFrequency = 12000000;
@@ -0,0 +1,338 @@
+/**
+ * @file DMA.c
+ * @brief Source code for the DMA driver.
+ *
+ * This file contains the function definitions for the DMA driver.
+ * It owns the channel control structure, allocates the channels and dispatches the completion
+ * interrupts (DMA_INT0 to DMA_INT3) to the callbacks of the channels.
+ *
+ * For more information regarding the DMA controller, refer to the DMA (11) section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/DMA.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/Trace.h"
+
+// IRQ numbers of the completion interrupts (section 2.4.3.20)
+#define DMA_INT0_IRQ        34
+#define DMA_INT1_IRQ        33
+#define DMA_INT2_IRQ        32
+#define DMA_INT3_IRQ        31
+
+// Control word of the primary structure of a scatter-gather channel: each task is copied as four words
+// (arbitrate after 4 transfers) into the alternate structure of the channel
+#define SCATTER_GATHER_CONTROL  (DMA_SIZE_32 | DMA_ARBITRATE(2))
+
+// Primary control structure for channels 0 to 7, followed by the alternate structure.
+// The controller requires the base address to be aligned to 256 bytes.
+#pragma DATA_ALIGN(DMA_Control_Table, 256)
+static DMA_Descriptor DMA_Control_Table[2 * DMA_CHANNEL_COUNT];
+
+static uint8_t Initialized;
+static uint8_t Allocated;               // One bit per allocated channel
+static uint8_t Shared_Interrupt;        // One bit per channel using DMA_INT0
+
+// Callback of each channel, and channel of DMA_INT1 to DMA_INT3 (-1 if free)
+static void (*Callbacks[DMA_CHANNEL_COUNT])(uint8_t channel);
+static int8_t Interrupt_Channel[4] = {-1, -1, -1, -1};
+
+static const uint8_t Interrupt_IRQ[4] = {DMA_INT0_IRQ, DMA_INT1_IRQ, DMA_INT2_IRQ, DMA_INT3_IRQ};
+
+static void Enable_IRQ(uint8_t irq, uint8_t priority)
+{
+    NVIC->IP[irq] = (priority << 5);
+    NVIC->ISER[irq >> 5] = (1 << (irq & 0x1F));
+}
+
+/**
+ * @brief Writes INTn_SRCCFG: bit 5 enables the interrupt, bits 4-0 select the channel.
+ */
+static void Set_Interrupt_Source(uint8_t interrupt, uint32_t value)
+{
+    switch(interrupt)
+    {
+        case 1: DMA_Channel->INT1_SRCCFG = value; break;
+        case 2: DMA_Channel->INT2_SRCCFG = value; break;
+        case 3: DMA_Channel->INT3_SRCCFG = value; break;
+    }
+}
+
+/**
+ * @brief Returns the address of the last item of a transfer, for an address increment field of the control word.
+ */
+static volatile const void *End_Address(volatile const void *start, uint32_t increment, uint16_t count)
+{
+    if (increment == 0x3)
+    {
+        return start;
+    }
+
+    return (volatile const uint8_t *)start + ((uint32_t)(count - 1) << increment);
+}
+
+void DMA_Init()
+{
+    if (Initialized)
+    {
+        return;
+    }
+
+    // Enable the controller and set the base address of the control structure
+    DMA_Control->ENACLR = 0xFF;
+    DMA_Control->CFG = 0x01;
+    DMA_Control->CTLBASE = (uint32_t)DMA_Control_Table;
+    Initialized = 1;
+}
+
+int DMA_Allocate(uint8_t trigger)
+{
+    uint32_t section;
+    int channel;
+
+    DMA_Init();
+
+    section = Critical_Section_Enter();
+
+    if (trigger == DMA_TRIGGER_SOFTWARE)
+    {
+        for (channel = DMA_CHANNEL_COUNT - 1; (channel >= 0) && (Allocated & (1 << channel)); channel--);
+    }
+    else
+    {
+        channel = trigger >> 3;
+        if ((channel >= DMA_CHANNEL_COUNT) || (Allocated & (1 << channel)))
+        {
+            channel = -1;
+        }
+    }
+
+    if (channel < 0)
+    {
+        Critical_Section_Exit(section);
+        return DMA_ERROR_BUSY;
+    }
+
+    Allocated |= (1 << channel);
+    Critical_Section_Exit(section);
+
+    // Source 0 is not connected, so a software channel is only started by DMA_Request
+    DMA_Channel->CH_SRCCFG[channel] = (trigger == DMA_TRIGGER_SOFTWARE) ? 0 : (trigger & 0x07);
+    DMA_Control->ENACLR = (1 << channel);
+    DMA_Control->ALTCLR = (1 << channel);
+    DMA_Control->USEBURSTCLR = (1 << channel);
+    DMA_Control->REQMASKCLR = (1 << channel);
+    DMA_Control->PRIOCLR = (1 << channel);
+
+    return channel;
+}
+
+void DMA_Free(uint8_t channel)
+{
+    uint32_t section;
+
+    DMA_Disable(channel);
+    DMA_Set_Callback(channel, 0, 0);
+
+    section = Critical_Section_Enter();
+    Allocated &= ~(1 << channel);
+    Critical_Section_Exit(section);
+}
+
+DMA_Descriptor *DMA_Primary(uint8_t channel)
+{
+    return &DMA_Control_Table[channel];
+}
+
+DMA_Descriptor *DMA_Alternate(uint8_t channel)
+{
+    return &DMA_Control_Table[DMA_CHANNEL_COUNT + channel];
+}
+
+void DMA_Set_Transfer(DMA_Descriptor *descriptor, uint32_t control, volatile const void *source,
+                      volatile void *destination, uint16_t count)
+{
+    descriptor->src_end = End_Address(source, (control >> 26) & 0x3, count);
+    descriptor->dst_end = (volatile void *)End_Address(destination, (control >> 30) & 0x3, count);
+    descriptor->control = (control & ~DMA_COUNT_MASK) | ((uint32_t)(count - 1) << 4);
+}
+
+int DMA_Set_Scatter_Gather(uint8_t channel, DMA_Descriptor *tasks, uint16_t task_count, uint8_t peripheral)
+{
+    uint32_t mode = peripheral ? DMA_MODE_PERIPHERAL_SCATTER_GATHER : DMA_MODE_MEMORY_SCATTER_GATHER;
+    uint16_t i;
+
+    if ((task_count == 0) || (task_count > (DMA_MAX_TRANSFERS / 4)))
+    {
+        return DMA_ERROR_LENGTH;
+    }
+
+    // Every task but the last one continues with the next task. The last one is a basic cycle
+    // (peripheral) or an auto cycle (memory), after which the channel completes.
+    for (i = 0; i < task_count; i++)
+    {
+        tasks[i].control &= ~DMA_MODE_MASK;
+        if (i < (task_count - 1))
+        {
+            tasks[i].control |= mode + DMA_MODE_ALTERNATE;
+        }
+        else
+        {
+            tasks[i].control |= peripheral ? DMA_MODE_BASIC : DMA_MODE_AUTO;
+        }
+    }
+
+    DMA_Set_Transfer(DMA_Primary(channel), SCATTER_GATHER_CONTROL | mode, tasks, DMA_Alternate(channel), 4 * task_count);
+
+    return 0;
+}
+
+void DMA_Enable(uint8_t channel)
+{
+    DMA_Control->ALTCLR = (1 << channel);
+    DMA_Control->ENASET = (1 << channel);
+}
+
+void DMA_Disable(uint8_t channel)
+{
+    DMA_Control->ENACLR = (1 << channel);
+}
+
+uint8_t DMA_Is_Enabled(uint8_t channel)
+{
+    return (DMA_Control->ENASET & (1 << channel)) ? 1 : 0;
+}
+
+void DMA_Request(uint8_t channel)
+{
+    DMA_Channel->SW_CHTRIG = (1 << channel);
+}
+
+uint16_t DMA_Get_Remaining(uint8_t channel)
+{
+    uint32_t control = DMA_Control_Table[channel].control;
+
+    // The controller writes the mode back as DMA_MODE_STOP at the end of the cycle
+    if ((control & DMA_MODE_MASK) == DMA_MODE_STOP)
+    {
+        return 0;
+    }
+
+    return ((control & DMA_COUNT_MASK) >> 4) + 1;
+}
+
+uint8_t DMA_Is_Alternate(uint8_t channel)
+{
+    return (DMA_Control->ALTSET & (1 << channel)) ? 1 : 0;
+}
+
+void DMA_Set_High_Priority(uint8_t channel, uint8_t high)
+{
+    if (high)
+    {
+        DMA_Control->PRIOSET = (1 << channel);
+    }
+    else
+    {
+        DMA_Control->PRIOCLR = (1 << channel);
+    }
+}
+
+void DMA_Set_Callback(uint8_t channel, void (*callback)(uint8_t channel), uint8_t priority)
+{
+    uint32_t section;
+    uint8_t interrupt;
+
+    section = Critical_Section_Enter();
+
+    // Find the interrupt already used by the channel, if any
+    for (interrupt = 1; (interrupt < 4) && (Interrupt_Channel[interrupt] != channel); interrupt++);
+
+    if (callback == 0)
+    {
+        Callbacks[channel] = 0;
+        Shared_Interrupt &= ~(1 << channel);
+        if (interrupt < 4)
+        {
+            Set_Interrupt_Source(interrupt, 0);
+            Interrupt_Channel[interrupt] = -1;
+        }
+        Critical_Section_Exit(section);
+        return;
+    }
+
+    if (interrupt == 4)
+    {
+        for (interrupt = 1; (interrupt < 4) && (Interrupt_Channel[interrupt] >= 0); interrupt++);
+    }
+
+    Callbacks[channel] = callback;
+    if (interrupt < 4)
+    {
+        // Map the completion of the channel to its own interrupt
+        Interrupt_Channel[interrupt] = channel;
+        Set_Interrupt_Source(interrupt, 0x20 | channel);
+        Enable_IRQ(Interrupt_IRQ[interrupt], priority);
+    }
+    else
+    {
+        Shared_Interrupt |= (1 << channel);
+        Enable_IRQ(DMA_INT0_IRQ, DMA_INT0_PRIORITY);
+    }
+
+    Critical_Section_Exit(section);
+}
+
+static void Dispatch(uint8_t interrupt)
+{
+    int8_t channel = Interrupt_Channel[interrupt];
+
+    TRACE_ISR_ENTER(TRACE_ID_DMA);
+
+    if ((channel >= 0) && Callbacks[channel])
+    {
+        Callbacks[channel](channel);
+    }
+
+    TRACE_ISR_EXIT(TRACE_ID_DMA);
+}
+
+void DMA_INT0_IRQHandler(void)
+{
+    // INT0_SRCFLG has one bit for each channel that completed and is not mapped to DMA_INT1 to DMA_INT3
+    uint32_t flags = DMA_Channel->INT0_SRCFLG;
+    uint8_t channel;
+
+    TRACE_ISR_ENTER(TRACE_ID_DMA);
+
+    DMA_Channel->INT0_CLRFLG = flags;
+    flags &= Shared_Interrupt;
+
+    for (channel = 0; flags; channel++, flags >>= 1)
+    {
+        if ((flags & 0x01) && Callbacks[channel])
+        {
+            Callbacks[channel](channel);
+        }
+    }
+
+    TRACE_ISR_EXIT(TRACE_ID_DMA);
+}
+
+void DMA_INT1_IRQHandler(void)
+{
+    Dispatch(1);
+}
+
+void DMA_INT2_IRQHandler(void)
+{
+    Dispatch(2);
+}
+
+void DMA_INT3_IRQHandler(void)
+{
+    Dispatch(3);
+}
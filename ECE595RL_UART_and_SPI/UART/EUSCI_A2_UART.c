@@ -3,6 +3,7 @@
  * @brief Source code for the EUSCI_A2_UART driver.
  *
  * This file contains the function definitions for the EUSCI_A2_UART driver.
+ * The functions are implemented on top of the EUSCI_A_UART driver.
  *
  * @note Assumes that the necessary pin configurations for UART communication have been performed
  *       on the corresponding pins. P3.2 is used for UART RX while P3.3 is used for UART TX.
@@ -19,81 +20,24 @@
 
 void EUSCI_A2_UART_Init()
 {
-    // Hold the EUSCI_A2 module in reset mode
-    EUSCI_A2->CTLW0 |= 0x01;
-
-    // Set all the bits of the modulation control register to zero
-    EUSCI_A2->MCTLW &= ~0xFF;
-
-    // Hold the EUSCI_A2 module in reset mode
-    // Set the clock source to SMCLK
-    // MSB first
-    EUSCI_A2->CTLW0 |= 0x20C1;
-
-    // Set the baud rate
-    // N = (Clock Frequency) / (Baud Rate) = (12,000,000 / 115,200) = 104.1667
-    // Use only the integer part, so N = 104
-    EUSCI_A2->BRW |= 104;
-
-    // Configure P3.2 and P3.3 as primary module function
-    P3->SEL0 |= 0x0C;
-    P3->SEL1 &= ~0x0C;
-
-    // Clear the software reset bit to enable the EUSCI_A2 module
-    EUSCI_A2->CTLW0 &= ~0x01;
-
-    // Ensure that the following interrupts are disabled:
-    // - Receive Interrupt
-    // - Transmit Interrupt
-    // - Start Bit Interrupt
-    // - Transmit Complete Interrupt
-    EUSCI_A2->IE &= ~0x0F;
+    // 115200 baud, 8 data bits, no parity, 1 stop bit, MSB first
+    static const EUSCI_A_UART_Config config = EUSCI_A_UART_CONFIG(115200, EUSCI_A_UART_PARITY_NONE, 8, 1, EUSCI_A_UART_MSB_FIRST);
+    EUSCI_A_UART_Init(EUSCI_A2_UART_PORT, &config);
 }
 
 void EUSCI_A2_UART_Init_V2()
 {
-    // Hold the EUSCI_A2 module in reset mode
-    EUSCI_A2->CTLW0 |= 0x01;
-
-    // Set all the bits of the modulation control register to zero
-    EUSCI_A2->MCTLW &= ~0xFF;
-
-    // Hold the EUSCI_A2 module in reset mode
-    // Set the clock source to SMCLK~0x
-    // MSB first
-    // Odd parity enabled
-    // stop bit 2
-    EUSCI_A2->CTLW0 |=0xA8C1;
-
-    // Set the baud rate
-    // N = (Clock Frequency) / (Baud Rate) = (12,000,000 / 9600) = 1250
-    // Use only the integer part, so N = 1250
-    EUSCI_A2->BRW |= 1250;
-
-    // Configure P3.2 and P3.3 as primary module function
-    P3->SEL0 |= 0x0C;
-    P3->SEL1 &= ~0x0C;
-
-    // Clear the software reset bit to enable the EUSCI_A2 module
-    EUSCI_A2->CTLW0 &= ~0x01;
-
-    // Ensure that the following interrupts are disabled:
-    // - Receive Interrupt
-    // - Transmit Interrupt
-    // - Start Bit Interrupt
-    // - Transmit Complete Interrupt
-    EUSCI_A2->IE &= ~0x0F;
+    // 9600 baud, 8 data bits, odd parity, 2 stop bits, MSB first
+    static const EUSCI_A_UART_Config config = EUSCI_A_UART_CONFIG(9600, EUSCI_A_UART_PARITY_ODD, 8, 2, EUSCI_A_UART_MSB_FIRST);
+    EUSCI_A_UART_Init(EUSCI_A2_UART_PORT, &config);
 }
 
-
 void EUSCI_A2_UART_OutChar(uint8_t data)
 {
-    while((EUSCI_A2->IFG & 0x02) == 0);
-    EUSCI_A2->TXBUF = data;
+    EUSCI_A_UART_OutChar(EUSCI_A2_UART_PORT, data);
 }
 
 uint8_t EUSCI_A2_UART_InChar()
 {
-    while((EUSCI_A2->IFG & 0x01) == 0);
-    return EUSCI_A2->RXBUF;
+    return EUSCI_A_UART_InChar(EUSCI_A2_UART_PORT);
 }
@@ -0,0 +1,786 @@
+/**
+ * @file EUSCI_A_UART.c
+ * @brief Source code for the EUSCI_A_UART driver.
+ *
+ * This file contains the function definitions for the EUSCI_A_UART driver.
+ * It is an interrupt-driven UART driver shared by all four eUSCI_A modules (EUSCI_A0 to EUSCI_A3).
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
+ * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/EUSCI_A_UART.h"
+#include "../inc/Register_Fields.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/Trace.h"
+
+#define TX_MASK     (EUSCI_A_UART_TX_BUFFER_SIZE - 1)
+#define RX_MASK     (EUSCI_A_UART_RX_BUFFER_SIZE - 1)
+
+const EUSCI_A_UART_Config EUSCI_A_UART_DEFAULT_CONFIG = EUSCI_A_UART_CONFIG(115200, EUSCI_A_UART_PARITY_NONE, 8, 1, EUSCI_A_UART_LSB_FIRST);
+
+/**
+ * @brief Pin-mux description of one UART port.
+ */
+typedef struct
+{
+    EUSCI_A_Type *module;
+    volatile uint8_t *sel0;
+    volatile uint8_t *sel1;
+    uint8_t pins;
+    uint8_t irq;
+} EUSCI_A_UART_Port_Map;
+
+static const EUSCI_A_UART_Port_Map Port_Map[EUSCI_A_UART_NUM_PORTS] = {
+    // Module       SEL0            SEL1            Pins (RX | TX)      IRQ
+    {EUSCI_A0,      &P1->SEL0,      &P1->SEL1,      0x0C,               16},
+    {EUSCI_A1,      &P2->SEL0,      &P2->SEL1,      0x0C,               17},
+    {EUSCI_A2,      &P3->SEL0,      &P3->SEL1,      0x0C,               18},
+    {EUSCI_A3,      &P9->SEL0,      &P9->SEL1,      0xC0,               19}
+};
+
+/**
+ * @brief RTS/CTS pins of one UART port. The CTS pins are all on P5 so that they share the PORT5 interrupt.
+ */
+typedef struct
+{
+    DIO_PORT_Odd_Interruptable_Type *rts_port;
+    uint8_t rts_bit;
+    uint8_t cts_bit;
+} EUSCI_A_UART_Flow_Map;
+
+static const EUSCI_A_UART_Flow_Map Flow_Map[EUSCI_A_UART_NUM_PORTS] = {
+    // RTS port     RTS bit     CTS bit (P5)
+    {P3,            0x01,       0x02},
+    {0,             0x00,       0x00},
+    {P3,            0x20,       0x40},
+    {0,             0x00,       0x00}
+};
+
+/**
+ * @brief Queues and statistics of one UART port.
+ *
+ * The transmit queue is written by the main program and read by the interrupt handler.
+ * The receive queue is written by the interrupt handler and read by the main program.
+ * Each index is only modified by one side, so no critical section is needed.
+ *
+ * The same split applies to flow control: only the interrupt handler deasserts RTS and
+ * only the main program asserts it again, while cts_stalled is only used by the
+ * eUSCI and PORT5 interrupt handlers, which run at the same priority.
+ */
+typedef struct
+{
+    uint8_t tx_buffer[EUSCI_A_UART_TX_BUFFER_SIZE];
+    uint8_t rx_buffer[EUSCI_A_UART_RX_BUFFER_SIZE];
+    volatile uint16_t tx_head;
+    volatile uint16_t tx_tail;
+    volatile uint16_t rx_head;
+    volatile uint16_t rx_tail;
+    volatile uint8_t flow_control;
+    volatile uint8_t rts_deasserted;
+    volatile uint8_t cts_stalled;
+    uint32_t stall_start;
+    EUSCI_A_UART_Stats stats;
+} EUSCI_A_UART_Port_State;
+
+static EUSCI_A_UART_Port_State Port_State[EUSCI_A_UART_NUM_PORTS];
+
+// UCBRSx values indexed by the fractional part of the division factor, in units of 1/10000
+// (refer to Table 24-4 of the MSP432Pxx Microcontrollers Technical Reference Manual)
+static const uint16_t UCBRS_Fraction[36] = {
+       0,  529,  715,  835, 1001, 1252, 1430, 1670, 2147, 2224, 2503, 3000,
+    3335, 3575, 3753, 4003, 4286, 4378, 5002, 5715, 6003, 6254, 6432, 6667,
+    7001, 7147, 7503, 7861, 8004, 8333, 8464, 8572, 8751, 9004, 9170, 9288
+};
+
+static const uint8_t UCBRS_Value[36] = {
+    0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x11, 0x21, 0x22, 0x44, 0x25,
+    0x49, 0x4A, 0x52, 0x92, 0x53, 0x55, 0xAA, 0x6B, 0xAD, 0xB5, 0xB6, 0xD6,
+    0xB7, 0xBB, 0xDD, 0xED, 0xEE, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFD, 0xFE
+};
+
+void EUSCI_A_UART_Compute_Baud_Rate(uint32_t clock_frequency, uint32_t baud_rate, uint16_t *brw, uint16_t *mctlw)
+{
+    uint32_t n = clock_frequency / baud_rate;
+    uint32_t fraction = (uint32_t)(((uint64_t)(clock_frequency % baud_rate) * 10000) / baud_rate);
+    uint8_t ucbrs = 0;
+    int i;
+
+    for (i = 0; i < 36; i++)
+    {
+        if (fraction >= UCBRS_Fraction[i])
+        {
+            ucbrs = UCBRS_Value[i];
+        }
+    }
+
+    if (n >= 16)
+    {
+        // Oversampling mode: UCBRx = INT(N / 16), UCBRFx = INT(((N / 16) - INT(N / 16)) * 16)
+        *brw = (uint16_t)(n / 16);
+        *mctlw = REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRS, ucbrs) | REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRF, n % 16) | EUSCI_A_MCTLW_OS16;
+    }
+    else
+    {
+        // Low-frequency mode: UCBRx = INT(N)
+        *brw = (uint16_t)n;
+        *mctlw = REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRS, ucbrs);
+    }
+}
+
+void EUSCI_A_UART_Init(uint8_t port, const EUSCI_A_UART_Config *config)
+{
+    const EUSCI_A_UART_Port_Map *map = &Port_Map[port];
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    EUSCI_A_Type *module = map->module;
+    uint16_t ctlw0 = REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 0) | REGISTER_FIELD(EUSCI_A_CTLW0_SSEL, 2) | EUSCI_A_CTLW0_RXEIE | EUSCI_A_CTLW0_SWRST;
+    uint16_t brw;
+    uint16_t mctlw;
+    uint8_t *stats = (uint8_t *)&state->stats;
+    int i;
+
+    // Hold the module in reset mode
+    module->CTLW0 |= EUSCI_A_CTLW0_SWRST;
+
+    // CTLW0 Register Configuration
+    //
+    //  Bit(s)      Field       Value       Description
+    //  -----       -----       -----       -----------
+    //   15         UCPEN       config      Parity enable
+    //   14         UCPAR       config      0 = odd parity, 1 = even parity
+    //   13         UCMSB       config      0 = LSB first, 1 = MSB first
+    //   12         UC7BIT      config      0 = 8-bit data, 1 = 7-bit data
+    //   11         UCSPB       config      0 = one stop bit, 1 = two stop bits
+    //   10-9       UCMODEx     0x0         UART mode
+    //   8          UCSYNC      0x0         Asynchronous mode
+    //   7-6        UCSSELx     0x2         eUSCI clock source is SMCLK
+    //   5          UCRXEIE     0x1         Erroneous characters set UCRXIFG
+    //   4-1        Various     0x0         No break interrupt, dormant or address mode, and no break transmission
+    //   0          UCSWRST     0x1         eUSCI logic held in reset state
+    if (config->parity != EUSCI_A_UART_PARITY_NONE) ctlw0 |= EUSCI_A_CTLW0_PEN;
+    if (config->parity == EUSCI_A_UART_PARITY_EVEN) ctlw0 |= EUSCI_A_CTLW0_PAR;
+    if (config->bit_order == EUSCI_A_UART_MSB_FIRST) ctlw0 |= EUSCI_A_CTLW0_MSB;
+    if (config->data_bits == 7) ctlw0 |= EUSCI_A_CTLW0_SEVENBIT;
+    if (config->stop_bits == 2) ctlw0 |= EUSCI_A_CTLW0_SPB;
+
+    // Write the whole register so that no bits from a previous configuration are kept
+    module->CTLW0 = ctlw0;
+
+    // Set the baud rate, computing the divider unless it was computed at compile time by EUSCI_A_UART_CONFIG
+    brw = config->brw;
+    mctlw = config->mctlw;
+    if (brw == 0)
+    {
+        EUSCI_A_UART_Compute_Baud_Rate(EUSCI_A_UART_SMCLK_FREQUENCY, config->baud_rate, &brw, &mctlw);
+    }
+    module->BRW = brw;
+    module->MCTLW = mctlw;
+
+    // Configure the RX and TX pins as primary module function
+    *map->sel0 |= map->pins;
+    *map->sel1 &= ~map->pins;
+
+    // Clear the queues and the statistics
+    state->tx_head = 0;
+    state->tx_tail = 0;
+    state->rx_head = 0;
+    state->rx_tail = 0;
+    for (i = 0; i < sizeof(EUSCI_A_UART_Stats); i++)
+    {
+        stats[i] = 0;
+    }
+
+    // Clear the software reset bit to enable the module
+    module->CTLW0 &= ~EUSCI_A_CTLW0_SWRST;
+
+    // Enable the receive interrupt. The transmit interrupt is enabled when data is queued.
+    module->IE = 0x01;
+
+    // Set the priority of the interrupt and enable it in the NVIC
+    // EUSCIA0 to EUSCIA3 are IRQ 16 to 19 (section 2.4.3.20)
+    NVIC->IP[map->irq] = (EUSCI_A_UART_PRIORITY << 5);
+    NVIC->ISER[0] = (1 << map->irq);
+}
+
+int EUSCI_A_UART_Enable_Flow_Control(uint8_t port)
+{
+    const EUSCI_A_UART_Flow_Map *flow = &Flow_Map[port];
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+
+    if (flow->rts_port == 0)
+    {
+        return EUSCI_A_UART_ERROR_NO_FLOW_CONTROL;
+    }
+
+    // Enable the DWT cycle counter used to measure the stall time
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Configure the RTS pin as GPIO output, asserted (low)
+    flow->rts_port->SEL0 &= ~flow->rts_bit;
+    flow->rts_port->SEL1 &= ~flow->rts_bit;
+    flow->rts_port->OUT &= ~flow->rts_bit;
+    flow->rts_port->DIR |= flow->rts_bit;
+    state->rts_deasserted = 0;
+    state->cts_stalled = 0;
+
+    // Configure the CTS pin as GPIO input with a pull-up resistor, so that an unconnected CTS stops transmission
+    P5->SEL0 &= ~flow->cts_bit;
+    P5->SEL1 &= ~flow->cts_bit;
+    P5->DIR &= ~flow->cts_bit;
+    P5->REN |= flow->cts_bit;
+    P5->OUT |= flow->cts_bit;
+
+    // Interrupt on the falling edge of CTS (the peer is ready to receive again)
+    P5->IES |= flow->cts_bit;
+    P5->IFG &= ~flow->cts_bit;
+    P5->IE |= flow->cts_bit;
+
+    state->flow_control = 1;
+
+    // Set the priority of the PORT5 interrupt and enable it in the NVIC
+    // PORT5 is IRQ 39 (section 2.4.3.20)
+    NVIC->IP[39] = (EUSCI_A_UART_PRIORITY << 5);
+    NVIC->ISER[1] = (1 << (39 - 32));
+
+    return 0;
+}
+
+void EUSCI_A_UART_Disable_Flow_Control(uint8_t port)
+{
+    const EUSCI_A_UART_Flow_Map *flow = &Flow_Map[port];
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint32_t section;
+
+    if (flow->rts_port == 0)
+    {
+        return;
+    }
+
+    P5->IE &= ~flow->cts_bit;
+    state->flow_control = 0;
+
+    // Leave RTS asserted
+    section = Critical_Section_Enter_Priority(EUSCI_A_UART_PRIORITY);
+    flow->rts_port->OUT &= ~flow->rts_bit;
+    state->rts_deasserted = 0;
+    Critical_Section_Exit(section);
+
+    // Resume a stalled transmission. The transmit interrupt is disabled while stalled, so it cannot interfere.
+    if (state->cts_stalled)
+    {
+        state->stats.cts_stall_cycles += DWT->CYCCNT - state->stall_start;
+        state->cts_stalled = 0;
+        Port_Map[port].module->IE |= 0x02;
+    }
+}
+
+/**
+ * @brief Asserts RTS again once the main program has drained the receive queue below the low watermark.
+ */
+static void EUSCI_A_UART_Update_RTS(uint8_t port)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint32_t section;
+
+    if (state->rts_deasserted && (((state->rx_head - state->rx_tail) & RX_MASK) < EUSCI_A_UART_RTS_LOW_WATERMARK))
+    {
+        // The RTS pins of EUSCI_A0 and EUSCI_A2 share P3: the interrupt of the other port must not write P3->OUT
+        // between the read and the write of this port
+        section = Critical_Section_Enter_Priority(EUSCI_A_UART_PRIORITY);
+        state->rts_deasserted = 0;
+        Flow_Map[port].rts_port->OUT &= ~Flow_Map[port].rts_bit;
+        Critical_Section_Exit(section);
+    }
+}
+
+/**
+ * @brief Interrupt handler logic shared by all four ports.
+ *
+ * Received bytes are moved into the receive queue, counting errors and dropped bytes.
+ * When TXBUF is empty, the next byte is taken from the transmit queue. The transmit interrupt
+ * is disabled once the queue is empty.
+ */
+static void EUSCI_A_UART_IRQ(uint8_t port)
+{
+    EUSCI_A_Type *module = Port_Map[port].module;
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint16_t status;
+    uint8_t data;
+    uint16_t next;
+
+    TRACE_ISR_ENTER(TRACE_ID_EUSCI_A_UART + port);
+
+    // UCRXIFG - A character has been received
+    if (module->IFG & 0x01)
+    {
+        // Read STATW before RXBUF, since reading RXBUF clears the error flags
+        status = module->STATW;
+        data = (uint8_t)module->RXBUF;
+
+        if (status & 0x0070)
+        {
+            if (status & 0x0020) state->stats.rx_overrun_errors++;
+            if (status & 0x0040) state->stats.rx_framing_errors++;
+            if (status & 0x0010) state->stats.rx_parity_errors++;
+        }
+        else
+        {
+            next = (state->rx_head + 1) & RX_MASK;
+            if (next == state->rx_tail)
+            {
+                state->stats.rx_dropped++;
+            }
+            else
+            {
+                state->rx_buffer[state->rx_head] = data;
+                state->rx_head = next;
+                state->stats.rx_bytes++;
+            }
+
+            // Deassert RTS when the receive queue reaches the high watermark
+            if (state->flow_control && !state->rts_deasserted
+                && (((state->rx_head - state->rx_tail) & RX_MASK) >= EUSCI_A_UART_RTS_HIGH_WATERMARK))
+            {
+                Flow_Map[port].rts_port->OUT |= Flow_Map[port].rts_bit;
+                state->rts_deasserted = 1;
+                state->stats.rts_deasserts++;
+            }
+        }
+    }
+
+    // UCTXIFG - TXBUF is ready to accept a new character
+    if ((module->IE & 0x02) && (module->IFG & 0x02))
+    {
+        if (state->tx_tail == state->tx_head)
+        {
+            module->IE &= ~0x02;
+        }
+        else if (state->flow_control && (P5->IN & Flow_Map[port].cts_bit))
+        {
+            // CTS is deasserted: stop until the PORT5 interrupt reports that it has been asserted again.
+            // A writer may re-enable UCTXIE during the stall, so only the first entry starts the stall timer.
+            module->IE &= ~0x02;
+            if (!state->cts_stalled)
+            {
+                state->cts_stalled = 1;
+                state->stall_start = DWT->CYCCNT;
+                state->stats.cts_stalls++;
+            }
+        }
+        else
+        {
+            module->TXBUF = state->tx_buffer[state->tx_tail];
+            state->tx_tail = (state->tx_tail + 1) & TX_MASK;
+            state->stats.tx_bytes++;
+        }
+    }
+
+    TRACE_ISR_EXIT(TRACE_ID_EUSCI_A_UART + port);
+}
+
+void EUSCIA0_IRQHandler(void)
+{
+    EUSCI_A_UART_IRQ(EUSCI_A0_UART_PORT);
+}
+
+void EUSCIA1_IRQHandler(void)
+{
+    EUSCI_A_UART_IRQ(EUSCI_A1_UART_PORT);
+}
+
+void EUSCIA2_IRQHandler(void)
+{
+    EUSCI_A_UART_IRQ(EUSCI_A2_UART_PORT);
+}
+
+void EUSCIA3_IRQHandler(void)
+{
+    EUSCI_A_UART_IRQ(EUSCI_A3_UART_PORT);
+}
+
+/**
+ * @brief Resumes the transmission of the ports that were stalled when CTS is asserted.
+ */
+void PORT5_IRQHandler(void)
+{
+    EUSCI_A_UART_Port_State *state;
+    uint8_t cts_bit;
+    uint8_t port;
+
+    for (port = 0; port < EUSCI_A_UART_NUM_PORTS; port++)
+    {
+        cts_bit = Flow_Map[port].cts_bit;
+        if (cts_bit && (P5->IFG & cts_bit))
+        {
+            P5->IFG &= ~cts_bit;
+            state = &Port_State[port];
+
+            // The flag may be left over from an earlier edge, so check that CTS is still asserted
+            if (state->cts_stalled && ((P5->IN & cts_bit) == 0))
+            {
+                state->stats.cts_stall_cycles += DWT->CYCCNT - state->stall_start;
+                state->cts_stalled = 0;
+                Port_Map[port].module->IE |= 0x02;
+            }
+        }
+    }
+}
+
+void EUSCI_A_UART_OutChar(uint8_t port, uint8_t data)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint16_t next = (state->tx_head + 1) & TX_MASK;
+
+    // Wait for space in the transmit queue
+    if (next == state->tx_tail)
+    {
+        state->stats.tx_queue_full++;
+        while(next == state->tx_tail);
+    }
+
+    state->tx_buffer[state->tx_head] = data;
+    state->tx_head = next;
+
+    // Enable the transmit interrupt. UCTXIFG is set while TXBUF is empty, so the interrupt fires immediately if idle.
+    Port_Map[port].module->IE |= 0x02;
+}
+
+uint8_t EUSCI_A_UART_InChar(uint8_t port)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint8_t data;
+
+    while(state->rx_tail == state->rx_head);
+
+    data = state->rx_buffer[state->rx_tail];
+    state->rx_tail = (state->rx_tail + 1) & RX_MASK;
+
+    EUSCI_A_UART_Update_RTS(port);
+
+    return data;
+}
+
+uint16_t EUSCI_A_UART_Write(uint8_t port, const uint8_t *buffer, uint16_t length)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint16_t head = state->tx_head;
+    uint16_t count = 0;
+    uint16_t next;
+
+    while(count < length)
+    {
+        next = (head + 1) & TX_MASK;
+        if (next == state->tx_tail)
+        {
+            break;
+        }
+        state->tx_buffer[head] = buffer[count];
+        head = next;
+        count++;
+    }
+
+    state->tx_head = head;
+
+    if (count)
+    {
+        Port_Map[port].module->IE |= 0x02;
+    }
+
+    return count;
+}
+
+uint16_t EUSCI_A_UART_Read(uint8_t port, uint8_t *buffer, uint16_t length)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    uint16_t tail = state->rx_tail;
+    uint16_t count = 0;
+
+    while((count < length) && (tail != state->rx_head))
+    {
+        buffer[count] = state->rx_buffer[tail];
+        tail = (tail + 1) & RX_MASK;
+        count++;
+    }
+
+    state->rx_tail = tail;
+
+    EUSCI_A_UART_Update_RTS(port);
+
+    return count;
+}
+
+uint16_t EUSCI_A_UART_RX_Available(uint8_t port)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    return (state->rx_head - state->rx_tail) & RX_MASK;
+}
+
+uint16_t EUSCI_A_UART_TX_Free(uint8_t port)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+    return TX_MASK - ((state->tx_head - state->tx_tail) & TX_MASK);
+}
+
+void EUSCI_A_UART_Flush(uint8_t port)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+
+    while(state->tx_tail != state->tx_head);
+
+    // UCBUSY - Wait until the last character has been shifted out
+    while((Port_Map[port].module->STATW & 0x0001) == 0x0001);
+}
+
+void EUSCI_A_UART_Get_Stats(uint8_t port, EUSCI_A_UART_Stats *stats)
+{
+    // The interrupt is above CRITICAL_SECTION_PRIORITY, so its own level is masked while the counters are copied
+    uint32_t section = Critical_Section_Enter_Priority(EUSCI_A_UART_PRIORITY);
+
+    *stats = Port_State[port].stats;
+    Critical_Section_Exit(section);
+}
+
+void EUSCI_A_UART_Clear_Stats(uint8_t port)
+{
+    uint8_t *stats = (uint8_t *)&Port_State[port].stats;
+    uint32_t section = Critical_Section_Enter_Priority(EUSCI_A_UART_PRIORITY);
+    int i;
+
+    for (i = 0; i < sizeof(EUSCI_A_UART_Stats); i++)
+    {
+        stats[i] = 0;
+    }
+    Critical_Section_Exit(section);
+}
+
+void EUSCI_A_UART_OutString(uint8_t port, const char *pt)
+{
+    while(*pt)
+    {
+        EUSCI_A_UART_OutChar(port, *pt);
+        pt++;
+    }
+}
+
+void EUSCI_A_UART_InString(uint8_t port, char *bufPt, uint16_t max)
+{
+    int length = 0;
+    char character = EUSCI_A_UART_InChar(port);
+
+    while(character != CR)
+    {
+        if (character == BS)
+        {
+            if (length)
+            {
+                bufPt--;
+                length--;
+                EUSCI_A_UART_OutChar(port, BS);
+            }
+        }
+        else if (length < max)
+        {
+            *bufPt = character;
+            bufPt++;
+            length++;
+            EUSCI_A_UART_OutChar(port, character);
+        }
+        character = EUSCI_A_UART_InChar(port);
+    }
+    *bufPt = 0;
+}
+
+/**
+ * @brief Stream sink of one port. The transmit queue is the buffer of the sink.
+ */
+typedef struct
+{
+    Stream stream;
+    uint8_t port;
+} EUSCI_A_UART_Sink;
+
+static uint32_t Sink_Write(Stream *stream, const char *data, uint32_t length)
+{
+    uint8_t port = ((EUSCI_A_UART_Sink *)stream)->port;
+    uint32_t written = 0;
+    uint16_t chunk;
+
+    // Wait for space like EUSCI_A_UART_OutChar
+    while (written < length)
+    {
+        chunk = ((length - written) > 0xFFFF) ? 0xFFFF : (uint16_t)(length - written);
+        written += EUSCI_A_UART_Write(port, (const uint8_t *)&data[written], chunk);
+    }
+
+    return length;
+}
+
+static uint32_t Sink_Get_Buffer(Stream *stream, char **buffer)
+{
+    EUSCI_A_UART_Port_State *state = &Port_State[((EUSCI_A_UART_Sink *)stream)->port];
+    uint16_t head = state->tx_head;
+    uint16_t tail = state->tx_tail;
+
+    *buffer = (char *)&state->tx_buffer[head];
+
+    // Free space up to the tail, or up to the end of the buffer, keeping one slot empty
+    if (tail > head)
+    {
+        return tail - head - 1;
+    }
+    return EUSCI_A_UART_TX_BUFFER_SIZE - head - (tail == 0);
+}
+
+static void Sink_Commit(Stream *stream, uint32_t count)
+{
+    uint8_t port = ((EUSCI_A_UART_Sink *)stream)->port;
+    EUSCI_A_UART_Port_State *state = &Port_State[port];
+
+    state->tx_head = (state->tx_head + count) & TX_MASK;
+    Port_Map[port].module->IE |= 0x02;
+}
+
+static void Sink_Flush(Stream *stream)
+{
+    EUSCI_A_UART_Flush(((EUSCI_A_UART_Sink *)stream)->port);
+}
+
+static const Stream_Interface Sink_Interface = {Sink_Write, Sink_Get_Buffer, Sink_Commit, Sink_Flush};
+
+static EUSCI_A_UART_Sink Sinks[EUSCI_A_UART_NUM_PORTS] = {
+    {{&Sink_Interface}, 0},
+    {{&Sink_Interface}, 1},
+    {{&Sink_Interface}, 2},
+    {{&Sink_Interface}, 3}
+};
+
+Stream *EUSCI_A_UART_Get_Stream(uint8_t port)
+{
+    return &Sinks[port].stream;
+}
+
+void EUSCI_A_UART_OutUDec(uint8_t port, uint32_t n)
+{
+    Stream_Put_UDec(&Sinks[port].stream, n, 0);
+}
+
+void EUSCI_A_UART_OutSDec(uint8_t port, int32_t n)
+{
+    Stream_Put_SDec(&Sinks[port].stream, n, 0);
+}
+
+void EUSCI_A_UART_OutUFix(uint8_t port, uint32_t n)
+{
+    Stream_Put_UFix(&Sinks[port].stream, n, 1, 0);
+}
+
+void EUSCI_A_UART_OutUHex(uint8_t port, uint32_t number)
+{
+    Stream_Put_UHex(&Sinks[port].stream, number, 0);
+}
+
+int EUSCI_A_UART_InNumber(uint8_t port, uint8_t format, uint8_t decimals, uint32_t *value)
+{
+    char buffer[EUSCI_A_UART_NUMBER_LENGTH];
+    uint32_t values[2];
+    Number_Parser parser;
+    uint16_t length = 0;
+    uint8_t overflow = 0;
+    int32_t count;
+    char character;
+
+    count = Number_Parser_Init(&parser, format, decimals);
+    if (count < 0)
+    {
+        return count;
+    }
+
+    // Same line editing as EUSCI_A_UART_InString
+    character = EUSCI_A_UART_InChar(port);
+    while(character != CR)
+    {
+        if (character == BS)
+        {
+            if (length)
+            {
+                length--;
+                EUSCI_A_UART_OutChar(port, BS);
+            }
+        }
+        else if (length < EUSCI_A_UART_NUMBER_LENGTH)
+        {
+            buffer[length] = character;
+            length++;
+            EUSCI_A_UART_OutChar(port, character);
+        }
+        else
+        {
+            // The character does not fit: the buffer no longer holds the line that was entered
+            overflow = 1;
+        }
+        character = EUSCI_A_UART_InChar(port);
+    }
+
+    if (overflow)
+    {
+        return NUMBER_PARSER_ERROR_OVERFLOW;
+    }
+
+    // Exactly one number must have been entered
+    count = Number_Parser_Parse(&parser, buffer, length, values, 2);
+    if (count < 0)
+    {
+        return count;
+    }
+    if (count != 1)
+    {
+        return NUMBER_PARSER_ERROR_SYNTAX;
+    }
+
+    *value = values[0];
+
+    return 0;
+}
+
+int EUSCI_A_UART_Poll_Number(uint8_t port, Number_Parser *parser, uint32_t *value)
+{
+    uint8_t character;
+    int result;
+
+    while(EUSCI_A_UART_Read(port, &character, 1))
+    {
+        result = Number_Parser_Feed(parser, (char)character, value);
+        if (result != NUMBER_PARSER_MORE)
+        {
+            return result;
+        }
+    }
+
+    return NUMBER_PARSER_MORE;
+}
+
+uint32_t EUSCI_A_UART_InUDec(uint8_t port)
+{
+    uint32_t number;
+
+    if (EUSCI_A_UART_InNumber(port, NUMBER_PARSER_UNSIGNED, 0, &number) < 0)
+    {
+        return 0;
+    }
+    return number;
+}
+
+uint32_t EUSCI_A_UART_InUHex(uint8_t port)
+{
+    uint32_t number;
+
+    if (EUSCI_A_UART_InNumber(port, NUMBER_PARSER_HEX, 0, &number) < 0)
+    {
+        return 0;
+    }
+    return number;
+}
@@ -25,6 +25,7 @@
 
 #include "../inc/GPIO.h"
 #include "../inc/Clock.h"
+#include "../inc/Pin_Map.h"
 
 // Constant definitions for the built-in red LED
 const uint8_t RED_LED_OFF           =   0x00;
@@ -48,9 +49,7 @@ const uint8_t PMOD_8LD_4_7_ON       =   0xF0;
 
 void LED1_Init()
 {
-    P1->SEL0 &= ~0x01;
-    P1->SEL1 &= ~0x01;
-    P1->DIR |= 0x01;
+    PIN_MAP_CONFIGURE(PIN_GROUP_LED1);
 }
 
 uint8_t LED1_Output(uint8_t led_value)
@@ -61,11 +60,7 @@ uint8_t LED1_Output(uint8_t led_value)
 
 void LED2_Init()
 {
-    P2->SEL0 &= ~0x07;
-    P2->SEL1 &= ~0x07;
-    P2->DS |= 0x07;
-    P2->DIR |= 0x07;
-    P2->OUT &= ~0x07;
+    PIN_MAP_CONFIGURE(PIN_GROUP_LED2);
 }
 
 uint8_t LED2_Output(uint8_t led_value)
@@ -81,11 +76,7 @@ void LED2_Toggle(uint8_t led_value)
 
 void Buttons_Init()
 {
-    P1->SEL0 &= ~0x12;
-    P1->SEL1 &= ~0x12;
-    P1->DIR |= ~0x12;
-    P1->REN |= 0x12;
-    P1->OUT |= 0x12;
+    PIN_MAP_CONFIGURE(PIN_GROUP_BUTTONS);
 }
 
 uint8_t Get_Buttons_Status()
@@ -96,11 +87,7 @@ uint8_t Get_Buttons_Status()
 
 void PMOD_8LD_Init()
 {
-    P9->SEL0 &= ~0xFF;
-    P9->SEL1 &= ~0xFF;
-    P9->DS |= 0xFF;
-    P9->DIR |= 0xFF;
-    P9->OUT &= ~0xFF;
+    PIN_MAP_CONFIGURE(PIN_GROUP_PMOD_8LD);
 }
 
 uint8_t PMOD_8LD_Output(uint8_t led_value)
@@ -112,9 +99,7 @@ uint8_t PMOD_8LD_Output(uint8_t led_value)
 
 void PMOD_SWT_Init()
 {
-    P10->SEL0 &= ~0xF;
-    P10->SEL1 &= ~0xF;
-    P10->DIR &= ~0xF;
+    PIN_MAP_CONFIGURE(PIN_GROUP_PMOD_SWT);
 }
 
 uint8_t PMOD_SWT_Status()
@@ -209,8 +194,5 @@ void LED_Controller(uint8_t button_status, uint8_t switch_status)
 
 void P8_Init()
 {
-    P8->SEL0 &= ~0xE1;
-    P8->SEL1 &= ~0xE1;
-    P8->DIR |= 0xE1;
-    P8->OUT &= ~0xE1;
+    PIN_MAP_CONFIGURE(PIN_GROUP_CHASSIS_LEDS);
 }
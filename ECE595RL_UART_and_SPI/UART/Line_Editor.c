@@ -0,0 +1,454 @@
+/**
+ * @file Line_Editor.c
+ * @brief Source code for the Line_Editor library.
+ *
+ * This file contains the function definitions for the Line_Editor library.
+ * Each edit updates the line first and then queues the shortest echo that makes the terminal show it,
+ * using the VT100 cursor movement (ESC [ n C and ESC [ n D) and erase to end of line (ESC [ K) sequences.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <string.h>
+#include "../inc/Line_Editor.h"
+
+#define ESCAPE_NONE         0
+#define ESCAPE_START        1   // After ESC
+#define ESCAPE_SEQUENCE     2   // After ESC [ or ESC O, reading the parameter
+
+#define REDRAW_LINE         0x01    // The echo of the current line was dropped
+#define REDRAW_RETURNED     0x02    // The echo of the returned line was dropped
+
+#define CTRL_A              0x01
+#define CTRL_B              0x02
+#define CTRL_C              0x03
+#define CTRL_E              0x05
+#define CTRL_F              0x06
+#define CTRL_K              0x0B
+#define CTRL_U              0x15
+
+static void Echo(Line_Editor *editor, const char *data, uint16_t length)
+{
+    // Once an echo has been dropped, the rest is useless until the line is drawn again.
+    // Before the prompt, the line is not shown yet: Line_Editor_Prompt draws what was typed ahead.
+    if (editor->redraw || !editor->prompted)
+    {
+        return;
+    }
+
+    if (Ring_Buffer_Free(&editor->echo) < length)
+    {
+        editor->redraw = REDRAW_LINE;
+        editor->echo_dropped++;
+        return;
+    }
+
+    Ring_Buffer_Push_Multiple(&editor->echo, data, length);
+}
+
+static void Echo_String(Line_Editor *editor, const char *string)
+{
+    Echo(editor, string, strlen(string));
+}
+
+/**
+ * @brief Moves the terminal cursor count columns to the right ('C') or to the left ('D').
+ */
+static void Echo_Move(Line_Editor *editor, uint16_t count, char direction)
+{
+    char sequence[8];
+    uint8_t length = 0;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    sequence[length++] = ESC;
+    sequence[length++] = '[';
+    if (count >= 100)
+    {
+        sequence[length++] = '0' + (count / 100);
+    }
+    if (count >= 10)
+    {
+        sequence[length++] = '0' + ((count / 10) % 10);
+    }
+    sequence[length++] = '0' + (count % 10);
+    sequence[length++] = direction;
+
+    Echo(editor, sequence, length);
+}
+
+/**
+ * @brief Draws the prompt and a line from the start of the terminal line, and places the cursor.
+ */
+static void Draw_Line(Line_Editor *editor, const char *line, uint16_t length, uint16_t cursor)
+{
+    Echo_String(editor, "\r");
+    Echo_String(editor, editor->prompt);
+    Echo(editor, line, length);
+    Echo_String(editor, "\x1B[K");
+    Echo_Move(editor, length - cursor, 'D');
+}
+
+/**
+ * @brief Moves as much of the echo as fits into the transmit queue. Once all the echo queued before a dropped
+ *        one has been sent, draws the returned line (if <enter> was pressed in the meantime) and the current line.
+ */
+static void Flush(Line_Editor *editor)
+{
+    const void *span;
+    uint32_t count;
+    uint16_t written;
+    uint8_t prompted;
+    uint8_t redraw;
+
+    while((count = Ring_Buffer_Read_Span(&editor->echo, &span)) > 0)
+    {
+        written = EUSCI_A_UART_Write(editor->port, span, count);
+        Ring_Buffer_Consume(&editor->echo, written);
+        if (written < count)
+        {
+            return;
+        }
+    }
+
+    if (editor->redraw)
+    {
+        redraw = editor->redraw;
+        editor->redraw = 0;
+        if (redraw & REDRAW_RETURNED)
+        {
+            // The returned line had a prompt, even if the current line does not have one yet
+            prompted = editor->prompted;
+            editor->prompted = 1;
+            Draw_Line(editor, editor->returned, strlen(editor->returned), strlen(editor->returned));
+            Echo_String(editor, "\r\n");
+            editor->prompted = prompted;
+        }
+        if (editor->prompted)
+        {
+            Draw_Line(editor, editor->line, editor->length, editor->cursor);
+        }
+        Flush(editor);
+    }
+}
+
+/**
+ * @brief Replaces the whole line, for example with a line of the history.
+ */
+static void Set_Line(Line_Editor *editor, const char *text)
+{
+    Echo_Move(editor, editor->cursor, 'D');
+
+    editor->length = strlen(text);
+    memcpy(editor->line, text, editor->length);
+    editor->cursor = editor->length;
+
+    Echo(editor, editor->line, editor->length);
+    Echo_String(editor, "\x1B[K");
+}
+
+static void Insert(Line_Editor *editor, char character)
+{
+    if (editor->length == LINE_EDITOR_LENGTH)
+    {
+        return;
+    }
+
+    memmove(&editor->line[editor->cursor + 1], &editor->line[editor->cursor], editor->length - editor->cursor);
+    editor->line[editor->cursor] = character;
+    editor->length++;
+
+    // Write the new character and the ones after it, then go back to the cursor
+    Echo(editor, &editor->line[editor->cursor], editor->length - editor->cursor);
+    editor->cursor++;
+    Echo_Move(editor, editor->length - editor->cursor, 'D');
+}
+
+/**
+ * @brief Deletes the character under the cursor and redraws the end of the line.
+ */
+static void Delete(Line_Editor *editor)
+{
+    if (editor->cursor == editor->length)
+    {
+        return;
+    }
+
+    memmove(&editor->line[editor->cursor], &editor->line[editor->cursor + 1], editor->length - editor->cursor - 1);
+    editor->length--;
+
+    Echo(editor, &editor->line[editor->cursor], editor->length - editor->cursor);
+    Echo_String(editor, " ");
+    Echo_Move(editor, editor->length - editor->cursor + 1, 'D');
+}
+
+static void Move_Left(Line_Editor *editor)
+{
+    if (editor->cursor > 0)
+    {
+        editor->cursor--;
+        Echo_String(editor, "\b");
+    }
+}
+
+static void Move_Right(Line_Editor *editor)
+{
+    if (editor->cursor < editor->length)
+    {
+        // Writing the character again moves the cursor with a single byte
+        Echo(editor, &editor->line[editor->cursor], 1);
+        editor->cursor++;
+    }
+}
+
+static void Move_Home(Line_Editor *editor)
+{
+    Echo_Move(editor, editor->cursor, 'D');
+    editor->cursor = 0;
+}
+
+static void Move_End(Line_Editor *editor)
+{
+    Echo_Move(editor, editor->length - editor->cursor, 'C');
+    editor->cursor = editor->length;
+}
+
+/**
+ * @brief Shows an older (direction 1) or newer (direction -1) line of the history.
+ *        Going past the most recent line shows an empty line.
+ */
+static void Browse_History(Line_Editor *editor, int8_t direction)
+{
+    uint8_t position = editor->history_position + direction;
+
+    if ((direction > 0) && (editor->history_position == editor->history_count))
+    {
+        return;
+    }
+    if ((direction < 0) && (editor->history_position == 0))
+    {
+        return;
+    }
+
+    editor->history_position = position;
+    if (position == 0)
+    {
+        Set_Line(editor, "");
+    }
+    else
+    {
+        Set_Line(editor, editor->history[(editor->history_newest + LINE_EDITOR_HISTORY_SIZE + 1 - position) % LINE_EDITOR_HISTORY_SIZE]);
+    }
+}
+
+static void Add_History(Line_Editor *editor)
+{
+    char *newest = editor->history[editor->history_newest];
+
+    // Empty lines and repeats of the previous line are not stored
+    if ((editor->length == 0) || ((editor->history_count > 0) && (strcmp(newest, editor->line) == 0)))
+    {
+        return;
+    }
+
+    editor->history_newest = (editor->history_newest + 1) % LINE_EDITOR_HISTORY_SIZE;
+    strcpy(editor->history[editor->history_newest], editor->line);
+    if (editor->history_count < LINE_EDITOR_HISTORY_SIZE)
+    {
+        editor->history_count++;
+    }
+}
+
+/**
+ * @brief Handles the final character of an escape sequence.
+ */
+static void Escape_Sequence(Line_Editor *editor, char character)
+{
+    switch(character)
+    {
+        case 'A':   Browse_History(editor, 1);      break;
+        case 'B':   Browse_History(editor, -1);     break;
+        case 'C':   Move_Right(editor);             break;
+        case 'D':   Move_Left(editor);              break;
+        case 'H':   Move_Home(editor);              break;
+        case 'F':   Move_End(editor);               break;
+        case '~':
+        {
+            // ESC [ n ~ (Home and End differ between terminals)
+            switch(editor->escape_parameter)
+            {
+                case 1:
+                case 7:     Move_Home(editor);      break;
+                case 4:
+                case 8:     Move_End(editor);       break;
+                case 3:     Delete(editor);         break;
+                default:                            break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Handles one received character.
+ *
+ * @return 1 if the line is complete, otherwise 0.
+ */
+static uint8_t Process(Line_Editor *editor, char character)
+{
+    uint8_t last_was_cr = editor->last_was_cr;
+
+    editor->last_was_cr = (character == CR);
+
+    if (editor->escape_state == ESCAPE_START)
+    {
+        editor->escape_state = ((character == '[') || (character == 'O')) ? ESCAPE_SEQUENCE : ESCAPE_NONE;
+        editor->escape_parameter = 0;
+        return 0;
+    }
+
+    if (editor->escape_state == ESCAPE_SEQUENCE)
+    {
+        if ((character >= '0') && (character <= '9'))
+        {
+            if (editor->escape_parameter < 100)
+            {
+                editor->escape_parameter = editor->escape_parameter * 10 + (character - '0');
+            }
+        }
+        else if (character != ';')
+        {
+            // Any other character ends the sequence
+            editor->escape_state = ESCAPE_NONE;
+            Escape_Sequence(editor, character);
+        }
+        return 0;
+    }
+
+    switch(character)
+    {
+        case CR:
+            return 1;
+        case LF:
+            return !last_was_cr;
+        case ESC:
+            editor->escape_state = ESCAPE_START;
+            break;
+        case BS:
+        case DEL:
+            if (editor->cursor > 0)
+            {
+                Move_Left(editor);
+                Delete(editor);
+            }
+            break;
+        case CTRL_A:    Move_Home(editor);          break;
+        case CTRL_E:    Move_End(editor);           break;
+        case CTRL_B:    Move_Left(editor);          break;
+        case CTRL_F:    Move_Right(editor);         break;
+        case CTRL_U:    Set_Line(editor, "");       break;
+        case CTRL_K:
+            editor->length = editor->cursor;
+            Echo_String(editor, "\x1B[K");
+            break;
+        case CTRL_C:
+            editor->length = 0;
+            editor->cursor = 0;
+            editor->history_position = 0;
+            Echo_String(editor, "^C\r\n");
+            Echo_String(editor, editor->prompt);
+            break;
+        default:
+            if ((character >= SP) && (character < DEL))
+            {
+                Insert(editor, character);
+            }
+            break;
+    }
+
+    return 0;
+}
+
+void Line_Editor_Init(Line_Editor *editor, uint8_t port, const char *prompt)
+{
+    editor->port = port;
+    strncpy(editor->prompt, prompt, LINE_EDITOR_PROMPT_LENGTH);
+    editor->prompt[LINE_EDITOR_PROMPT_LENGTH] = 0;
+    editor->length = 0;
+    editor->cursor = 0;
+    editor->escape_state = ESCAPE_NONE;
+    editor->escape_parameter = 0;
+    editor->last_was_cr = 0;
+    editor->redraw = 0;
+    editor->prompted = 0;
+    editor->history_count = 0;
+    editor->history_newest = 0;
+    editor->history_position = 0;
+    editor->echo_dropped = 0;
+    Ring_Buffer_Init(&editor->echo, editor->echo_storage, 1, LINE_EDITOR_ECHO_SIZE);
+
+    Line_Editor_Prompt(editor);
+}
+
+int Line_Editor_Poll(Line_Editor *editor, char *line, uint16_t max)
+{
+    uint8_t character;
+    uint16_t length;
+
+    // Take all the input first, so that the receive queue never waits for the echo
+    while(EUSCI_A_UART_Read(editor->port, &character, 1))
+    {
+        if (Process(editor, (char)character))
+        {
+            editor->line[editor->length] = 0;
+            Add_History(editor);
+
+            // With max == 0 there is no room for the null terminator, and nothing is written
+            length = 0;
+            if (max > 0)
+            {
+                length = (editor->length < max) ? editor->length : (max - 1);
+                memcpy(line, editor->line, length);
+                line[length] = 0;
+            }
+
+            // If echo was dropped (or the end of line does not fit), the returned line is drawn
+            // once the queued echo has been sent
+            Echo_String(editor, "\r\n");
+            if (editor->redraw)
+            {
+                strcpy(editor->returned, editor->line);
+                editor->redraw |= REDRAW_RETURNED;
+            }
+
+            editor->prompted = 0;
+            editor->length = 0;
+            editor->cursor = 0;
+            editor->history_position = 0;
+            Flush(editor);
+
+            return length;
+        }
+    }
+
+    Flush(editor);
+
+    return LINE_EDITOR_NO_LINE;
+}
+
+void Line_Editor_Prompt(Line_Editor *editor)
+{
+    editor->prompted = 1;
+
+    // Characters typed before the prompt are shown after it
+    Echo_String(editor, editor->prompt);
+    Echo(editor, editor->line, editor->length);
+    Echo_Move(editor, editor->length - editor->cursor, 'D');
+    Flush(editor);
+}
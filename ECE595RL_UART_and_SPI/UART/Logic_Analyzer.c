@@ -0,0 +1,230 @@
+/**
+ * @file Logic_Analyzer.c
+ * @brief Source code for the Logic_Analyzer driver.
+ *
+ * This file contains the function definitions for the Logic_Analyzer driver.
+ * It samples GPIO pins into RAM after a trigger and streams the run-length encoded capture over EUSCI_A0.
+ *
+ * For more information regarding the Data Watchpoint and Trace unit (DWT),
+ * refer to the ARM Cortex-M4 Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Logic_Analyzer.h"
+#include "../inc/CRC16.h"
+
+#define BUFFER_MASK     (LOGIC_ANALYZER_BUFFER_SIZE - 1)
+
+static uint8_t Capture_Buffer[LOGIC_ANALYZER_BUFFER_SIZE];
+
+// Result of the last capture: index of the first sample in Capture_Buffer, number of samples and error code
+static uint16_t Capture_Start;
+static uint16_t Capture_Count;
+static int Capture_Error;
+
+int Logic_Analyzer_Capture(const Logic_Analyzer_Config *config)
+{
+    volatile uint8_t *inputs[LOGIC_ANALYZER_MAX_CHANNELS];
+    uint8_t pins[LOGIC_ANALYZER_MAX_CHANNELS];
+    uint8_t num_channels = config->num_channels;
+    uint8_t mask = config->trigger.mask;
+    uint8_t value = config->trigger.value;
+    uint8_t edge_mask = config->trigger.edge_mask;
+    uint32_t period;
+    uint32_t next;
+    uint32_t waited = 0;
+    uint32_t remaining = 0;
+    uint32_t count = 0;
+    uint32_t primask;
+    uint16_t index = 0;
+    uint8_t sample;
+    uint8_t previous = 0;
+    uint8_t triggered = 0;
+    uint8_t late = 0;
+    int ch;
+
+    Capture_Count = 0;
+    Capture_Error = LOGIC_ANALYZER_ERROR_CONFIG;
+
+    if ((num_channels == 0) || (num_channels > LOGIC_ANALYZER_MAX_CHANNELS)
+        || (config->sample_rate == 0) || (config->sample_rate > LOGIC_ANALYZER_MAX_SAMPLE_RATE)
+        || (config->total_samples == 0) || (config->total_samples > LOGIC_ANALYZER_BUFFER_SIZE)
+        || (config->pretrigger_samples >= config->total_samples))
+    {
+        return LOGIC_ANALYZER_ERROR_CONFIG;
+    }
+
+    for (ch = 0; ch < num_channels; ch++)
+    {
+        inputs[ch] = config->channels[ch].input;
+        pins[ch] = config->channels[ch].pin;
+    }
+
+    period = LOGIC_ANALYZER_CPU_FREQUENCY / config->sample_rate;
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    next = DWT->CYCCNT + period;
+
+    while(1)
+    {
+        // Wait for the sample time. If it has already passed, the loop is too slow for the sample rate.
+        if ((int32_t)(DWT->CYCCNT - next) > (int32_t)period)
+        {
+            late = 1;
+        }
+        while((int32_t)(DWT->CYCCNT - next) < 0);
+        next += period;
+
+        sample = 0;
+        for (ch = 0; ch < num_channels; ch++)
+        {
+            sample |= ((*inputs[ch] >> pins[ch]) & 0x01) << ch;
+        }
+
+        Capture_Buffer[index] = sample;
+        index = (index + 1) & BUFFER_MASK;
+        count++;
+
+        if (triggered)
+        {
+            remaining--;
+            if (remaining == 0)
+            {
+                break;
+            }
+        }
+        else if (count > config->pretrigger_samples)
+        {
+            // The first sample after arming has no valid previous sample for edge detection
+            if (((sample & mask) == value)
+                && ((edge_mask == 0) || ((count > config->pretrigger_samples + 1) && ((sample ^ previous) & edge_mask))))
+            {
+                triggered = 1;
+                remaining = config->total_samples - config->pretrigger_samples - 1;
+                if (remaining == 0)
+                {
+                    break;
+                }
+            }
+            else if (config->timeout_samples && (++waited >= config->timeout_samples))
+            {
+                break;
+            }
+        }
+
+        previous = sample;
+    }
+
+    __set_PRIMASK(primask);
+
+    if (!triggered)
+    {
+        Capture_Error = LOGIC_ANALYZER_ERROR_TIMEOUT;
+        return Capture_Error;
+    }
+
+    if (late)
+    {
+        Capture_Error = LOGIC_ANALYZER_ERROR_OVERRUN;
+        return Capture_Error;
+    }
+
+    Capture_Start = (index - config->total_samples) & BUFFER_MASK;
+    Capture_Count = config->total_samples;
+    Capture_Error = 0;
+
+    return Capture_Count;
+}
+
+uint32_t Logic_Analyzer_Stream(const Logic_Analyzer_Config *config)
+{
+    uint32_t bytes = 16;
+    uint16_t crc = CRC16_INITIAL_VALUE;
+    Stream *stream = EUSCI_A_UART_Get_Stream(EUSCI_A0_UART_PORT);
+    uint16_t index = Capture_Start;
+    uint16_t sent = 0;
+    uint32_t run;
+    uint8_t sample;
+    uint8_t data;
+    uint8_t length;
+    int ch;
+
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, 'L');
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, 'A');
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, LOGIC_ANALYZER_STREAM_VERSION);
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, config->num_channels);
+    Stream_Put_U32_LE(stream, config->sample_rate);
+    Stream_Put_U32_LE(stream, Capture_Count);
+    Stream_Put_U32_LE(stream, config->pretrigger_samples);
+
+    for (ch = 0; ch < config->num_channels; ch++)
+    {
+        for (length = 0; config->channels[ch].name[length]; length++);
+        EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, length);
+        EUSCI_A_UART_OutString(EUSCI_A0_UART_PORT, config->channels[ch].name);
+        bytes += 1 + length;
+    }
+
+    // A failed capture is reported with zero samples followed by the negated error code
+    if (Capture_Count == 0)
+    {
+        EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, (uint8_t)(-Capture_Error));
+        return bytes + 1;
+    }
+
+    while(sent < Capture_Count)
+    {
+        // Count the samples that are equal to the first one
+        sample = Capture_Buffer[index];
+        run = 0;
+        do
+        {
+            index = (index + 1) & BUFFER_MASK;
+            sent++;
+            run++;
+        } while((sent < Capture_Count) && (Capture_Buffer[index] == sample));
+
+        EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, sample);
+        crc = CRC16_Update(crc, sample);
+        bytes++;
+
+        // Run length minus one, 7 bits per byte, least significant group first
+        run--;
+        do
+        {
+            data = run & 0x7F;
+            run >>= 7;
+            if (run)
+            {
+                data |= 0x80;
+            }
+            EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, data);
+            crc = CRC16_Update(crc, data);
+            bytes++;
+        } while(run);
+    }
+
+    Stream_Put_U16_LE(stream, crc);
+
+    return bytes + 2;
+}
+
+void Logic_Analyzer_Run(const Logic_Analyzer_Config *config)
+{
+    while(1)
+    {
+        if (EUSCI_A_UART_InChar(EUSCI_A0_UART_PORT) == LOGIC_ANALYZER_CMD_CAPTURE)
+        {
+            Logic_Analyzer_Capture(config);
+            Logic_Analyzer_Stream(config);
+        }
+    }
+}
@@ -0,0 +1,337 @@
+/**
+ * @file Memory_Block.c
+ * @brief Source code for the Memory_Block driver.
+ *
+ * This file contains the function definitions for the Memory_Block driver.
+ * The inner loops are in Memory_Block_Loops.asm, so that they keep the LDM/STM and the SIMD (USUB8, SEL, USADA8)
+ * instructions whatever the optimization level.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Memory_Block.h"
+#include "../inc/DMA.h"
+
+// DMA channel, or DMA_ERROR_BUSY until it is allocated
+static int DMA_Channel_Number = DMA_ERROR_BUSY;
+
+// Task list of the transfer in progress, and the word that is read by a fill
+static DMA_Descriptor DMA_Tasks[MEMORY_BLOCK_DMA_MAX_TASKS];
+static uint16_t DMA_Task_Count;
+static uint32_t DMA_Fill_Pattern;
+
+// Inner loops in Memory_Block_Loops.asm. The pointers are aligned to a word and blocks is not 0.
+
+/**
+ * @brief Writes pattern to blocks * 32 bytes.
+ */
+void Memory_Block_Fill_Blocks(uint32_t *destination, uint32_t pattern, uint32_t blocks);
+
+/**
+ * @brief Copies blocks * 32 bytes.
+ */
+void Memory_Block_Copy_Blocks(uint32_t *destination, const uint32_t *source, uint32_t blocks);
+
+/**
+ * @brief Compares blocks of 8 bytes until two differ.
+ *
+ * @return The number of blocks left, including the one that differs (0 if all are equal).
+ */
+uint32_t Memory_Block_Compare_Blocks(const uint32_t *a, const uint32_t *b, uint32_t blocks);
+
+/**
+ * @brief Counts the bytes that differ in blocks of 8 bytes, with the USUB8, SEL and USADA8 instructions.
+ *
+ * @return The number of bytes that differ.
+ */
+uint32_t Memory_Block_Count_Blocks(const uint32_t *a, const uint32_t *b, uint32_t blocks);
+
+/**
+ * @brief Returns 1 if both addresses have the same alignment, so that the word loops can be used after the first bytes.
+ */
+static uint8_t Same_Alignment(const void *a, const void *b)
+{
+    return ((((uint32_t)a ^ (uint32_t)b) & 0x03) == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Returns the number of bytes before the first word boundary, limited to length.
+ */
+static uint32_t Head_Length(const void *address, uint32_t length)
+{
+    uint32_t head = (4 - ((uint32_t)address & 0x03)) & 0x03;
+
+    return (head < length) ? head : length;
+}
+
+void Memory_Block_Fill(void *destination, uint8_t value, uint32_t length)
+{
+    uint8_t *d = destination;
+    uint32_t pattern = (uint32_t)value * 0x01010101u;
+    uint32_t head = Head_Length(d, length);
+    uint32_t blocks;
+
+    length -= head;
+    while (head--)
+    {
+        *d++ = value;
+    }
+
+    blocks = length >> 5;
+    if (blocks)
+    {
+        Memory_Block_Fill_Blocks((uint32_t *)d, pattern, blocks);
+        d += blocks << 5;
+        length &= 0x1F;
+    }
+
+    for (; length >= 4; length -= 4, d += 4)
+    {
+        *(uint32_t *)d = pattern;
+    }
+
+    while (length--)
+    {
+        *d++ = value;
+    }
+}
+
+void Memory_Block_Copy(void *destination, const void *source, uint32_t length)
+{
+    uint8_t *d = destination;
+    const uint8_t *s = source;
+    uint32_t head;
+    uint32_t blocks;
+
+    if (Same_Alignment(d, s))
+    {
+        head = Head_Length(d, length);
+        length -= head;
+        while (head--)
+        {
+            *d++ = *s++;
+        }
+
+        blocks = length >> 5;
+        if (blocks)
+        {
+            Memory_Block_Copy_Blocks((uint32_t *)d, (const uint32_t *)s, blocks);
+            d += blocks << 5;
+            s += blocks << 5;
+            length &= 0x1F;
+        }
+
+        for (; length >= 4; length -= 4, d += 4, s += 4)
+        {
+            *(uint32_t *)d = *(const uint32_t *)s;
+        }
+    }
+
+    while (length--)
+    {
+        *d++ = *s++;
+    }
+}
+
+int32_t Memory_Block_Compare(const void *a, const void *b, uint32_t length)
+{
+    const uint8_t *x = a;
+    const uint8_t *y = b;
+    uint32_t i = 0;
+    uint32_t head;
+    uint32_t blocks;
+    uint32_t remaining;
+
+    if (Same_Alignment(x, y))
+    {
+        for (head = Head_Length(x, length); i < head; i++)
+        {
+            if (x[i] != y[i])
+            {
+                return i;
+            }
+        }
+
+        // The block loop stops at the first block that differs, which is then searched by the byte loop
+        blocks = (length - i) >> 3;
+        if (blocks)
+        {
+            remaining = Memory_Block_Compare_Blocks((const uint32_t *)&x[i], (const uint32_t *)&y[i], blocks);
+            i += (blocks - remaining) << 3;
+        }
+    }
+
+    for (; i < length; i++)
+    {
+        if (x[i] != y[i])
+        {
+            return i;
+        }
+    }
+
+    return MEMORY_BLOCK_EQUAL;
+}
+
+uint32_t Memory_Block_Count_Differences(const void *a, const void *b, uint32_t length)
+{
+    const uint8_t *x = a;
+    const uint8_t *y = b;
+    uint32_t differences = 0;
+    uint32_t i = 0;
+    uint32_t head;
+    uint32_t blocks;
+
+    if (Same_Alignment(x, y))
+    {
+        for (head = Head_Length(x, length); i < head; i++)
+        {
+            differences += (x[i] != y[i]);
+        }
+
+        blocks = (length - i) >> 3;
+        if (blocks)
+        {
+            differences += Memory_Block_Count_Blocks((const uint32_t *)&x[i], (const uint32_t *)&y[i], blocks);
+            i += blocks << 3;
+        }
+    }
+
+    for (; i < length; i++)
+    {
+        differences += (x[i] != y[i]);
+    }
+
+    return differences;
+}
+
+/**
+ * @brief Appends the tasks that transfer count items of 2^size_shift bytes, 1024 items per task, and advances the pointers.
+ */
+static int Add_Tasks(uint8_t **destination, const uint8_t **source, uint8_t source_fixed,
+                     uint32_t count, uint32_t control, uint8_t size_shift)
+{
+    uint32_t cycle;
+
+    while (count)
+    {
+        if (DMA_Task_Count == MEMORY_BLOCK_DMA_MAX_TASKS)
+        {
+            return MEMORY_BLOCK_ERROR_LENGTH;
+        }
+
+        cycle = (count > DMA_MAX_TRANSFERS) ? DMA_MAX_TRANSFERS : count;
+        DMA_Set_Transfer(&DMA_Tasks[DMA_Task_Count++], control, *source, *destination, cycle);
+
+        *destination += cycle << size_shift;
+        if (!source_fixed)
+        {
+            *source += cycle << size_shift;
+        }
+        count -= cycle;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Builds the task list of a copy, or of a fill from a fixed source, and starts the DMA channel.
+ */
+static int DMA_Start(uint8_t *destination, const uint8_t *source, uint8_t source_fixed, uint32_t length)
+{
+    uint32_t fixed = source_fixed ? DMA_SRC_FIXED : 0;
+    uint32_t byte_control = DMA_SIZE_8 | fixed | DMA_ARBITRATE(MEMORY_BLOCK_DMA_ARBITRATION);
+    uint32_t word_control = DMA_SIZE_32 | fixed | DMA_ARBITRATE(MEMORY_BLOCK_DMA_ARBITRATION);
+    uint32_t head;
+    int result;
+
+    if (DMA_Channel_Number < 0)
+    {
+        DMA_Channel_Number = DMA_Allocate(DMA_TRIGGER_SOFTWARE);
+    }
+    if ((DMA_Channel_Number < 0) || DMA_Is_Enabled(DMA_Channel_Number))
+    {
+        return MEMORY_BLOCK_ERROR_BUSY;
+    }
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    DMA_Task_Count = 0;
+
+    // Word tasks need both addresses aligned after the head bytes. The fill pattern is a word, so a fill only depends on the destination.
+    if (source_fixed || Same_Alignment(destination, source))
+    {
+        head = Head_Length(destination, length);
+        result = Add_Tasks(&destination, &source, source_fixed, head, byte_control, 0);
+        if (result == 0)
+        {
+            result = Add_Tasks(&destination, &source, source_fixed, (length - head) >> 2, word_control, 2);
+        }
+        if (result == 0)
+        {
+            result = Add_Tasks(&destination, &source, source_fixed, (length - head) & 0x03, byte_control, 0);
+        }
+    }
+    else
+    {
+        result = Add_Tasks(&destination, &source, source_fixed, length, byte_control, 0);
+    }
+
+    if (result < 0)
+    {
+        return result;
+    }
+
+    // A memory scatter-gather list runs every task after one software request
+    DMA_Set_Scatter_Gather(DMA_Channel_Number, DMA_Tasks, DMA_Task_Count, 0);
+    DMA_Enable(DMA_Channel_Number);
+    DMA_Request(DMA_Channel_Number);
+
+    return 0;
+}
+
+int Memory_Block_DMA_Copy_Start(void *destination, const void *source, uint32_t length)
+{
+    return DMA_Start(destination, source, 0, length);
+}
+
+int Memory_Block_DMA_Fill_Start(void *destination, uint8_t value, uint32_t length)
+{
+    if (Memory_Block_DMA_Is_Busy())
+    {
+        return MEMORY_BLOCK_ERROR_BUSY;
+    }
+
+    DMA_Fill_Pattern = (uint32_t)value * 0x01010101u;
+
+    return DMA_Start(destination, (const uint8_t *)&DMA_Fill_Pattern, 1, length);
+}
+
+uint8_t Memory_Block_DMA_Is_Busy()
+{
+    return (DMA_Channel_Number >= 0) ? DMA_Is_Enabled(DMA_Channel_Number) : 0;
+}
+
+void Memory_Block_DMA_Copy(void *destination, const void *source, uint32_t length)
+{
+    if (Memory_Block_DMA_Copy_Start(destination, source, length) < 0)
+    {
+        Memory_Block_Copy(destination, source, length);
+        return;
+    }
+
+    while (Memory_Block_DMA_Is_Busy());
+}
+
+void Memory_Block_DMA_Fill(void *destination, uint8_t value, uint32_t length)
+{
+    if (Memory_Block_DMA_Fill_Start(destination, value, length) < 0)
+    {
+        Memory_Block_Fill(destination, value, length);
+        return;
+    }
+
+    while (Memory_Block_DMA_Is_Busy());
+}
@@ -0,0 +1,113 @@
+;******************************************************************************
+; @file Memory_Block_Loops.asm
+; @brief Inner loops of the Memory_Block driver.
+;
+; The loops are written in assembly so that they keep the LDM/STM and the SIMD
+; (USUB8, SEL, USADA8) instructions whatever the optimization level. They follow
+; the AAPCS: the arguments are in R0 to R3, the result is returned in R0, R12
+; is used as a scratch register and R4 to R9 are saved. The pointers are
+; aligned to a word and the number of blocks is not 0 (checked by the callers
+; in Memory_Block.c).
+;
+; @author Michael Granberry
+;
+;******************************************************************************
+
+        .thumb
+        .text
+        .align  2
+
+        .global Memory_Block_Fill_Blocks
+        .global Memory_Block_Copy_Blocks
+        .global Memory_Block_Compare_Blocks
+        .global Memory_Block_Count_Blocks
+
+;------------------------------------------------------------------------------
+; void Memory_Block_Fill_Blocks(uint32_t *destination, uint32_t pattern, uint32_t blocks)
+; Writes pattern to blocks * 32 bytes.
+;------------------------------------------------------------------------------
+Memory_Block_Fill_Blocks: .asmfunc
+        PUSH    {R4, R5}
+        MOV     R3, R1
+        MOV     R4, R1
+        MOV     R5, R1
+Fill_Loop:
+        STMIA   R0!, {R1, R3, R4, R5}
+        STMIA   R0!, {R1, R3, R4, R5}
+        SUBS    R2, R2, #1
+        BNE     Fill_Loop
+        POP     {R4, R5}
+        BX      LR
+        .endasmfunc
+
+;------------------------------------------------------------------------------
+; void Memory_Block_Copy_Blocks(uint32_t *destination, const uint32_t *source, uint32_t blocks)
+; Copies blocks * 32 bytes.
+;------------------------------------------------------------------------------
+Memory_Block_Copy_Blocks: .asmfunc
+        PUSH    {R4, R5, R6}
+Copy_Loop:
+        LDMIA   R1!, {R3, R4, R5, R6}
+        STMIA   R0!, {R3, R4, R5, R6}
+        LDMIA   R1!, {R3, R4, R5, R6}
+        STMIA   R0!, {R3, R4, R5, R6}
+        SUBS    R2, R2, #1
+        BNE     Copy_Loop
+        POP     {R4, R5, R6}
+        BX      LR
+        .endasmfunc
+
+;------------------------------------------------------------------------------
+; uint32_t Memory_Block_Compare_Blocks(const uint32_t *a, const uint32_t *b, uint32_t blocks)
+; Compares blocks of 8 bytes until two differ. Returns the number of blocks
+; left, including the one that differs (0 if all are equal).
+;------------------------------------------------------------------------------
+Memory_Block_Compare_Blocks: .asmfunc
+        PUSH    {R4, R5, R6, R7}
+Compare_Loop:
+        LDMIA   R0!, {R4, R5}
+        LDMIA   R1!, {R6, R7}
+        EOR     R4, R4, R6
+        EOR     R5, R5, R7
+        ORRS    R4, R4, R5
+        BNE     Compare_Done
+        SUBS    R2, R2, #1
+        BNE     Compare_Loop
+Compare_Done:
+        MOV     R0, R2
+        POP     {R4, R5, R6, R7}
+        BX      LR
+        .endasmfunc
+
+;------------------------------------------------------------------------------
+; uint32_t Memory_Block_Count_Blocks(const uint32_t *a, const uint32_t *b, uint32_t blocks)
+; Returns the number of bytes that differ in blocks of 8 bytes.
+; USUB8 of 0 minus the XOR of two words sets the GE flag of a lane only when
+; the lane is 0 (equal bytes), SEL then picks 0 for the equal lanes and 1 for
+; the other ones, and USADA8 adds the four lanes to the count.
+;------------------------------------------------------------------------------
+Memory_Block_Count_Blocks: .asmfunc
+        PUSH    {R4, R5, R6, R7, R8, R9}
+        MOV     R8, #0
+        MOVW    R9, #0x0101
+        MOVT    R9, #0x0101
+        MOV     R12, #0
+Count_Loop:
+        LDMIA   R0!, {R4, R5}
+        LDMIA   R1!, {R6, R7}
+        EOR     R4, R4, R6
+        EOR     R5, R5, R7
+        USUB8   R4, R8, R4
+        SEL     R4, R8, R9
+        USADA8  R12, R4, R8, R12
+        USUB8   R5, R8, R5
+        SEL     R5, R8, R9
+        USADA8  R12, R5, R8, R12
+        SUBS    R2, R2, #1
+        BNE     Count_Loop
+        MOV     R0, R12
+        POP     {R4, R5, R6, R7, R8, R9}
+        BX      LR
+        .endasmfunc
+
+        .end
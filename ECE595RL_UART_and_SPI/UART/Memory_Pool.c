@@ -0,0 +1,219 @@
+/**
+ * @file Memory_Pool.c
+ * @brief Source code for the Memory_Pool library.
+ *
+ * This file contains the function definitions for the Memory_Pool library.
+ * Each size class has a singly linked list of free blocks. The link is stored in the first bytes of the free block,
+ * so only the 8-byte header is needed in addition to the data. The lists and the reference counts are only changed
+ * in a critical section, for a few instructions.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Memory_Pool.h"
+
+#ifndef MEMORY_POOL_HOST
+#include "../inc/Critical_Section.h"
+#endif
+
+#define HEADER_SIZE         8
+#define HEADER_MAGIC        0x4D50  // "MP", marks an allocated block
+
+/**
+ * @brief Header in front of each block.
+ */
+typedef struct
+{
+    uint8_t size_class;
+    uint8_t reserved;
+    uint16_t magic;                 // HEADER_MAGIC while the block is allocated, otherwise 0
+    uint32_t references;
+} Memory_Pool_Header;
+
+/**
+ * @brief State of one size class.
+ */
+typedef struct
+{
+    uint8_t *storage;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint8_t *free_list;             // First free block (its data area holds the address of the next one)
+    Memory_Pool_Stats stats;
+} Memory_Pool_Class;
+
+// uint64_t keeps the storage aligned to 8 bytes
+static uint64_t Class_0_Storage[MEMORY_POOL_CLASS_0_COUNT * (HEADER_SIZE + MEMORY_POOL_CLASS_0_SIZE) / 8];
+static uint64_t Class_1_Storage[MEMORY_POOL_CLASS_1_COUNT * (HEADER_SIZE + MEMORY_POOL_CLASS_1_SIZE) / 8];
+static uint64_t Class_2_Storage[MEMORY_POOL_CLASS_2_COUNT * (HEADER_SIZE + MEMORY_POOL_CLASS_2_SIZE) / 8];
+
+static Memory_Pool_Class Classes[MEMORY_POOL_NUM_CLASSES] = {
+    // Storage                          Block Size                  Block Count
+    {(uint8_t *)Class_0_Storage,        MEMORY_POOL_CLASS_0_SIZE,   MEMORY_POOL_CLASS_0_COUNT},
+    {(uint8_t *)Class_1_Storage,        MEMORY_POOL_CLASS_1_SIZE,   MEMORY_POOL_CLASS_1_COUNT},
+    {(uint8_t *)Class_2_Storage,        MEMORY_POOL_CLASS_2_SIZE,   MEMORY_POOL_CLASS_2_COUNT}
+};
+
+#ifdef MEMORY_POOL_HOST
+static uint32_t Lock()
+{
+    return 0;
+}
+
+static void Unlock(uint32_t primask)
+{
+    (void)primask;
+}
+#else
+static uint32_t Lock()
+{
+    return Critical_Section_Enter();
+}
+
+static void Unlock(uint32_t section)
+{
+    Critical_Section_Exit(section);
+}
+#endif
+
+static Memory_Pool_Header *Header_Of(const void *block)
+{
+    return (Memory_Pool_Header *)((uint8_t *)block - HEADER_SIZE);
+}
+
+void Memory_Pool_Init()
+{
+    Memory_Pool_Class *pool;
+    uint8_t *block;
+    uint32_t i;
+    uint8_t c;
+
+    for (c = 0; c < MEMORY_POOL_NUM_CLASSES; c++)
+    {
+        pool = &Classes[c];
+        pool->free_list = 0;
+
+        // Link the blocks in address order
+        for (i = pool->block_count; i > 0; i--)
+        {
+            block = pool->storage + (i - 1) * (HEADER_SIZE + pool->block_size) + HEADER_SIZE;
+            Header_Of(block)->size_class = c;
+            Header_Of(block)->magic = 0;
+            Header_Of(block)->references = 0;
+            *(uint8_t **)block = pool->free_list;
+            pool->free_list = block;
+        }
+
+        pool->stats.block_size = pool->block_size;
+        pool->stats.block_count = pool->block_count;
+        pool->stats.in_use = 0;
+        pool->stats.high_water = 0;
+        pool->stats.allocations = 0;
+        pool->stats.fallbacks = 0;
+        pool->stats.failures = 0;
+    }
+}
+
+void *Memory_Pool_Alloc(uint32_t size)
+{
+    Memory_Pool_Class *pool;
+    uint8_t *block = 0;
+    uint32_t primask;
+    uint8_t requested;
+    uint8_t c;
+
+    // Smallest class that fits
+    for (requested = 0; requested < MEMORY_POOL_NUM_CLASSES; requested++)
+    {
+        if (size <= Classes[requested].block_size)
+        {
+            break;
+        }
+    }
+    if (requested == MEMORY_POOL_NUM_CLASSES)
+    {
+        return 0;
+    }
+
+    primask = Lock();
+    for (c = requested; c < MEMORY_POOL_NUM_CLASSES; c++)
+    {
+        pool = &Classes[c];
+        block = pool->free_list;
+        if (block)
+        {
+            pool->free_list = *(uint8_t **)block;
+            pool->stats.allocations++;
+            pool->stats.in_use++;
+            if (pool->stats.in_use > pool->stats.high_water)
+            {
+                pool->stats.high_water = pool->stats.in_use;
+            }
+            Header_Of(block)->magic = HEADER_MAGIC;
+            Header_Of(block)->references = 1;
+            break;
+        }
+    }
+
+    if (block == 0)
+    {
+        Classes[requested].stats.failures++;
+    }
+    else if (c != requested)
+    {
+        Classes[requested].stats.fallbacks++;
+    }
+    Unlock(primask);
+
+    return block;
+}
+
+void *Memory_Pool_Retain(void *block)
+{
+    uint32_t primask = Lock();
+
+    Header_Of(block)->references++;
+    Unlock(primask);
+
+    return block;
+}
+
+void Memory_Pool_Release(void *block)
+{
+    Memory_Pool_Header *header;
+    Memory_Pool_Class *pool;
+    uint32_t primask;
+
+    if (block == 0)
+    {
+        return;
+    }
+
+    header = Header_Of(block);
+    primask = Lock();
+
+    // A block that is not allocated (released too many times) is left alone
+    if ((header->magic == HEADER_MAGIC) && (--header->references == 0))
+    {
+        pool = &Classes[header->size_class];
+        header->magic = 0;
+        *(uint8_t **)block = pool->free_list;
+        pool->free_list = block;
+        pool->stats.in_use--;
+    }
+    Unlock(primask);
+}
+
+uint32_t Memory_Pool_Block_Size(const void *block)
+{
+    return Classes[Header_Of(block)->size_class].block_size;
+}
+
+void Memory_Pool_Get_Stats(uint8_t size_class, Memory_Pool_Stats *stats)
+{
+    uint32_t primask = Lock();
+
+    *stats = Classes[size_class].stats;
+    Unlock(primask);
+}
@@ -0,0 +1,281 @@
+/**
+ * @file Number_Parser.c
+ * @brief Source code for the Number_Parser library.
+ *
+ * This file contains the function definitions for the Number_Parser library.
+ * Overflow is checked before each digit is added: magnitude * base + digit fits in the limit of the number
+ * (for example 2147483648 for a negative signed number) if magnitude is below limit / base, or equal to it
+ * and digit is at most limit % base. Both values are computed once per number, so no division is done per digit.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Number_Parser.h"
+
+#define STATE_IDLE          0   // Between numbers
+#define STATE_START         1   // First character of a number
+#define STATE_SIGN          2   // After the sign
+#define STATE_PREFIX        3   // After the 0x or 0b prefix
+#define STATE_INTEGER       4   // In the integer digits
+#define STATE_FRACTION      5   // In the fractional digits
+#define STATE_SKIP          6   // After an error, up to the next delimiter
+
+#define NOT_A_DIGIT         0xFF
+
+static const uint32_t Powers_Of_10[NUMBER_PARSER_MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static uint8_t Digit_Value(char character)
+{
+    uint8_t value = (uint8_t)(character - '0');
+
+    if (value <= 9)
+    {
+        return value;
+    }
+
+    // Lowercase letters: 'a' to 'f' are 10 to 15
+    value = (uint8_t)((character | 0x20) - 'a');
+    if (value <= 5)
+    {
+        return value + 10;
+    }
+
+    return NOT_A_DIGIT;
+}
+
+static uint8_t Is_Delimiter(char character)
+{
+    return (character == ' ') || (character == ',') || (character == '\r') || (character == '\n')
+           || (character == '\t') || (character == ';') || (character == 0);
+}
+
+static void Set_Limit(Number_Parser *parser)
+{
+    uint32_t limit;
+
+    if ((parser->format == NUMBER_PARSER_SIGNED) || (parser->format == NUMBER_PARSER_FIXED))
+    {
+        limit = parser->negative ? 0x80000000 : 0x7FFFFFFF;
+    }
+    else
+    {
+        limit = 0xFFFFFFFF;
+    }
+
+    parser->limit_quotient = limit / parser->base;
+    parser->limit_remainder = limit % parser->base;
+}
+
+/**
+ * @brief Completes the current number at its delimiter. state is the state before the delimiter.
+ */
+static int End_Number(Number_Parser *parser, uint8_t state, uint32_t *value)
+{
+    uint32_t magnitude = parser->magnitude;
+    uint8_t missing;
+
+    if ((parser->digits == 0) || (state == STATE_PREFIX))
+    {
+        return NUMBER_PARSER_ERROR_SYNTAX;
+    }
+
+    // Scale a fixed-point number with fewer fractional digits than decimal places, for example 12.5 to 12500
+    if (parser->format == NUMBER_PARSER_FIXED)
+    {
+        missing = parser->decimals - parser->fraction_digits;
+        if (magnitude > (parser->limit_quotient * 10 + parser->limit_remainder) / Powers_Of_10[missing])
+        {
+            return NUMBER_PARSER_ERROR_OVERFLOW;
+        }
+        magnitude *= Powers_Of_10[missing];
+    }
+
+    *value = parser->negative ? (0 - magnitude) : magnitude;
+
+    return NUMBER_PARSER_DONE;
+}
+
+int Number_Parser_Init(Number_Parser *parser, uint8_t format, uint8_t decimals)
+{
+    static const uint8_t Bases[5] = {10, 10, 16, 2, 10};
+
+    if ((format > NUMBER_PARSER_FIXED) || (decimals > NUMBER_PARSER_MAX_DECIMALS))
+    {
+        return NUMBER_PARSER_ERROR_FORMAT;
+    }
+
+    parser->format = format;
+    parser->base = Bases[format];
+    parser->decimals = (format == NUMBER_PARSER_FIXED) ? decimals : 0;
+    parser->state = STATE_IDLE;
+    parser->negative = 0;
+    parser->digits = 0;
+    parser->fraction_digits = 0;
+    parser->magnitude = 0;
+    Set_Limit(parser);
+
+    return 0;
+}
+
+int Number_Parser_Feed(Number_Parser *parser, char character, uint32_t *value)
+{
+    uint8_t state = parser->state;
+    uint8_t digit;
+
+    if (Is_Delimiter(character))
+    {
+        parser->state = STATE_IDLE;
+        if ((state == STATE_IDLE) || (state == STATE_SKIP))
+        {
+            return NUMBER_PARSER_MORE;
+        }
+        return End_Number(parser, state, value);
+    }
+
+    if (state == STATE_SKIP)
+    {
+        return NUMBER_PARSER_MORE;
+    }
+
+    if (state == STATE_IDLE)
+    {
+        if (parser->negative)
+        {
+            parser->negative = 0;
+            Set_Limit(parser);
+        }
+        parser->digits = 0;
+        parser->fraction_digits = 0;
+        parser->magnitude = 0;
+        state = STATE_START;
+        parser->state = STATE_START;
+
+        // Signs are only accepted by the decimal formats, and '-' only by the signed ones
+        if ((character == '+') && (parser->base == 10))
+        {
+            parser->state = STATE_SIGN;
+            return NUMBER_PARSER_MORE;
+        }
+        if ((character == '-') && ((parser->format == NUMBER_PARSER_SIGNED) || (parser->format == NUMBER_PARSER_FIXED)))
+        {
+            parser->negative = 1;
+            Set_Limit(parser);
+            parser->state = STATE_SIGN;
+            return NUMBER_PARSER_MORE;
+        }
+    }
+
+    digit = Digit_Value(character);
+    if (digit < parser->base)
+    {
+        if (parser->digits < 0xFF)
+        {
+            parser->digits++;
+        }
+
+        // Fractional digits beyond the decimal places are checked but truncated
+        if (state == STATE_FRACTION)
+        {
+            if (parser->fraction_digits == parser->decimals)
+            {
+                return NUMBER_PARSER_MORE;
+            }
+            parser->fraction_digits++;
+        }
+        else
+        {
+            parser->state = STATE_INTEGER;
+        }
+
+        if ((parser->magnitude > parser->limit_quotient)
+            || ((parser->magnitude == parser->limit_quotient) && (digit > parser->limit_remainder)))
+        {
+            parser->state = STATE_SKIP;
+            return NUMBER_PARSER_ERROR_OVERFLOW;
+        }
+        parser->magnitude = parser->magnitude * parser->base + digit;
+
+        return NUMBER_PARSER_MORE;
+    }
+
+    // 0x or 0b prefix after a single leading zero
+    if ((state == STATE_INTEGER) && (parser->digits == 1) && (parser->magnitude == 0)
+        && (((parser->format == NUMBER_PARSER_HEX) && ((character | 0x20) == 'x'))
+            || ((parser->format == NUMBER_PARSER_BINARY) && ((character | 0x20) == 'b'))))
+    {
+        parser->state = STATE_PREFIX;
+        return NUMBER_PARSER_MORE;
+    }
+
+    if ((character == '.') && (parser->format == NUMBER_PARSER_FIXED) && (state != STATE_FRACTION))
+    {
+        parser->state = STATE_FRACTION;
+        return NUMBER_PARSER_MORE;
+    }
+
+    parser->state = STATE_SKIP;
+    return NUMBER_PARSER_ERROR_SYNTAX;
+}
+
+int32_t Number_Parser_Parse(Number_Parser *parser, const char *line, uint32_t length, uint32_t *values, uint32_t max_values)
+{
+    uint32_t count = 0;
+    uint32_t magnitude;
+    uint32_t start;
+    uint32_t i = 0;
+    uint8_t digit;
+    int result;
+
+    while (count < max_values)
+    {
+        // Fast path: the following integer digits are added without going through the state machine
+        if (parser->state == STATE_INTEGER)
+        {
+            magnitude = parser->magnitude;
+            start = i;
+            while ((i < length) && ((digit = Digit_Value(line[i])) < parser->base))
+            {
+                if ((magnitude > parser->limit_quotient)
+                    || ((magnitude == parser->limit_quotient) && (digit > parser->limit_remainder)))
+                {
+                    break;
+                }
+                magnitude = magnitude * parser->base + digit;
+                i++;
+            }
+            parser->magnitude = magnitude;
+
+            // The exact count does not matter after the first digit, only that a prefix is no longer allowed
+            if ((i > start) && (parser->digits < 2))
+            {
+                parser->digits = 2;
+            }
+        }
+
+        // The end of the line is a delimiter
+        result = Number_Parser_Feed(parser, (i < length) ? line[i] : 0, &values[count]);
+        if (result == NUMBER_PARSER_DONE)
+        {
+            count++;
+        }
+        else if (result < 0)
+        {
+            parser->state = STATE_IDLE;
+            return result;
+        }
+
+        if (i >= length)
+        {
+            break;
+        }
+        i++;
+    }
+
+    // Parsing stopped at max_values: the rest of the line is dropped
+    parser->state = STATE_IDLE;
+
+    return count;
+}
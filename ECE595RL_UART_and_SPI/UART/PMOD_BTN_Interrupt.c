@@ -23,24 +23,16 @@
  */
 
 #include "../inc/PMOD_BTN_Interrupt.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/Interrupt_Priority.h"
 
 void PMOD_BTN_Interrupt_Init(void(*task)(uint8_t))
 {
     // Store the user-defined task function for use during interrupt handling
     PMOD_BTN_Task = task;
 
-    // Configure the following pins as GPIO pins: P6.0, P6.1, P6.2, and P6.3
-    P6->SEL0 &= ~0x0F;
-    P6->SEL1 &= ~0x0F;
-
-    // Set the following pins as input: P6.0, P6.1, P6.2, and P6.3
-    P6->DIR &= ~0x0F;
-
-    // Enable pull-down resistors on the following pins: P6.0, P6.1, P6.2, and P6.3
-    P6->REN |= 0x0F;
-
-    // Ensure that the pins are pulled down: P6.0, P6.1, P6.2, and P6.3
-    P6->OUT &= ~0x0F;
+    // Configure the following pins as GPIO inputs with pull-down resistors: P6.0, P6.1, P6.2, and P6.3
+    PIN_MAP_CONFIGURE(PIN_GROUP_PMOD_BTN);
 
     // Interrupt Edge Select: Low-to-High Transition
     // Configure the pins to use rising edge event triggers: P6.0, P6.1, P6.2, and P6.3
@@ -52,8 +44,8 @@ void PMOD_BTN_Interrupt_Init(void(*task)(uint8_t))
     // Enable interrupts on the following pins: P6.0, P6.1, P6.2, and P6.3
     P6->IE |= 0x0F;
 
-    // Set the priority of the interrupts (IRQ 40) to 0 (section 2.4.3.21)
-    NVIC->IP[10] = (NVIC->IP[10] & 0xFFFFFF0F);
+    // Set the priority of the interrupts (IRQ 40) (section 2.4.3.21)
+    NVIC->IP[40] = (INTERRUPT_PRIORITY_PMOD_BTN << 5);
 
     // Enable Interrupt 40 in NVIC (section 2.4.3.2)
     // Bit 8 corresponds to IRQ 40
@@ -0,0 +1,33 @@
+;******************************************************************************
+; @file Profiler_Handler.asm
+; @brief Timer32 module 1 interrupt handler of the Profiler driver.
+;
+; T32_INT1_IRQHandler finds the stack frame that the CPU pushed on entry (on
+; MSP or PSP, as told by bit 2 of EXC_RETURN in LR) and passes the stacked PC
+; (offset 24) and LR (offset 20) to Profiler_Record. It is written in assembly
+; so that nothing is pushed before the stack frame is read. Profiler_Record is
+; entered with a branch, so EXC_RETURN is still in LR and its return is the
+; return from the interrupt.
+;
+; @author Michael Granberry
+;
+;******************************************************************************
+
+        .thumb
+        .text
+        .align  2
+
+        .global T32_INT1_IRQHandler
+        .ref    Profiler_Record
+
+T32_INT1_IRQHandler: .asmfunc
+        TST     LR, #4                  ; bit 2 of EXC_RETURN: 0 for MSP, 1 for PSP
+        ITE     EQ
+        MRSEQ   R0, MSP
+        MRSNE   R0, PSP
+        LDR     R1, [R0, #20]           ; stacked LR
+        LDR     R0, [R0, #24]           ; stacked PC
+        B       Profiler_Record
+        .endasmfunc
+
+        .end
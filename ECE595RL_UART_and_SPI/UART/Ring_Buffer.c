@@ -0,0 +1,199 @@
+/**
+ * @file Ring_Buffer.c
+ * @brief Source code for the Ring_Buffer library.
+ *
+ * This file contains the function definitions for the Ring_Buffer library.
+ * The producer functions only write head and the consumer functions only write tail.
+ * Each function reads the index of the other side once, so that it works on a consistent snapshot.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <string.h>
+#include "../inc/Ring_Buffer.h"
+
+/**
+ * @brief Copies count elements starting at index into or out of the storage, in two parts if they wrap around.
+ */
+static void Copy_In(Ring_Buffer *ring, uint32_t index, const uint8_t *elements, uint32_t count)
+{
+    uint32_t position = index & ring->mask;
+    uint32_t first = ring->mask + 1 - position;
+
+    if (first > count)
+    {
+        first = count;
+    }
+    memcpy(&ring->data[position * ring->element_size], elements, first * ring->element_size);
+    memcpy(ring->data, &elements[first * ring->element_size], (count - first) * ring->element_size);
+}
+
+static void Copy_Out(Ring_Buffer *ring, uint32_t index, uint8_t *elements, uint32_t count)
+{
+    uint32_t position = index & ring->mask;
+    uint32_t first = ring->mask + 1 - position;
+
+    if (first > count)
+    {
+        first = count;
+    }
+    memcpy(elements, &ring->data[position * ring->element_size], first * ring->element_size);
+    memcpy(&elements[first * ring->element_size], ring->data, (count - first) * ring->element_size);
+}
+
+int Ring_Buffer_Init(Ring_Buffer *ring, void *storage, uint32_t element_size, uint32_t capacity)
+{
+    if ((capacity == 0) || (capacity & (capacity - 1)))
+    {
+        return RING_BUFFER_ERROR_CAPACITY;
+    }
+
+    ring->head = 0;
+    ring->tail = 0;
+    ring->data = storage;
+    ring->mask = capacity - 1;
+    ring->element_size = element_size;
+
+    return 0;
+}
+
+uint8_t Ring_Buffer_Push(Ring_Buffer *ring, const void *element)
+{
+    uint32_t head = ring->head;
+
+    if ((head - ring->tail) > ring->mask)
+    {
+        return 0;
+    }
+
+    // The consumer has finished reading the slot before it published tail
+    RING_BUFFER_BARRIER();
+    memcpy(&ring->data[(head & ring->mask) * ring->element_size], element, ring->element_size);
+
+    // Publish the element after it is written
+    RING_BUFFER_BARRIER();
+    ring->head = head + 1;
+
+    return 1;
+}
+
+uint8_t Ring_Buffer_Pop(Ring_Buffer *ring, void *element)
+{
+    uint32_t tail = ring->tail;
+
+    if (ring->head == tail)
+    {
+        return 0;
+    }
+
+    // Read the element after head shows that it was written
+    RING_BUFFER_BARRIER();
+    memcpy(element, &ring->data[(tail & ring->mask) * ring->element_size], ring->element_size);
+
+    // Free the slot after the element is read
+    RING_BUFFER_BARRIER();
+    ring->tail = tail + 1;
+
+    return 1;
+}
+
+uint32_t Ring_Buffer_Push_Multiple(Ring_Buffer *ring, const void *elements, uint32_t count)
+{
+    uint32_t head = ring->head;
+    uint32_t free = ring->mask + 1 - (head - ring->tail);
+
+    if (count > free)
+    {
+        count = free;
+    }
+
+    if (count > 0)
+    {
+        RING_BUFFER_BARRIER();
+        Copy_In(ring, head, elements, count);
+        RING_BUFFER_BARRIER();
+        ring->head = head + count;
+    }
+
+    return count;
+}
+
+uint32_t Ring_Buffer_Pop_Multiple(Ring_Buffer *ring, void *elements, uint32_t count)
+{
+    uint32_t tail = ring->tail;
+    uint32_t available = ring->head - tail;
+
+    if (count > available)
+    {
+        count = available;
+    }
+
+    if (count > 0)
+    {
+        RING_BUFFER_BARRIER();
+        Copy_Out(ring, tail, elements, count);
+        RING_BUFFER_BARRIER();
+        ring->tail = tail + count;
+    }
+
+    return count;
+}
+
+uint32_t Ring_Buffer_Write_Span(Ring_Buffer *ring, void **span)
+{
+    uint32_t head = ring->head;
+    uint32_t free = ring->mask + 1 - (head - ring->tail);
+    uint32_t position = head & ring->mask;
+
+    if (free > (ring->mask + 1 - position))
+    {
+        free = ring->mask + 1 - position;
+    }
+
+    // The slots must not be written before the consumer has finished reading them
+    RING_BUFFER_BARRIER();
+    *span = &ring->data[position * ring->element_size];
+
+    return free;
+}
+
+void Ring_Buffer_Commit(Ring_Buffer *ring, uint32_t count)
+{
+    RING_BUFFER_BARRIER();
+    ring->head += count;
+}
+
+uint32_t Ring_Buffer_Read_Span(Ring_Buffer *ring, const void **span)
+{
+    uint32_t tail = ring->tail;
+    uint32_t available = ring->head - tail;
+    uint32_t position = tail & ring->mask;
+
+    if (available > (ring->mask + 1 - position))
+    {
+        available = ring->mask + 1 - position;
+    }
+
+    // The elements must not be read before head shows that they were written
+    RING_BUFFER_BARRIER();
+    *span = &ring->data[position * ring->element_size];
+
+    return available;
+}
+
+void Ring_Buffer_Consume(Ring_Buffer *ring, uint32_t count)
+{
+    RING_BUFFER_BARRIER();
+    ring->tail += count;
+}
+
+uint32_t Ring_Buffer_Count(const Ring_Buffer *ring)
+{
+    return ring->head - ring->tail;
+}
+
+uint32_t Ring_Buffer_Free(const Ring_Buffer *ring)
+{
+    return ring->mask + 1 - (ring->head - ring->tail);
+}
@@ -0,0 +1,477 @@
+/**
+ * @file Stream.c
+ * @brief Source code for the Stream library.
+ *
+ * This file contains the function definitions for the Stream library.
+ * All numbers go through Put_Number: it counts the digits first, so that the final length is known, and then
+ * writes the digits from right to left directly at their place in the buffer of the sink.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <string.h>
+#include "../inc/Stream.h"
+
+/**
+ * @brief Size of the local array used when a sink has no buffer, or not enough free space
+ */
+#define NUMBER_BUFFER_SIZE  48
+
+/**
+ * @brief Maximum number of digits of a number padded with zeros
+ */
+#define MAX_DIGITS          32
+
+#define FLAG_LEFT           0x01    // Left-justify (pad on the right)
+#define FLAG_ZERO           0x02    // Pad with zeros after the sign
+#define FLAG_LOWERCASE      0x04    // Lowercase hexadecimal digits
+
+static const char Uppercase_Digits[16] = "0123456789ABCDEF";
+static const char Lowercase_Digits[16] = "0123456789abcdef";
+static const char Spaces[16] = "                ";
+
+static uint8_t Count_Digits(uint32_t n, uint8_t base)
+{
+    uint8_t digits = 1;
+
+    if (base == 16)
+    {
+        while (n >= 0x10)
+        {
+            n >>= 4;
+            digits++;
+        }
+    }
+    else
+    {
+        while (n >= 10)
+        {
+            n /= 10;
+            digits++;
+        }
+    }
+
+    return digits;
+}
+
+static uint32_t Put_Padding(Stream *stream, uint32_t count)
+{
+    uint32_t written = 0;
+
+    while (count > sizeof(Spaces))
+    {
+        written += Stream_Write(stream, Spaces, sizeof(Spaces));
+        count -= sizeof(Spaces);
+    }
+
+    return written + Stream_Write(stream, Spaces, count);
+}
+
+/**
+ * @brief Writes a number with its sign, decimal point and padding.
+ *
+ * @return Number of characters written.
+ */
+static uint32_t Put_Number(Stream *stream, uint32_t magnitude, uint8_t negative, uint8_t base, uint8_t decimals,
+                           uint8_t min_digits, uint8_t width, uint8_t flags)
+{
+    const char *digit_characters = (flags & FLAG_LOWERCASE) ? Lowercase_Digits : Uppercase_Digits;
+    char local[NUMBER_BUFFER_SIZE];
+    char *buffer = 0;
+    char *position;
+    uint32_t space = 0;
+    uint32_t written = 0;
+    uint32_t length;
+    uint32_t total;
+    uint32_t pad;
+    uint32_t pad_after = 0;
+    uint8_t digits;
+    uint8_t i;
+
+    // Zero padding fills the width with digits
+    if ((flags & FLAG_ZERO) && !(flags & FLAG_LEFT) && (width > negative + (decimals ? 1 : 0)))
+    {
+        min_digits = width - negative - (decimals ? 1 : 0);
+    }
+    if (min_digits > MAX_DIGITS)
+    {
+        min_digits = MAX_DIGITS;
+    }
+
+    digits = Count_Digits(magnitude, base);
+    if (digits <= decimals)
+    {
+        digits = decimals + 1;
+    }
+    if (digits < min_digits)
+    {
+        digits = min_digits;
+    }
+
+    length = digits + negative + (decimals ? 1 : 0);
+    pad = (width > length) ? (width - length) : 0;
+
+    // Very wide padding is written on its own
+    if (length + pad > NUMBER_BUFFER_SIZE)
+    {
+        if (flags & FLAG_LEFT)
+        {
+            pad_after = pad;
+        }
+        else
+        {
+            written += Put_Padding(stream, pad);
+        }
+        pad = 0;
+    }
+    total = length + pad;
+
+    if (stream->interface->get_buffer)
+    {
+        space = stream->interface->get_buffer(stream, &buffer);
+    }
+    if (space < total)
+    {
+        buffer = local;
+    }
+
+    position = buffer;
+    if (!(flags & FLAG_LEFT))
+    {
+        memset(position, ' ', pad);
+        position += pad;
+    }
+    if (negative)
+    {
+        *position++ = '-';
+    }
+
+    // Digits from right to left, with the decimal point after the fractional digits
+    position += length - negative;
+    if (base == 16)
+    {
+        for (i = 0; i < digits; i++)
+        {
+            *--position = digit_characters[magnitude & 0x0F];
+            magnitude >>= 4;
+        }
+    }
+    else
+    {
+        for (i = 0; i < digits; i++)
+        {
+            if (decimals && (i == decimals))
+            {
+                *--position = '.';
+            }
+            *--position = '0' + (magnitude % 10);
+            magnitude /= 10;
+        }
+    }
+    position += length - negative;
+
+    if (flags & FLAG_LEFT)
+    {
+        memset(position, ' ', pad);
+    }
+
+    if (buffer == local)
+    {
+        written += Stream_Write(stream, local, total);
+    }
+    else
+    {
+        stream->interface->commit(stream, total);
+        written += total;
+    }
+
+    if (pad_after)
+    {
+        written += Put_Padding(stream, pad_after);
+    }
+
+    return written;
+}
+
+/**
+ * @brief Functions of the RAM sink
+ */
+static uint32_t Memory_Write(Stream *stream, const char *data, uint32_t length)
+{
+    Stream_Memory *sink = (Stream_Memory *)stream;
+    uint32_t free = sink->size - 1 - sink->length;
+
+    if (length > free)
+    {
+        sink->dropped += length - free;
+        length = free;
+    }
+
+    memcpy(&sink->buffer[sink->length], data, length);
+    sink->length += length;
+    sink->buffer[sink->length] = 0;
+
+    return length;
+}
+
+static uint32_t Memory_Get_Buffer(Stream *stream, char **buffer)
+{
+    Stream_Memory *sink = (Stream_Memory *)stream;
+
+    *buffer = &sink->buffer[sink->length];
+
+    return sink->size - 1 - sink->length;
+}
+
+static void Memory_Commit(Stream *stream, uint32_t count)
+{
+    Stream_Memory *sink = (Stream_Memory *)stream;
+
+    sink->length += count;
+    sink->buffer[sink->length] = 0;
+}
+
+static const Stream_Interface Memory_Interface = {Memory_Write, Memory_Get_Buffer, Memory_Commit, 0};
+
+/**
+ * @brief Functions of the null sink
+ */
+static uint32_t Null_Write(Stream *stream, const char *data, uint32_t length)
+{
+    ((Stream_Null *)stream)->bytes += length;
+
+    return length;
+}
+
+static uint32_t Null_Get_Buffer(Stream *stream, char **buffer)
+{
+    *buffer = ((Stream_Null *)stream)->scratch;
+
+    return STREAM_NULL_BUFFER_SIZE;
+}
+
+static void Null_Commit(Stream *stream, uint32_t count)
+{
+    ((Stream_Null *)stream)->bytes += count;
+}
+
+static const Stream_Interface Null_Interface = {Null_Write, Null_Get_Buffer, Null_Commit, 0};
+
+Stream *Stream_Memory_Init(Stream_Memory *sink, char *buffer, uint32_t size)
+{
+    sink->stream.interface = &Memory_Interface;
+    sink->buffer = buffer;
+    sink->size = size;
+    Stream_Memory_Clear(sink);
+
+    return &sink->stream;
+}
+
+void Stream_Memory_Clear(Stream_Memory *sink)
+{
+    sink->length = 0;
+    sink->dropped = 0;
+    sink->buffer[0] = 0;
+}
+
+Stream *Stream_Null_Init(Stream_Null *sink)
+{
+    sink->stream.interface = &Null_Interface;
+    sink->bytes = 0;
+
+    return &sink->stream;
+}
+
+uint32_t Stream_Write(Stream *stream, const char *data, uint32_t length)
+{
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    return stream->interface->write(stream, data, length);
+}
+
+void Stream_Flush(Stream *stream)
+{
+    if (stream->interface->flush)
+    {
+        stream->interface->flush(stream);
+    }
+}
+
+void Stream_Put_Char(Stream *stream, char character)
+{
+    stream->interface->write(stream, &character, 1);
+}
+
+void Stream_Put_String(Stream *stream, const char *string)
+{
+    Stream_Write(stream, string, strlen(string));
+}
+
+void Stream_Put_UDec(Stream *stream, uint32_t n, uint8_t width)
+{
+    Put_Number(stream, n, 0, 10, 0, 0, width, 0);
+}
+
+void Stream_Put_SDec(Stream *stream, int32_t n, uint8_t width)
+{
+    Put_Number(stream, (n < 0) ? (0 - (uint32_t)n) : (uint32_t)n, n < 0, 10, 0, 0, width, 0);
+}
+
+void Stream_Put_UFix(Stream *stream, uint32_t n, uint8_t decimals, uint8_t width)
+{
+    Put_Number(stream, n, 0, 10, decimals, 0, width, 0);
+}
+
+void Stream_Put_SFix(Stream *stream, int32_t n, uint8_t decimals, uint8_t width)
+{
+    Put_Number(stream, (n < 0) ? (0 - (uint32_t)n) : (uint32_t)n, n < 0, 10, decimals, 0, width, 0);
+}
+
+void Stream_Put_UHex(Stream *stream, uint32_t n, uint8_t digits)
+{
+    Put_Number(stream, n, 0, 16, 0, digits, 0, 0);
+}
+
+void Stream_Put_U16_LE(Stream *stream, uint16_t value)
+{
+    char bytes[2];
+
+    bytes[0] = value & 0xFF;
+    bytes[1] = value >> 8;
+    stream->interface->write(stream, bytes, 2);
+}
+
+void Stream_Put_U32_LE(Stream *stream, uint32_t value)
+{
+    char bytes[4];
+
+    bytes[0] = value & 0xFF;
+    bytes[1] = (value >> 8) & 0xFF;
+    bytes[2] = (value >> 16) & 0xFF;
+    bytes[3] = value >> 24;
+    stream->interface->write(stream, bytes, 4);
+}
+
+uint32_t Stream_Printf(Stream *stream, const char *format, ...)
+{
+    va_list arguments;
+    uint32_t written;
+
+    va_start(arguments, format);
+    written = Stream_VPrintf(stream, format, arguments);
+    va_end(arguments);
+
+    return written;
+}
+
+uint32_t Stream_VPrintf(Stream *stream, const char *format, va_list arguments)
+{
+    const char *start;
+    const char *string;
+    uint32_t written = 0;
+    uint32_t length;
+    uint32_t precision;
+    int32_t number;
+    uint8_t flags;
+    uint8_t width;
+    char character;
+
+    while (*format)
+    {
+        // Text up to the next conversion is written in one piece
+        start = format;
+        while (*format && (*format != '%'))
+        {
+            format++;
+        }
+        written += Stream_Write(stream, start, format - start);
+        if (*format == 0)
+        {
+            break;
+        }
+        format++;
+
+        flags = 0;
+        width = 0;
+        precision = 0xFFFFFFFF;
+        while ((*format == '-') || (*format == '0'))
+        {
+            flags |= (*format == '-') ? FLAG_LEFT : FLAG_ZERO;
+            format++;
+        }
+        while ((*format >= '0') && (*format <= '9'))
+        {
+            width = width * 10 + (*format - '0');
+            format++;
+        }
+        if (*format == '.')
+        {
+            precision = 0;
+            format++;
+            while ((*format >= '0') && (*format <= '9'))
+            {
+                precision = precision * 10 + (*format - '0');
+                format++;
+            }
+        }
+        while ((*format == 'l') || (*format == 'h'))
+        {
+            format++;
+        }
+
+        switch (*format)
+        {
+            case 'd':
+            case 'i':
+                number = va_arg(arguments, int32_t);
+                written += Put_Number(stream, (number < 0) ? (0 - (uint32_t)number) : (uint32_t)number, number < 0,
+                                      10, 0, 0, width, flags);
+                break;
+            case 'u':
+                written += Put_Number(stream, va_arg(arguments, uint32_t), 0, 10, 0, 0, width, flags);
+                break;
+            case 'x':
+                written += Put_Number(stream, va_arg(arguments, uint32_t), 0, 16, 0, 0, width, flags | FLAG_LOWERCASE);
+                break;
+            case 'X':
+                written += Put_Number(stream, va_arg(arguments, uint32_t), 0, 16, 0, 0, width, flags);
+                break;
+            case 'c':
+            case 's':
+                if (*format == 'c')
+                {
+                    character = (char)va_arg(arguments, int);
+                    string = &character;
+                    length = 1;
+                }
+                else
+                {
+                    string = va_arg(arguments, const char *);
+                    for (length = 0; (length < precision) && string[length]; length++);
+                }
+                if (!(flags & FLAG_LEFT) && (width > length))
+                {
+                    written += Put_Padding(stream, width - length);
+                }
+                written += Stream_Write(stream, string, length);
+                if ((flags & FLAG_LEFT) && (width > length))
+                {
+                    written += Put_Padding(stream, width - length);
+                }
+                break;
+            case '%':
+                written += Stream_Write(stream, "%", 1);
+                break;
+            default:
+                // Unknown conversion: stop, as the arguments can no longer be matched
+                return written;
+        }
+        format++;
+    }
+
+    return written;
+}
@@ -30,5 +30,5 @@ void SysTick_Interrupt_Init(uint32_t clock_cycles, uint32_t priority)
     SCB->SHP[11] = priority << 5;
 
     // Enable SysTick with interrupts and the core clock
-    SysTick->CTRL = 0x00000007;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
 }
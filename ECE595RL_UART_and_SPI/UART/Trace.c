@@ -0,0 +1,159 @@
+/**
+ * @file Trace.c
+ * @brief Source code for the Trace driver.
+ *
+ * This file contains the function definitions for the Trace driver.
+ * Count is the number of events recorded since Trace_Init: the next event goes to Count modulo TRACE_BUFFER_SIZE,
+ * and the buffer holds the last min(Count, TRACE_BUFFER_SIZE) events.
+ *
+ * For more information regarding the Data Watchpoint and Trace unit (DWT),
+ * refer to the ARM Cortex-M4 Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Trace.h"
+#include "../inc/EUSCI_A_UART.h"
+#include "../inc/CRC16.h"
+
+#define BUFFER_MASK     (TRACE_BUFFER_SIZE - 1)
+
+static Trace_Event Buffer[TRACE_BUFFER_SIZE];
+static volatile uint32_t Count;
+static volatile uint8_t Recording;
+
+static const char *Names[TRACE_MAX_IDS] = {
+    "EUSCI_A0_UART", "EUSCI_A1_UART", "EUSCI_A2_UART", "EUSCI_A3_UART",
+    "EUSCI_B0_SPI", "DMA", "SysTick", "Nokia5110",
+    "Active_Object_1", "Active_Object_2", "Active_Object_3", "Active_Object_4",
+    "Active_Object_5", "Active_Object_6", "Active_Object_7", "Active_Object_8"
+};
+
+void Trace_Init()
+{
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Recording = 0;
+    Count = 0;
+    Recording = 1;
+}
+
+void Trace_Start()
+{
+    Recording = 1;
+}
+
+void Trace_Stop()
+{
+    Recording = 0;
+}
+
+void Trace_Set_Name(uint8_t id, const char *name)
+{
+    if (id < TRACE_MAX_IDS)
+    {
+        Names[id] = name;
+    }
+}
+
+void Trace_Record(uint8_t type, uint8_t id, uint16_t data)
+{
+    Trace_Event *event;
+    uint32_t primask;
+
+    if (!Recording)
+    {
+        return;
+    }
+
+    // PRIMASK rather than Critical_Section_Enter: the events come from every priority,
+    // and they would be counted in the statistics of the critical sections
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    event = &Buffer[Count & BUFFER_MASK];
+    event->timestamp = DWT->CYCCNT;
+    event->type = type;
+    event->id = id;
+    event->data = data;
+    Count++;
+
+    __set_PRIMASK(primask);
+}
+
+uint32_t Trace_Stream()
+{
+    uint32_t bytes = 16;
+    uint32_t total = Count;
+    uint32_t events = (total < TRACE_BUFFER_SIZE) ? total : TRACE_BUFFER_SIZE;
+    uint32_t i;
+    uint16_t crc = CRC16_INITIAL_VALUE;
+    Stream *stream = EUSCI_A_UART_Get_Stream(EUSCI_A0_UART_PORT);
+    const uint8_t *data;
+    uint8_t num_names = 0;
+    uint8_t length;
+    uint8_t id;
+    uint8_t b;
+
+    for (id = 0; id < TRACE_MAX_IDS; id++)
+    {
+        if (Names[id])
+        {
+            num_names++;
+        }
+    }
+
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, 'T');
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, 'R');
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, TRACE_STREAM_VERSION);
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, num_names);
+    Stream_Put_U32_LE(stream, TRACE_CPU_FREQUENCY);
+    Stream_Put_U32_LE(stream, events);
+    Stream_Put_U32_LE(stream, total);
+
+    for (id = 0; id < TRACE_MAX_IDS; id++)
+    {
+        if (Names[id])
+        {
+            for (length = 0; Names[id][length]; length++);
+            EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, id);
+            EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, length);
+            EUSCI_A_UART_OutString(EUSCI_A0_UART_PORT, Names[id]);
+            bytes += 2 + length;
+        }
+    }
+
+    // Oldest event first. The structure has no padding, and both sides are little-endian.
+    for (i = total - events; i != total; i++)
+    {
+        data = (const uint8_t *)&Buffer[i & BUFFER_MASK];
+        for (b = 0; b < sizeof(Trace_Event); b++)
+        {
+            EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, data[b]);
+            crc = CRC16_Update(crc, data[b]);
+        }
+        bytes += sizeof(Trace_Event);
+    }
+
+    Stream_Put_U16_LE(stream, crc);
+
+    return bytes + 2;
+}
+
+uint8_t Trace_Poll()
+{
+    if ((EUSCI_A_UART_RX_Available(EUSCI_A0_UART_PORT) == 0)
+        || (EUSCI_A_UART_InChar(EUSCI_A0_UART_PORT) != TRACE_CMD_READ))
+    {
+        return 0;
+    }
+
+    Trace_Stop();
+    Trace_Stream();
+    Trace_Init();
+
+    return 1;
+}
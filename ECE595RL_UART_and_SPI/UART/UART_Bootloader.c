@@ -0,0 +1,603 @@
+/**
+ * @file UART_Bootloader.c
+ * @brief Source code for the UART_Bootloader driver.
+ *
+ * This file contains the function definitions for the UART_Bootloader driver.
+ * It receives an application image over EUSCI_A0, programs it into bank 1 of the MAIN flash memory,
+ * verifies it, and jumps to it.
+ *
+ * For more information regarding the flash controller, refer to the Flash Controller (FLCTL) section (9)
+ * of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/UART_Bootloader.h"
+#include "../inc/CRC16.h"
+
+// Inter-byte timeout while a frame is being received
+#define BYTE_TIMEOUT_MS     100
+
+// Largest payload: a 4-byte offset followed by a block
+#define MAX_PAYLOAD         (4 + UART_BOOTLOADER_BLOCK_SIZE)
+
+// Start of SRAM and end of the 64 KB SRAM, used to check the initial stack pointer of an image
+#define SRAM_START          0x20000000
+#define SRAM_END            0x20010000
+
+static uint8_t Frame_Payload[MAX_PAYLOAD];
+
+// State of the upload in progress
+static uint8_t Upload_Started;
+static uint32_t Upload_Length;
+static uint32_t Upload_CRC;
+static uint32_t Upload_Next_Offset;
+
+static uint32_t Slot_Address(uint8_t slot)
+{
+    return UART_BOOTLOADER_SLOT0_ADDRESS + ((uint32_t)slot * UART_BOOTLOADER_SLOT_SIZE);
+}
+
+static const UART_Bootloader_Header *Slot_Header(uint8_t slot)
+{
+    return (const UART_Bootloader_Header *)(Slot_Address(slot) + UART_BOOTLOADER_IMAGE_SIZE);
+}
+
+static uint32_t Get_U32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+void UART_Bootloader_Init()
+{
+    static const EUSCI_A_UART_Config config = EUSCI_A_UART_CONFIG(UART_BOOTLOADER_BAUD_RATE, EUSCI_A_UART_PARITY_NONE, 8, 1,
+                                                                  EUSCI_A_UART_LSB_FIRST);
+
+    EUSCI_A_UART_Init(EUSCI_A0_UART_PORT, &config);
+}
+
+uint32_t UART_Bootloader_CRC32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    uint32_t i;
+    int bit;
+
+    for (i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+int UART_Bootloader_Check_Slot(uint8_t slot)
+{
+    const UART_Bootloader_Header *header = Slot_Header(slot);
+
+    if (header->magic != UART_BOOTLOADER_MAGIC
+        || header->header_crc != UART_Bootloader_CRC32((const uint8_t *)header, 12)
+        || header->length == 0
+        || header->length > UART_BOOTLOADER_IMAGE_SIZE
+        || UART_Bootloader_CRC32((const uint8_t *)Slot_Address(slot), header->length) != header->image_crc)
+    {
+        return UART_BOOTLOADER_ERROR_NO_IMAGE;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Erases the header sector of a slot, then the sectors that hold the first length bytes of the image.
+ */
+static int Erase_Slot(uint8_t slot, uint32_t length)
+{
+    uint32_t address = Slot_Address(slot);
+    int result = UART_Bootloader_Erase_Sector(address + UART_BOOTLOADER_IMAGE_SIZE);
+
+    for (; (result == 0) && (address < Slot_Address(slot) + length); address += UART_BOOTLOADER_SECTOR_SIZE)
+    {
+        result = UART_Bootloader_Erase_Sector(address);
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the header of a slot and checks the result.
+ */
+static int Write_Header(uint8_t slot, uint32_t length, uint32_t image_crc)
+{
+    UART_Bootloader_Header header;
+    int result;
+
+    header.magic = UART_BOOTLOADER_MAGIC;
+    header.length = length;
+    header.image_crc = image_crc;
+    header.header_crc = UART_Bootloader_CRC32((const uint8_t *)&header, 12);
+
+    result = UART_Bootloader_Program((uint32_t)Slot_Header(slot), (const uint8_t *)&header, sizeof(header));
+    if ((result == 0) && (UART_Bootloader_Check_Slot(slot) != 0))
+    {
+        result = UART_BOOTLOADER_ERROR_VERIFY;
+    }
+    return result;
+}
+
+int UART_Bootloader_Install()
+{
+    const UART_Bootloader_Header *staging = Slot_Header(UART_BOOTLOADER_STAGING_SLOT);
+    uint32_t length = staging->length;
+    uint32_t image_crc = staging->image_crc;
+    int result = UART_Bootloader_Check_Slot(UART_BOOTLOADER_STAGING_SLOT);
+
+    if (result == 0)
+    {
+        result = Erase_Slot(UART_BOOTLOADER_ACTIVE_SLOT, length);
+    }
+    if (result == 0)
+    {
+        // Bank 1 can be read while it is being programmed, so the image is copied directly from the staging slot
+        result = UART_Bootloader_Program(Slot_Address(UART_BOOTLOADER_ACTIVE_SLOT),
+                                         (const uint8_t *)Slot_Address(UART_BOOTLOADER_STAGING_SLOT), length);
+    }
+    if (result == 0)
+    {
+        result = Write_Header(UART_BOOTLOADER_ACTIVE_SLOT, length, image_crc);
+    }
+    return result;
+}
+
+int UART_Bootloader_Erase_Sector(uint32_t address)
+{
+    // Bit 0 of BANK1_MAIN_WEPROT protects the first sector of bank 1 (0x00020000)
+    uint32_t sector = (address - UART_BOOTLOADER_SLOT0_ADDRESS) / UART_BOOTLOADER_SECTOR_SIZE;
+    const uint32_t *word = (const uint32_t *)address;
+    uint32_t status;
+    int result = 0;
+    int i;
+
+    // Remove the write/erase protection of the sector
+    FLCTL->BANK1_MAIN_WEPROT &= ~((uint32_t)1 << sector);
+
+    // Clear the status of the previous erase
+    FLCTL->ERASE_CTLSTAT = 0x00080000;
+    FLCTL->ERASE_SECTADDR = address;
+
+    // ERASE_CTLSTAT Register Configuration
+    //
+    //  Bit(s)      Field       Value       Description
+    //  -----       -----       -----       -----------
+    //   19         CLR_STAT    0x0         No effect
+    //   3-2        TYPE        0x0         Main memory
+    //   1          MODE        0x0         Sector erase
+    //   0          START       0x1         Start the erase operation
+    FLCTL->ERASE_CTLSTAT = 0x00000001;
+
+    // STATUS (bits 17-16): 1 = erase triggered, 2 = erase in progress, 3 = erase complete
+    do
+    {
+        status = FLCTL->ERASE_CTLSTAT & 0x00030000;
+    } while ((status == 0x00010000) || (status == 0x00020000));
+
+    // ADDR_ERR - The sector address was not valid or the sector is protected
+    if (FLCTL->ERASE_CTLSTAT & 0x00040000)
+    {
+        result = UART_BOOTLOADER_ERROR_ERASE;
+    }
+
+    FLCTL->ERASE_CTLSTAT = 0x00080000;
+    FLCTL->BANK1_MAIN_WEPROT |= ((uint32_t)1 << sector);
+
+    for (i = 0; (result == 0) && (i < UART_BOOTLOADER_SECTOR_SIZE / 4); i++)
+    {
+        if (word[i] != 0xFFFFFFFF)
+        {
+            result = UART_BOOTLOADER_ERROR_ERASE;
+        }
+    }
+
+    return result;
+}
+
+int UART_Bootloader_Program(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    uint32_t first_sector = (address - UART_BOOTLOADER_SLOT0_ADDRESS) / UART_BOOTLOADER_SECTOR_SIZE;
+    uint32_t last_sector = (address + length - 1 - UART_BOOTLOADER_SLOT0_ADDRESS) / UART_BOOTLOADER_SECTOR_SIZE;
+    uint32_t protect_mask = 0;
+    volatile uint32_t *word = (volatile uint32_t *)address;
+    uint32_t value;
+    uint32_t i;
+    int result = 0;
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    for (i = first_sector; i <= last_sector; i++)
+    {
+        protect_mask |= ((uint32_t)1 << i);
+    }
+    FLCTL->BANK1_MAIN_WEPROT &= ~protect_mask;
+
+    // PRG_CTLSTAT Register Configuration
+    //
+    //  Bit(s)      Field       Value       Description
+    //  -----       -----       -----       -----------
+    //   3          VER_PST     0x0         No post-program verify (the data is read back instead)
+    //   2          VER_PRE     0x0         No pre-program verify
+    //   1          MODE        0x0         Immediate word program mode
+    //   0          ENABLE      0x1         Word programming enabled
+    FLCTL->PRG_CTLSTAT = 0x00000001;
+
+    for (i = 0; i < length / 4; i++)
+    {
+        value = Get_U32(&data[4 * i]);
+
+        // Clear PRG_ERR and PRG, then write the word. The flash controller programs it immediately.
+        FLCTL->CLRIFG = 0x00000208;
+        word[i] = value;
+
+        // PRG - Wait until the word program operation is complete
+        while((FLCTL->IFG & 0x00000008) == 0);
+
+        if ((FLCTL->IFG & 0x00000200) || (word[i] != value))
+        {
+            result = UART_BOOTLOADER_ERROR_PROGRAM;
+            break;
+        }
+    }
+
+    FLCTL->PRG_CTLSTAT = 0x00000000;
+    FLCTL->BANK1_MAIN_WEPROT |= protect_mask;
+
+    return result;
+}
+
+/**
+ * @brief Branches to the reset handler of an image with its initial stack pointer.
+ *
+ * The arguments are passed in r0 and r1 (AAPCS), so no compiler-generated code runs after MSP is changed.
+ * The function must not be inlined: the arguments would no longer be in r0 and r1.
+ */
+#pragma FUNC_CANNOT_INLINE(UART_Bootloader_Jump)
+static void UART_Bootloader_Jump(uint32_t stack_pointer, uint32_t reset_handler)
+{
+    __asm("    msr msp, r0\n"
+          "    bx r1\n");
+}
+
+void UART_Bootloader_Boot()
+{
+    const uint32_t *vectors = (const uint32_t *)Slot_Address(UART_BOOTLOADER_ACTIVE_SLOT);
+    int i;
+
+    __disable_irq();
+
+    // Stop the peripherals used by the loader and clear every enabled or pending interrupt
+    SysTick->CTRL = 0;
+    EUSCI_A0->IE = 0;
+    EUSCI_A0->CTLW0 |= EUSCI_A_CTLW0_SWRST;
+    for (i = 0; i < 2; i++)
+    {
+        NVIC->ICER[i] = 0xFFFFFFFF;
+        NVIC->ICPR[i] = 0xFFFFFFFF;
+    }
+
+    // Use the vector table of the image
+    SCB->VTOR = Slot_Address(UART_BOOTLOADER_ACTIVE_SLOT);
+    __DSB();
+    __ISB();
+
+    // Interrupts are enabled at reset, and the application expects the same
+    __enable_irq();
+
+    UART_Bootloader_Jump(vectors[0], vectors[1]);
+}
+
+/**
+ * @brief Waits for a received byte.
+ *
+ * @return The byte, or UART_BOOTLOADER_ERROR_TIMEOUT. A timeout of 0 waits forever.
+ */
+static int Get_Byte(uint32_t timeout_ms)
+{
+    uint32_t ticks = timeout_ms * 100;
+
+    while(EUSCI_A_UART_RX_Available(EUSCI_A0_UART_PORT) == 0)
+    {
+        if (timeout_ms)
+        {
+            if (ticks == 0)
+            {
+                return UART_BOOTLOADER_ERROR_TIMEOUT;
+            }
+            ticks--;
+            Clock_Delay1us(10);
+        }
+    }
+    return EUSCI_A_UART_InChar(EUSCI_A0_UART_PORT);
+}
+
+/**
+ * @brief Receives a frame into Frame_Payload.
+ *
+ * @return The payload length, or a negative UART_BOOTLOADER_ERROR code.
+ */
+static int Receive_Frame(uint8_t *command, uint32_t timeout_ms)
+{
+    uint8_t header[3];
+    uint16_t length;
+    uint16_t crc;
+    int data;
+    int i;
+
+    // Discard everything up to the start of a frame
+    do
+    {
+        data = Get_Byte(timeout_ms);
+        if (data < 0)
+        {
+            return data;
+        }
+    } while(data != UART_BOOTLOADER_SOH);
+
+    for (i = 0; i < 3; i++)
+    {
+        data = Get_Byte(BYTE_TIMEOUT_MS);
+        if (data < 0)
+        {
+            return UART_BOOTLOADER_ERROR_FORMAT;
+        }
+        header[i] = (uint8_t)data;
+    }
+
+    length = header[1] | ((uint16_t)header[2] << 8);
+    if (length > MAX_PAYLOAD)
+    {
+        return UART_BOOTLOADER_ERROR_FORMAT;
+    }
+
+    for (i = 0; i < length + 2; i++)
+    {
+        data = Get_Byte(BYTE_TIMEOUT_MS);
+        if (data < 0)
+        {
+            return UART_BOOTLOADER_ERROR_FORMAT;
+        }
+        if (i < length)
+        {
+            Frame_Payload[i] = (uint8_t)data;
+        }
+        else if (i == length)
+        {
+            crc = (uint16_t)data;
+        }
+        else
+        {
+            crc |= (uint16_t)data << 8;
+        }
+    }
+
+    if (crc != CRC16_Compute(CRC16_Compute(CRC16_INITIAL_VALUE, header, 3), Frame_Payload, length))
+    {
+        return UART_BOOTLOADER_ERROR_CRC;
+    }
+
+    *command = header[0];
+    return length;
+}
+
+static void Respond(int result)
+{
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, (result < 0) ? UART_BOOTLOADER_NAK : UART_BOOTLOADER_ACK);
+    EUSCI_A_UART_OutChar(EUSCI_A0_UART_PORT, (result < 0) ? (uint8_t)(-result) : 0);
+}
+
+static int Handle_Start(int length)
+{
+    int result;
+
+    Upload_Started = 0;
+
+    if (length != 8)
+    {
+        return UART_BOOTLOADER_ERROR_FORMAT;
+    }
+
+    Upload_Length = Get_U32(&Frame_Payload[0]);
+    Upload_CRC = Get_U32(&Frame_Payload[4]);
+    if ((Upload_Length == 0) || (Upload_Length > UART_BOOTLOADER_IMAGE_SIZE) || (Upload_Length & 0x3))
+    {
+        return UART_BOOTLOADER_ERROR_FORMAT;
+    }
+
+    // The active slot is not touched until the new image has been verified
+    result = Erase_Slot(UART_BOOTLOADER_STAGING_SLOT, Upload_Length);
+    if (result == 0)
+    {
+        Upload_Next_Offset = 0;
+        Upload_Started = 1;
+    }
+    return result;
+}
+
+static int Handle_Data(int length)
+{
+    uint32_t offset = Get_U32(&Frame_Payload[0]);
+    uint32_t block_length = length - 4;
+    const uint8_t *block = &Frame_Payload[4];
+    const uint8_t *flash;
+    uint32_t i;
+    int result;
+
+    if (!Upload_Started)
+    {
+        return UART_BOOTLOADER_ERROR_SEQUENCE;
+    }
+
+    // Written without offset + block_length, which wraps around for an offset close to 2^32
+    if ((length < 4) || (block_length & 0x3) || (offset & 0x3) || (offset > Upload_Length)
+        || (block_length > Upload_Length - offset))
+    {
+        return UART_BOOTLOADER_ERROR_FORMAT;
+    }
+
+    // A block that has already been programmed is a retransmission after a lost ACK
+    if (offset + block_length <= Upload_Next_Offset)
+    {
+        flash = (const uint8_t *)(Slot_Address(UART_BOOTLOADER_STAGING_SLOT) + offset);
+        for (i = 0; i < block_length; i++)
+        {
+            if (flash[i] != block[i])
+            {
+                return UART_BOOTLOADER_ERROR_VERIFY;
+            }
+        }
+        return 0;
+    }
+
+    if (offset != Upload_Next_Offset)
+    {
+        return UART_BOOTLOADER_ERROR_SEQUENCE;
+    }
+
+    result = UART_Bootloader_Program(Slot_Address(UART_BOOTLOADER_STAGING_SLOT) + offset, block, block_length);
+    if (result == 0)
+    {
+        Upload_Next_Offset += block_length;
+    }
+    return result;
+}
+
+static int Handle_End()
+{
+    const uint32_t *vectors = (const uint32_t *)Slot_Address(UART_BOOTLOADER_STAGING_SLOT);
+    uint32_t active = Slot_Address(UART_BOOTLOADER_ACTIVE_SLOT);
+    int result;
+
+    if (!Upload_Started || (Upload_Next_Offset != Upload_Length))
+    {
+        return UART_BOOTLOADER_ERROR_SEQUENCE;
+    }
+    Upload_Started = 0;
+
+    if (UART_Bootloader_CRC32((const uint8_t *)vectors, Upload_Length) != Upload_CRC)
+    {
+        return UART_BOOTLOADER_ERROR_VERIFY;
+    }
+
+    // The image must start with a vector table linked for the active slot
+    if ((vectors[0] <= SRAM_START) || (vectors[0] > SRAM_END) || ((vectors[1] & 0x1) == 0)
+        || (vectors[1] < active) || (vectors[1] >= active + Upload_Length))
+    {
+        return UART_BOOTLOADER_ERROR_FORMAT;
+    }
+
+    result = Write_Header(UART_BOOTLOADER_STAGING_SLOT, Upload_Length, Upload_CRC);
+    if (result == 0)
+    {
+        result = UART_Bootloader_Install();
+    }
+    return result;
+}
+
+/**
+ * @brief Makes sure that the active slot holds a valid image, installing the staging image if needed.
+ */
+static int Prepare_Boot()
+{
+    if (UART_Bootloader_Check_Slot(UART_BOOTLOADER_ACTIVE_SLOT) == 0)
+    {
+        return 0;
+    }
+    return UART_Bootloader_Install();
+}
+
+void UART_Bootloader_Run(uint32_t timeout_ms)
+{
+    uint8_t command = 0;
+    int length;
+    int result;
+
+    Upload_Started = 0;
+
+    while(1)
+    {
+        length = Receive_Frame(&command, timeout_ms);
+
+        if (length == UART_BOOTLOADER_ERROR_TIMEOUT)
+        {
+            // No host: boot the active image, or keep waiting if there is none
+            if (Prepare_Boot() == 0)
+            {
+                UART_Bootloader_Boot();
+            }
+            timeout_ms = 0;
+            continue;
+        }
+
+        // Once a host has been seen, wait for it indefinitely
+        timeout_ms = 0;
+
+        if (length < 0)
+        {
+            Respond(length);
+            continue;
+        }
+
+        switch(command)
+        {
+            case UART_BOOTLOADER_CMD_PING:
+            {
+                Respond(0);
+                break;
+            }
+
+            case UART_BOOTLOADER_CMD_START:
+            {
+                Respond(Handle_Start(length));
+                break;
+            }
+
+            case UART_BOOTLOADER_CMD_DATA:
+            {
+                Respond(Handle_Data(length));
+                break;
+            }
+
+            case UART_BOOTLOADER_CMD_END:
+            {
+                result = Handle_End();
+                Respond(result);
+                if (result == 0)
+                {
+                    EUSCI_A_UART_Flush(EUSCI_A0_UART_PORT);
+                    UART_Bootloader_Boot();
+                }
+                break;
+            }
+
+            case UART_BOOTLOADER_CMD_BOOT:
+            {
+                result = Prepare_Boot();
+                Respond(result);
+                if (result == 0)
+                {
+                    EUSCI_A_UART_Flush(EUSCI_A0_UART_PORT);
+                    UART_Bootloader_Boot();
+                }
+                break;
+            }
+
+            default:
+            {
+                Respond(UART_BOOTLOADER_ERROR_FORMAT);
+                break;
+            }
+        }
+    }
+}
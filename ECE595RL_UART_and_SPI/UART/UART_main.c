@@ -19,11 +19,61 @@
 #include "../inc/GPIO.h"
 #include "../inc/EUSCI_A0_UART.h"
 #include "../inc/EUSCI_A2_UART.h"
+#include "../inc/Pin_Map.h"
+#include "../inc/Memory_Block.h"
 
 // Comment or uncomment the lines to choose the UART program
 //#define USE_EUSCI_A0_UART 1
 //#define USE_EUSCI_A2_UART 1
 #define UART_EXTERNAL_LOOPBACK 1
+//#define USE_AES256_LINK 1
+//#define USE_UART_BOOTLOADER 1
+//#define USE_LOGIC_ANALYZER 1
+//#define USE_RING_BUFFER_TEST 1
+//#define USE_MEMORY_POOL_TEST 1
+//#define USE_NUMBER_PARSER_TEST 1
+//#define USE_LINE_EDITOR 1
+//#define USE_STREAM_BENCHMARK 1
+//#define USE_MEMORY_BLOCK_BENCHMARK 1
+
+#ifdef USE_AES256_LINK
+#include "../inc/AES256_Link.h"
+#endif
+
+#ifdef USE_UART_BOOTLOADER
+#include "../inc/UART_Bootloader.h"
+#endif
+
+#ifdef USE_LOGIC_ANALYZER
+#include "../inc/Logic_Analyzer.h"
+#endif
+
+#ifdef USE_RING_BUFFER_TEST
+#include "../inc/Ring_Buffer.h"
+#include "../inc/SysTick_Interrupt.h"
+#endif
+
+#ifdef USE_NUMBER_PARSER_TEST
+#include "../inc/Number_Parser.h"
+#endif
+
+#ifdef USE_LINE_EDITOR
+#include <string.h>
+#include "../inc/Line_Editor.h"
+#include "../inc/Number_Parser.h"
+#endif
+
+#ifdef USE_STREAM_BENCHMARK
+#include "../inc/Stream.h"
+#endif
+
+#ifdef USE_MEMORY_POOL_TEST
+#include <stdlib.h>
+#include "../inc/Memory_Pool.h"
+#include "../inc/Ring_Buffer.h"
+#include "../inc/SysTick_Interrupt.h"
+#include "../inc/Critical_Section.h"
+#endif
 
 /**
  * @brief The Transmit_UART_Data function transmits data over UART based on the status of the user buttons.
@@ -141,7 +191,7 @@ int main(void)
     EUSCI_A0_UART_OutUFix(user_value);
 
     printf("\n\nInUHex Test\nEnter an unsigned hexadecimal value: ");
-    user_value = UART0_InUHex();
+    user_value = EUSCI_A0_UART_InUHex();
 
     printf("\nOutUHex Value: ");
     EUSCI_A0_UART_OutUHex(user_value);
@@ -202,7 +252,15 @@ int main(void)
 #endif
 
 #ifdef UART_EXTERNAL_LOOPBACK
-#define BUFFER_LENGTH 255
+#define BUFFER_LENGTH 256
+
+// Pins of the demo. LED1, the buttons and EUSCI_A0 share P1; the build fails if two groups use the same pin.
+#define LOOPBACK_DEMO_PINS(X, port) \
+    PIN_GROUP_LED1(X, port) \
+    PIN_GROUP_LED2(X, port) \
+    PIN_GROUP_BUTTONS(X, port) \
+    PIN_GROUP_EUSCI_A0_UART(X, port) \
+    PIN_GROUP_EUSCI_A2_UART(X, port)
 
 uint8_t TX_Buffer[BUFFER_LENGTH];
 uint8_t RX_Buffer[BUFFER_LENGTH];
@@ -221,7 +279,7 @@ uint8_t RX_Buffer[BUFFER_LENGTH];
 void UART_Ramp_Data()
 {
 
-    for (int i = 0; i <= BUFFER_LENGTH; i++){
+    for (int i = 0; i < BUFFER_LENGTH; i++){
         TX_Buffer[i] = i;
         EUSCI_A2_UART_OutChar(i);
         RX_Buffer[i] = EUSCI_A2_UART_InChar();
@@ -233,7 +291,7 @@ void UART_Ramp_Data()
  * @brief The Validate_UART_Loopback function verifies if the data sent and data received is the same.
  *
  * This function is used to verify whether loop-back test was successful or not by comparing the data sent in TX_Buffer and data received in RX_Buffer.
- * It prints the content of both buffers and outputs a warning if they don't match.
+ * It prints the number of bytes received correctly, then a warning for each byte that doesn't match.
  *
  * @param None
  *
@@ -241,14 +299,26 @@ void UART_Ramp_Data()
  */
 void Validate_UART_Loopback()
 {
-    for (int i = 0; i <= BUFFER_LENGTH; i++){
-        printf("TX Data: 0x%02X | RX Data: 0x%02X\n", TX_Buffer[i], RX_Buffer[i]);
-        Clock_Delay1us(100);
-        if (TX_Buffer[i] != RX_Buffer[i]){
-            printf("MISMATCH! TX Data: 0x%02X | RX Data: 0x%02X\n", TX_Buffer[i], RX_Buffer[i]);
+    uint32_t mismatches = Memory_Block_Count_Differences(TX_Buffer, RX_Buffer, BUFFER_LENGTH);
+    uint32_t i = 0;
+    int32_t offset;
+
+    printf("%u of %u bytes received correctly\n", BUFFER_LENGTH - mismatches, BUFFER_LENGTH);
+
+    // Only the bytes that differ are printed
+    while (i < BUFFER_LENGTH)
+    {
+        offset = Memory_Block_Compare(&TX_Buffer[i], &RX_Buffer[i], BUFFER_LENGTH - i);
+        if (offset == MEMORY_BLOCK_EQUAL)
+        {
+            break;
         }
-    }
 
+        i += offset;
+        printf("MISMATCH! Index %u | TX Data: 0x%02X | RX Data: 0x%02X\n", i, TX_Buffer[i], RX_Buffer[i]);
+        Clock_Delay1us(100);
+        i++;
+    }
 }
 
 int main(void)
@@ -265,6 +335,9 @@ int main(void)
     // Initialize the 48 MHz Clock
     Clock_Init48MHz();
 
+    // Configure the pins of P1, P2 and P3 with one write per register
+    PIN_MAP_INIT(LOOPBACK_DEMO_PINS);
+
     // Initialize the built-in red LED and the RGB LED
     LED1_Init();
     LED2_Init();
@@ -297,3 +370,846 @@ int main(void)
     }
 }
 #endif
+
+#ifdef USE_AES256_LINK
+int main(void)
+{
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A2_UART
+    EUSCI_A2_UART_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    printf("\nStart of AES256_Link Test\n");
+    printf("---------------------------\n");
+
+    // Turn on the red LED if the self-test passes
+    if (AES256_Link_Benchmark() == 0)
+    {
+        LED1_Output(RED_LED_ON);
+    }
+
+    printf("---------------------------\n");
+    printf("End of AES256_Link Test\n");
+
+    while(1);
+}
+#endif
+
+#ifdef USE_UART_BOOTLOADER
+int main(void)
+{
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED and the buttons
+    LED1_Init();
+    Buttons_Init();
+
+    // Initialize EUSCI_A0_UART at the loader baud rate
+    UART_Bootloader_Init();
+
+    // Turn on the red LED while the loader is running
+    LED1_Output(RED_LED_ON);
+
+    // Stay in the loader while Button 1 (P1.1) is held at reset.
+    // Otherwise, wait one second for tools/uart_uploader.py before booting the newest image.
+    if ((Get_Buttons_Status() & 0x02) == 0x00)
+    {
+        UART_Bootloader_Run(0);
+    }
+    else
+    {
+        UART_Bootloader_Run(1000);
+    }
+
+    while(1);
+}
+#endif
+
+#ifdef USE_LOGIC_ANALYZER
+// Edit this table to choose the sampled pins (up to LOGIC_ANALYZER_MAX_CHANNELS)
+const Logic_Analyzer_Channel Logic_Analyzer_Channels[] = {
+    {"P3.2_UART_RX",    &P3->IN,    2},
+    {"P3.3_UART_TX",    &P3->IN,    3},
+    {"P9.4_SPI_SCE",    &P9->IN,    4},
+    {"P9.5_SPI_SCLK",   &P9->IN,    5},
+    {"P9.7_SPI_MOSI",   &P9->IN,    7},
+    {"P4.0_BUMP_0",     &P4->IN,    0},
+    {"P4.2_BUMP_1",     &P4->IN,    2},
+    {"P4.3_BUMP_2",     &P4->IN,    3}
+};
+
+// 1 MHz for 16.384 ms, triggered by the start bit of a UART character received on P3.2
+const Logic_Analyzer_Config Logic_Analyzer_Settings = {
+    Logic_Analyzer_Channels,
+    8,
+    1000000,
+    LOGIC_ANALYZER_TRIGGER_FALLING(0),
+    1024,
+    LOGIC_ANALYZER_BUFFER_SIZE,
+    0
+};
+
+int main(void)
+{
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART to stream the captures
+    EUSCI_A0_UART_Init();
+
+    // Turn on the red LED while waiting for tools/logic_analyzer.py
+    LED1_Output(RED_LED_ON);
+
+    Logic_Analyzer_Run(&Logic_Analyzer_Settings);
+}
+#endif
+
+#ifdef USE_RING_BUFFER_TEST
+#define RING_TEST_SYSTICK_CYCLES    480         // 100 kHz producer interrupt
+#define RING_TEST_DURATION_S        10
+#define RING_TEST_BENCHMARK_COUNT   1000
+
+// Sequence numbers posted by SysTick_Handler and checked by the main loop
+RING_BUFFER_DEFINE(Ring_Test_Queue, uint32_t, 64);
+
+volatile uint32_t Ring_Test_Sequence;
+volatile uint32_t Ring_Test_Overflows;
+
+void SysTick_Handler(void)
+{
+    uint32_t sequence = Ring_Test_Sequence;
+
+    if (Ring_Buffer_Push(&Ring_Test_Queue, &sequence))
+    {
+        Ring_Test_Sequence = sequence + 1;
+    }
+    else
+    {
+        Ring_Test_Overflows++;
+    }
+}
+
+/**
+ * @brief The Ring_Test_Benchmark function measures the average number of cycles per element of each Ring_Buffer function
+ *        with the DWT cycle counter, before the interrupt is enabled.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Ring_Test_Benchmark()
+{
+    uint32_t elements[32];
+    uint32_t element = 0;
+    uint32_t start;
+    uint32_t push_cycles = 0;
+    uint32_t pop_cycles = 0;
+    uint32_t multiple_cycles;
+    uint32_t span_cycles;
+    const void *span;
+    int i;
+
+    for (i = 0; i < RING_TEST_BENCHMARK_COUNT; i++)
+    {
+        start = DWT->CYCCNT;
+        Ring_Buffer_Push(&Ring_Test_Queue, &element);
+        push_cycles += DWT->CYCCNT - start;
+
+        start = DWT->CYCCNT;
+        Ring_Buffer_Pop(&Ring_Test_Queue, &element);
+        pop_cycles += DWT->CYCCNT - start;
+    }
+
+    start = DWT->CYCCNT;
+    for (i = 0; i < RING_TEST_BENCHMARK_COUNT; i++)
+    {
+        Ring_Buffer_Push_Multiple(&Ring_Test_Queue, elements, 32);
+        Ring_Buffer_Pop_Multiple(&Ring_Test_Queue, elements, 32);
+    }
+    multiple_cycles = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    for (i = 0; i < RING_TEST_BENCHMARK_COUNT; i++)
+    {
+        Ring_Buffer_Push_Multiple(&Ring_Test_Queue, elements, 32);
+        Ring_Buffer_Consume(&Ring_Test_Queue, Ring_Buffer_Read_Span(&Ring_Test_Queue, &span));
+    }
+    span_cycles = DWT->CYCCNT - start;
+
+    printf("Push: %u cycles, Pop: %u cycles\n", push_cycles / RING_TEST_BENCHMARK_COUNT, pop_cycles / RING_TEST_BENCHMARK_COUNT);
+    printf("Push_Multiple + Pop_Multiple: %u cycles per element (%u kelements/s)\n", multiple_cycles / (RING_TEST_BENCHMARK_COUNT * 32),
+           (48000 * RING_TEST_BENCHMARK_COUNT * 32) / multiple_cycles);
+    printf("Push_Multiple + Read_Span/Consume: %u cycles per element\n", span_cycles / (RING_TEST_BENCHMARK_COUNT * 32));
+}
+
+int main(void)
+{
+    uint32_t elements[8];
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    uint32_t count;
+    uint32_t i;
+    uint32_t start;
+    uint32_t method = 0;
+    const uint32_t *span;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    printf("\nRing_Buffer test\n");
+    Ring_Test_Benchmark();
+
+    // The main loop consumes the sequence numbers posted by the SysTick interrupt, using each pop method in turn
+    SysTick_Interrupt_Init(RING_TEST_SYSTICK_CYCLES, SYSTICK_INT_PRIORITY);
+    start = DWT->CYCCNT;
+    while((DWT->CYCCNT - start) < (RING_TEST_DURATION_S * 48000000))
+    {
+        switch(method++ % 3)
+        {
+            case 0:
+            {
+                count = Ring_Buffer_Pop(&Ring_Test_Queue, elements);
+                span = elements;
+                break;
+            }
+
+            case 1:
+            {
+                count = Ring_Buffer_Pop_Multiple(&Ring_Test_Queue, elements, 8);
+                span = elements;
+                break;
+            }
+
+            default:
+            {
+                count = Ring_Buffer_Read_Span(&Ring_Test_Queue, (const void **)&span);
+                break;
+            }
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            if (span[i] != expected)
+            {
+                errors++;
+            }
+            expected = span[i] + 1;
+        }
+
+        if ((method % 3) == 0)
+        {
+            Ring_Buffer_Consume(&Ring_Test_Queue, count);
+        }
+    }
+    SysTick->CTRL = 0;
+
+    printf("%u elements, %u order errors, %u overflows: %s\n", expected, errors, Ring_Test_Overflows,
+           (errors == 0) ? "PASS" : "FAIL");
+
+    LED1_Output((errors == 0) ? RED_LED_OFF : RED_LED_ON);
+
+    while(1);
+}
+#endif
+
+#ifdef USE_MEMORY_POOL_TEST
+#define POOL_TEST_ITERATIONS        1000
+#define POOL_TEST_SYSTICK_CYCLES    4800        // 10 kHz producer interrupt
+#define POOL_TEST_DURATION_S        5
+
+// Frames allocated by SysTick_Handler and handed to the main loop without copying them
+typedef struct
+{
+    uint32_t sequence;
+    uint16_t length;
+    uint8_t data[];
+} Pool_Test_Frame;
+
+RING_BUFFER_DEFINE(Pool_Test_Queue, Pool_Test_Frame *, 16);
+
+volatile uint32_t Pool_Test_Sequence;
+volatile uint32_t Pool_Test_Dropped;
+
+void SysTick_Handler(void)
+{
+    uint32_t sequence = Pool_Test_Sequence++;
+    uint16_t length = 8 + ((sequence * 37) % 400);
+    Pool_Test_Frame *frame = Memory_Pool_Alloc(sizeof(Pool_Test_Frame) + length);
+    uint16_t i;
+
+    if (frame == 0)
+    {
+        Pool_Test_Dropped++;
+        return;
+    }
+
+    frame->sequence = sequence;
+    frame->length = length;
+    for (i = 0; i < length; i++)
+    {
+        frame->data[i] = sequence + i;
+    }
+
+    if (!Ring_Buffer_Push(&Pool_Test_Queue, &frame))
+    {
+        Memory_Pool_Release(frame);
+        Pool_Test_Dropped++;
+    }
+}
+
+/**
+ * @brief The Pool_Test_Measure function prints the minimum, average and maximum number of cycles
+ *        of an allocation followed by a release, with Memory_Pool and with malloc.
+ *
+ * The sizes cycle through the three size classes while up to 8 blocks are allocated, so that malloc
+ * has to search its free list as it would in an application.
+ *
+ * @param use_pool 1 for Memory_Pool_Alloc and Memory_Pool_Release, 0 for malloc and free.
+ *
+ * @return None
+ */
+void Pool_Test_Measure(uint8_t use_pool)
+{
+    static const uint16_t sizes[8] = {24, 100, 16, 60, 8, 32, 90, 12};
+    void *blocks[8] = {0};
+    uint32_t cycles;
+    uint32_t min = 0xFFFFFFFF;
+    uint32_t max = 0;
+    uint32_t total = 0;
+    uint32_t start;
+    int i;
+
+    for (i = 0; i < POOL_TEST_ITERATIONS; i++)
+    {
+        start = DWT->CYCCNT;
+        if (use_pool)
+        {
+            Memory_Pool_Release(blocks[i & 7]);
+            blocks[i & 7] = Memory_Pool_Alloc(sizes[(i * 3) & 7]);
+        }
+        else
+        {
+            free(blocks[i & 7]);
+            blocks[i & 7] = malloc(sizes[(i * 3) & 7]);
+        }
+        cycles = DWT->CYCCNT - start;
+
+        total += cycles;
+        min = (cycles < min) ? cycles : min;
+        max = (cycles > max) ? cycles : max;
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        if (use_pool)
+        {
+            Memory_Pool_Release(blocks[i]);
+        }
+        else
+        {
+            free(blocks[i]);
+        }
+    }
+
+    printf("%s: min %u, average %u, max %u cycles per release + allocation\n", use_pool ? "Memory_Pool" : "malloc",
+           min, total / POOL_TEST_ITERATIONS, max);
+}
+
+int main(void)
+{
+    Memory_Pool_Stats stats;
+    Critical_Section_Stats section_stats;
+    Pool_Test_Frame *frame;
+    Pool_Test_Frame *log_frame = 0;
+    uint32_t start;
+    uint32_t received = 0;
+    uint32_t errors = 0;
+    uint16_t i;
+    uint8_t c;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Memory_Pool_Init();
+
+    printf("\nMemory_Pool test\n");
+    Pool_Test_Measure(1);
+    Pool_Test_Measure(0);
+
+    // The main loop checks each frame, and keeps the last one for a second user (the "log") with Memory_Pool_Retain
+    Critical_Section_Clear_Stats();
+    SysTick_Interrupt_Init(POOL_TEST_SYSTICK_CYCLES, SYSTICK_INT_PRIORITY);
+    start = DWT->CYCCNT;
+    while((DWT->CYCCNT - start) < (POOL_TEST_DURATION_S * 48000000))
+    {
+        if (Ring_Buffer_Pop(&Pool_Test_Queue, &frame))
+        {
+            for (i = 0; i < frame->length; i++)
+            {
+                if (frame->data[i] != (uint8_t)(frame->sequence + i))
+                {
+                    errors++;
+                    break;
+                }
+            }
+            received++;
+
+            Memory_Pool_Release(log_frame);
+            log_frame = Memory_Pool_Retain(frame);
+            Memory_Pool_Release(frame);
+        }
+    }
+    SysTick->CTRL = 0;
+    Memory_Pool_Release(log_frame);
+
+    printf("%u frames received, %u dropped, %u errors\n", received, Pool_Test_Dropped, errors);
+    for (c = 0; c < MEMORY_POOL_NUM_CLASSES; c++)
+    {
+        Memory_Pool_Get_Stats(c, &stats);
+        printf("Class %u (%u x %u bytes): %u in use, high water %u, %u allocations, %u fallbacks, %u failures\n",
+               c, stats.block_count, stats.block_size, stats.in_use, stats.high_water,
+               stats.allocations, stats.fallbacks, stats.failures);
+    }
+
+    // Longest time during which SysTick (and every interrupt below CRITICAL_SECTION_PRIORITY) was held off
+    Critical_Section_Get_Stats(&section_stats);
+    printf("%u critical sections, longest %u cycles, average %u cycles\n", section_stats.sections,
+           section_stats.max_cycles, section_stats.sections ? (section_stats.total_cycles / section_stats.sections) : 0);
+
+    LED1_Output((errors == 0) ? RED_LED_OFF : RED_LED_ON);
+
+    while(1);
+}
+#endif
+
+#ifdef USE_NUMBER_PARSER_TEST
+#define PARSER_TEST_LINE_LENGTH     4096
+#define PARSER_TEST_MAX_VALUES      512
+
+static char Parser_Test_Line[PARSER_TEST_LINE_LENGTH];
+static uint32_t Parser_Test_Values[PARSER_TEST_MAX_VALUES];
+
+/**
+ * @brief The Parser_Test_Fill function fills Parser_Test_Line with comma-separated signed numbers
+ *        of 1 to 10 digits and returns its length.
+ */
+uint32_t Parser_Test_Fill(uint32_t *count)
+{
+    uint32_t length = 0;
+    uint32_t seed = 12345;
+    int32_t number;
+
+    *count = 0;
+    while((length < (PARSER_TEST_LINE_LENGTH - 13)) && (*count < PARSER_TEST_MAX_VALUES))
+    {
+        seed = seed * 1103515245 + 12345;
+        number = (int32_t)seed >> (seed & 0x1F);
+        length += sprintf(&Parser_Test_Line[length], "%ld,", (long)number);
+        (*count)++;
+    }
+
+    return length;
+}
+
+int main(void)
+{
+    Number_Parser parser;
+    uint32_t expected;
+    uint32_t length;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t value;
+    int32_t count;
+    int result;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Batch mode: parse a line of a few kilobytes at once
+    length = Parser_Test_Fill(&expected);
+    Number_Parser_Init(&parser, NUMBER_PARSER_SIGNED, 0);
+    start = DWT->CYCCNT;
+    count = Number_Parser_Parse(&parser, Parser_Test_Line, length, Parser_Test_Values, PARSER_TEST_MAX_VALUES);
+    cycles = DWT->CYCCNT - start;
+
+    printf("\nNumber_Parser test\n");
+    printf("Parsed %ld of %u numbers (%u bytes) in %u cycles: %u cycles per byte, %u kB/s\n",
+           (long)count, expected, length, cycles, cycles / length, (uint32_t)((48000ULL * length) / cycles));
+
+    // Streaming mode: numbers typed in the serial terminal are converted while the main loop keeps running
+    printf("Enter signed fixed-point numbers with 2 decimal places, separated by spaces or <enter> (with local echo on in the terminal):\n");
+    Number_Parser_Init(&parser, NUMBER_PARSER_FIXED, 2);
+
+    while(1)
+    {
+        result = EUSCI_A_UART_Poll_Number(EUSCI_A0_UART_PORT, &parser, &value);
+        if (result == NUMBER_PARSER_DONE)
+        {
+            printf("\n%ld (in units of 0.01)\n", (long)(int32_t)value);
+        }
+        else if (result == NUMBER_PARSER_ERROR_OVERFLOW)
+        {
+            printf("\nOut of range\n");
+        }
+        else if (result == NUMBER_PARSER_ERROR_SYNTAX)
+        {
+            printf("\nInvalid number\n");
+        }
+    }
+}
+#endif
+
+#ifdef USE_LINE_EDITOR
+#define CONSOLE_MAX_NUMBERS         16
+
+static Line_Editor Console;
+
+/**
+ * @brief The Console_Command function runs one command line:
+ *
+ *  sum <numbers>   Prints the sum of up to CONSOLE_MAX_NUMBERS signed numbers
+ *  stats           Prints the statistics of EUSCI_A0 and of the line editor
+ */
+void Console_Command(char *line)
+{
+    uint32_t values[CONSOLE_MAX_NUMBERS];
+    EUSCI_A_UART_Stats stats;
+    Number_Parser parser;
+    int32_t count;
+    int32_t sum = 0;
+    int32_t i;
+
+    if (strncmp(line, "sum ", 4) == 0)
+    {
+        Number_Parser_Init(&parser, NUMBER_PARSER_SIGNED, 0);
+        count = Number_Parser_Parse(&parser, &line[4], strlen(&line[4]), values, CONSOLE_MAX_NUMBERS);
+        if (count < 0)
+        {
+            printf("Invalid number\n");
+            return;
+        }
+        for (i = 0; i < count; i++)
+        {
+            sum += (int32_t)values[i];
+        }
+        printf("%ld numbers, sum %ld\n", (long)count, (long)sum);
+    }
+    else if (strcmp(line, "stats") == 0)
+    {
+        EUSCI_A_UART_Get_Stats(EUSCI_A0_UART_PORT, &stats);
+        printf("RX bytes %u, overrun errors %u, dropped %u, echo redraws %u\n",
+               stats.rx_bytes, stats.rx_overrun_errors, stats.rx_dropped, Console.echo_dropped);
+    }
+    else if (line[0] != 0)
+    {
+        printf("Unknown command: %s\n", line);
+    }
+}
+
+int main(void)
+{
+    char line[LINE_EDITOR_LENGTH + 1];
+    uint32_t last_toggle;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize the built-in red LED
+    LED1_Init();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    printf("\nLine editor test: arrow keys, Home, End, Delete, history (Up and Down), Ctrl+A/E/K/U/C\n");
+    printf("Commands: sum <numbers>, stats\n");
+    Line_Editor_Init(&Console, EUSCI_A0_UART_PORT, "rslk> ");
+
+    // The LED keeps blinking while a line is typed or pasted, since Line_Editor_Poll never waits
+    last_toggle = DWT->CYCCNT;
+    while(1)
+    {
+        if (Line_Editor_Poll(&Console, line, sizeof(line)) != LINE_EDITOR_NO_LINE)
+        {
+            Console_Command(line);
+            Line_Editor_Prompt(&Console);
+        }
+
+        if ((DWT->CYCCNT - last_toggle) >= 24000000)
+        {
+            last_toggle += 24000000;
+            LED1_Output((P1->OUT & 0x01) ? RED_LED_OFF : RED_LED_ON);
+        }
+    }
+}
+#endif
+
+#ifdef USE_STREAM_BENCHMARK
+#define STREAM_TEST_ITERATIONS      1000
+
+static char Stream_Test_Buffer[128];
+
+/**
+ * @brief The Stream_Test_Format function formats one line of a telemetry record, the same as the sprintf
+ *        call measured in main, and returns the number of characters written.
+ */
+uint32_t Stream_Test_Format(Stream *stream, uint32_t i)
+{
+    return Stream_Printf(stream, "t=%u x=%d y=%-6d id=%08X %s\n", i, (int32_t)(i * 37) - 18000, -(int32_t)i, i * 0x9E3779B9, "ok");
+}
+
+int main(void)
+{
+    Stream_Memory memory_sink;
+    Stream_Null null_sink;
+    Stream *memory;
+    Stream *null;
+    Stream *uart;
+    uint32_t cycles_sprintf = 0;
+    uint32_t cycles_memory = 0;
+    uint32_t cycles_null = 0;
+    uint32_t cycles_uart;
+    uint32_t start;
+    uint32_t i;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    memory = Stream_Memory_Init(&memory_sink, Stream_Test_Buffer, sizeof(Stream_Test_Buffer));
+    null = Stream_Null_Init(&null_sink);
+    uart = EUSCI_A_UART_Get_Stream(EUSCI_A0_UART_PORT);
+
+    // The same record is formatted by sprintf, into a RAM buffer and into the null sink
+    for (i = 0; i < STREAM_TEST_ITERATIONS; i++)
+    {
+        start = DWT->CYCCNT;
+        sprintf(Stream_Test_Buffer, "t=%lu x=%ld y=%-6ld id=%08lX %s\n", (unsigned long)i, (long)((int32_t)(i * 37) - 18000),
+                (long)-(int32_t)i, (unsigned long)(i * 0x9E3779B9), "ok");
+        cycles_sprintf += DWT->CYCCNT - start;
+
+        Stream_Memory_Clear(&memory_sink);
+        start = DWT->CYCCNT;
+        Stream_Test_Format(memory, i);
+        cycles_memory += DWT->CYCCNT - start;
+
+        start = DWT->CYCCNT;
+        Stream_Test_Format(null, i);
+        cycles_null += DWT->CYCCNT - start;
+    }
+
+    // Formatting straight into the transmit queue of the UART (the queue is empty, so nothing waits)
+    EUSCI_A_UART_Flush(EUSCI_A0_UART_PORT);
+    start = DWT->CYCCNT;
+    Stream_Test_Format(uart, i);
+    cycles_uart = DWT->CYCCNT - start;
+    Stream_Flush(uart);
+
+    Stream_Printf(uart, "\nStream benchmark (%u records, average cycles per record)\n", STREAM_TEST_ITERATIONS);
+    Stream_Printf(uart, "sprintf:                %u\n", cycles_sprintf / STREAM_TEST_ITERATIONS);
+    Stream_Printf(uart, "Stream_Printf (RAM):    %u\n", cycles_memory / STREAM_TEST_ITERATIONS);
+    Stream_Printf(uart, "Stream_Printf (null):   %u (%u bytes)\n", cycles_null / STREAM_TEST_ITERATIONS, null_sink.bytes);
+    Stream_Printf(uart, "Stream_Printf (UART):   %u\n", cycles_uart);
+    Stream_Printf(uart, "Last RAM record: %s", Stream_Test_Buffer);
+
+    while(1);
+}
+#endif
+
+#ifdef USE_MEMORY_BLOCK_BENCHMARK
+#define MEMORY_TEST_LENGTH      4096
+
+// Aligned to a word, so that the word loops start at the first byte
+#pragma DATA_ALIGN(Memory_Test_A, 4)
+#pragma DATA_ALIGN(Memory_Test_B, 4)
+static uint8_t Memory_Test_A[MEMORY_TEST_LENGTH];
+static uint8_t Memory_Test_B[MEMORY_TEST_LENGTH];
+
+// Sizes measured: a short block, the Nokia 5110 frame buffer (84 x 48 / 8) and a large block
+static const uint32_t Memory_Test_Sizes[] = {32, 504, MEMORY_TEST_LENGTH};
+
+/**
+ * @brief Byte loops used as the reference of the benchmark.
+ */
+static void Byte_Fill(uint8_t *destination, uint8_t value, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        destination[i] = value;
+    }
+}
+
+static void Byte_Copy(uint8_t *destination, const uint8_t *source, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        destination[i] = source[i];
+    }
+}
+
+static int32_t Byte_Compare(const uint8_t *a, const uint8_t *b, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        if (a[i] != b[i])
+        {
+            return i;
+        }
+    }
+
+    return MEMORY_BLOCK_EQUAL;
+}
+
+static uint32_t Byte_Count_Differences(const uint8_t *a, const uint8_t *b, uint32_t length)
+{
+    uint32_t differences = 0;
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        differences += (a[i] != b[i]);
+    }
+
+    return differences;
+}
+
+/**
+ * @brief Prints a number of cycles and the cycles per byte with two decimals.
+ */
+static void Memory_Test_Print(const char *name, uint32_t cycles, uint32_t length)
+{
+    uint32_t hundredths = (cycles * 100 + length / 2) / length;
+
+    printf("  %-28s %6u cycles  %3u.%02u cycles/byte\n", name, cycles, hundredths / 100, hundredths % 100);
+}
+
+int main(void)
+{
+    uint32_t length;
+    uint32_t start;
+    uint32_t i;
+
+    // Initialize the 48 MHz Clock
+    Clock_Init48MHz();
+
+    // Initialize EUSCI_A0_UART
+    EUSCI_A0_UART_Init_Printf();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    printf("\nMemory block benchmark\n");
+
+    for (i = 0; i < sizeof(Memory_Test_Sizes) / sizeof(Memory_Test_Sizes[0]); i++)
+    {
+        length = Memory_Test_Sizes[i];
+        printf("%u bytes\n", length);
+
+        start = DWT->CYCCNT;
+        Byte_Fill(Memory_Test_A, 0x5A, length);
+        Memory_Test_Print("Fill (byte loop)", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Memory_Block_Fill(Memory_Test_A, 0x5A, length);
+        Memory_Test_Print("Memory_Block_Fill", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Memory_Block_DMA_Fill(Memory_Test_A, 0x5A, length);
+        Memory_Test_Print("Memory_Block_DMA_Fill", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Byte_Copy(Memory_Test_B, Memory_Test_A, length);
+        Memory_Test_Print("Copy (byte loop)", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Memory_Block_Copy(Memory_Test_B, Memory_Test_A, length);
+        Memory_Test_Print("Memory_Block_Copy", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Memory_Block_DMA_Copy(Memory_Test_B, Memory_Test_A, length);
+        Memory_Test_Print("Memory_Block_DMA_Copy", DWT->CYCCNT - start, length);
+
+        // The blocks are equal, so the compare loops scan the whole length
+        start = DWT->CYCCNT;
+        Byte_Compare(Memory_Test_A, Memory_Test_B, length);
+        Memory_Test_Print("Compare (byte loop)", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Memory_Block_Compare(Memory_Test_A, Memory_Test_B, length);
+        Memory_Test_Print("Memory_Block_Compare", DWT->CYCCNT - start, length);
+
+        Memory_Test_B[length / 2] ^= 0xFF;
+
+        start = DWT->CYCCNT;
+        Byte_Count_Differences(Memory_Test_A, Memory_Test_B, length);
+        Memory_Test_Print("Count differences (byte loop)", DWT->CYCCNT - start, length);
+
+        start = DWT->CYCCNT;
+        Memory_Block_Count_Differences(Memory_Test_A, Memory_Test_B, length);
+        Memory_Test_Print("Memory_Block_Count_Differences", DWT->CYCCNT - start, length);
+
+        // Both versions must agree
+        if ((Byte_Compare(Memory_Test_A, Memory_Test_B, length) != Memory_Block_Compare(Memory_Test_A, Memory_Test_B, length)) ||
+            (Byte_Count_Differences(Memory_Test_A, Memory_Test_B, length) != Memory_Block_Count_Differences(Memory_Test_A, Memory_Test_B, length)))
+        {
+            printf("  MISMATCH between the byte loops and Memory_Block\n");
+        }
+    }
+
+    while(1);
+}
+#endif
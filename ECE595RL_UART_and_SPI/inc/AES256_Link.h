@@ -0,0 +1,210 @@
+/**
+ * @file AES256_Link.h
+ * @brief Header file for the AES256_Link driver.
+ *
+ * This file contains the function definitions for the AES256_Link driver.
+ * It provides an encrypted and authenticated framing layer over the EUSCI_A2 UART
+ * using the AES256 accelerator of the MSP432 in AES-CCM mode (NIST SP 800-38C):
+ *
+ *  - Key: 256-bit
+ *  - Nonce: 13 bytes (5-byte link salt followed by an 8-byte big-endian frame counter)
+ *  - Tag: 8 bytes
+ *  - No associated data
+ *
+ * Each frame transmitted on the P3.3 pin has the following layout:
+ *
+ *  Offset              Size        Field
+ *  ------              ----        -----
+ *   0                   1          AES256_LINK_SYNC (0x7E)
+ *   1                   1          Payload length (0 to AES256_LINK_MAX_PAYLOAD)
+ *   2                   13         Nonce
+ *   15                  length     Ciphertext
+ *   15 + length         8          Authentication tag
+ *
+ * The CTR keystream is produced by the AES256 accelerator in ECB mode while it is fed by two DMA channels
+ * (AES trigger 1 writes AESADIN, AES trigger 0 reads AESADOUT). The CBC-MAC is computed through AESAXDIN
+ * one block at a time so that it overlaps with the transmission of the previous block over EUSCI_A2.
+ *
+ * A software AES-256 implementation is included as a baseline for benchmarking.
+ * The host-side reference implementation used to generate and check test vectors is tools/aes256_link.py.
+ *
+ * For more information regarding the AES256 accelerator and the DMA controller,
+ * refer to the AES256 Accelerator (22) and DMA (11) sections of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @note Assumes that EUSCI_A2_UART_Init() has been called. P3.2 is used for UART RX while P3.3 is used for UART TX.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef AES256_LINK_H_
+#define AES256_LINK_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/EUSCI_A2_UART.h"
+
+/**
+ * @brief Start-of-frame marker
+ */
+#define AES256_LINK_SYNC            0x7E
+
+/**
+ * @brief Length of the nonce in bytes (CCM parameter N)
+ */
+#define AES256_LINK_NONCE_LENGTH    13
+
+/**
+ * @brief Length of the link salt in bytes. The remaining 8 bytes of the nonce are the frame counter.
+ */
+#define AES256_LINK_SALT_LENGTH     5
+
+/**
+ * @brief Length of the authentication tag in bytes (CCM parameter M)
+ */
+#define AES256_LINK_TAG_LENGTH      8
+
+/**
+ * @brief Number of bytes in the frame header (sync, length and nonce)
+ */
+#define AES256_LINK_HEADER_LENGTH   (2 + AES256_LINK_NONCE_LENGTH)
+
+/**
+ * @brief Maximum payload length in bytes (15 AES blocks)
+ */
+#define AES256_LINK_MAX_PAYLOAD     240
+
+/**
+ * @brief Maximum length of a complete frame in bytes
+ */
+#define AES256_LINK_MAX_FRAME       (AES256_LINK_HEADER_LENGTH + AES256_LINK_MAX_PAYLOAD + AES256_LINK_TAG_LENGTH)
+
+/**
+ * @brief Error codes returned by AES256_Link_Open and AES256_Link_Receive
+ */
+#define AES256_LINK_ERROR_FORMAT    -1
+#define AES256_LINK_ERROR_LENGTH    -2
+#define AES256_LINK_ERROR_TAG       -3
+#define AES256_LINK_ERROR_REPLAY    -4
+#define AES256_LINK_ERROR_REFLECTED -5
+
+/**
+ * @brief Initializes the AES256 accelerator and loads the 256-bit link key.
+ *
+ * This function resets the AES256 accelerator, selects a 256-bit key length and writes the key
+ * to the AESAKEY register. It also expands the key for the software baseline, stores the link salt,
+ * and resets the transmit and receive frame counters.
+ *
+ * Both ends of the link share the key but must use different salts: AES256_Link_Open rejects a frame that
+ * carries the local salt, so a frame reflected back to its sender does not authenticate.
+ *
+ * @param key Pointer to the 32-byte key.
+ * @param salt Pointer to the 5-byte link salt which forms the first bytes of every nonce transmitted by this end.
+ *
+ * @return None
+ */
+void AES256_Link_Init(const uint8_t *key, const uint8_t *salt);
+
+/**
+ * @brief Encrypts a single 16-byte block using the AES256 accelerator in ECB mode.
+ *
+ * @param input Pointer to the 16-byte plaintext block.
+ * @param output Pointer to the 16-byte buffer where the ciphertext will be stored.
+ *
+ * @return None
+ */
+void AES256_Link_Encrypt_Block(const uint8_t *input, uint8_t *output);
+
+/**
+ * @brief Encrypts a single 16-byte block using the software AES-256 implementation.
+ *
+ * This function is used as a baseline to measure the speedup of the AES256 accelerator.
+ *
+ * @param input Pointer to the 16-byte plaintext block.
+ * @param output Pointer to the 16-byte buffer where the ciphertext will be stored.
+ *
+ * @return None
+ */
+void AES256_Link_Software_Encrypt_Block(const uint8_t *input, uint8_t *output);
+
+/**
+ * @brief Builds an encrypted and authenticated frame using the AES256 accelerator.
+ *
+ * The keystream is generated by the AES256 accelerator fed by DMA, and the CBC-MAC is computed through AESAXDIN.
+ * The transmit frame counter is incremented after each call.
+ *
+ * @param plaintext Pointer to the payload to be encrypted.
+ * @param length Length of the payload in bytes (0 to AES256_LINK_MAX_PAYLOAD).
+ * @param frame Pointer to the buffer where the frame will be stored. It must hold at least AES256_LINK_MAX_FRAME bytes.
+ *
+ * @return Length of the frame in bytes, or AES256_LINK_ERROR_LENGTH if the payload is too long.
+ */
+int AES256_Link_Seal(const uint8_t *plaintext, uint8_t length, uint8_t *frame);
+
+/**
+ * @brief Builds an encrypted and authenticated frame using the software AES-256 implementation.
+ *
+ * The output is identical to AES256_Link_Seal for the same key, salt and frame counter.
+ * The transmit frame counter is incremented after each call.
+ *
+ * @param plaintext Pointer to the payload to be encrypted.
+ * @param length Length of the payload in bytes (0 to AES256_LINK_MAX_PAYLOAD).
+ * @param frame Pointer to the buffer where the frame will be stored. It must hold at least AES256_LINK_MAX_FRAME bytes.
+ *
+ * @return Length of the frame in bytes, or AES256_LINK_ERROR_LENGTH if the payload is too long.
+ */
+int AES256_Link_Seal_Software(const uint8_t *plaintext, uint8_t length, uint8_t *frame);
+
+/**
+ * @brief Verifies and decrypts a complete frame using the AES256 accelerator.
+ *
+ * The frame counter in the nonce must be greater than that of the last accepted frame, and the salt in the nonce
+ * must differ from the local salt (AES256_LINK_ERROR_REFLECTED otherwise). The plaintext buffer is cleared if the tag does not match.
+ *
+ * @param frame Pointer to the received frame.
+ * @param frame_length Length of the received frame in bytes.
+ * @param plaintext Pointer to the buffer where the payload will be stored. It must hold at least AES256_LINK_MAX_PAYLOAD bytes.
+ *
+ * @return Length of the payload in bytes, or a negative AES256_LINK_ERROR code.
+ */
+int AES256_Link_Open(const uint8_t *frame, uint16_t frame_length, uint8_t *plaintext);
+
+/**
+ * @brief Encrypts a payload and transmits it as a frame over EUSCI_A2.
+ *
+ * This function starts the DMA-fed keystream generation, transmits the frame header while the AES256 accelerator
+ * is busy, and then computes the CBC-MAC of each block while the previous ciphertext block is being shifted out.
+ *
+ * @param plaintext Pointer to the payload to be encrypted.
+ * @param length Length of the payload in bytes (0 to AES256_LINK_MAX_PAYLOAD).
+ *
+ * @return Number of bytes transmitted, or AES256_LINK_ERROR_LENGTH if the payload is too long.
+ */
+int AES256_Link_Send(const uint8_t *plaintext, uint8_t length);
+
+/**
+ * @brief Receives a frame over EUSCI_A2, then verifies and decrypts it.
+ *
+ * This function blocks until AES256_LINK_SYNC is received, then reads the rest of the frame.
+ *
+ * @param plaintext Pointer to the buffer where the payload will be stored. It must hold at least AES256_LINK_MAX_PAYLOAD bytes.
+ *
+ * @return Length of the payload in bytes, or a negative AES256_LINK_ERROR code.
+ */
+int AES256_Link_Receive(uint8_t *plaintext);
+
+/**
+ * @brief Runs the AES256_Link self-test and throughput benchmark, and prints the results using printf.
+ *
+ * The self-test checks the FIPS-197 AES-256 known-answer vector with both implementations and compares
+ * the frames produced by AES256_Link_Seal and AES256_Link_Seal_Software. The benchmark reports the number of
+ * clock cycles used to seal a maximum-length payload, and the time to transmit it as plaintext and as a frame.
+ *
+ * @note Assumes that EUSCI_A0_UART_Init_Printf() and EUSCI_A2_UART_Init() have been called.
+ *       Reinitializes the link with the FIPS-197 key.
+ *
+ * @return 0 if the self-test passes, otherwise -1.
+ */
+int AES256_Link_Benchmark();
+
+#endif /* AES256_LINK_H_ */
@@ -0,0 +1,229 @@
+/**
+ * @file Active_Object.h
+ * @brief Header file for the Active_Object framework.
+ *
+ * This file contains the function definitions for the Active_Object framework.
+ * An active object owns a queue of events and a hierarchical state machine. The scheduler takes the events one
+ * at a time from the highest priority active object that has one, and runs the state machine until the event
+ * is handled (run-to-completion), so the state machines never wait and never preempt each other.
+ * When all the queues are empty, the CPU sleeps (WFI) until an interrupt posts an event.
+ *
+ * A state is a function that handles an event and returns what it did:
+ *
+ *      static uint8_t Counting(Active_Object *me, const Active_Object_Event *e)
+ *      {
+ *          switch(e->signal)
+ *          {
+ *              case ACTIVE_OBJECT_SIGNAL_ENTRY:    ...; return ACTIVE_OBJECT_HANDLED();
+ *              case TIMEOUT_SIGNAL:                ...; return ACTIVE_OBJECT_TRANSITION(Fast);
+ *          }
+ *          return ACTIVE_OBJECT_SUPER(Active_Object_Top);
+ *      }
+ *
+ * The first parameter of a state must be named me, which the return macros use. An event that a state does not
+ * handle goes to its parent state (ACTIVE_OBJECT_SUPER). A transition exits the states
+ * up to the closest common parent of the source and the target, enters the states down to the target, then follows
+ * the ACTIVE_OBJECT_SIGNAL_INIT transitions of the target to a leaf state. A transition to the source state itself
+ * exits and enters it again.
+ *
+ * Events are two 16-bit values copied into the queue, so an interrupt handler can post them without allocating
+ * memory. Active_Object_Post and the timers use Critical_Section_Enter: they can be used from the interrupts at or
+ * below CRITICAL_SECTION_PRIORITY (refer to Interrupt_Priority.h).
+ *
+ * When ACTIVE_OBJECT_HOST is defined, the framework can be compiled on a computer (without the critical sections
+ * and the sleep). Active_Object_Run_Once and Active_Object_Tick then let a test run the events and the time in
+ * a fixed order.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef ACTIVE_OBJECT_H_
+#define ACTIVE_OBJECT_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Highest priority of an active object. Each active object has its own priority, from 1 to this value.
+ */
+#define ACTIVE_OBJECT_MAX_PRIORITY      8
+
+/**
+ * @brief Maximum depth of the state hierarchy, Active_Object_Top excluded
+ */
+#define ACTIVE_OBJECT_MAX_NESTING       6
+
+/**
+ * @brief Error codes
+ */
+#define ACTIVE_OBJECT_ERROR_FULL        -1      // The queue of the active object is full, the event is dropped
+#define ACTIVE_OBJECT_ERROR_PRIORITY    -2      // The priority is out of range or already used
+
+/**
+ * @brief Reserved signals, sent by the framework to the states. The application signals start at ACTIVE_OBJECT_SIGNAL_USER.
+ */
+#define ACTIVE_OBJECT_SIGNAL_EMPTY      0       // Asks a state for its parent state
+#define ACTIVE_OBJECT_SIGNAL_ENTRY      1
+#define ACTIVE_OBJECT_SIGNAL_EXIT       2
+#define ACTIVE_OBJECT_SIGNAL_INIT       3       // Initial transition of a composite state
+#define ACTIVE_OBJECT_SIGNAL_USER       4
+
+/**
+ * @brief Values returned by a state
+ */
+#define ACTIVE_OBJECT_RETURN_HANDLED    0
+#define ACTIVE_OBJECT_RETURN_IGNORED    1
+#define ACTIVE_OBJECT_RETURN_SUPER      2
+#define ACTIVE_OBJECT_RETURN_TRANSITION 3
+
+/**
+ * @brief Return statements of a state. The parent state and the target are kept in me->next until the framework uses them.
+ */
+#define ACTIVE_OBJECT_HANDLED()             (ACTIVE_OBJECT_RETURN_HANDLED)
+#define ACTIVE_OBJECT_SUPER(parent)         ((me)->next = (parent), ACTIVE_OBJECT_RETURN_SUPER)
+#define ACTIVE_OBJECT_TRANSITION(target)    ((me)->next = (target), ACTIVE_OBJECT_RETURN_TRANSITION)
+
+/**
+ * @brief An event: a signal and a parameter (for example the status of the buttons)
+ */
+typedef struct
+{
+    uint16_t signal;
+    uint16_t parameter;
+} Active_Object_Event;
+
+typedef struct Active_Object Active_Object;
+
+/**
+ * @brief A state of a state machine
+ */
+typedef uint8_t (*Active_Object_State)(Active_Object *me, const Active_Object_Event *e);
+
+/**
+ * @brief An active object. The application puts it at the start of its own structure to add its variables.
+ */
+struct Active_Object
+{
+    Active_Object_State state;          // Current leaf state
+    Active_Object_State next;           // Set by ACTIVE_OBJECT_SUPER and ACTIVE_OBJECT_TRANSITION
+    Active_Object_Event *queue;
+    uint8_t queue_length;
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint8_t count;
+    uint8_t max_count;                  // High water mark of the queue
+    uint8_t priority;
+    uint16_t dropped;                   // Events dropped because the queue was full
+};
+
+/**
+ * @brief A timer that posts an event to an active object after a number of ticks, once or periodically
+ */
+typedef struct Active_Object_Timer
+{
+    Active_Object *target;
+    Active_Object_Event event;
+    uint32_t remaining;                 // Ticks before the event is posted, 0 if the timer is stopped
+    uint32_t period;                    // 0 for a single event
+    struct Active_Object_Timer *next;   // Next running timer
+} Active_Object_Timer;
+
+/**
+ * @brief The Active_Object_Top state is the parent of the states that have no other parent. It ignores all events.
+ *
+ * @param me    The active object
+ * @param e     The event
+ *
+ * @return ACTIVE_OBJECT_RETURN_IGNORED
+ */
+uint8_t Active_Object_Top(Active_Object *me, const Active_Object_Event *e);
+
+/**
+ * @brief The Active_Object_Start function registers an active object and enters its initial state.
+ *
+ * The entry actions of the states from Active_Object_Top down to the initial state are run, then the initial
+ * transitions (ACTIVE_OBJECT_SIGNAL_INIT) down to a leaf state.
+ *
+ * @param ao            The active object
+ * @param priority      Priority of the active object, from 1 to ACTIVE_OBJECT_MAX_PRIORITY (highest)
+ * @param queue         Storage of the event queue
+ * @param queue_length  Number of events in the storage (1 to 255)
+ * @param initial       Initial state
+ *
+ * @return 0 or ACTIVE_OBJECT_ERROR_PRIORITY
+ */
+int Active_Object_Start(Active_Object *ao, uint8_t priority, Active_Object_Event *queue, uint8_t queue_length,
+                        Active_Object_State initial);
+
+/**
+ * @brief The Active_Object_Post function adds an event at the end of the queue of an active object.
+ *
+ * @param ao            The active object
+ * @param signal        Signal of the event (ACTIVE_OBJECT_SIGNAL_USER or more)
+ * @param parameter     Parameter of the event
+ *
+ * @return 0 or ACTIVE_OBJECT_ERROR_FULL
+ */
+int Active_Object_Post(Active_Object *ao, uint16_t signal, uint16_t parameter);
+
+/**
+ * @brief The Active_Object_Run_Once function dispatches one event, from the highest priority active object that has one.
+ *
+ * @param None
+ *
+ * @return 1 if an event was dispatched, 0 if all the queues are empty
+ */
+uint8_t Active_Object_Run_Once();
+
+/**
+ * @brief The Active_Object_Run function dispatches the events forever, and sleeps when all the queues are empty.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Active_Object_Run();
+
+/**
+ * @brief The Active_Object_Timer_Init function sets the active object and the event of a timer. The timer is stopped.
+ *
+ * @param timer     The timer
+ * @param target    Active object that receives the event
+ * @param signal    Signal of the event
+ * @param parameter Parameter of the event
+ *
+ * @return None
+ */
+void Active_Object_Timer_Init(Active_Object_Timer *timer, Active_Object *target, uint16_t signal, uint16_t parameter);
+
+/**
+ * @brief The Active_Object_Timer_Start function (re)starts a timer.
+ *
+ * @param timer     The timer
+ * @param ticks     Ticks before the first event (at least 1)
+ * @param period    Ticks between the next events, or 0 for a single event
+ *
+ * @return None
+ */
+void Active_Object_Timer_Start(Active_Object_Timer *timer, uint32_t ticks, uint32_t period);
+
+/**
+ * @brief The Active_Object_Timer_Stop function stops a timer. An event that was already posted stays in the queue.
+ *
+ * @param timer     The timer
+ *
+ * @return None
+ */
+void Active_Object_Timer_Stop(Active_Object_Timer *timer);
+
+/**
+ * @brief The Active_Object_Tick function counts one tick for the running timers and posts the events of
+ *        the timers that expire. It is called by a periodic interrupt (for example SysTick_Handler).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Active_Object_Tick();
+
+#endif /* ACTIVE_OBJECT_H_ */
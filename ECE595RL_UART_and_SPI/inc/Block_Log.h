@@ -0,0 +1,171 @@
+/**
+ * @file Block_Log.h
+ * @brief Header file for the Block_Log driver.
+ *
+ * This file contains the function definitions for the Block_Log driver.
+ * It records a stream of bytes (for example sensor samples and timestamps) on a block device, so that data
+ * produced faster than the UART can send it is kept on the board and read later (refer to tools/block_log_reader.py).
+ *
+ * Appended bytes are copied into a RAM buffer of BLOCK_LOG_CHUNK_BLOCKS blocks. When the buffer is full, all of its
+ * blocks are written with one call to write_blocks, at a block number that is a multiple of BLOCK_LOG_CHUNK_BLOCKS.
+ * Large aligned writes are much faster than single blocks on SD cards and flash memory. Block_Log_Flush writes
+ * the blocks that changed since the last write, including the block being filled, which is written again when
+ * more bytes are appended to it.
+ *
+ * Layout of the device:
+ *
+ *  Block       Contents
+ *  -----       --------
+ *  0           Header only (index 0): identifies the log and its log_id
+ *  1 to N      Header and up to BLOCK_LOG_PAYLOAD_SIZE bytes of the log
+ *
+ * Header of every block (little-endian):
+ *
+ *  Offset      Size    Field       Description
+ *  ------      ----    -----       -----------
+ *  0           4       magic       BLOCK_LOG_MAGIC ("BLOG")
+ *  4           4       log_id      Incremented by Block_Log_Format, so blocks of a previous log are not valid
+ *  8           4       index       Block number
+ *  12          2       used        Number of payload bytes in the block, ORed with BLOCK_LOG_RUN_START in the first block of a run
+ *  14          2       crc         CRC-16/CCITT (initial value 0xFFFF) of bytes 0 to 13 and of the used payload bytes
+ *
+ * Blocks are always written in order, so the valid blocks of a log form a prefix of the device.
+ * Block_Log_Mount finds its end with a binary search and starts a new run in the next block, so that bytes appended
+ * by different runs (for example before and after a reset) are never mixed in one block. The reader uses the
+ * BLOCK_LOG_RUN_START flag to split the log into runs and drops a record that was cut off at the end of a run.
+ *
+ * Block_Log_Append_Record adds a record with a header (BLOCK_LOG_RECORD_SYNC, type, 16-bit length) so that
+ * different kinds of data can be mixed in the same log. Records may span several blocks.
+ *
+ * The device is accessed through a Block_Log_Device structure, so the same code can use an SD card (SD_Card driver),
+ * a NOR flash or a file on a computer.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef BLOCK_LOG_H_
+#define BLOCK_LOG_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Block sizes in bytes
+ */
+#define BLOCK_LOG_BLOCK_SIZE        512
+#define BLOCK_LOG_HEADER_SIZE       16
+#define BLOCK_LOG_PAYLOAD_SIZE      (BLOCK_LOG_BLOCK_SIZE - BLOCK_LOG_HEADER_SIZE)
+
+/**
+ * @brief Number of blocks in the RAM buffer and in each aligned write (8 blocks = 4 KB)
+ */
+#define BLOCK_LOG_CHUNK_BLOCKS      8
+
+/**
+ * @brief Value of the magic field ("BLOG" in little-endian byte order)
+ */
+#define BLOCK_LOG_MAGIC             0x474F4C42
+
+/**
+ * @brief Flag of the used field in the first block written after Block_Log_Format or Block_Log_Mount
+ */
+#define BLOCK_LOG_RUN_START         0x8000
+
+/**
+ * @brief First byte of a record
+ */
+#define BLOCK_LOG_RECORD_SYNC       0xA5
+#define BLOCK_LOG_RECORD_HEADER_SIZE 4
+
+/**
+ * @brief Error codes
+ */
+#define BLOCK_LOG_ERROR_DEVICE      -1  // read_block or write_blocks returned an error
+#define BLOCK_LOG_ERROR_FULL        -2  // The device is full
+#define BLOCK_LOG_ERROR_NO_LOG      -3  // Block 0 does not hold a log header (Block_Log_Format must be called)
+#define BLOCK_LOG_ERROR_NOT_MOUNTED -4  // Block_Log_Format or Block_Log_Mount has not succeeded
+#define BLOCK_LOG_ERROR_LENGTH      -5  // The record is longer than 65535 bytes
+
+/**
+ * @brief A block device with BLOCK_LOG_BLOCK_SIZE bytes per block.
+ */
+typedef struct
+{
+    uint32_t block_count;
+
+    // Both functions return 0 on success or a negative value on error
+    int (*read_block)(uint32_t block, uint8_t *data);
+    int (*write_blocks)(uint32_t block, const uint8_t *data, uint16_t count);
+} Block_Log_Device;
+
+/**
+ * @brief State of the log.
+ */
+typedef struct
+{
+    uint32_t log_id;
+    uint32_t blocks;                // Blocks used by the log, including the block being filled and block 0
+    uint32_t block_count;           // Blocks of the device
+    uint32_t bytes;                 // Bytes appended since Block_Log_Format or Block_Log_Mount
+    uint32_t buffered;              // Payload bytes in the blocks that changed since the last write to the device
+    uint32_t blocks_written;        // Including blocks written again
+    uint32_t writes;                // Calls to write_blocks
+} Block_Log_Stats;
+
+/**
+ * @brief Starts a new empty log on a device. The previous log can no longer be read.
+ *
+ * @param device Pointer to the device. It must remain valid while the log is used.
+ *
+ * @return 0 on success, or a negative BLOCK_LOG_ERROR code.
+ */
+int Block_Log_Format(const Block_Log_Device *device);
+
+/**
+ * @brief Opens the log of a device so that Block_Log_Append continues after its last byte.
+ *
+ * @param device Pointer to the device. It must remain valid while the log is used.
+ *
+ * @return 0 on success, or a negative BLOCK_LOG_ERROR code.
+ */
+int Block_Log_Mount(const Block_Log_Device *device);
+
+/**
+ * @brief Appends bytes to the log. A chunk of BLOCK_LOG_CHUNK_BLOCKS blocks is written each time the buffer is full.
+ *
+ * @param data Pointer to the bytes.
+ * @param length Number of bytes.
+ *
+ * @return 0 on success, or a negative BLOCK_LOG_ERROR code. If the device becomes full,
+ *         the bytes that fit are appended and BLOCK_LOG_ERROR_FULL is returned.
+ */
+int Block_Log_Append(const void *data, uint32_t length);
+
+/**
+ * @brief Appends a record (sync byte, type, length and data). Nothing is appended if the whole record does not fit.
+ *
+ * @param type Type of the record, defined by the application.
+ * @param data Pointer to the data of the record.
+ * @param length Number of bytes (up to 65535).
+ *
+ * @return 0 on success, or a negative BLOCK_LOG_ERROR code.
+ */
+int Block_Log_Append_Record(uint8_t type, const void *data, uint32_t length);
+
+/**
+ * @brief Writes the buffered bytes to the device.
+ *
+ * @return 0 on success, or a negative BLOCK_LOG_ERROR code.
+ */
+int Block_Log_Flush();
+
+/**
+ * @brief Returns the state of the log.
+ *
+ * @param stats Pointer to where the state will be stored.
+ *
+ * @return None
+ */
+void Block_Log_Get_Stats(Block_Log_Stats *stats);
+
+#endif /* BLOCK_LOG_H_ */
@@ -0,0 +1,47 @@
+/**
+ * @file CRC16.h
+ * @brief Header file for the CRC16 library.
+ *
+ * This file contains the function definitions for the CRC16 library.
+ * It computes the CRC-16/CCITT (polynomial 0x1021, not reflected, no final XOR) used by the binary streams of
+ * the drivers (Trace, Profiler, Logic_Analyzer), the frames of UART_Bootloader and the blocks of Block_Log.
+ * All of them start from CRC16_INITIAL_VALUE and send the result little-endian.
+ *
+ * A CRC can be computed in several parts: the result of one call is the initial value of the next one.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Initial value of a CRC
+ */
+#define CRC16_INITIAL_VALUE     0xFFFF
+
+/**
+ * @brief Adds one byte to a CRC.
+ *
+ * @param crc The CRC of the previous bytes (CRC16_INITIAL_VALUE for the first byte).
+ * @param data The byte.
+ *
+ * @return The updated CRC.
+ */
+uint16_t CRC16_Update(uint16_t crc, uint8_t data);
+
+/**
+ * @brief Adds a buffer to a CRC.
+ *
+ * @param crc The CRC of the previous bytes (CRC16_INITIAL_VALUE for a new CRC).
+ * @param data Pointer to the bytes.
+ * @param length Number of bytes.
+ *
+ * @return The updated CRC.
+ */
+uint16_t CRC16_Compute(uint16_t crc, const uint8_t *data, uint32_t length);
+
+#endif /* CRC16_H_ */
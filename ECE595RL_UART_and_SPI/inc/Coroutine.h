@@ -0,0 +1,147 @@
+/**
+ * @file Coroutine.h
+ * @brief Header file for the Coroutine macros.
+ *
+ * This file contains the macros for stackless coroutines (protothreads). A coroutine is a function that is called
+ * again and again, for example from the main loop. Each call runs it until it has to wait, then it returns
+ * COROUTINE_WAITING, and the next call resumes it after the wait. The sequence is written as straight code
+ * but never blocks the CPU:
+ *
+ *      static uint8_t Blink(Coroutine *co)
+ *      {
+ *          COROUTINE_BEGIN(co);
+ *          while(1)
+ *          {
+ *              LED1_Output(RED_LED_ON);
+ *              COROUTINE_DELAY(co, 100);
+ *              LED1_Output(RED_LED_OFF);
+ *              COROUTINE_DELAY(co, 900);
+ *          }
+ *          COROUTINE_END(co);
+ *      }
+ *
+ * The position in the function is kept in co->line and the function resumes with a switch statement, so:
+ *  - The local variables are lost at each wait: the variables used across a wait must be static or in a structure.
+ *  - A coroutine must not wait inside its own switch statement.
+ *  - A coroutine can only wait in its own body. It waits for another coroutine with COROUTINE_AWAIT_CALL.
+ *
+ * COROUTINE_DELAY counts the ticks of Coroutine_Tick, which must be called by a periodic interrupt
+ * (for example SysTick_Handler every 1 ms). COROUTINE_AWAIT_SPI and COROUTINE_AWAIT_UART_BYTE use the
+ * SPI_Bus and EUSCI_A_UART drivers, whose headers must be included by the file that uses them.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef COROUTINE_H_
+#define COROUTINE_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Values returned by a coroutine
+ */
+#define COROUTINE_WAITING       0
+#define COROUTINE_DONE          1
+
+/**
+ * @brief State of a coroutine. It must be set to 0 (COROUTINE_INIT) before the first call.
+ */
+typedef struct
+{
+    uint16_t line;              // Line where the coroutine resumes, 0 at the start
+    uint32_t wait_start;        // Tick count at the start of COROUTINE_DELAY
+} Coroutine;
+
+/**
+ * @brief Restarts a coroutine from the beginning on its next call
+ */
+#define COROUTINE_INIT(co)              ((co)->line = 0)
+
+/**
+ * @brief Start and end of the body of a coroutine. A coroutine that reaches COROUTINE_END returns COROUTINE_DONE,
+ *        and its next call starts again from the beginning.
+ */
+#define COROUTINE_BEGIN(co)             switch((co)->line) { case 0:
+#define COROUTINE_END(co)               } (co)->line = 0; return COROUTINE_DONE
+
+/**
+ * @brief Returns COROUTINE_WAITING until a condition is true. The condition is checked at each call.
+ */
+#define COROUTINE_WAIT_UNTIL(co, condition)                 \
+    do                                                      \
+    {                                                       \
+        (co)->line = __LINE__; case __LINE__:               \
+        if (!(condition))                                   \
+        {                                                   \
+            return COROUTINE_WAITING;                       \
+        }                                                   \
+    } while(0)
+
+/**
+ * @brief Returns COROUTINE_WAITING once, to let the other coroutines run
+ */
+#define COROUTINE_YIELD(co)                                 \
+    do                                                      \
+    {                                                       \
+        (co)->line = __LINE__;                              \
+        return COROUTINE_WAITING;                           \
+        case __LINE__:;                                     \
+    } while(0)
+
+/**
+ * @brief Starts another coroutine and runs it at each call until it is done
+ *
+ * @param co        This coroutine
+ * @param child     State of the other coroutine
+ * @param call      The call of the other coroutine, for example Nokia5110_Init_Async(child)
+ */
+#define COROUTINE_AWAIT_CALL(co, child, call)               \
+    do                                                      \
+    {                                                       \
+        COROUTINE_INIT(child);                              \
+        COROUTINE_WAIT_UNTIL(co, (call) == COROUTINE_DONE); \
+    } while(0)
+
+/**
+ * @brief Waits for a number of ticks of Coroutine_Tick. Since the first tick can come at any time,
+ *        the wait lasts between ticks - 1 and ticks tick periods.
+ */
+#define COROUTINE_DELAY(co, ticks)                          \
+    do                                                      \
+    {                                                       \
+        (co)->wait_start = Coroutine_Get_Ticks();           \
+        COROUTINE_WAIT_UNTIL(co, (Coroutine_Get_Ticks() - (co)->wait_start) >= (ticks)); \
+    } while(0)
+
+/**
+ * @brief Waits until an SPI_Bus_Transaction that was submitted with SPI_Bus_Submit is complete
+ */
+#define COROUTINE_AWAIT_SPI(co, transaction)                \
+    COROUTINE_WAIT_UNTIL(co, (transaction)->status == SPI_BUS_DONE)
+
+/**
+ * @brief Waits until the receive buffer of an EUSCI_A_UART port holds at least one byte
+ */
+#define COROUTINE_AWAIT_UART_BYTE(co, port)                 \
+    COROUTINE_WAIT_UNTIL(co, EUSCI_A_UART_RX_Available(port) > 0)
+
+/**
+ * @brief The Coroutine_Tick function counts one tick for COROUTINE_DELAY. It is called by a periodic interrupt.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Coroutine_Tick();
+
+/**
+ * @brief The Coroutine_Get_Ticks function returns the number of calls to Coroutine_Tick.
+ *
+ * @param None
+ *
+ * @return The number of ticks, which wraps around at 2^32
+ */
+uint32_t Coroutine_Get_Ticks();
+
+#endif /* COROUTINE_H_ */
@@ -0,0 +1,91 @@
+/**
+ * @file Critical_Section.h
+ * @brief Header file for the Critical_Section driver.
+ *
+ * This file contains the function definitions for the Critical_Section driver.
+ * A critical section masks the interrupts by priority with BASEPRI instead of disabling all of them with PRIMASK,
+ * so the interrupts above CRITICAL_SECTION_PRIORITY (refer to Interrupt_Priority.h) stay live:
+ *
+ *      uint32_t state = Critical_Section_Enter();
+ *      ...
+ *      Critical_Section_Exit(state);
+ *
+ * The sections can be nested: Critical_Section_Enter returns the previous mask, which Critical_Section_Exit restores,
+ * and a nested section never lowers the mask of the outer one.
+ *
+ * When CRITICAL_SECTION_AUDIT is defined, the outermost sections are timed with the DWT cycle counter, and
+ * Critical_Section_Get_Stats returns the longest time during which interrupts were masked.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef CRITICAL_SECTION_H_
+#define CRITICAL_SECTION_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Interrupt_Priority.h"
+
+// Comment out to remove the time measurement from the critical sections
+#define CRITICAL_SECTION_AUDIT 1
+
+/**
+ * @brief Measurements of the outermost critical sections
+ */
+typedef struct
+{
+    uint32_t sections;          // Number of outermost sections
+    uint32_t total_cycles;      // Cycles spent with interrupts masked (wraps after about 89 s at 48 MHz)
+    uint32_t max_cycles;        // Longest section
+    uint8_t max_priority;       // Priority masked by the longest section (0 = all interrupts)
+} Critical_Section_Stats;
+
+/**
+ * @brief The Critical_Section_Enter function masks the interrupts from CRITICAL_SECTION_PRIORITY to the lowest priority.
+ *
+ * @param None
+ *
+ * @return The previous mask, to be passed to Critical_Section_Exit
+ */
+uint32_t Critical_Section_Enter();
+
+/**
+ * @brief The Critical_Section_Enter_Priority function masks the interrupts from a priority to the lowest priority.
+ *        It is used to share data with an interrupt above CRITICAL_SECTION_PRIORITY, by masking that interrupt only.
+ *
+ * @param priority  Highest priority masked (0 to 7). 0 masks all interrupts with PRIMASK.
+ *
+ * @return The previous mask, to be passed to Critical_Section_Exit
+ */
+uint32_t Critical_Section_Enter_Priority(uint8_t priority);
+
+/**
+ * @brief The Critical_Section_Exit function restores the mask that was in effect before the matching Critical_Section_Enter.
+ *
+ * @param state The value returned by Critical_Section_Enter or Critical_Section_Enter_Priority
+ *
+ * @return None
+ */
+void Critical_Section_Exit(uint32_t state);
+
+/**
+ * @brief The Critical_Section_Get_Stats function copies the measurements of the critical sections.
+ *        All fields are 0 when CRITICAL_SECTION_AUDIT is not defined.
+ *
+ * @param stats Pointer to the structure that receives the measurements
+ *
+ * @return None
+ */
+void Critical_Section_Get_Stats(Critical_Section_Stats *stats);
+
+/**
+ * @brief The Critical_Section_Clear_Stats function clears the measurements and enables the DWT cycle counter.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Critical_Section_Clear_Stats();
+
+#endif /* CRITICAL_SECTION_H_ */
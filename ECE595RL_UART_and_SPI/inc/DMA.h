@@ -0,0 +1,300 @@
+/**
+ * @file DMA.h
+ * @brief Header file for the DMA driver.
+ *
+ * This file contains the function definitions for the DMA driver.
+ * The driver owns the channel control structure of the DMA controller, which must be unique, and lends the
+ * eight channels to the other drivers (EUSCI_B0_SPI, EUSCI_B2_SPI_Slave, AES256_Link, ...).
+ *
+ * Each channel has its own list of triggers, selected with CH_SRCCFG (refer to Table 6-37 of the MSP432P401R datasheet):
+ *
+ *  Channel     Source 1    Source 2    Source 6    Source 7
+ *  -------     --------    --------    --------    --------
+ *  0           UCA0TXIFG   UCB0TXIFG0  TA0CCR0     AESTRIGGER0
+ *  1           UCA0RXIFG   UCB0RXIFG0  TA0CCR2     AESTRIGGER1
+ *  2           UCA1TXIFG   UCB1TXIFG0  TA1CCR0     AESTRIGGER2
+ *  3           UCA1RXIFG   UCB1RXIFG0  TA1CCR2     Reserved
+ *  4           UCA2TXIFG   UCB2TXIFG0  TA2CCR0     Reserved
+ *  5           UCA2RXIFG   UCB2RXIFG0  TA2CCR2     Reserved
+ *  6           UCA3TXIFG   UCB3TXIFG0  TA3CCR0     DMAE0 (external pin)
+ *  7           UCA3RXIFG   UCB3RXIFG0  TA3CCR2     ADC14
+ *
+ * A trigger therefore names its channel: DMA_Allocate(DMA_TRIGGER_EUSCI_B0_RX) returns channel 1, or
+ * DMA_ERROR_BUSY if another driver already uses channel 1. DMA_TRIGGER_SOFTWARE takes any free channel,
+ * which is then started with DMA_Request (memory-to-memory transfers).
+ *
+ * The following cycle types are supported:
+ *
+ *  Mode                                Description
+ *  ----                                -----------
+ *  DMA_MODE_BASIC                      One transfer per trigger until the count is reached
+ *  DMA_MODE_AUTO                       The whole count after one trigger (software requests)
+ *  DMA_MODE_PING_PONG                  Primary and alternate structures alternate. The callback refills the idle one.
+ *  DMA_Set_Scatter_Gather              A list of tasks, each copied in turn into the alternate structure by the controller
+ *
+ * The completion of a channel can call a function. The first three channels given a callback have their own
+ * interrupt (DMA_INT1 to DMA_INT3), and the other ones share DMA_INT0.
+ *
+ * For more information regarding the DMA controller, refer to the DMA (11) section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef DMA_H_
+#define DMA_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Register_Fields.h"
+#include "../inc/Interrupt_Priority.h"
+
+/**
+ * @brief Number of channels of the DMA controller
+ */
+#define DMA_CHANNEL_COUNT               8
+
+/**
+ * @brief Maximum number of transfers of one cycle (n_minus_1 is a 10-bit field)
+ */
+#define DMA_MAX_TRANSFERS               1024
+
+/**
+ * @brief Priority of DMA_INT0, shared by the channels that do not have their own interrupt
+ */
+#define DMA_INT0_PRIORITY               INTERRUPT_PRIORITY_DMA
+
+/**
+ * @brief Error codes
+ */
+#define DMA_ERROR_BUSY                  -1      // The channel (or every channel, for DMA_TRIGGER_SOFTWARE) is in use
+#define DMA_ERROR_LENGTH                -2      // Too many transfers or tasks
+
+/**
+ * @brief Triggers: channel in bits 6-3, source (CH_SRCCFG) in bits 2-0
+ */
+#define DMA_TRIGGER(channel, source)    (((channel) << 3) | (source))
+#define DMA_TRIGGER_SOFTWARE            0x80
+
+#define DMA_TRIGGER_EUSCI_A0_TX         DMA_TRIGGER(0, 1)
+#define DMA_TRIGGER_EUSCI_A0_RX         DMA_TRIGGER(1, 1)
+#define DMA_TRIGGER_EUSCI_A1_TX         DMA_TRIGGER(2, 1)
+#define DMA_TRIGGER_EUSCI_A1_RX         DMA_TRIGGER(3, 1)
+#define DMA_TRIGGER_EUSCI_A2_TX         DMA_TRIGGER(4, 1)
+#define DMA_TRIGGER_EUSCI_A2_RX         DMA_TRIGGER(5, 1)
+#define DMA_TRIGGER_EUSCI_A3_TX         DMA_TRIGGER(6, 1)
+#define DMA_TRIGGER_EUSCI_A3_RX         DMA_TRIGGER(7, 1)
+#define DMA_TRIGGER_EUSCI_B0_TX         DMA_TRIGGER(0, 2)
+#define DMA_TRIGGER_EUSCI_B0_RX         DMA_TRIGGER(1, 2)
+#define DMA_TRIGGER_EUSCI_B1_TX         DMA_TRIGGER(2, 2)
+#define DMA_TRIGGER_EUSCI_B1_RX         DMA_TRIGGER(3, 2)
+#define DMA_TRIGGER_EUSCI_B2_TX         DMA_TRIGGER(4, 2)
+#define DMA_TRIGGER_EUSCI_B2_RX         DMA_TRIGGER(5, 2)
+#define DMA_TRIGGER_EUSCI_B3_TX         DMA_TRIGGER(6, 2)
+#define DMA_TRIGGER_EUSCI_B3_RX         DMA_TRIGGER(7, 2)
+#define DMA_TRIGGER_AES256_OUTPUT       DMA_TRIGGER(0, 7)   // AESTRIGGER0: an output block is ready
+#define DMA_TRIGGER_AES256_INPUT        DMA_TRIGGER(1, 7)   // AESTRIGGER1: ready for the next input block
+#define DMA_TRIGGER_ADC14               DMA_TRIGGER(7, 7)
+
+// Channel control word (refer to Table 11-9 of the MSP432Pxx Technical Reference Manual)
+//
+//  Bit(s)      Field           Description
+//  -----       -----           -----------
+//   31-30      dst_inc         Destination address increment (0x0 = byte, 0x1 = half-word, 0x2 = word, 0x3 = none)
+//   29-28      dst_size        Destination data size (0x0 = byte, 0x1 = half-word, 0x2 = word)
+//   27-26      src_inc         Source address increment
+//   25-24      src_size        Source data size
+//   17-14      R_power         Arbitrate after 2^R transfers
+//   13-4       n_minus_1       Number of transfers minus one (written by DMA_Set_Transfer)
+//   3          next_useburst   Not used
+//   2-0        cycle_ctrl      Mode
+//
+// A control word is made of one size, the fixed addresses if any, the arbitration and the mode, for example
+// DMA_SIZE_16 | DMA_DST_FIXED | DMA_ARBITRATE(3) | DMA_MODE_BASIC. The addresses increment by the size unless they are fixed.
+#define DMA_SIZE_8                      0x00000000
+#define DMA_SIZE_16                     0x55000000
+#define DMA_SIZE_32                     0xAA000000
+#define DMA_SRC_FIXED                   0x0C000000
+#define DMA_DST_FIXED                   0xC0000000
+#define DMA_ARBITRATE(r_power)          (((uint32_t)(r_power) << 14) + REGISTER_CHECK((r_power) <= 10))
+
+#define DMA_MODE_STOP                   0x0
+#define DMA_MODE_BASIC                  0x1
+#define DMA_MODE_AUTO                   0x2
+#define DMA_MODE_PING_PONG              0x3
+#define DMA_MODE_MEMORY_SCATTER_GATHER  0x4
+#define DMA_MODE_PERIPHERAL_SCATTER_GATHER  0x6
+#define DMA_MODE_ALTERNATE              0x1     // Added to a scatter-gather mode for the tasks
+#define DMA_MODE_MASK                   0x00000007
+#define DMA_COUNT_MASK                  0x00003FF0
+
+/**
+ * @brief One entry of the channel control structure, also used for the tasks of a scatter-gather list.
+ */
+typedef struct
+{
+    volatile const void *src_end;
+    volatile void *dst_end;
+    volatile uint32_t control;
+    uint32_t spare;
+} DMA_Descriptor;
+
+/**
+ * @brief Enables the DMA controller with the control structure of the driver. Can be called more than once.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void DMA_Init();
+
+/**
+ * @brief Reserves the channel of a trigger and selects the trigger. The channel is disabled, uses the primary
+ *        structure, single requests and the default priority. Calls DMA_Init.
+ *
+ * @param trigger A DMA_TRIGGER_ value, or DMA_TRIGGER_SOFTWARE for any free channel without a hardware trigger.
+ *
+ * @return The channel, or DMA_ERROR_BUSY.
+ */
+int DMA_Allocate(uint8_t trigger);
+
+/**
+ * @brief Disables a channel, removes its callback and makes it available again.
+ *
+ * @param channel The channel.
+ *
+ * @return None
+ */
+void DMA_Free(uint8_t channel);
+
+/**
+ * @brief Returns the primary structure of a channel.
+ *
+ * @param channel The channel.
+ *
+ * @return Pointer to the structure.
+ */
+DMA_Descriptor *DMA_Primary(uint8_t channel);
+
+/**
+ * @brief Returns the alternate structure of a channel (ping-pong mode).
+ *
+ * @param channel The channel.
+ *
+ * @return Pointer to the structure.
+ */
+DMA_Descriptor *DMA_Alternate(uint8_t channel);
+
+/**
+ * @brief Fills a structure or a task for count transfers. The end addresses are computed from the size and the
+ *        increments of the control word.
+ *
+ * @param descriptor Pointer to the structure.
+ * @param control Size, fixed addresses, arbitration and mode.
+ * @param source Address of the first source item.
+ * @param destination Address of the first destination item.
+ * @param count Number of transfers (1 to DMA_MAX_TRANSFERS).
+ *
+ * @return None
+ */
+void DMA_Set_Transfer(DMA_Descriptor *descriptor, uint32_t control, volatile const void *source,
+                      volatile void *destination, uint16_t count);
+
+/**
+ * @brief Sets the primary structure of a channel to run a list of tasks filled with DMA_Set_Transfer.
+ *
+ * The mode of each task is set by this function: the tasks are run one after the other without the CPU,
+ * and the channel completes after the last one. In peripheral mode, each transfer of each task waits for
+ * the trigger of the channel. In memory mode, each task runs completely after one request (DMA_Request).
+ * The list must remain valid until the channel completes.
+ *
+ * @param channel The channel.
+ * @param tasks Pointer to the first task.
+ * @param task_count Number of tasks (1 to DMA_MAX_TRANSFERS / 4).
+ * @param peripheral 1 for a peripheral trigger, 0 for software requests.
+ *
+ * @return 0 on success, or DMA_ERROR_LENGTH.
+ */
+int DMA_Set_Scatter_Gather(uint8_t channel, DMA_Descriptor *tasks, uint16_t task_count, uint8_t peripheral);
+
+/**
+ * @brief Starts a channel from its primary structure.
+ *
+ * @param channel The channel.
+ *
+ * @return None
+ */
+void DMA_Enable(uint8_t channel);
+
+/**
+ * @brief Stops a channel.
+ *
+ * @param channel The channel.
+ *
+ * @return None
+ */
+void DMA_Disable(uint8_t channel);
+
+/**
+ * @brief Indicates if a channel is enabled. The controller disables a channel when its cycle completes.
+ *
+ * @param channel The channel.
+ *
+ * @return 1 if the channel is enabled, 0 otherwise.
+ */
+uint8_t DMA_Is_Enabled(uint8_t channel);
+
+/**
+ * @brief Generates a software request on a channel.
+ *
+ * @param channel The channel.
+ *
+ * @return None
+ */
+void DMA_Request(uint8_t channel);
+
+/**
+ * @brief Returns the number of transfers left in the primary structure of a channel.
+ *
+ * @param channel The channel.
+ *
+ * @return Number of transfers left, 0 if the cycle is complete.
+ */
+uint16_t DMA_Get_Remaining(uint8_t channel);
+
+/**
+ * @brief Indicates which structure a ping-pong channel is using.
+ *
+ * @param channel The channel.
+ *
+ * @return 1 for the alternate structure, 0 for the primary structure.
+ */
+uint8_t DMA_Is_Alternate(uint8_t channel);
+
+/**
+ * @brief Sets the priority of a channel. High priority channels are served first, then the lowest channel number.
+ *
+ * @param channel The channel.
+ * @param high 1 for high priority, 0 for the default priority.
+ *
+ * @return None
+ */
+void DMA_Set_High_Priority(uint8_t channel, uint8_t high);
+
+/**
+ * @brief Sets a function to be called from the interrupt handler when a channel completes a cycle
+ *        (each half of a ping-pong cycle, or the end of a scatter-gather list).
+ *
+ * The channel gets one of DMA_INT1 to DMA_INT3 with the given priority if one is free, otherwise it
+ * shares DMA_INT0 (DMA_INT0_PRIORITY).
+ *
+ * @param channel The channel.
+ * @param callback The function, which receives the channel, or 0 to remove the callback.
+ * @param priority Priority of the interrupt (0 to 7).
+ *
+ * @return None
+ */
+void DMA_Set_Callback(uint8_t channel, void (*callback)(uint8_t channel), uint8_t priority);
+
+#endif /* DMA_H_ */
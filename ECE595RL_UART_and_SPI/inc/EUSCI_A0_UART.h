@@ -20,31 +20,7 @@
 #include <stdio.h>
 #include "msp.h"
 #include "file.h"
-
-/**
- * @brief Carriage return character
- */
-#define CR   0x0D
-/**
- * @brief Line feed character
- */
-#define LF   0x0A
-/**
- * @brief Back space character
- */
-#define BS   0x08
-/**
- * @brief escape character
- */
-#define ESC  0x1B
-/**
- * @brief space character
- */
-#define SP   0x20
-/**
- * @brief delete character
- */
-#define DEL  0x7F
+#include "../inc/EUSCI_A_UART.h"
 
 /**
  * @brief Initializes the UART module EUSCI_A0 for communication.
@@ -59,7 +35,7 @@
  * - Mode: UART
  * - LSB first
  * - UART clock source: SMCLK
- * - Interrupts disabled
+ * - Interrupt-driven transmit and receive queues (EUSCI_A_UART driver, port EUSCI_A0_UART_PORT)
  *
  * For more information regarding the registers used, refer to the eUSCI_A UART Registers section (24.4)
  * of the MSP432Pxx Microcontrollers Technical Reference Manual
@@ -73,7 +49,7 @@ void EUSCI_A0_UART_Init();
 /**
  * @brief The EUSCI_A0_UART_InChar function reads a character from the UART receive buffer.
  *
- * This function waits until a character is available in the UART receive buffer (EUSCI_A0)
+ * This function waits until a character is available in the receive queue of EUSCI_A0
  * from the serial terminal input and returns the received character as a char type.
  *
  * @param None
@@ -85,8 +61,8 @@ char EUSCI_A0_UART_InChar();
 /**
  * @brief The EUSCI_A0_UART_OutChar function transmits a character via UART to the serial terminal.
  *
- * This function waits until the UART transmit buffer (EUSCI_A0) is ready to accept
- * a new character and then writes the specified character in the transmit buffer to the serial terminal.
+ * This function waits only if the transmit queue of EUSCI_A0 is full, and then queues
+ * the specified character for transmission to the serial terminal.
  *
  * @param letter The character to be transmitted to the serial terminal.
  *
@@ -125,13 +101,13 @@ void EUSCI_A0_UART_OutString(char *pt);
  * @brief The EUSCI_A0_UART_InUDec function reads an unsigned decimal number from the UART receive buffer.
  *
  * This function reads characters from the UART receive buffer (EUSCI_A0) in the serial terminal
- * until a carriage return (CR) character is encountered.
- * It converts the received characters into an unsigned decimal number and returns the result.
- * The function supports backspace (BS) character for deleting digits from the number during input.
+ * until a carriage return (CR) character is encountered, with backspace (BS) support,
+ * and converts them with EUSCI_A0_UART_InNumber.
  *
  * @param None
  *
- * @return The received unsigned decimal number from the serial terminal as a uint32_t type.
+ * @return The received unsigned decimal number (0 to 4294967295), or 0 if the input is not a valid number
+ *         or is out of range.
  */
 uint32_t EUSCI_A0_UART_InUDec();
 
@@ -171,19 +147,34 @@ void EUSCI_A0_UART_OutSDec(int32_t n);
 void EUSCI_A0_UART_OutUFix(uint32_t n);
 
 /**
- * @brief The UART0_InUHex function reads an unsigned hexadecimal number from the UART receive buffer.
+ * @brief The EUSCI_A0_UART_InUHex function reads an unsigned hexadecimal number from the UART receive buffer.
  *
  * This function reads characters from the UART receive buffer (EUSCI_A0) in the serial terminal
- * until a carriage return (CR) character is encountered.
- * It converts the received characters into an unsigned hexadecimal number and returns the result.
- * The function supports backspace (BS) character for deleting digits from the number during input.
- * The input characters 'A' to 'F' (uppercase or lowercase) are considered valid hexadecimal digits.
+ * until a carriage return (CR) character is encountered, with backspace (BS) support,
+ * and converts them with EUSCI_A0_UART_InNumber.
+ * The digits 'A' to 'F' can be uppercase or lowercase, and the number can start with the 0x prefix.
  *
  * @param None
  *
- * @return The received unsigned hexadecimal number from teh serial terminal as a uint32_t type.
+ * @return The received unsigned hexadecimal number (0 to 0xFFFFFFFF), or 0 if the input is not a valid number
+ *         or is out of range.
+ */
+uint32_t EUSCI_A0_UART_InUHex();
+
+/**
+ * @brief The EUSCI_A0_UART_InNumber function reads a number in any of the Number_Parser formats.
+ *
+ * This function reads characters from the UART receive buffer (EUSCI_A0) in the serial terminal
+ * until a carriage return (CR) character is encountered, with backspace (BS) support.
+ * Signs, overflow and invalid characters are reported instead of being ignored.
+ *
+ * @param format One of the NUMBER_PARSER formats (for example NUMBER_PARSER_SIGNED).
+ * @param decimals Number of decimal places for NUMBER_PARSER_FIXED, otherwise ignored.
+ * @param value Pointer to where the number will be stored (as the bits of an int32_t for the signed formats).
+ *
+ * @return 0 on success, or a NUMBER_PARSER error code.
  */
-uint32_t UART0_InUHex();
+int EUSCI_A0_UART_InNumber(uint8_t format, uint8_t decimals, uint32_t *value);
 
 /**
  * @brief The EUSCI_A0_UART_OutUHex function transmits an unsigned hexadecimal number via UART to the serial terminal.
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "../inc/EUSCI_A_UART.h"
 
 /**
  * @brief Initializes the UART module EUSCI_A2 for communication.
@@ -34,7 +35,7 @@
  * - Mode: UART
  * - MSB first
  * - UART clock source: SMCLK
- * - Interrupts disabled
+ * - Interrupt-driven transmit and receive queues (EUSCI_A_UART driver, port EUSCI_A2_UART_PORT)
  *
  * For more information regarding the registers used, refer to the eUSCI_A UART Registers section (24.4)
  * of the MSP432Pxx Microcontrollers Technical Reference Manual
@@ -59,7 +60,7 @@ void EUSCI_A2_UART_Init();
  * - Mode: UART
  * - MSB first
  * - UART clock source: SMCLK
- * - Interrupts disabled
+ * - Interrupt-driven transmit and receive queues (EUSCI_A_UART driver, port EUSCI_A2_UART_PORT)
  *
  * For more information regarding the registers used, refer to the eUSCI_A UART Registers section (24.4)
  * of the MSP432Pxx Microcontroller Technical Reference Manual
@@ -75,8 +76,7 @@ void EUSCI_A2_UART_Init_V2();
  * @brief Transmits a single character over UART using the EUSCI_A2 module.
  *
  * This function transmits a single character over UART using the EUSCI_A2 module.
- * It waits until the UART transmit buffer is ready to accept new data and then writes the provided data
- * to the transmit buffer for transmission. A character consists of the following bits:
+ * It waits only if the transmit queue is full and then queues the provided data for transmission. A character consists of the following bits:
  *
  * - 1 Start Bit
  * - 8 Data Bits
@@ -92,7 +92,7 @@ void EUSCI_A2_UART_OutChar(uint8_t data);
  * @brief Receives a single character over UART using the EUSCI_A2 module.
  *
  * This function receives a single character over UART using the EUSCI_A2 module.
- * It waits until a character is available in the UART receive buffer and then reads
+ * It waits until a character is available in the receive queue and then reads
  * the received data. A character consists of the following bits:
  *
  * - 1 Start Bit
@@ -23,6 +23,36 @@
 #include <stdio.h>
 #include <stdint.h>
 #include "msp.h"
+#include "../inc/Interrupt_Priority.h"
+
+/**
+ * @brief Frequency of SMCLK in Hz, used as the SPI clock source
+ */
+#define EUSCI_A3_SPI_SMCLK_FREQUENCY    12000000
+
+/**
+ * @brief BRW value that gives the highest SPI clock frequency not above clock_frequency.
+ *        A constant when clock_frequency is a constant.
+ */
+#define EUSCI_A3_SPI_BRW(clock_frequency) \
+    ((EUSCI_A3_SPI_SMCLK_FREQUENCY + (clock_frequency) - 1) / (clock_frequency))
+
+/**
+ * @brief Maximum number of bytes in one transfer started with EUSCI_A3_SPI_Write_Start (n_minus_1 is a 10-bit field)
+ */
+#define EUSCI_A3_SPI_DMA_MAX_LENGTH     1024
+
+/**
+ * @brief Priority level of the DMA interrupt of the receive channel (0 = highest, 7 = lowest)
+ */
+#define EUSCI_A3_SPI_PRIORITY           INTERRUPT_PRIORITY_EUSCI_A3_SPI
+
+/**
+ * @brief Error codes
+ */
+#define EUSCI_A3_SPI_ERROR_BUSY         -1
+#define EUSCI_A3_SPI_ERROR_LENGTH       -2
+#define EUSCI_A3_SPI_ERROR_DMA          -3      // The DMA channels are used by another driver
 
 /**
  * @brief Initializes the SPI module EUSCI_A3 for communication.
@@ -86,4 +116,69 @@ void EUSCI_A3_SPI_Command_Write(uint8_t command);
  */
 void EUSCI_A3_SPI_Data_Write(uint8_t data);
 
+/**
+ * @brief Configures EUSCI_A3 as a 3-pin SPI master with the given clock frequency and mode.
+ *
+ * Unlike EUSCI_A3_SPI_Init, UCSTE is not used: P9.4 is left as a GPIO pin so that the chip-select
+ * of each device can be driven by software (refer to SPI_Bus). The function can be called again
+ * to change the settings, provided that no byte is being shifted.
+ *
+ * - Clock Frequency: SMCLK (12 MHz) divided by an integer, rounded down to at most clock_frequency
+ * - Mode: 0 to 3 (bit 1 = CPOL, bit 0 = CPHA)
+ * - Interrupts disabled
+ *
+ * @param clock_frequency SPI clock frequency in Hz.
+ * @param mode SPI mode.
+ *
+ * @return None
+ */
+void EUSCI_A3_SPI_Configure(uint32_t clock_frequency, uint8_t mode);
+
+/**
+ * @brief The EUSCI_A3_SPI_Write function transmits a buffer and waits until the last byte has been shifted out.
+ *
+ * The transmit buffer is written as soon as it is empty, so there is no gap between consecutive bytes.
+ *
+ * @param data Pointer to the bytes to be written.
+ * @param length Number of bytes.
+ *
+ * @return None
+ */
+void EUSCI_A3_SPI_Write(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Starts transmitting a buffer in the background with DMA channels 6 (UCA3TXIFG) and 7 (UCA3RXIFG).
+ *
+ * The transmit channel writes every byte to TXBUF. The receive channel discards every received byte, so that
+ * the transfer is complete when the last byte has been shifted out. The EUSCIA3 interrupt vector belongs to the
+ * EUSCI_A_UART driver, so the completion is reported by the DMA interrupt of the receive channel, which calls
+ * the function set with EUSCI_A3_SPI_Set_Callback. The channels are allocated by the first call.
+ * The buffer must remain valid until EUSCI_A3_SPI_Is_Busy returns 0.
+ *
+ * @param data Pointer to the bytes to be written.
+ * @param length Number of bytes (1 to EUSCI_A3_SPI_DMA_MAX_LENGTH).
+ *
+ * @return 0 on success, EUSCI_A3_SPI_ERROR_BUSY, EUSCI_A3_SPI_ERROR_LENGTH, or EUSCI_A3_SPI_ERROR_DMA
+ *         if channel 6 or 7 is used by another driver (use EUSCI_A3_SPI_Write instead).
+ */
+int EUSCI_A3_SPI_Write_Start(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Sets a function to be called when a transfer started with EUSCI_A3_SPI_Write_Start is complete.
+ *
+ * The function is called from the DMA interrupt handler of the receive channel and may start the next transfer.
+ *
+ * @param callback Pointer to the function, or 0 for none.
+ *
+ * @return None
+ */
+void EUSCI_A3_SPI_Set_Callback(void (*callback)(void));
+
+/**
+ * @brief Checks whether a transfer started with EUSCI_A3_SPI_Write_Start is in progress.
+ *
+ * @return 1 if a transfer is in progress, otherwise 0.
+ */
+uint8_t EUSCI_A3_SPI_Is_Busy();
+
 #endif /* EUSCI_A3_SPI_H_ */
@@ -0,0 +1,521 @@
+/**
+ * @file EUSCI_A_UART.h
+ * @brief Header file for the EUSCI_A_UART driver.
+ *
+ * This file contains the function definitions for the EUSCI_A_UART driver.
+ * It is an interrupt-driven UART driver shared by all four eUSCI_A modules (EUSCI_A0 to EUSCI_A3).
+ * Each port has its own transmit and receive queues, error statistics and frame format,
+ * and all ports are serviced by the same interrupt handler logic.
+ *
+ * The following pins are used by each port:
+ *
+ *  Port        RX          TX          Note
+ *  ----        --          --          ----
+ *  EUSCI_A0    P1.2        P1.3        Connected to the USB bridge (serial terminal)
+ *  EUSCI_A1    P2.2        P2.3
+ *  EUSCI_A2    P3.2        P3.3
+ *  EUSCI_A3    P9.6        P9.7        Shared with the Nokia 5110 LCD D/C and MOSI pins
+ *
+ * Hardware flow control (RTS/CTS) is available on EUSCI_A0 and EUSCI_A2 using GPIO pins.
+ * Both signals are active low, as seen from the MSP432:
+ *
+ *  Port        RTS (output)    CTS (input)     Note
+ *  ----        ------------    -----------     ----
+ *  EUSCI_A0    P3.0            P5.1            Connect RTS to the CTS input of the peer, and CTS to its RTS output
+ *  EUSCI_A2    P3.5            P5.6
+ *
+ * RTS is deasserted (high) when the receive queue reaches EUSCI_A_UART_RTS_HIGH_WATERMARK and asserted again (low)
+ * once it has been drained below EUSCI_A_UART_RTS_LOW_WATERMARK. Transmission stops while CTS is high, and
+ * the PORT5 interrupt resumes it on the falling edge of CTS.
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
+ * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @note The baud rate divider is computed assuming that SMCLK runs at EUSCI_A_UART_SMCLK_FREQUENCY,
+ *       which is the case after calling Clock_Init48MHz().
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef EUSCI_A_UART_H_
+#define EUSCI_A_UART_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Number_Parser.h"
+#include "../inc/Stream.h"
+#include "../inc/Register_Fields.h"
+#include "../inc/Interrupt_Priority.h"
+
+/**
+ * @brief Carriage return character
+ */
+#define CR   0x0D
+/**
+ * @brief Line feed character
+ */
+#define LF   0x0A
+/**
+ * @brief Back space character
+ */
+#define BS   0x08
+/**
+ * @brief escape character
+ */
+#define ESC  0x1B
+/**
+ * @brief space character
+ */
+#define SP   0x20
+/**
+ * @brief delete character
+ */
+#define DEL  0x7F
+
+/**
+ * @brief Port numbers used to select the eUSCI_A module
+ */
+#define EUSCI_A0_UART_PORT              0
+#define EUSCI_A1_UART_PORT              1
+#define EUSCI_A2_UART_PORT              2
+#define EUSCI_A3_UART_PORT              3
+#define EUSCI_A_UART_NUM_PORTS          4
+
+/**
+ * @brief Frequency of SMCLK in Hz, used as the UART clock source
+ */
+#define EUSCI_A_UART_SMCLK_FREQUENCY    12000000
+
+/**
+ * @brief Size of the transmit and receive queues of each port in bytes. Must be a power of two.
+ */
+#define EUSCI_A_UART_TX_BUFFER_SIZE     256
+#define EUSCI_A_UART_RX_BUFFER_SIZE     256
+
+/**
+ * @brief Maximum number of characters of a number entered with EUSCI_A_UART_InNumber
+ */
+#define EUSCI_A_UART_NUMBER_LENGTH      40
+
+/**
+ * @brief Priority level of the eUSCI_A interrupts (0 = highest, 7 = lowest), above CRITICAL_SECTION_PRIORITY
+ */
+#define EUSCI_A_UART_PRIORITY           INTERRUPT_PRIORITY_EUSCI_A_UART
+
+/**
+ * @brief Receive queue levels (in bytes) at which RTS is deasserted and asserted again.
+ *
+ * The space above the high watermark absorbs the bytes that the peer sends before it reacts to RTS
+ * (USB bridges commonly finish their current packet of up to 64 bytes).
+ */
+#define EUSCI_A_UART_RTS_HIGH_WATERMARK (EUSCI_A_UART_RX_BUFFER_SIZE - 80)
+#define EUSCI_A_UART_RTS_LOW_WATERMARK  (EUSCI_A_UART_RX_BUFFER_SIZE / 4)
+
+/**
+ * @brief Error code returned by EUSCI_A_UART_Enable_Flow_Control for ports without RTS/CTS pins
+ */
+#define EUSCI_A_UART_ERROR_NO_FLOW_CONTROL  -1
+
+/**
+ * @brief Parity options for EUSCI_A_UART_Config
+ */
+#define EUSCI_A_UART_PARITY_NONE        0
+#define EUSCI_A_UART_PARITY_ODD         1
+#define EUSCI_A_UART_PARITY_EVEN        2
+
+/**
+ * @brief Bit order options for EUSCI_A_UART_Config
+ */
+#define EUSCI_A_UART_LSB_FIRST          0
+#define EUSCI_A_UART_MSB_FIRST          1
+
+/**
+ * @brief Frame format and baud rate of a UART port.
+ */
+typedef struct
+{
+    uint32_t baud_rate;     // Baud rate in bits per second
+    uint8_t parity;         // EUSCI_A_UART_PARITY_NONE, EUSCI_A_UART_PARITY_ODD or EUSCI_A_UART_PARITY_EVEN
+    uint8_t data_bits;      // 7 or 8
+    uint8_t stop_bits;      // 1 or 2
+    uint8_t bit_order;      // EUSCI_A_UART_LSB_FIRST or EUSCI_A_UART_MSB_FIRST
+    uint16_t brw;           // BRW and MCTLW computed by EUSCI_A_UART_CONFIG, or 0 to compute them in EUSCI_A_UART_Init
+    uint16_t mctlw;         // (set brw to 0 when baud_rate is changed in a copy of a configuration)
+} EUSCI_A_UART_Config;
+
+/**
+ * @brief Maximum error of the average bit time allowed by EUSCI_A_UART_CONFIG, in parts per million.
+ *        1% leaves the other half of a typical 2% budget to the clock of the peer.
+ */
+#define EUSCI_A_UART_MAX_BAUD_ERROR_PPM     10000
+
+/**
+ * @brief Compile-time versions of EUSCI_A_UART_Compute_Baud_Rate. The arguments must be constants.
+ *
+ * EUSCI_A_UART_N is the division factor, EUSCI_A_UART_FRACTION its fractional part in units of 1/10000, and
+ * EUSCI_A_UART_UCBRS the matching UCBRSx value of Table 24-4 of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ */
+#define EUSCI_A_UART_N(clock_frequency, baud_rate)          ((clock_frequency) / (baud_rate))
+#define EUSCI_A_UART_FRACTION(clock_frequency, baud_rate) \
+    ((uint32_t)(((uint64_t)((clock_frequency) % (baud_rate)) * 10000) / (baud_rate)))
+
+#define EUSCI_A_UART_UCBRS(fraction) \
+    (((fraction) >= 9288) ? 0xFE : ((fraction) >= 9170) ? 0xFD : ((fraction) >= 9004) ? 0xFB : ((fraction) >= 8751) ? 0xF7 : \
+     ((fraction) >= 8572) ? 0xEF : ((fraction) >= 8464) ? 0xDF : ((fraction) >= 8333) ? 0xBF : ((fraction) >= 8004) ? 0xEE : \
+     ((fraction) >= 7861) ? 0xED : ((fraction) >= 7503) ? 0xDD : ((fraction) >= 7147) ? 0xBB : ((fraction) >= 7001) ? 0xB7 : \
+     ((fraction) >= 6667) ? 0xD6 : ((fraction) >= 6432) ? 0xB6 : ((fraction) >= 6254) ? 0xB5 : ((fraction) >= 6003) ? 0xAD : \
+     ((fraction) >= 5715) ? 0x6B : ((fraction) >= 5002) ? 0xAA : ((fraction) >= 4378) ? 0x55 : ((fraction) >= 4286) ? 0x53 : \
+     ((fraction) >= 4003) ? 0x92 : ((fraction) >= 3753) ? 0x52 : ((fraction) >= 3575) ? 0x4A : ((fraction) >= 3335) ? 0x49 : \
+     ((fraction) >= 3000) ? 0x25 : ((fraction) >= 2503) ? 0x44 : ((fraction) >= 2224) ? 0x22 : ((fraction) >= 2147) ? 0x21 : \
+     ((fraction) >= 1670) ? 0x11 : ((fraction) >= 1430) ? 0x20 : ((fraction) >= 1252) ? 0x10 : ((fraction) >= 1001) ? 0x08 : \
+     ((fraction) >= 835) ? 0x04 : ((fraction) >= 715) ? 0x02 : ((fraction) >= 529) ? 0x01 : 0x00)
+
+#define EUSCI_A_UART_BRW(clock_frequency, baud_rate) \
+    ((EUSCI_A_UART_N(clock_frequency, baud_rate) >= 16) ? (EUSCI_A_UART_N(clock_frequency, baud_rate) / 16) \
+                                                        : EUSCI_A_UART_N(clock_frequency, baud_rate))
+
+#define EUSCI_A_UART_MCTLW(clock_frequency, baud_rate) \
+    (REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRS, EUSCI_A_UART_UCBRS(EUSCI_A_UART_FRACTION(clock_frequency, baud_rate))) \
+     | ((EUSCI_A_UART_N(clock_frequency, baud_rate) >= 16) \
+        ? (REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRF, EUSCI_A_UART_N(clock_frequency, baud_rate) % 16) | EUSCI_A_MCTLW_OS16) : 0))
+
+/**
+ * @brief Error of the average bit time produced by BRW and MCTLW, in parts per million. Each bit of UCBRSx
+ *        lengthens one bit of the character by one clock cycle, so the average bit time is
+ *        N' = INT(N) + (number of ones in UCBRSx) / 8 clock cycles, and the error is |N' - N| / N.
+ */
+#define EUSCI_A_UART_BITS_SET(value) \
+    (((value) & 1) + (((value) >> 1) & 1) + (((value) >> 2) & 1) + (((value) >> 3) & 1) \
+     + (((value) >> 4) & 1) + (((value) >> 5) & 1) + (((value) >> 6) & 1) + (((value) >> 7) & 1))
+
+#define EUSCI_A_UART_EIGHTHS(clock_frequency, baud_rate) \
+    (8ULL * EUSCI_A_UART_N(clock_frequency, baud_rate) \
+     + EUSCI_A_UART_BITS_SET(EUSCI_A_UART_UCBRS(EUSCI_A_UART_FRACTION(clock_frequency, baud_rate))))
+
+#define EUSCI_A_UART_ERROR_DIFFERENCE(clock_frequency, baud_rate) \
+    ((EUSCI_A_UART_EIGHTHS(clock_frequency, baud_rate) * (uint64_t)(baud_rate) >= 8ULL * (clock_frequency)) \
+     ? (EUSCI_A_UART_EIGHTHS(clock_frequency, baud_rate) * (uint64_t)(baud_rate) - 8ULL * (clock_frequency)) \
+     : (8ULL * (clock_frequency) - EUSCI_A_UART_EIGHTHS(clock_frequency, baud_rate) * (uint64_t)(baud_rate)))
+
+#define EUSCI_A_UART_BAUD_ERROR_PPM(clock_frequency, baud_rate) \
+    ((uint32_t)(((EUSCI_A_UART_ERROR_DIFFERENCE(clock_frequency, baud_rate)) * 1000000ULL) / (8ULL * (clock_frequency))))
+
+/**
+ * @brief Initializer of an EUSCI_A_UART_Config with BRW and MCTLW computed at compile time for SMCLK.
+ *        Does not compile if the error of the baud rate is above EUSCI_A_UART_MAX_BAUD_ERROR_PPM.
+ *
+ *  static const EUSCI_A_UART_Config config = EUSCI_A_UART_CONFIG(9600, EUSCI_A_UART_PARITY_ODD, 8, 2, EUSCI_A_UART_MSB_FIRST);
+ */
+#define EUSCI_A_UART_CONFIG(baud_rate, parity, data_bits, stop_bits, bit_order) \
+    {(baud_rate), (parity), (data_bits), (stop_bits), (bit_order), \
+     EUSCI_A_UART_BRW(EUSCI_A_UART_SMCLK_FREQUENCY, baud_rate) \
+     + REGISTER_CHECK(EUSCI_A_UART_BAUD_ERROR_PPM(EUSCI_A_UART_SMCLK_FREQUENCY, baud_rate) <= EUSCI_A_UART_MAX_BAUD_ERROR_PPM), \
+     EUSCI_A_UART_MCTLW(EUSCI_A_UART_SMCLK_FREQUENCY, baud_rate)}
+
+/**
+ * @brief Statistics collected by the interrupt handler of a UART port.
+ */
+typedef struct
+{
+    uint32_t tx_bytes;              // Number of bytes written to TXBUF
+    uint32_t rx_bytes;              // Number of bytes stored in the receive queue
+    uint32_t rx_overrun_errors;     // UCOE: a byte was overwritten in RXBUF before it was read
+    uint32_t rx_framing_errors;     // UCFE: a low stop bit was detected
+    uint32_t rx_parity_errors;      // UCPE: the parity bit did not match
+    uint32_t rx_dropped;            // Bytes discarded because the receive queue was full
+    uint32_t tx_queue_full;         // Number of times a writer had to wait for space in the transmit queue
+    uint32_t rts_deasserts;         // Number of times RTS was deasserted because the receive queue reached the high watermark
+    uint32_t cts_stalls;            // Number of times transmission stopped because CTS was deasserted
+    uint32_t cts_stall_cycles;      // Total time spent waiting for CTS, in CPU clock cycles
+} EUSCI_A_UART_Stats;
+
+/**
+ * @brief The default configuration: 115200 baud, 8 data bits, no parity, 1 stop bit, LSB first
+ */
+extern const EUSCI_A_UART_Config EUSCI_A_UART_DEFAULT_CONFIG;
+
+/**
+ * @brief Initializes a eUSCI_A module as an interrupt-driven UART.
+ *
+ * This function holds the module in reset, configures the frame format, sets the BRW and MCTLW values
+ * for the requested baud rate (refer to the Baud-Rate Settings section (24.3.10) of the MSP432Pxx Microcontrollers
+ * Technical Reference Manual), selects the primary module function for the RX and TX pins, clears the queues and
+ * statistics, and enables the receive interrupt in the module and in the NVIC.
+ *
+ * BRW and MCTLW are only computed here if the configuration was not built with EUSCI_A_UART_CONFIG.
+ *
+ * Receive errors are reported to the interrupt handler (UCRXEIE = 1) so that they can be counted.
+ * The erroneous byte is discarded.
+ *
+ * @param port The port number (EUSCI_A0_UART_PORT to EUSCI_A3_UART_PORT).
+ * @param config Pointer to the frame format and baud rate.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_Init(uint8_t port, const EUSCI_A_UART_Config *config);
+
+/**
+ * @brief Enables RTS/CTS hardware flow control on a port.
+ *
+ * This function configures the RTS pin as an output (asserted low), configures the CTS pin as an input with a pull-up
+ * resistor and a falling-edge interrupt, and enables the PORT5 interrupt in the NVIC at EUSCI_A_UART_PRIORITY.
+ * The DWT cycle counter is enabled to measure the time spent waiting for CTS.
+ *
+ * @note Call after EUSCI_A_UART_Init(), which does not change the flow control setting.
+ *
+ * @param port The port number (EUSCI_A0_UART_PORT or EUSCI_A2_UART_PORT).
+ *
+ * @return 0 on success, or EUSCI_A_UART_ERROR_NO_FLOW_CONTROL if the port has no RTS/CTS pins.
+ */
+int EUSCI_A_UART_Enable_Flow_Control(uint8_t port);
+
+/**
+ * @brief Disables RTS/CTS hardware flow control on a port.
+ *
+ * RTS is left asserted so that the peer keeps transmitting, and the CTS interrupt is disabled.
+ * A transmission stalled on CTS is resumed.
+ *
+ * @param port The port number.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_Disable_Flow_Control(uint8_t port);
+
+/**
+ * @brief Computes the BRW and MCTLW register values for a baud rate.
+ *
+ * Oversampling mode (UCOS16 = 1) is used when the division factor is at least 16.
+ * EUSCI_A_UART_BRW and EUSCI_A_UART_MCTLW give the same values at compile time.
+ * The UCBRSx value is selected from Table 24-4 of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ * @param clock_frequency The frequency of the UART clock source in Hz.
+ * @param baud_rate The baud rate in bits per second.
+ * @param brw Pointer to where the BRW value will be stored.
+ * @param mctlw Pointer to where the MCTLW value will be stored.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_Compute_Baud_Rate(uint32_t clock_frequency, uint32_t baud_rate, uint16_t *brw, uint16_t *mctlw);
+
+/**
+ * @brief Queues a character for transmission.
+ *
+ * This function waits only if the transmit queue is full.
+ *
+ * @param port The port number.
+ * @param data The character to be transmitted.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_OutChar(uint8_t port, uint8_t data);
+
+/**
+ * @brief Reads a character from the receive queue.
+ *
+ * This function waits until a character is available in the receive queue.
+ *
+ * @param port The port number.
+ *
+ * @return The received character.
+ */
+uint8_t EUSCI_A_UART_InChar(uint8_t port);
+
+/**
+ * @brief Queues as many bytes as fit in the transmit queue without waiting.
+ *
+ * @param port The port number.
+ * @param buffer Pointer to the data to be transmitted.
+ * @param length Number of bytes to transmit.
+ *
+ * @return Number of bytes queued.
+ */
+uint16_t EUSCI_A_UART_Write(uint8_t port, const uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Copies the bytes currently available in the receive queue without waiting.
+ *
+ * @param port The port number.
+ * @param buffer Pointer to where the received data will be stored.
+ * @param length Maximum number of bytes to read.
+ *
+ * @return Number of bytes read.
+ */
+uint16_t EUSCI_A_UART_Read(uint8_t port, uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Returns the number of bytes waiting in the receive queue.
+ *
+ * @param port The port number.
+ *
+ * @return Number of bytes available to read.
+ */
+uint16_t EUSCI_A_UART_RX_Available(uint8_t port);
+
+/**
+ * @brief Returns the number of free bytes in the transmit queue.
+ *
+ * @param port The port number.
+ *
+ * @return Number of bytes that can be queued without waiting.
+ */
+uint16_t EUSCI_A_UART_TX_Free(uint8_t port);
+
+/**
+ * @brief Waits until the transmit queue is empty and the last character has been shifted out.
+ *
+ * @param port The port number.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_Flush(uint8_t port);
+
+/**
+ * @brief Copies the statistics of a port.
+ *
+ * @param port The port number.
+ * @param stats Pointer to where the statistics will be stored.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_Get_Stats(uint8_t port, EUSCI_A_UART_Stats *stats);
+
+/**
+ * @brief Clears the statistics of a port.
+ *
+ * @param port The port number.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_Clear_Stats(uint8_t port);
+
+/**
+ * @brief Transmits a null-terminated string.
+ *
+ * @param port The port number.
+ * @param pt Pointer to the null-terminated string to be transmitted.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_OutString(uint8_t port, const char *pt);
+
+/**
+ * @brief Reads a string until a carriage return (CR) character is received.
+ *
+ * The characters are stored in the provided buffer up to the specified maximum length and echoed.
+ * The backspace (BS) character deletes the previous character.
+ *
+ * @param port The port number.
+ * @param bufPt Pointer to the buffer where the received string will be stored.
+ * @param max Maximum length of the buffer.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_InString(uint8_t port, char *bufPt, uint16_t max);
+
+/**
+ * @brief Returns the stream of a port, to use the Stream formatting functions (Stream_Printf, ...).
+ *
+ * The numbers are converted directly into the transmit queue when it has enough contiguous free space.
+ * Like EUSCI_A_UART_OutChar, writing waits for space in the transmit queue.
+ *
+ * @param port The port number.
+ *
+ * @return Pointer to the stream of the port.
+ */
+Stream *EUSCI_A_UART_Get_Stream(uint8_t port);
+
+/**
+ * @brief Transmits an unsigned decimal number.
+ *
+ * @param port The port number.
+ * @param n The unsigned decimal number to be transmitted.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_OutUDec(uint8_t port, uint32_t n);
+
+/**
+ * @brief Transmits a signed decimal number. If the number is negative, a minus sign '-' is transmitted first.
+ *
+ * @param port The port number.
+ * @param n The signed decimal number to be transmitted.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_OutSDec(uint8_t port, int32_t n);
+
+/**
+ * @brief Transmits an unsigned fixed-point number with one decimal place.
+ *
+ * @param port The port number.
+ * @param n The unsigned fixed-point number to be transmitted (in units of 0.1).
+ *
+ * @return None
+ */
+void EUSCI_A_UART_OutUFix(uint8_t port, uint32_t n);
+
+/**
+ * @brief Transmits an unsigned hexadecimal number using uppercase digits.
+ *
+ * @param port The port number.
+ * @param number The unsigned number to be transmitted.
+ *
+ * @return None
+ */
+void EUSCI_A_UART_OutUHex(uint8_t port, uint32_t number);
+
+/**
+ * @brief Reads one number in the given format until a carriage return (CR) character is received.
+ *
+ * Up to EUSCI_A_UART_NUMBER_LENGTH characters are echoed, and the backspace (BS) character deletes the last one.
+ * The line is then converted with the Number_Parser library, so that signs, overflow and invalid characters are
+ * detected instead of being ignored. If more characters are entered, the extra ones are neither echoed nor
+ * stored, and the line is rejected with NUMBER_PARSER_ERROR_OVERFLOW instead of parsing the part that fit.
+ *
+ * @param port The port number.
+ * @param format One of the NUMBER_PARSER formats (see Number_Parser.h).
+ * @param decimals Number of decimal places for NUMBER_PARSER_FIXED, otherwise ignored.
+ * @param value Pointer to where the number will be stored (as the bits of an int32_t for the signed formats).
+ *
+ * @return 0 on success, NUMBER_PARSER_ERROR_OVERFLOW if the line was longer than EUSCI_A_UART_NUMBER_LENGTH,
+ *         or a NUMBER_PARSER error code if the line is not exactly one valid number.
+ */
+int EUSCI_A_UART_InNumber(uint8_t port, uint8_t format, uint8_t decimals, uint32_t *value);
+
+/**
+ * @brief Feeds the bytes waiting in the receive queue to a parser without waiting, and stops when a number
+ *        is complete or an error is found. The following bytes are left in the queue.
+ *
+ * Example, in the main loop:
+ *
+ *  if (EUSCI_A_UART_Poll_Number(EUSCI_A0_UART_PORT, &parser, &value) == NUMBER_PARSER_DONE) { ...use value... }
+ *
+ * @param port The port number.
+ * @param parser Pointer to a parser initialized with Number_Parser_Init. It keeps a partial number between calls.
+ * @param value Pointer to where the number will be stored when NUMBER_PARSER_DONE is returned.
+ *
+ * @return NUMBER_PARSER_MORE if the queue was emptied before the end of a number,
+ *         NUMBER_PARSER_DONE, or a NUMBER_PARSER error code.
+ */
+int EUSCI_A_UART_Poll_Number(uint8_t port, Number_Parser *parser, uint32_t *value);
+
+/**
+ * @brief Reads an unsigned decimal number (0 to 4294967295) with EUSCI_A_UART_InNumber.
+ *
+ * @param port The port number.
+ *
+ * @return The received unsigned decimal number, or 0 if the input is not a valid number or is out of range.
+ */
+uint32_t EUSCI_A_UART_InUDec(uint8_t port);
+
+/**
+ * @brief Reads an unsigned hexadecimal number (0 to 0xFFFFFFFF, with an optional 0x prefix) with EUSCI_A_UART_InNumber.
+ *
+ * @param port The port number.
+ *
+ * @return The received unsigned hexadecimal number, or 0 if the input is not a valid number or is out of range.
+ */
+uint32_t EUSCI_A_UART_InUHex(uint8_t port);
+
+#endif /* EUSCI_A_UART_H_ */
@@ -0,0 +1,182 @@
+/**
+ * @file EUSCI_B0_SPI.h
+ * @brief Header file for the EUSCI_B0_SPI driver.
+ *
+ * This file contains the function definitions for the EUSCI_B0_SPI driver.
+ * It is a full-duplex 3-pin SPI master driver: every transfer shifts out one buffer while shifting in another.
+ * Three backends are available:
+ *
+ *  Backend                     Description
+ *  -------                     -----------
+ *  EUSCI_B0_SPI_BLOCKING       The CPU keeps TXBUF full and reads RXBUF by polling the interrupt flags
+ *  EUSCI_B0_SPI_IRQ            The EUSCIB0 interrupt handler reads each received byte and writes the next one
+ *  EUSCI_B0_SPI_DMA            DMA channel 0 (UCB0TXIFG0) writes TXBUF and DMA channel 1 (UCB0RXIFG0) reads RXBUF
+ *
+ * The DMA channels are allocated from the DMA driver by EUSCI_B0_SPI_Init.
+ *
+ * EUSCI_A3 cannot be used for full-duplex transfers in this project because P9.6 (UCA3SOMI) is the
+ * Nokia 5110 LCD D/C line, so EUSCI_B0 is used instead. The following pins are used:
+ *  - P1.5 (SCLK)
+ *  - P1.6 (MOSI, Master Out Slave In)
+ *  - P1.7 (MISO, Master In Slave Out)
+ *
+ * Chip-select is not generated by this driver. Connect P1.6 to P1.7 for a loopback test.
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI) and the DMA controller,
+ * refer to the eUSCI SPI Mode (25) and DMA (11) sections of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef EUSCI_B0_SPI_H_
+#define EUSCI_B0_SPI_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Interrupt_Priority.h"
+
+/**
+ * @brief Frequency of SMCLK in Hz, used as the SPI clock source
+ */
+#define EUSCI_B0_SPI_SMCLK_FREQUENCY    12000000
+
+/**
+ * @brief BRW value that gives the highest SPI clock frequency not above clock_frequency.
+ *        A constant when clock_frequency is a constant.
+ */
+#define EUSCI_B0_SPI_BRW(clock_frequency) \
+    ((EUSCI_B0_SPI_SMCLK_FREQUENCY + (clock_frequency) - 1) / (clock_frequency))
+
+/**
+ * @brief SPI modes (clock polarity and phase)
+ */
+#define EUSCI_B0_SPI_MODE_0             0   // CPOL = 0, CPHA = 0
+#define EUSCI_B0_SPI_MODE_1             1   // CPOL = 0, CPHA = 1
+#define EUSCI_B0_SPI_MODE_2             2   // CPOL = 1, CPHA = 0
+#define EUSCI_B0_SPI_MODE_3             3   // CPOL = 1, CPHA = 1
+
+/**
+ * @brief Transfer backends
+ */
+#define EUSCI_B0_SPI_BLOCKING           0
+#define EUSCI_B0_SPI_IRQ                1
+#define EUSCI_B0_SPI_DMA                2
+
+/**
+ * @brief Maximum number of bytes in one DMA transfer (n_minus_1 is a 10-bit field).
+ *        EUSCI_B0_SPI_Transfer splits longer transfers.
+ */
+#define EUSCI_B0_SPI_DMA_MAX_LENGTH     1024
+
+/**
+ * @brief Byte transmitted when no transmit buffer is given
+ */
+#define EUSCI_B0_SPI_FILL_BYTE          0xFF
+
+/**
+ * @brief Priority level of the EUSCIB0 interrupt (0 = highest, 7 = lowest)
+ */
+#define EUSCI_B0_SPI_PRIORITY           INTERRUPT_PRIORITY_EUSCI_B0_SPI
+
+/**
+ * @brief Error codes
+ */
+#define EUSCI_B0_SPI_ERROR_BUSY         -1
+#define EUSCI_B0_SPI_ERROR_LENGTH       -2
+#define EUSCI_B0_SPI_ERROR_DMA          -3      // The DMA channels are used by another driver
+
+/**
+ * @brief Initializes EUSCI_B0 as a 3-pin SPI master, MSB first, with SMCLK as the clock source.
+ *
+ * The clock divider is SMCLK / clock_frequency (rounded up, so the SPI clock never exceeds the requested value).
+ * The backend is set to EUSCI_B0_SPI_BLOCKING.
+ *
+ * @param clock_frequency SPI clock frequency in Hz (up to EUSCI_B0_SPI_SMCLK_FREQUENCY).
+ * @param mode EUSCI_B0_SPI_MODE_0 to EUSCI_B0_SPI_MODE_3.
+ *
+ * @return None
+ */
+void EUSCI_B0_SPI_Init(uint32_t clock_frequency, uint8_t mode);
+
+/**
+ * @brief Changes the clock frequency and mode without reconfiguring the pins, the NVIC or the backend.
+ *
+ * The module is held in reset while CTLW0 and BRW are written, so no transfer may be in progress.
+ *
+ * @param clock_frequency SPI clock frequency in Hz (up to EUSCI_B0_SPI_SMCLK_FREQUENCY).
+ * @param mode EUSCI_B0_SPI_MODE_0 to EUSCI_B0_SPI_MODE_3.
+ *
+ * @return None
+ */
+void EUSCI_B0_SPI_Configure(uint32_t clock_frequency, uint8_t mode);
+
+/**
+ * @brief Returns the SPI clock frequency in Hz selected by EUSCI_B0_SPI_Init or EUSCI_B0_SPI_Configure.
+ *
+ * @return The SPI clock frequency.
+ */
+uint32_t EUSCI_B0_SPI_Get_Clock_Frequency();
+
+/**
+ * @brief Selects the backend used by EUSCI_B0_SPI_Transfer and EUSCI_B0_SPI_Transfer_Start.
+ *
+ * @param backend EUSCI_B0_SPI_BLOCKING, EUSCI_B0_SPI_IRQ or EUSCI_B0_SPI_DMA.
+ *
+ * @return None
+ */
+void EUSCI_B0_SPI_Set_Backend(uint8_t backend);
+
+/**
+ * @brief Sets a function to be called when a transfer started with the IRQ or DMA backend is complete.
+ *
+ * The function is called from the EUSCIB0 interrupt handler (IRQ backend) or from the DMA interrupt handler
+ * of the receive channel (DMA backend). The function may start the next transfer.
+ *
+ * @param callback Pointer to the function, or 0 for none.
+ *
+ * @return None
+ */
+void EUSCI_B0_SPI_Set_Callback(void (*callback)(void));
+
+/**
+ * @brief Transmits length bytes from tx while receiving length bytes into rx, and waits until done.
+ *
+ * @param tx Pointer to the bytes to transmit, or 0 to transmit EUSCI_B0_SPI_FILL_BYTE.
+ * @param rx Pointer to where the received bytes will be stored, or 0 to discard them.
+ * @param length Number of bytes.
+ *
+ * @return 0 on success, EUSCI_B0_SPI_ERROR_BUSY if a transfer is in progress, or the error of
+ *         EUSCI_B0_SPI_Transfer_Start (EUSCI_B0_SPI_ERROR_LENGTH or EUSCI_B0_SPI_ERROR_DMA).
+ */
+int EUSCI_B0_SPI_Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length);
+
+/**
+ * @brief Starts a transfer in the background using the IRQ or DMA backend.
+ *
+ * With the blocking backend, the transfer is completed before returning.
+ * The buffers must remain valid until EUSCI_B0_SPI_Is_Busy returns 0.
+ *
+ * @param tx Pointer to the bytes to transmit, or 0 to transmit EUSCI_B0_SPI_FILL_BYTE.
+ * @param rx Pointer to where the received bytes will be stored, or 0 to discard them.
+ * @param length Number of bytes (up to EUSCI_B0_SPI_DMA_MAX_LENGTH with the DMA backend).
+ *
+ * @return 0 on success, EUSCI_B0_SPI_ERROR_BUSY, EUSCI_B0_SPI_ERROR_LENGTH, or EUSCI_B0_SPI_ERROR_DMA.
+ */
+int EUSCI_B0_SPI_Transfer_Start(const uint8_t *tx, uint8_t *rx, uint16_t length);
+
+/**
+ * @brief Checks whether a transfer is in progress.
+ *
+ * @return 1 if a transfer is in progress, otherwise 0.
+ */
+uint8_t EUSCI_B0_SPI_Is_Busy();
+
+/**
+ * @brief Waits until the transfer in progress is complete.
+ *
+ * @return None
+ */
+void EUSCI_B0_SPI_Wait();
+
+#endif /* EUSCI_B0_SPI_H_ */
@@ -0,0 +1,140 @@
+/**
+ * @file EUSCI_B2_SPI_Slave.h
+ * @brief Header file for the EUSCI_B2_SPI_Slave driver.
+ *
+ * This file contains the function definitions for the EUSCI_B2_SPI_Slave driver.
+ * It receives data from an external SPI master (for example a second LaunchPad or a Linux single-board computer)
+ * at several Mbit/s. A transaction is framed by the chip-select line: it starts when CS goes low and ends when CS goes high.
+ * The received bytes are stored by DMA into one of two buffers. While the application reads one buffer, the next
+ * transaction is stored into the other one. An optional response buffer is transmitted on SOMI during the transaction.
+ *
+ * The following connections must be made:
+ *  - Master SCLK   <-->  MSP432 LaunchPad Pin P3.5 (UCB2CLK)
+ *  - Master MOSI   <-->  MSP432 LaunchPad Pin P3.6 (UCB2SIMO)
+ *  - Master MISO   <-->  MSP432 LaunchPad Pin P3.7 (UCB2SOMI)
+ *  - Master CS     <-->  MSP432 LaunchPad Pin P3.4 (GPIO with interrupt)
+ *  - Master GND    <-->  MSP432 LaunchPad GND
+ *
+ * EUSCI_B2 is used in 3-pin slave mode, and the chip-select is handled by the PORT3 interrupt:
+ *  - CS falling edge: EUSCI_B2 is released from reset, SOMI is enabled and the DMA channel loads the first response byte
+ *  - CS rising edge: EUSCI_B2 is held in reset, SOMI is released (high impedance) and the buffers are swapped
+ *
+ * EUSCI_B2 is held in reset while CS is high, so SCLK is ignored between transactions. Because the first byte is loaded
+ * after the interrupt handler has run, the master must wait at least EUSCI_B2_SPI_SLAVE_SETUP_TIME_US after CS goes low before
+ * the first SCLK edge, and at least the same time after CS goes high before the next transaction.
+ * SCLK is generated by the master. The DMA controller moves each byte within a few cycles of MCLK (48 MHz),
+ * so the limit is the eUSCI slave clock frequency given in the device datasheet.
+ *
+ * DMA channel 4 (UCB2TXIFG0) transmits the response and DMA channel 5 (UCB2RXIFG0) stores the received bytes.
+ * The channels are allocated from the DMA driver, so the EUSCI_B0_SPI DMA backend (channels 0 and 1) can be used at the same time.
+ *
+ * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI) and the DMA controller,
+ * refer to the eUSCI SPI Mode (25) and DMA (11) sections of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @note Assumes that Clock_Init48MHz() has been called.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef EUSCI_B2_SPI_SLAVE_H_
+#define EUSCI_B2_SPI_SLAVE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Interrupt_Priority.h"
+
+/**
+ * @brief Maximum number of bytes in one transaction (n_minus_1 of a DMA basic cycle is a 10-bit field).
+ *        The bytes after this limit are discarded and counted as an overrun.
+ */
+#define EUSCI_B2_SPI_SLAVE_MAX_LENGTH       1024
+
+/**
+ * @brief Minimum time in microseconds between a CS edge and the next SCLK edge or CS edge
+ */
+#define EUSCI_B2_SPI_SLAVE_SETUP_TIME_US    5
+
+/**
+ * @brief Byte transmitted when no response buffer is set
+ */
+#define EUSCI_B2_SPI_SLAVE_FILL_BYTE        0xFF
+
+/**
+ * @brief Priority level of the PORT3 interrupt (0 = highest, 7 = lowest), above CRITICAL_SECTION_PRIORITY
+ */
+#define EUSCI_B2_SPI_SLAVE_PRIORITY         INTERRUPT_PRIORITY_EUSCI_B2_SPI_SLAVE
+
+/**
+ * @brief SPI modes (clock polarity and phase), same as the EUSCI_B0_SPI driver
+ */
+#define EUSCI_B2_SPI_SLAVE_MODE_0           0   // CPOL = 0, CPHA = 0
+#define EUSCI_B2_SPI_SLAVE_MODE_1           1   // CPOL = 0, CPHA = 1
+#define EUSCI_B2_SPI_SLAVE_MODE_2           2   // CPOL = 1, CPHA = 0
+#define EUSCI_B2_SPI_SLAVE_MODE_3           3   // CPOL = 1, CPHA = 1
+
+/**
+ * @brief Error codes
+ */
+#define EUSCI_B2_SPI_SLAVE_ERROR_DMA        -1      // DMA channel 4 or 5 is used by another driver
+
+/**
+ * @brief Transaction counters.
+ */
+typedef struct
+{
+    uint32_t transactions;          // Transactions received into a buffer
+    uint32_t bytes;                 // Bytes received into a buffer
+    uint32_t dropped_transactions;  // Transactions discarded because both buffers were full
+    uint32_t overruns;              // Transactions longer than EUSCI_B2_SPI_SLAVE_MAX_LENGTH (truncated)
+    uint32_t active_cycles;         // CPU cycles (48 MHz) with CS low, to compute the throughput during transactions
+} EUSCI_B2_SPI_Slave_Stats;
+
+/**
+ * @brief Initializes EUSCI_B2 as an SPI slave, MSB first, and starts waiting for a transaction.
+ *
+ * @param mode EUSCI_B2_SPI_SLAVE_MODE_0 to EUSCI_B2_SPI_SLAVE_MODE_3 (must match the master).
+ *
+ * @return 0 on success, or EUSCI_B2_SPI_SLAVE_ERROR_DMA.
+ */
+int EUSCI_B2_SPI_Slave_Init(uint8_t mode);
+
+/**
+ * @brief Returns the oldest received transaction that has not been released.
+ *
+ * @param data Pointer to where the address of the received bytes will be stored.
+ *
+ * @return Number of bytes in the transaction (which can be 0 if CS was toggled without SCLK), or -1 if none is available.
+ */
+int EUSCI_B2_SPI_Slave_Get_Transaction(const uint8_t **data);
+
+/**
+ * @brief Releases the buffer returned by EUSCI_B2_SPI_Slave_Get_Transaction so that it can receive a new transaction.
+ *
+ * @return None
+ */
+void EUSCI_B2_SPI_Slave_Release_Transaction();
+
+/**
+ * @brief Sets the bytes to transmit on SOMI from the next transaction on, until another response is set.
+ *
+ * The buffer is not copied and must remain valid. If the transaction is longer than the response, the bytes
+ * transmitted after the response are undefined.
+ *
+ * @param response Pointer to the bytes to transmit, or 0 to transmit EUSCI_B2_SPI_SLAVE_FILL_BYTE.
+ * @param length Number of bytes (up to EUSCI_B2_SPI_SLAVE_MAX_LENGTH).
+ *
+ * @return None
+ */
+void EUSCI_B2_SPI_Slave_Set_Response(const uint8_t *response, uint16_t length);
+
+/**
+ * @brief Returns the transaction counters.
+ *
+ * @param stats Pointer to where the counters will be stored.
+ *
+ * @return None
+ */
+void EUSCI_B2_SPI_Slave_Get_Stats(EUSCI_B2_SPI_Slave_Stats *stats);
+
+#endif /* EUSCI_B2_SPI_SLAVE_H_ */
@@ -0,0 +1,61 @@
+/**
+ * @file Interrupt_Priority.h
+ * @brief Priority levels of every interrupt used by the drivers.
+ *
+ * The MSP432 has three priority bits (0 = highest, 7 = lowest). The drivers take their priority from this table,
+ * so that the whole plan can be read and changed in one place:
+ *
+ *  Priority    Interrupt                   Reason
+ *  --------    ---------                   ------
+ *  0           PORT3 (EUSCI_B2_SPI_Slave)  The DMA channels must be armed before the master sends the first clock edge
+ *  1           EUSCIA0-3, PORT5 (UART)     RXBUF holds one byte: it has to be read within one character time
+ *  1           T32_INT1 (Profiler)         Samples the code inside the critical sections too
+ *  ----------- CRITICAL_SECTION_PRIORITY -------------------------------------------------------------------------------
+ *  2           PORT4 (Bumper_Sensors)      Collisions, a few per second, but the motors must stop quickly
+ *  3           EUSCIB0, DMA_INT0-3         SPI transfers (EUSCI_B0_SPI, EUSCI_A3_SPI) and DMA completions, which already
+ *                                          buffer the data
+ *  4           SysTick                     Periodic tasks
+ *  5           PORT6 (PMOD_BTN)            Human input
+ *
+ * Critical_Section_Enter masks the interrupts from CRITICAL_SECTION_PRIORITY down to 7 with BASEPRI. The interrupts
+ * above it keep running inside the critical sections, so they must not use the functions that rely on them
+ * (DMA_Allocate, DMA_Set_Callback, SPI_Bus_Submit, Memory_Pool_Alloc, ...). They only share lock-free
+ * queues or mask their own level with Critical_Section_Enter_Priority.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef INTERRUPT_PRIORITY_H_
+#define INTERRUPT_PRIORITY_H_
+
+/**
+ * @brief Highest priority masked by Critical_Section_Enter
+ */
+#define CRITICAL_SECTION_PRIORITY               2
+
+/**
+ * @brief Interrupts that are never masked by Critical_Section_Enter
+ */
+#define INTERRUPT_PRIORITY_EUSCI_B2_SPI_SLAVE   0
+#define INTERRUPT_PRIORITY_EUSCI_A_UART         1
+#define INTERRUPT_PRIORITY_PROFILER             1
+
+/**
+ * @brief Interrupts that are masked by Critical_Section_Enter
+ */
+#define INTERRUPT_PRIORITY_BUMPER_SENSORS       2
+#define INTERRUPT_PRIORITY_EUSCI_B0_SPI         3
+#define INTERRUPT_PRIORITY_EUSCI_A3_SPI         3
+#define INTERRUPT_PRIORITY_DMA                  3
+#define INTERRUPT_PRIORITY_SYSTICK              4
+#define INTERRUPT_PRIORITY_PMOD_BTN             5
+
+// The build fails if an interrupt moves to the wrong side of CRITICAL_SECTION_PRIORITY
+typedef char Interrupt_Priority_EUSCI_B2_SPI_Slave_Is_Not_Masked[(INTERRUPT_PRIORITY_EUSCI_B2_SPI_SLAVE < CRITICAL_SECTION_PRIORITY) ? 1 : -1];
+typedef char Interrupt_Priority_EUSCI_A_UART_Is_Not_Masked[(INTERRUPT_PRIORITY_EUSCI_A_UART < CRITICAL_SECTION_PRIORITY) ? 1 : -1];
+typedef char Interrupt_Priority_Profiler_Is_Not_Masked[(INTERRUPT_PRIORITY_PROFILER < CRITICAL_SECTION_PRIORITY) ? 1 : -1];
+typedef char Interrupt_Priority_DMA_Is_Masked[(INTERRUPT_PRIORITY_DMA >= CRITICAL_SECTION_PRIORITY) ? 1 : -1];
+typedef char Interrupt_Priority_SysTick_Is_Masked[(INTERRUPT_PRIORITY_SYSTICK >= CRITICAL_SECTION_PRIORITY) ? 1 : -1];
+
+#endif /* INTERRUPT_PRIORITY_H_ */
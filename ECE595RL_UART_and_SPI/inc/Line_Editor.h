@@ -0,0 +1,131 @@
+/**
+ * @file Line_Editor.h
+ * @brief Header file for the Line_Editor library.
+ *
+ * This file contains the function definitions for the Line_Editor library.
+ * It reads command lines from a serial terminal on one of the EUSCI_A_UART ports without blocking:
+ * Line_Editor_Poll is called from the main loop, takes every byte waiting in the receive queue and returns
+ * a line once <enter> is pressed. Input is never held back by the echo. The echo is queued in a Ring_Buffer
+ * and moved to the transmit queue only as space becomes free, so a pasted command is captured at full speed
+ * even when the echo takes longer to send than the characters take to arrive.
+ *
+ * The following keys are supported (VT100/ANSI escape sequences, as sent by PuTTY, Tera Term, screen and minicom):
+ *
+ *  Key                         Action
+ *  ---                         ------
+ *  Left, Right, Ctrl+B/F       Move the cursor
+ *  Home, End, Ctrl+A/E         Move the cursor to the start or the end of the line
+ *  Backspace (BS or DEL)       Delete the character before the cursor
+ *  Delete                      Delete the character under the cursor
+ *  Ctrl+K                      Delete from the cursor to the end of the line
+ *  Ctrl+U                      Delete the whole line
+ *  Ctrl+C                      Discard the line and show a new prompt
+ *  Up, Down                    Browse the LINE_EDITOR_HISTORY_SIZE most recent lines
+ *  Enter (CR, LF or CR LF)     Return the line
+ *
+ * If the echo buffer fills up (for example when a long line is pasted while a slow terminal is connected),
+ * the rest of the echo is dropped and the whole line is drawn again once the buffer is empty,
+ * so the terminal always ends up showing the line that will be returned.
+ *
+ * @note The characters are inserted at the cursor. Characters beyond LINE_EDITOR_LENGTH are ignored.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef LINE_EDITOR_H_
+#define LINE_EDITOR_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/EUSCI_A_UART.h"
+#include "../inc/Ring_Buffer.h"
+
+/**
+ * @brief Maximum number of characters in a line (without the null terminator)
+ */
+#define LINE_EDITOR_LENGTH              80
+
+/**
+ * @brief Number of lines kept in the history
+ */
+#define LINE_EDITOR_HISTORY_SIZE        8
+
+/**
+ * @brief Size of the echo buffer in bytes. Must be a power of two, and large enough to redraw two whole lines.
+ */
+#define LINE_EDITOR_ECHO_SIZE           256
+
+/**
+ * @brief Maximum length of the prompt
+ */
+#define LINE_EDITOR_PROMPT_LENGTH       16
+
+/**
+ * @brief Returned by Line_Editor_Poll while the line is not complete
+ */
+#define LINE_EDITOR_NO_LINE             -1
+
+/**
+ * @brief State of a line editor. The fields are private to the library.
+ */
+typedef struct
+{
+    uint8_t port;
+    char prompt[LINE_EDITOR_PROMPT_LENGTH + 1];
+    char line[LINE_EDITOR_LENGTH + 1];
+    uint16_t length;
+    uint16_t cursor;
+    uint8_t escape_state;
+    uint8_t escape_parameter;
+    uint8_t last_was_cr;                // Ignores the LF of a CR LF pair
+    uint8_t redraw;                     // The echo was dropped, the line must be drawn again
+    char returned[LINE_EDITOR_LENGTH + 1];      // Last returned line, drawn again if its echo was dropped
+    uint8_t prompted;                   // The prompt of the current line has been shown
+    char history[LINE_EDITOR_HISTORY_SIZE][LINE_EDITOR_LENGTH + 1];
+    uint8_t history_count;              // Number of lines in the history
+    uint8_t history_newest;             // Index of the most recent line
+    uint8_t history_position;           // 0 while editing a new line, n while showing the nth most recent line
+    Ring_Buffer echo;
+    uint8_t echo_storage[LINE_EDITOR_ECHO_SIZE];
+    uint32_t echo_dropped;              // Number of times the echo buffer was full
+} Line_Editor;
+
+/**
+ * @brief Initializes a line editor and shows the prompt. The UART port must already be initialized.
+ *
+ * @param editor Pointer to the line editor.
+ * @param port The EUSCI_A_UART port number.
+ * @param prompt Null-terminated prompt shown before each line (up to LINE_EDITOR_PROMPT_LENGTH characters).
+ *
+ * @return None
+ */
+void Line_Editor_Init(Line_Editor *editor, uint8_t port, const char *prompt);
+
+/**
+ * @brief Processes the bytes waiting in the receive queue and sends the pending echo, without waiting.
+ *
+ * When <enter> is pressed, the line is copied to the buffer, added to the history, and the bytes received
+ * after it are left in the receive queue for the next call. The prompt for the next line is shown
+ * by Line_Editor_Prompt, so that the output of the command appears before it. Characters typed in the
+ * meantime are kept and shown after the prompt.
+ *
+ * @param editor Pointer to the line editor.
+ * @param line Pointer to where the null-terminated line will be stored.
+ * @param max Size of the buffer in bytes (the line is truncated to max - 1 characters). If max is 0, the line is
+ *            taken but nothing is written, and 0 is returned.
+ *
+ * @return Length of the line, or LINE_EDITOR_NO_LINE if <enter> has not been pressed yet.
+ */
+int Line_Editor_Poll(Line_Editor *editor, char *line, uint16_t max);
+
+/**
+ * @brief Shows the prompt for the next line (after the output of a command).
+ *
+ * @param editor Pointer to the line editor.
+ *
+ * @return None
+ */
+void Line_Editor_Prompt(Line_Editor *editor);
+
+#endif /* LINE_EDITOR_H_ */
@@ -0,0 +1,164 @@
+/**
+ * @file Logic_Analyzer.h
+ * @brief Header file for the Logic_Analyzer driver.
+ *
+ * This file contains the function definitions for the Logic_Analyzer driver.
+ * It samples up to eight GPIO pins at a fixed rate into a circular buffer in RAM, stops a configurable
+ * number of samples after a pattern or edge trigger, and streams the capture over EUSCI_A0 using
+ * run-length encoding. The host tool tools/logic_analyzer.py converts the stream into a VCD file
+ * that can be opened with PulseView or GTKWave.
+ *
+ * The sampling loop runs with interrupts disabled and is paced by the DWT cycle counter, so the signals
+ * should be generated by another board (for example a peer robot or a second LaunchPad running the UART or SPI program)
+ * or by a peripheral that does not need the CPU. The ground of both boards must be connected.
+ *
+ * Each sample is one byte where bit n holds the level of channel n. The stream has the following layout
+ * (multi-byte fields are little-endian):
+ *
+ *  Size        Field
+ *  ----        -----
+ *   2          "LA"
+ *   1          LOGIC_ANALYZER_STREAM_VERSION
+ *   1          Number of channels
+ *   4          Sample rate in Hz
+ *   4          Number of samples
+ *   4          Index of the trigger sample
+ *   1 + n      For each channel: length of the name, followed by the name
+ *   ...        Runs: sample value (1 byte) followed by the run length minus one (LEB128), until all samples are sent
+ *   2          CRC-16/CCITT (initial value 0xFFFF) of the runs
+ *
+ * For more information regarding the Data Watchpoint and Trace unit (DWT),
+ * refer to the ARM Cortex-M4 Technical Reference Manual
+ *
+ * @note Assumes that Clock_Init48MHz() has been called, and that EUSCI_A0 has been initialized (for example with EUSCI_A0_UART_Init()).
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef LOGIC_ANALYZER_H_
+#define LOGIC_ANALYZER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/EUSCI_A_UART.h"
+
+/**
+ * @brief Frequency of the CPU clock in Hz, used to compute the sample period
+ */
+#define LOGIC_ANALYZER_CPU_FREQUENCY    48000000
+
+/**
+ * @brief Maximum number of channels (one bit of a sample each)
+ */
+#define LOGIC_ANALYZER_MAX_CHANNELS     8
+
+/**
+ * @brief Size of the capture buffer in samples. Must be a power of two.
+ */
+#define LOGIC_ANALYZER_BUFFER_SIZE      16384
+
+/**
+ * @brief Highest sample rate in Hz that the sampling loop sustains with eight channels
+ */
+#define LOGIC_ANALYZER_MAX_SAMPLE_RATE  1000000
+
+/**
+ * @brief Version of the stream format
+ */
+#define LOGIC_ANALYZER_STREAM_VERSION   1
+
+/**
+ * @brief Command byte sent by the host to start a capture
+ */
+#define LOGIC_ANALYZER_CMD_CAPTURE      'C'
+
+/**
+ * @brief Error codes returned by Logic_Analyzer_Capture
+ */
+#define LOGIC_ANALYZER_ERROR_CONFIG     -1
+#define LOGIC_ANALYZER_ERROR_TIMEOUT    -2
+#define LOGIC_ANALYZER_ERROR_OVERRUN    -3
+
+/**
+ * @brief Triggers for Logic_Analyzer_Trigger
+ *
+ * A sample triggers the capture when (sample & mask) == value and, if edge_mask is not zero,
+ * when at least one of the edge_mask channels changed since the previous sample.
+ */
+#define LOGIC_ANALYZER_TRIGGER_NONE                 {0x00, 0x00, 0x00}
+#define LOGIC_ANALYZER_TRIGGER_RISING(channel)      {(1 << (channel)), (1 << (channel)), (1 << (channel))}
+#define LOGIC_ANALYZER_TRIGGER_FALLING(channel)     {(1 << (channel)), 0x00, (1 << (channel))}
+#define LOGIC_ANALYZER_TRIGGER_ANY_EDGE(channel)    {0x00, 0x00, (1 << (channel))}
+#define LOGIC_ANALYZER_TRIGGER_PATTERN(mask, value) {(mask), (value), 0x00}
+
+/**
+ * @brief A sampled pin.
+ */
+typedef struct
+{
+    const char *name;           // Name shown in the VCD file, for example "P3.3_UART_TX"
+    volatile uint8_t *input;    // Address of the PxIN register, for example &P3->IN
+    uint8_t pin;                // Pin number (0 to 7)
+} Logic_Analyzer_Channel;
+
+/**
+ * @brief Trigger condition (refer to the LOGIC_ANALYZER_TRIGGER macros).
+ */
+typedef struct
+{
+    uint8_t mask;
+    uint8_t value;
+    uint8_t edge_mask;
+} Logic_Analyzer_Trigger;
+
+/**
+ * @brief Capture settings.
+ */
+typedef struct
+{
+    const Logic_Analyzer_Channel *channels;
+    uint8_t num_channels;           // 1 to LOGIC_ANALYZER_MAX_CHANNELS
+    uint32_t sample_rate;           // Samples per second, up to LOGIC_ANALYZER_MAX_SAMPLE_RATE
+    Logic_Analyzer_Trigger trigger;
+    uint16_t pretrigger_samples;    // Samples kept before the trigger. The trigger is armed once they have been captured.
+    uint16_t total_samples;         // Samples in the capture, up to LOGIC_ANALYZER_BUFFER_SIZE
+    uint32_t timeout_samples;       // Samples to wait for the trigger after arming, or 0 to wait forever
+} Logic_Analyzer_Config;
+
+/**
+ * @brief Captures samples until the trigger fires and the post-trigger samples have been stored.
+ *
+ * The pins are not reconfigured: they are inputs after reset, and PxIN also reflects the level of pins that are
+ * used by a peripheral. Interrupts are disabled while sampling, and the DWT cycle counter is used to start each
+ * sample exactly one sample period after the previous one.
+ *
+ * @param config Pointer to the capture settings.
+ *
+ * @return The number of samples (config->total_samples) with the trigger at index config->pretrigger_samples,
+ *         or a negative LOGIC_ANALYZER_ERROR code. LOGIC_ANALYZER_ERROR_OVERRUN means that a sample was taken
+ *         late because the sample rate is too high for the number of channels.
+ */
+int Logic_Analyzer_Capture(const Logic_Analyzer_Config *config);
+
+/**
+ * @brief Transmits the last capture over EUSCI_A0 in the stream format described above.
+ *
+ * @param config Pointer to the settings used for the capture.
+ *
+ * @return Number of bytes transmitted.
+ */
+uint32_t Logic_Analyzer_Stream(const Logic_Analyzer_Config *config);
+
+/**
+ * @brief Waits for LOGIC_ANALYZER_CMD_CAPTURE from the host, then captures and streams, forever.
+ *
+ * If the capture fails, the stream header is sent with zero samples followed by the negated error code.
+ *
+ * @param config Pointer to the capture settings.
+ *
+ * @return None (does not return)
+ */
+void Logic_Analyzer_Run(const Logic_Analyzer_Config *config);
+
+#endif /* LOGIC_ANALYZER_H_ */
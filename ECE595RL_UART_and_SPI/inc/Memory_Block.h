@@ -0,0 +1,154 @@
+/**
+ * @file Memory_Block.h
+ * @brief Header file for the Memory_Block driver.
+ *
+ * This file contains the function definitions for the Memory_Block driver.
+ * It fills, copies and compares blocks of memory (frame buffers, transfer buffers) a word at a time:
+ *
+ *  Function                            Inner loop
+ *  --------                            ----------
+ *  Memory_Block_Fill                   Two STM of four registers (32 bytes) per iteration
+ *  Memory_Block_Copy                   Two LDM/STM pairs of four registers (32 bytes) per iteration
+ *  Memory_Block_Compare                LDM of two words from each block, EOR/ORRS, stops at the first difference
+ *  Memory_Block_Count_Differences      USUB8/SEL turn each differing byte lane into 1, USADA8 adds the lanes
+ *
+ * The bytes before the first aligned word and after the last block are handled one at a time. The word loops
+ * are only used when both blocks have the same alignment (the address modulo 4), otherwise the byte loop does the whole block.
+ *
+ * Memory_Block_DMA_Copy_Start and Memory_Block_DMA_Fill_Start run the same operations on a software DMA channel
+ * as one memory scatter-gather list (byte tasks for the unaligned head and tail, word tasks of 1024 words for the rest),
+ * so the CPU is free until Memory_Block_DMA_Is_Busy returns 0. The channel is allocated on the first call.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef MEMORY_BLOCK_H_
+#define MEMORY_BLOCK_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Returned by Memory_Block_Compare when the blocks are equal
+ */
+#define MEMORY_BLOCK_EQUAL              -1
+
+/**
+ * @brief Error codes
+ */
+#define MEMORY_BLOCK_ERROR_BUSY         -1      // No DMA channel is available, or the previous transfer is not done
+#define MEMORY_BLOCK_ERROR_LENGTH       -2      // The block needs more than MEMORY_BLOCK_DMA_MAX_TASKS tasks
+
+/**
+ * @brief Maximum number of tasks of a DMA transfer. With eight tasks, a block can be up to 24 KB
+ *        (6 word tasks) when both addresses have the same alignment, and up to 8 KB otherwise.
+ */
+#define MEMORY_BLOCK_DMA_MAX_TASKS      8
+
+/**
+ * @brief The DMA channel lets the other channels run after every 2^4 transfers
+ */
+#define MEMORY_BLOCK_DMA_ARBITRATION    4
+
+/**
+ * @brief The Memory_Block_Fill function sets every byte of a block to a value.
+ *
+ * @param destination   Pointer to the block
+ * @param value         Value written to each byte
+ * @param length        Number of bytes
+ *
+ * @return None
+ */
+void Memory_Block_Fill(void *destination, uint8_t value, uint32_t length);
+
+/**
+ * @brief The Memory_Block_Copy function copies a block. The blocks must not overlap.
+ *
+ * @param destination   Pointer to the destination block
+ * @param source        Pointer to the source block
+ * @param length        Number of bytes
+ *
+ * @return None
+ */
+void Memory_Block_Copy(void *destination, const void *source, uint32_t length);
+
+/**
+ * @brief The Memory_Block_Compare function finds the first byte that differs between two blocks.
+ *
+ * @param a         Pointer to the first block
+ * @param b         Pointer to the second block
+ * @param length    Number of bytes
+ *
+ * @return The index of the first byte that differs, or MEMORY_BLOCK_EQUAL
+ */
+int32_t Memory_Block_Compare(const void *a, const void *b, uint32_t length);
+
+/**
+ * @brief The Memory_Block_Count_Differences function counts the bytes that differ between two blocks.
+ *
+ * @param a         Pointer to the first block
+ * @param b         Pointer to the second block
+ * @param length    Number of bytes
+ *
+ * @return The number of bytes that differ
+ */
+uint32_t Memory_Block_Count_Differences(const void *a, const void *b, uint32_t length);
+
+/**
+ * @brief The Memory_Block_DMA_Copy_Start function starts copying a block with the DMA controller.
+ *        The blocks must not change until Memory_Block_DMA_Is_Busy returns 0.
+ *
+ * @param destination   Pointer to the destination block
+ * @param source        Pointer to the source block
+ * @param length        Number of bytes
+ *
+ * @return 0, MEMORY_BLOCK_ERROR_BUSY or MEMORY_BLOCK_ERROR_LENGTH
+ */
+int Memory_Block_DMA_Copy_Start(void *destination, const void *source, uint32_t length);
+
+/**
+ * @brief The Memory_Block_DMA_Fill_Start function starts filling a block with the DMA controller.
+ *
+ * @param destination   Pointer to the block
+ * @param value         Value written to each byte
+ * @param length        Number of bytes
+ *
+ * @return 0, MEMORY_BLOCK_ERROR_BUSY or MEMORY_BLOCK_ERROR_LENGTH
+ */
+int Memory_Block_DMA_Fill_Start(void *destination, uint8_t value, uint32_t length);
+
+/**
+ * @brief The Memory_Block_DMA_Is_Busy function indicates if a DMA copy or fill is in progress.
+ *
+ * @param None
+ *
+ * @return 1 if the DMA channel is running, 0 otherwise
+ */
+uint8_t Memory_Block_DMA_Is_Busy();
+
+/**
+ * @brief The Memory_Block_DMA_Copy function copies a block with the DMA controller and waits for the end of the copy.
+ *        It uses Memory_Block_Copy when the DMA channel cannot take the block.
+ *
+ * @param destination   Pointer to the destination block
+ * @param source        Pointer to the source block
+ * @param length        Number of bytes
+ *
+ * @return None
+ */
+void Memory_Block_DMA_Copy(void *destination, const void *source, uint32_t length);
+
+/**
+ * @brief The Memory_Block_DMA_Fill function fills a block with the DMA controller and waits for the end of the fill.
+ *        It uses Memory_Block_Fill when the DMA channel cannot take the block.
+ *
+ * @param destination   Pointer to the block
+ * @param value         Value written to each byte
+ * @param length        Number of bytes
+ *
+ * @return None
+ */
+void Memory_Block_DMA_Fill(void *destination, uint8_t value, uint32_t length);
+
+#endif /* MEMORY_BLOCK_H_ */
@@ -0,0 +1,131 @@
+/**
+ * @file Memory_Pool.h
+ * @brief Header file for the Memory_Pool library.
+ *
+ * This file contains the function definitions for the Memory_Pool library.
+ * It allocates buffers (for example UART frames, LCD images and log blocks) from pools of fixed-size blocks
+ * instead of the heap used by malloc. Allocation and release take a constant time, can be done in interrupt
+ * handlers and never fragment the memory, because each block goes back to the free list of its own size class.
+ * The interrupt handlers must be at or below CRITICAL_SECTION_PRIORITY (refer to Interrupt_Priority.h).
+ *
+ * The blocks are divided into MEMORY_POOL_NUM_CLASSES size classes. The default classes are:
+ *
+ *  Class       Block Size      Blocks      Typical Use
+ *  -----       ----------      ------      -----------
+ *  0           32 bytes        32          Commands, short UART frames, events
+ *  1           128 bytes       16          UART frames, LCD rows
+ *  2           512 bytes       8           SD card and log blocks, full LCD images (504 bytes)
+ *
+ * Memory_Pool_Alloc uses the smallest class whose blocks are large enough, or a larger class if that one is empty.
+ * The sizes and counts can be changed by defining MEMORY_POOL_CLASS_n_SIZE and MEMORY_POOL_CLASS_n_COUNT
+ * in the project settings.
+ *
+ * Each block has a reference count, so that a buffer can be handed from one subsystem to another without copying it.
+ * Memory_Pool_Alloc returns a block with one reference. Each subsystem that keeps the block calls Memory_Pool_Retain,
+ * and each one calls Memory_Pool_Release when it is done. The block is freed by the last Memory_Pool_Release.
+ *
+ * Each block starts with an 8-byte header, so the returned address is aligned to 8 bytes.
+ *
+ * When MEMORY_POOL_HOST is defined, the library can be compiled on a computer (without the critical sections).
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef MEMORY_POOL_H_
+#define MEMORY_POOL_H_
+
+#include <stdint.h>
+
+#ifndef MEMORY_POOL_HOST
+#include "msp.h"
+#endif
+
+/**
+ * @brief Size classes: size of a block in bytes (multiple of 8) and number of blocks
+ */
+#define MEMORY_POOL_NUM_CLASSES     3
+
+#ifndef MEMORY_POOL_CLASS_0_SIZE
+#define MEMORY_POOL_CLASS_0_SIZE    32
+#define MEMORY_POOL_CLASS_0_COUNT   32
+#endif
+
+#ifndef MEMORY_POOL_CLASS_1_SIZE
+#define MEMORY_POOL_CLASS_1_SIZE    128
+#define MEMORY_POOL_CLASS_1_COUNT   16
+#endif
+
+#ifndef MEMORY_POOL_CLASS_2_SIZE
+#define MEMORY_POOL_CLASS_2_SIZE    512
+#define MEMORY_POOL_CLASS_2_COUNT   8
+#endif
+
+/**
+ * @brief Statistics of one size class.
+ */
+typedef struct
+{
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t in_use;            // Blocks currently allocated
+    uint32_t high_water;        // Largest number of blocks allocated at the same time
+    uint32_t allocations;       // Blocks allocated from this class
+    uint32_t fallbacks;         // Requests for this class served by a larger class because it was empty
+    uint32_t failures;          // Requests for this class that failed because it and all larger classes were empty
+} Memory_Pool_Stats;
+
+/**
+ * @brief Builds the free lists of all size classes. Must be called before the other functions.
+ *
+ * @return None
+ */
+void Memory_Pool_Init();
+
+/**
+ * @brief Allocates a block with one reference.
+ *
+ * @param size Number of bytes needed.
+ *
+ * @return Pointer to the block, or 0 if size is larger than the largest block or no block is free.
+ */
+void *Memory_Pool_Alloc(uint32_t size);
+
+/**
+ * @brief Adds a reference to a block.
+ *
+ * @param block Pointer returned by Memory_Pool_Alloc.
+ *
+ * @return The same pointer, so that it can be passed on directly.
+ */
+void *Memory_Pool_Retain(void *block);
+
+/**
+ * @brief Removes a reference to a block and frees the block if it was the last one.
+ *
+ * @param block Pointer returned by Memory_Pool_Alloc, or 0 (ignored).
+ *
+ * @return None
+ */
+void Memory_Pool_Release(void *block);
+
+/**
+ * @brief Returns the number of bytes that can be used in a block (the block size of its class).
+ *
+ * @param block Pointer returned by Memory_Pool_Alloc.
+ *
+ * @return Size in bytes.
+ */
+uint32_t Memory_Pool_Block_Size(const void *block);
+
+/**
+ * @brief Returns the statistics of a size class.
+ *
+ * @param size_class Size class (0 to MEMORY_POOL_NUM_CLASSES - 1).
+ * @param stats Pointer to where the statistics will be stored.
+ *
+ * @return None
+ */
+void Memory_Pool_Get_Stats(uint8_t size_class, Memory_Pool_Stats *stats);
+
+#endif /* MEMORY_POOL_H_ */
@@ -38,6 +38,9 @@
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/Clock.h"
+#include "../inc/SPI_Bus.h"
+#include "../inc/Stream.h"
+#include "../inc/Coroutine.h"
 
 /**
  * @brief The SCREENW constant defines the width of the screen in pixels as 84.
@@ -89,6 +92,11 @@
  */
 #define MAX_Y       48
 
+/**
+ * @brief Number of characters per row. Each character is 7 pixels wide (5 for the glyph and 2 blank columns).
+ */
+#define NOKIA5110_CHARACTERS_PER_ROW    12
+
 /**
  * @brief The CONTRAST constant represents the contrast value for the Nokia 5110 LCD display.
  *
@@ -109,33 +117,16 @@
 /**
  * @brief Initializes the SPI module EUSCI_A3 for the Nokia 5110 LCD.
  *
- * This function configures the EUSCI_A3 module to enable SPI communication
- * for the Nokia 5110 LCD with the following configuration:
- *
- * - CTLW0 Register Configuration:
- *
- *  Bit(s)      Field       Value       Description
- *  -----       -----       -----       -----------
- *   15         UCCKPH       0x1        Data is captured on the first edge and changed on the following edge
- *   14         UCCKPL       0x0        Clock is low when inactive
- *   13         UCMSB        0x1        MSB first
- *   12         UC7BIT       0x0        8-bit data
- *   11         UCMST        0x1        Master mode is selected
- *   10-9       UCMODEx      0x2        4-pin SPI with active low UCSTE
- *   8          UCSYNC       0x1        Synchronous mode
- *   7-6        UCSSELx      0x2        eUSCI clock source is SMCLK
- *   5-2        Reserved     0x0        Reserved
- *   1          UCSTEM       0x1        UCSTE pin is used to generate signal for 4-wire slave
- *   0          UCSWRST      0x1        eUSCI logic held in reset state
+ * This function initializes the SPI_BUS_A3 bus of the SPI_Bus driver and adds the Nokia 5110 LCD to it
+ * with the following settings, so that other devices can share EUSCI_A3:
  *
- * - Clock Frequency: 4 MHz (refer to Page 20 of Nokia 5110 LCD datasheet)
- * - Interrupts disabled
+ * - Chip-select: P9.4 (SCE), driven as a GPIO pin by SPI_Bus instead of UCSTE
+ * - Clock Frequency: 1 MHz (refer to Page 20 of Nokia 5110 LCD datasheet)
+ * - Mode: 0 (data is captured on the first edge, clock is low when inactive)
  *
- * For more information regarding the registers used, refer to the eUSCI_A SPI Registers section (25.4)
- * of the MSP432Pxx Microcontrollers Technical Reference Manual
+ * P9.3 (Reset) and P9.6 (Data/Command) are configured as GPIO outputs.
  *
- * @note This function assumes that the necessary pin configurations for SPI communication have been performed
- *       on the corresponding pins. The Nokia 5110 LCD does not have a Master In Slave Out (MISO) line.
+ * @note The Nokia 5110 LCD does not have a Master In Slave Out (MISO) line.
  *
  * @return None
  */
@@ -219,8 +210,8 @@ void Nokia5110_Init();
  * @brief The Nokia5110_Command_Write function writes a command to the Nokia5110 LCD.
  *
  * This function writes a command byte to the Nokia5110 LCD by sending it via the SPI interface.
- * It waits for the SPI to become idle, sets the data/command select bit to indicate a command byte,
- * writes the command byte to the transmit buffer, and waits for the SPI to complete the transmission.
+ * It sets the data/command select bit to indicate a command byte and transfers the byte on SPI_BUS_A3,
+ * which returns after the transmission is complete.
  *
  * @param command The command byte to be written.
  *
@@ -232,8 +223,8 @@ void Nokia5110_Command_Write(uint8_t command);
  * @brief The Nokia5110_Data_Write function writes data to the Nokia5110 LCD.
  *
  * This function writes a data byte to the Nokia5110 LCD by sending it via the SPI interface.
- * It waits for the transmit buffer to become empty, sets the data/command select bit to indicate a data byte,
- * writes the data byte to the transmit buffer, and waits for the SPI to complete the transmission.
+ * It sets the data/command select bit to indicate a data byte and transfers the byte on SPI_BUS_A3,
+ * which returns after the transmission is complete.
  *
  * @param data The data byte to be written.
  *
@@ -241,6 +232,16 @@ void Nokia5110_Command_Write(uint8_t command);
  */
 void Nokia5110_Data_Write(uint8_t data);
 
+/**
+ * @brief The Nokia5110_Data_Write_Buffer function writes several data bytes to the Nokia5110 LCD in one SPI transaction.
+ *
+ * @param data Pointer to the data bytes to be written.
+ * @param length Number of bytes.
+ *
+ * @return None
+ */
+void Nokia5110_Data_Write_Buffer(const uint8_t *data, uint16_t length);
+
 /**
  * @brief The Nokia5110_OutChar function prints a character to the Nokia 5110 48x84 LCD.
  *
@@ -273,6 +274,22 @@ void Nokia5110_OutChar(char data);
  */
 void Nokia5110_OutString(char *ptr);
 
+/**
+ * @brief The Nokia5110_Get_Stream function returns the stream of the Nokia 5110 48x84 LCD.
+ *
+ * The stream can be used with the Stream formatting functions (Stream_Printf, ...). The characters are drawn
+ * as they are written, with SCE held low for each write. A new line character ('\n') blanks the rest of the row,
+ * so that the next character starts at the beginning of the following row. At the beginning of a row (a row
+ * that has just been filled, or after Nokia5110_SetCursor to column 0) it does nothing. Characters outside
+ * 0x20 to 0x7F are drawn as spaces.
+ *
+ * @return Pointer to the stream of the LCD.
+ *
+ * @note The row is tracked from the last call to Nokia5110_SetCursor or Nokia5110_Clear and the characters
+ *       written since, so a new line assumes the cursor was not moved by the pixel drawing functions.
+ */
+Stream *Nokia5110_Get_Stream();
+
 /**
  * @brief The Nokia5110_OutUDec function outputs a 16-bit number in unsigned decimal format.
  *
@@ -387,6 +404,22 @@ void Nokia5110_OutUDec2(uint32_t n);
  */
 void Nokia5110_SetCursor(uint8_t newX, uint8_t newY);
 
+/**
+ * @brief The Nokia5110_Write_Burst function moves the cursor and writes a run of data bytes in one chip-select burst.
+ *
+ * SCE is held low from the first command byte to the last data byte, and the bytes of each phase are sent
+ * back to back by keeping the transmit buffer full. The only gap is the D/C change between the cursor
+ * commands and the data bytes, which must wait until the last command bit has been shifted out.
+ *
+ * @param column X-position in pixels (0 to 83).
+ * @param bank Y-position in rows of 8 pixels (0 to 5).
+ * @param data Pointer to the data bytes, or 0 if length is 0.
+ * @param length Number of data bytes. The address wraps to the next row after column 83.
+ *
+ * @return None
+ */
+void Nokia5110_Write_Burst(uint8_t column, uint8_t bank, const uint8_t *data, uint16_t length);
+
 /**
  * @brief The Nokia5110_Clear function clears the LCD by writing zeros to the entire screen.
  *
@@ -486,4 +519,35 @@ void Nokia5110_ClrPxl(uint32_t i, uint32_t j);
  */
 void Nokia5110_SetPxl(uint32_t i, uint32_t j);
 
+/**
+ * @brief The Nokia5110_Init_Async function is the coroutine version of Nokia5110_Init.
+ *
+ * It does the same steps as Nokia5110_Init, but returns while the reset pulse and the SPI transfer of the
+ * configuration commands are in progress. It is called until it returns COROUTINE_DONE, for example with
+ * COROUTINE_AWAIT_CALL. The reset pulse lasts 1 to 2 ticks of Coroutine_Tick.
+ *
+ * @param co State of the coroutine
+ *
+ * @return COROUTINE_WAITING or COROUTINE_DONE
+ *
+ * @note The other Nokia5110 functions must not be called while a Nokia5110 coroutine is not done.
+ */
+uint8_t Nokia5110_Init_Async(Coroutine *co);
+
+/**
+ * @brief The Nokia5110_DisplayBuffer_Async function is the coroutine version of Nokia5110_DisplayBuffer.
+ *
+ * It sends the cursor commands and the whole RAM buffer in one chip-select burst, and returns while each part
+ * of the burst is in progress. The buffer must not be changed until the function returns COROUTINE_DONE.
+ * The transfers use the DMA channels 6 and 7 of SPI_BUS_A3. If another driver holds one of them, SPI_Bus runs
+ * the transfers by polling, and the function only returns once each part has been sent.
+ *
+ * @param co State of the coroutine
+ *
+ * @return COROUTINE_WAITING or COROUTINE_DONE
+ *
+ * @note The other Nokia5110 functions must not be called while a Nokia5110 coroutine is not done.
+ */
+uint8_t Nokia5110_DisplayBuffer_Async(Coroutine *co);
+
 #endif /* NOKIA5110_LCD_H_ */
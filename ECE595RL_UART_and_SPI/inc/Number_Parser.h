@@ -0,0 +1,115 @@
+/**
+ * @file Number_Parser.h
+ * @brief Header file for the Number_Parser library.
+ *
+ * This file contains the function definitions for the Number_Parser library.
+ * It converts ASCII numbers to 32-bit integers with a state machine that is fed one character at a time,
+ * so that it can consume a receive queue as the bytes arrive instead of waiting for each character.
+ * Number_Parser_Parse converts all the numbers of a received line at once.
+ *
+ * The following formats are supported:
+ *
+ *  Format                      Example         Result              Range
+ *  ------                      -------         ------              -----
+ *  NUMBER_PARSER_UNSIGNED      4294967295      uint32_t            0 to 4294967295 ('+' sign accepted)
+ *  NUMBER_PARSER_SIGNED        -2147483648     int32_t             -2147483648 to 2147483647
+ *  NUMBER_PARSER_HEX           0x1F or 1f      uint32_t            0 to 0xFFFFFFFF (optional 0x prefix)
+ *  NUMBER_PARSER_BINARY        0b101 or 101    uint32_t            0 to 0xFFFFFFFF (optional 0b prefix, up to 32 digits)
+ *  NUMBER_PARSER_FIXED         -12.5           int32_t             Number * 10^decimals, in the int32_t range
+ *
+ * Fixed-point numbers are returned in units of 10^-decimals, for example 12.5 is 125 with one decimal place,
+ * which is the format of EUSCI_A_UART_OutUFix. Fractional digits beyond the number of decimal places are truncated.
+ *
+ * Numbers are separated by delimiters: space, tab, comma, semicolon, CR, LF or NUL. A number ends at its
+ * delimiter, so a number at the end of a stream is only complete once its delimiter has been received.
+ * Any other character inside a number, or a value outside the range, is reported as an error as soon as it is
+ * received, and the rest of the number is skipped up to the next delimiter. The parser then continues with
+ * the next number, so one bad value does not desynchronize the stream.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef NUMBER_PARSER_H_
+#define NUMBER_PARSER_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Formats
+ */
+#define NUMBER_PARSER_UNSIGNED          0
+#define NUMBER_PARSER_SIGNED            1
+#define NUMBER_PARSER_HEX               2
+#define NUMBER_PARSER_BINARY            3
+#define NUMBER_PARSER_FIXED             4
+
+/**
+ * @brief Maximum number of decimal places of NUMBER_PARSER_FIXED
+ */
+#define NUMBER_PARSER_MAX_DECIMALS      9
+
+/**
+ * @brief Results of Number_Parser_Feed and error codes
+ */
+#define NUMBER_PARSER_MORE              0   // The character was consumed, no number is complete yet
+#define NUMBER_PARSER_DONE              1   // A number ended with this character and its value was stored
+#define NUMBER_PARSER_ERROR_SYNTAX      -1  // Invalid character in a number, or a sign or prefix without digits
+#define NUMBER_PARSER_ERROR_OVERFLOW    -2  // The number is outside the range of the format
+#define NUMBER_PARSER_ERROR_FORMAT      -3  // Unknown format or too many decimal places
+
+/**
+ * @brief State of a parser. The fields are private to the library.
+ */
+typedef struct
+{
+    uint8_t format;
+    uint8_t base;
+    uint8_t decimals;               // Decimal places of NUMBER_PARSER_FIXED
+    uint8_t state;
+    uint8_t negative;
+    uint8_t digits;                 // Digits received in the current number (after the prefix)
+    uint8_t fraction_digits;        // Digits received after the decimal point
+    uint8_t limit_remainder;        // limit % base
+    uint32_t limit_quotient;        // limit / base: the magnitude cannot take another digit above this value
+    uint32_t magnitude;
+} Number_Parser;
+
+/**
+ * @brief Initializes a parser and clears any partial number.
+ *
+ * @param parser Pointer to the parser.
+ * @param format One of the NUMBER_PARSER formats.
+ * @param decimals Number of decimal places for NUMBER_PARSER_FIXED (0 to NUMBER_PARSER_MAX_DECIMALS), otherwise ignored.
+ *
+ * @return 0 on success, or NUMBER_PARSER_ERROR_FORMAT.
+ */
+int Number_Parser_Init(Number_Parser *parser, uint8_t format, uint8_t decimals);
+
+/**
+ * @brief Feeds one character to a parser.
+ *
+ * @param parser Pointer to the parser.
+ * @param character The received character.
+ * @param value Pointer to where the number will be stored when NUMBER_PARSER_DONE is returned.
+ *              Signed and fixed-point numbers are stored as the bits of an int32_t.
+ *
+ * @return NUMBER_PARSER_MORE, NUMBER_PARSER_DONE, NUMBER_PARSER_ERROR_SYNTAX or NUMBER_PARSER_ERROR_OVERFLOW.
+ */
+int Number_Parser_Feed(Number_Parser *parser, char character, uint32_t *value);
+
+/**
+ * @brief Parses the numbers of a line. The end of the line ends the last number,
+ *        and the parser is left ready for the next line.
+ *
+ * @param parser Pointer to an initialized parser.
+ * @param line Pointer to the characters (they do not need to be null-terminated).
+ * @param length Number of characters.
+ * @param values Pointer to where the numbers will be stored.
+ * @param max_values Maximum number of numbers to store. Parsing stops when it is reached.
+ *
+ * @return Number of numbers stored, or the first error code (the values before the error are stored).
+ */
+int32_t Number_Parser_Parse(Number_Parser *parser, const char *line, uint32_t length, uint32_t *values, uint32_t max_values);
+
+#endif /* NUMBER_PARSER_H_ */
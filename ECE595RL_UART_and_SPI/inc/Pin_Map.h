@@ -0,0 +1,201 @@
+/**
+ * @file Pin_Map.h
+ * @brief Header file for the Pin_Map macros.
+ *
+ * This file contains the pins used by each driver (pin groups) and the macros that configure them.
+ * A pin group lists (port, pins, function) entries through a macro, so that groups can be combined into
+ * the pin map of a program:
+ *
+ *  #define NOKIA_DEMO_PINS(X, port) \
+ *      PIN_GROUP_LED1(X, port) \
+ *      PIN_GROUP_BUTTONS(X, port) \
+ *      PIN_GROUP_NOKIA5110_LCD(X, port)
+ *
+ *  PIN_MAP_INIT(NOKIA_DEMO_PINS);
+ *
+ * The register values of each port are computed at compile time from the list, and the build fails if
+ * two entries use the same pin (for example PIN_GROUP_PMOD_8LD, which uses all of P9, with PIN_GROUP_NOKIA5110_LCD).
+ * For each port used, PIN_MAP_INIT writes OUT, REN, DS, DIR, SEL0 and SEL1 once, as whole registers, so the pins
+ * that are not in the list are returned to their reset state (GPIO inputs). PIN_MAP_CONFIGURE only changes the
+ * pins in the list, with one read-modify-write per register, and is used by the drivers to configure their own group.
+ *
+ *  Function                        SEL1 SEL0   DIR     REN     OUT     DS
+ *  --------                        ---------   ---     ---     ---     --
+ *  PIN_GPIO_INPUT                      00      0       0       0       0
+ *  PIN_GPIO_INPUT_PULL_UP              00      0       1       1       0
+ *  PIN_GPIO_INPUT_PULL_DOWN            00      0       1       0       0
+ *  PIN_GPIO_OUTPUT_LOW                 00      1       0       0       0
+ *  PIN_GPIO_OUTPUT_HIGH                00      1       0       1       0
+ *  PIN_GPIO_OUTPUT_LOW_HIGH_DRIVE      00      1       0       0       1
+ *  PIN_PRIMARY                         01      0       0       0       0
+ *  PIN_SECONDARY                       10      0       0       0       0
+ *  PIN_TERTIARY                        11      0       0       0       0
+ *
+ * Pins of port J are not covered (PJ.2 and PJ.3 are configured for the crystal by Clock_Init48MHz).
+ * The SEL0 and SEL1 writes are not simultaneous, so a pin moving between two module functions briefly has a
+ * third one. Starting from the reset state (GPIO), this only happens for PIN_TERTIARY, which no group uses.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef PIN_MAP_H_
+#define PIN_MAP_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Register_Fields.h"
+
+/**
+ * @brief Bits of a pin function
+ */
+#define PIN_SEL0_FLAG                   0x01
+#define PIN_SEL1_FLAG                   0x02
+#define PIN_DIR_FLAG                    0x04
+#define PIN_REN_FLAG                    0x08
+#define PIN_OUT_FLAG                    0x10
+#define PIN_DS_FLAG                     0x20
+
+/**
+ * @brief Pin functions
+ */
+#define PIN_GPIO_INPUT                  0
+#define PIN_GPIO_INPUT_PULL_UP          (PIN_REN_FLAG | PIN_OUT_FLAG)
+#define PIN_GPIO_INPUT_PULL_DOWN        (PIN_REN_FLAG)
+#define PIN_GPIO_OUTPUT_LOW             (PIN_DIR_FLAG)
+#define PIN_GPIO_OUTPUT_HIGH            (PIN_DIR_FLAG | PIN_OUT_FLAG)
+#define PIN_GPIO_OUTPUT_LOW_HIGH_DRIVE  (PIN_DIR_FLAG | PIN_DS_FLAG)
+#define PIN_PRIMARY                     (PIN_SEL0_FLAG)
+#define PIN_SECONDARY                   (PIN_SEL1_FLAG)
+#define PIN_TERTIARY                    (PIN_SEL0_FLAG | PIN_SEL1_FLAG)
+
+/**
+ * @brief Pin groups of the drivers: X(port, number of the port, pins, function)
+ */
+#define PIN_GROUP_LED1(X, port)             X(port, 1, 0x01, PIN_GPIO_OUTPUT_LOW)
+#define PIN_GROUP_LED2(X, port)             X(port, 2, 0x07, PIN_GPIO_OUTPUT_LOW_HIGH_DRIVE)
+#define PIN_GROUP_BUTTONS(X, port)          X(port, 1, 0x12, PIN_GPIO_INPUT_PULL_UP)
+#define PIN_GROUP_PMOD_8LD(X, port)         X(port, 9, 0xFF, PIN_GPIO_OUTPUT_LOW_HIGH_DRIVE)
+#define PIN_GROUP_PMOD_SWT(X, port)         X(port, 10, 0x0F, PIN_GPIO_INPUT)
+#define PIN_GROUP_PMOD_BTN(X, port)         X(port, 6, 0x0F, PIN_GPIO_INPUT_PULL_DOWN)
+#define PIN_GROUP_BUMPER_SENSORS(X, port)   X(port, 4, 0xED, PIN_GPIO_INPUT_PULL_UP)
+#define PIN_GROUP_CHASSIS_LEDS(X, port)     X(port, 8, 0xE1, PIN_GPIO_OUTPUT_LOW)
+
+#define PIN_GROUP_EUSCI_A0_UART(X, port)    X(port, 1, 0x0C, PIN_PRIMARY)
+#define PIN_GROUP_EUSCI_A1_UART(X, port)    X(port, 2, 0x0C, PIN_PRIMARY)
+#define PIN_GROUP_EUSCI_A2_UART(X, port)    X(port, 3, 0x0C, PIN_PRIMARY)
+#define PIN_GROUP_EUSCI_A3_UART(X, port)    X(port, 9, 0xC0, PIN_PRIMARY)
+
+// RTS is an output (asserted low) and CTS an input with a pull-up (refer to EUSCI_A_UART_Enable_Flow_Control)
+#define PIN_GROUP_EUSCI_A0_FLOW_CONTROL(X, port) \
+    X(port, 3, 0x01, PIN_GPIO_OUTPUT_LOW) \
+    X(port, 5, 0x02, PIN_GPIO_INPUT_PULL_UP)
+#define PIN_GROUP_EUSCI_A2_FLOW_CONTROL(X, port) \
+    X(port, 3, 0x20, PIN_GPIO_OUTPUT_LOW) \
+    X(port, 5, 0x40, PIN_GPIO_INPUT_PULL_UP)
+
+// SCLK (P9.5) and SIMO (P9.7). P9.4 is a chip-select driven by SPI_Bus.
+#define PIN_GROUP_EUSCI_A3_SPI(X, port)     X(port, 9, 0xA0, PIN_PRIMARY)
+
+// STE (P9.4), SCLK (P9.5) and SIMO (P9.7), for EUSCI_A3_SPI_Init
+#define PIN_GROUP_EUSCI_A3_SPI_4_PIN(X, port) \
+                                            X(port, 9, 0xB0, PIN_PRIMARY)
+
+// SCLK (P1.5), SIMO (P1.6) and SOMI (P1.7)
+#define PIN_GROUP_EUSCI_B0_SPI(X, port)     X(port, 1, 0xE0, PIN_PRIMARY)
+
+// SCLK (P3.5) and SIMO (P3.6). SOMI (P3.7) is an input until a transaction starts, and CS (P3.4) has a pull-up.
+#define PIN_GROUP_EUSCI_B2_SPI_SLAVE(X, port) \
+    X(port, 3, 0x60, PIN_PRIMARY) \
+    X(port, 3, 0x80, PIN_GPIO_INPUT) \
+    X(port, 3, 0x10, PIN_GPIO_INPUT_PULL_UP)
+
+// Reset (P9.3, deasserted high) and D/C (P9.6) of the Nokia 5110 LCD
+#define PIN_GROUP_NOKIA5110_CONTROL(X, port) \
+    X(port, 9, 0x08, PIN_GPIO_OUTPUT_HIGH) \
+    X(port, 9, 0x40, PIN_GPIO_OUTPUT_LOW)
+
+// All the pins of the Nokia 5110 LCD: EUSCI_A3 SPI, SCE (P9.4, deasserted high), Reset and D/C
+#define PIN_GROUP_NOKIA5110_LCD(X, port) \
+    PIN_GROUP_EUSCI_A3_SPI(X, port) \
+    X(port, 9, 0x10, PIN_GPIO_OUTPUT_HIGH) \
+    PIN_GROUP_NOKIA5110_CONTROL(X, port)
+
+/**
+ * @brief Terms of the list for one port, combined by the macros below
+ */
+#define PIN_MAP_TERM(port, number, pins, function, flag) \
+    | ((((number) == (port)) && ((function) & (flag))) ? (uint8_t)(pins) : 0)
+
+#define PIN_MAP_SEL0_TERM(port, number, pins, function)     PIN_MAP_TERM(port, number, pins, function, PIN_SEL0_FLAG)
+#define PIN_MAP_SEL1_TERM(port, number, pins, function)     PIN_MAP_TERM(port, number, pins, function, PIN_SEL1_FLAG)
+#define PIN_MAP_DIR_TERM(port, number, pins, function)      PIN_MAP_TERM(port, number, pins, function, PIN_DIR_FLAG)
+#define PIN_MAP_REN_TERM(port, number, pins, function)      PIN_MAP_TERM(port, number, pins, function, PIN_REN_FLAG)
+#define PIN_MAP_OUT_TERM(port, number, pins, function)      PIN_MAP_TERM(port, number, pins, function, PIN_OUT_FLAG)
+#define PIN_MAP_DS_TERM(port, number, pins, function)       PIN_MAP_TERM(port, number, pins, function, PIN_DS_FLAG)
+#define PIN_MAP_PINS_TERM(port, number, pins, function)     | (((number) == (port)) ? (uint8_t)(pins) : 0)
+#define PIN_MAP_COUNT_TERM(port, number, pins, function)    + (((number) == (port)) ? PIN_MAP_BITS_SET(pins) : 0)
+#define PIN_MAP_VALID_TERM(port, number, pins, function) \
+    && ((number) >= 1) && ((number) <= 10) && (((pins) & ~0xFF) == 0) && (((function) & ~0x3F) == 0)
+
+#define PIN_MAP_BITS_SET(value) \
+    (((value) & 1) + (((value) >> 1) & 1) + (((value) >> 2) & 1) + (((value) >> 3) & 1) \
+     + (((value) >> 4) & 1) + (((value) >> 5) & 1) + (((value) >> 6) & 1) + (((value) >> 7) & 1))
+
+/**
+ * @brief Value of a register of one port, and the pins of the port used by the list
+ */
+#define PIN_MAP_VALUE(list, port, register)     ((uint8_t)(0 list(PIN_MAP_##register##_TERM, port)))
+#define PIN_MAP_PINS(list, port)                ((uint8_t)(0 list(PIN_MAP_PINS_TERM, port)))
+
+/**
+ * @brief Evaluates to 0 if no pin of the port is used twice and every entry is valid, and does not compile otherwise.
+ */
+#define PIN_MAP_CHECK(list, port) \
+    REGISTER_CHECK(((0 list(PIN_MAP_COUNT_TERM, port)) == PIN_MAP_BITS_SET(PIN_MAP_PINS(list, port))) \
+                   && (1 list(PIN_MAP_VALID_TERM, port)))
+
+/**
+ * @brief Writes the registers of one port. full is 1 to write whole registers, 0 to change only the pins of the list.
+ *        When the port is not used, the condition is 0 at compile time and no code is generated.
+ */
+#define PIN_MAP_WRITE(reg, pins, value, full)   ((reg) = (full) ? (value) : (((reg) & (uint8_t)~(pins)) | (value)))
+
+#define PIN_MAP_PORT(list, port, gpio, full) \
+    if (PIN_MAP_PINS(list, port) + PIN_MAP_CHECK(list, port)) \
+    { \
+        PIN_MAP_WRITE((gpio)->OUT, PIN_MAP_PINS(list, port), PIN_MAP_VALUE(list, port, OUT), full); \
+        PIN_MAP_WRITE((gpio)->REN, PIN_MAP_PINS(list, port), PIN_MAP_VALUE(list, port, REN), full); \
+        PIN_MAP_WRITE((gpio)->DS, PIN_MAP_PINS(list, port), PIN_MAP_VALUE(list, port, DS), full); \
+        PIN_MAP_WRITE((gpio)->DIR, PIN_MAP_PINS(list, port), PIN_MAP_VALUE(list, port, DIR), full); \
+        PIN_MAP_WRITE((gpio)->SEL0, PIN_MAP_PINS(list, port), PIN_MAP_VALUE(list, port, SEL0), full); \
+        PIN_MAP_WRITE((gpio)->SEL1, PIN_MAP_PINS(list, port), PIN_MAP_VALUE(list, port, SEL1), full); \
+    }
+
+#define PIN_MAP_PORTS(list, full) \
+    do \
+    { \
+        PIN_MAP_PORT(list, 1, P1, full) \
+        PIN_MAP_PORT(list, 2, P2, full) \
+        PIN_MAP_PORT(list, 3, P3, full) \
+        PIN_MAP_PORT(list, 4, P4, full) \
+        PIN_MAP_PORT(list, 5, P5, full) \
+        PIN_MAP_PORT(list, 6, P6, full) \
+        PIN_MAP_PORT(list, 7, P7, full) \
+        PIN_MAP_PORT(list, 8, P8, full) \
+        PIN_MAP_PORT(list, 9, P9, full) \
+        PIN_MAP_PORT(list, 10, P10, full) \
+    } while (0)
+
+/**
+ * @brief Configures every port used by a pin map with whole-register writes. The other pins of these ports
+ *        become GPIO inputs. Call once at startup, before the drivers are initialized.
+ */
+#define PIN_MAP_INIT(list)                      PIN_MAP_PORTS(list, 1)
+
+/**
+ * @brief Configures the pins of a pin map (or group) without changing the other pins of their ports.
+ */
+#define PIN_MAP_CONFIGURE(list)                 PIN_MAP_PORTS(list, 0)
+
+#endif /* PIN_MAP_H_ */
@@ -0,0 +1,157 @@
+/**
+ * @file Profiler.h
+ * @brief Header file for the Profiler driver.
+ *
+ * This file contains the function definitions for the Profiler driver.
+ * It is a statistical profiler: the Timer32 module 1 interrupt reads the program counter (PC) that the CPU pushed
+ * on the stack when it was interrupted, and counts it in a histogram in RAM where each bucket covers
+ * 2^PROFILER_BUCKET_SHIFT bytes of code. The host tool tools/profiler.py reads the histogram over EUSCI_A0 and
+ * adds up the buckets of each function of the ELF file (.out) into a flat profile.
+ *
+ * When PROFILER_SAMPLE_LR is defined, a second histogram counts the stacked link register (LR). For a function
+ * that does not call other functions, it is the address in the caller, which shows who calls a busy-wait loop.
+ *
+ * The Timer32 interrupt has the priority INTERRUPT_PRIORITY_PROFILER (refer to Interrupt_Priority.h), above
+ * CRITICAL_SECTION_PRIORITY, so the critical sections are sampled too. The interrupts of the same or a higher priority
+ * are not sampled: their time is counted in the code that they interrupted. The sample rate should not be a
+ * divisor or multiple of the rate of a periodic task (for example 997 Hz rather than 1000 Hz with a 1 ms SysTick),
+ * otherwise the samples always land at the same place in that task.
+ *
+ * Sampling stops by itself when a bucket reaches 65535, so that the histogram keeps the right proportions.
+ * The stream has the following layout (multi-byte fields are little-endian):
+ *
+ *  Size        Field
+ *  ----        -----
+ *   2          "PF"
+ *   1          PROFILER_STREAM_VERSION
+ *   1          PROFILER_BUCKET_SHIFT
+ *   1          Flags: PROFILER_FLAG_LR, PROFILER_FLAG_SATURATED
+ *   4          PROFILER_CODE_START
+ *   4          Number of buckets
+ *   4          Sample rate in Hz
+ *   4          Number of samples
+ *   4          Number of samples outside of the code range
+ *   ...        PC histogram: index (2 bytes) and count (2 bytes) of each bucket that is not zero, then index 0xFFFF
+ *   ...        LR histogram, only with PROFILER_FLAG_LR, in the same format
+ *   2          CRC-16/CCITT (initial value 0xFFFF) of the histograms
+ *
+ * @note Assumes that Clock_Init48MHz() has been called, and that EUSCI_A0 has been initialized (for example with EUSCI_A0_UART_Init()).
+ *       The driver defines T32_INT1_IRQHandler, so Timer32 module 1 cannot be used by the application.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/EUSCI_A_UART.h"
+#include "../inc/Interrupt_Priority.h"
+
+// Comment out to only sample the PC (halves the RAM used by the histograms)
+#define PROFILER_SAMPLE_LR 1
+
+/**
+ * @brief Frequency of the clock of Timer32 (MCLK) in Hz, used to compute the sample period
+ */
+#define PROFILER_CPU_FREQUENCY      48000000
+
+/**
+ * @brief Highest sample rate in Hz. Each sample takes about 40 cycles, less than 10% of the CPU at this rate.
+ */
+#define PROFILER_MAX_SAMPLE_RATE    100000
+
+/**
+ * @brief Range of code addresses covered by the histograms (the start of the flash memory)
+ */
+#define PROFILER_CODE_START         0x00000000
+#define PROFILER_CODE_SIZE          0x00010000
+
+/**
+ * @brief Each bucket of the histograms covers 2^PROFILER_BUCKET_SHIFT bytes of code
+ */
+#define PROFILER_BUCKET_SHIFT       4
+#define PROFILER_NUM_BUCKETS        (PROFILER_CODE_SIZE >> PROFILER_BUCKET_SHIFT)
+
+/**
+ * @brief Version of the stream format
+ */
+#define PROFILER_STREAM_VERSION     1
+
+/**
+ * @brief Flags of the stream
+ */
+#define PROFILER_FLAG_LR            0x01    // The LR histogram follows the PC histogram
+#define PROFILER_FLAG_SATURATED     0x02    // Sampling stopped because a bucket reached 65535
+
+/**
+ * @brief Command byte sent by the host to read the histograms
+ */
+#define PROFILER_CMD_READ           'P'
+
+/**
+ * @brief Error codes
+ */
+#define PROFILER_ERROR_RATE         -1
+
+/**
+ * @brief The Profiler_Init function configures Timer32 module 1 to interrupt at the sample rate and clears
+ *        the histograms. Sampling starts with Profiler_Start.
+ *
+ * @param sample_rate Samples per second, from 1 to PROFILER_MAX_SAMPLE_RATE
+ *
+ * @return 0 or PROFILER_ERROR_RATE
+ */
+int Profiler_Init(uint32_t sample_rate);
+
+/**
+ * @brief The Profiler_Start function starts or resumes sampling.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Start();
+
+/**
+ * @brief The Profiler_Stop function stops sampling. The histograms are kept.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Stop();
+
+/**
+ * @brief The Profiler_Clear function clears the histograms and the sample counts. Sampling must be stopped.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Clear();
+
+/**
+ * @brief The Profiler_Stream function sends the histograms over EUSCI_A0. Sampling must be stopped,
+ *        otherwise the histograms change while they are sent.
+ *
+ * @param None
+ *
+ * @return Number of bytes sent
+ */
+uint32_t Profiler_Stream();
+
+/**
+ * @brief The Profiler_Poll function checks, without waiting, whether the host sent PROFILER_CMD_READ.
+ *        If so, it stops sampling, sends the histograms, clears them and starts sampling again.
+ *        It is called from the main loop of the program that is profiled.
+ *
+ * @param None
+ *
+ * @return 1 if the histograms were sent, 0 otherwise
+ */
+uint8_t Profiler_Poll();
+
+#endif /* PROFILER_H_ */
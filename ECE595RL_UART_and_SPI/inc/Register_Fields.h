@@ -0,0 +1,60 @@
+/**
+ * @file Register_Fields.h
+ * @brief Header file for the Register_Fields macros.
+ *
+ * This file contains macros to build register values from the field definitions of msp.h instead of
+ * hexadecimal literals. msp.h describes each field of a peripheral register with three definitions:
+ *
+ *  Definition                      Example                         Description
+ *  ----------                      -------                         -----------
+ *  <REGISTER>_<FIELD>_OFS          EUSCI_A_CTLW0_MODE_OFS          Position of the lowest bit of the field
+ *  <REGISTER>_<FIELD>_MASK         EUSCI_A_CTLW0_MODE_MASK         Bits of the field (multi-bit fields only)
+ *  <REGISTER>_<FIELD>              EUSCI_A_CTLW0_SWRST             Bit of a single-bit field
+ *
+ * Single-bit fields are used as they are (EUSCI_A_CTLW0_MSB, CS_CTL2_HFXT_EN, ...), and the values of multi-bit
+ * fields go through REGISTER_FIELD, which checks at compile time that the value is a constant that fits in the field:
+ *
+ *  EUSCI_A3->CTLW0 = EUSCI_A_CTLW0_MSB | EUSCI_A_CTLW0_MST | REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 2) | ...;
+ *
+ * REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 4) does not compile, because the field is two bits wide. The result is
+ * a constant expression, so the whole value is folded by the compiler into the same single store as the
+ * hexadecimal literal it replaces.
+ *
+ * A configuration register is written as a whole (=) while the module is held in reset, so that no bits of
+ * a previous configuration are kept. REGISTER_MODIFY is for registers shared with other code, where only
+ * some fields must change.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef REGISTER_FIELDS_H_
+#define REGISTER_FIELDS_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Evaluates to 0 if condition is true, and does not compile if it is false or not a constant.
+ *        The width of a bit-field must be a positive integer constant.
+ */
+#define REGISTER_CHECK(condition)               (0 * sizeof(struct { int register_check : (condition) ? 1 : -1; }))
+
+/**
+ * @brief Value of a multi-bit field, for a constant value. Does not compile if the value does not fit in the field.
+ */
+#define REGISTER_FIELD(field, value) \
+    ((uint32_t)(((uint32_t)(value) << field##_OFS) & field##_MASK) \
+     + REGISTER_CHECK(((uint32_t)(value) & ~((uint32_t)field##_MASK >> field##_OFS)) == 0))
+
+/**
+ * @brief Value of a multi-bit field, for a value known only at run time. The bits that do not fit are dropped.
+ */
+#define REGISTER_FIELD_VALUE(field, value) \
+    ((uint32_t)(((uint32_t)(value) << field##_OFS) & field##_MASK))
+
+/**
+ * @brief Changes the bits of a register selected by mask to value, with one read and one write.
+ */
+#define REGISTER_MODIFY(reg, mask, value)       ((reg) = ((reg) & ~(mask)) | (value))
+
+#endif /* REGISTER_FIELDS_H_ */
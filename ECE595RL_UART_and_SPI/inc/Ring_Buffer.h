@@ -0,0 +1,209 @@
+/**
+ * @file Ring_Buffer.h
+ * @brief Header file for the Ring_Buffer library.
+ *
+ * This file contains the function definitions for the Ring_Buffer library.
+ * It is a lock-free queue with exactly one producer and one consumer, for example an interrupt handler that
+ * posts events and the main loop that handles them (or the reverse for a transmit queue). No critical section
+ * is needed because each index is only written by one side:
+ *
+ *  Field       Written by      Description
+ *  -----       ----------      -----------
+ *  head        Producer        Number of elements pushed since Ring_Buffer_Init (wraps around at 2^32)
+ *  tail        Consumer        Number of elements popped since Ring_Buffer_Init (wraps around at 2^32)
+ *
+ * The capacity must be a power of two, so that the position of an element in the storage is (index & mask).
+ * Because head and tail are free-running, head - tail is the number of elements and all slots can be used.
+ *
+ * Elements are copied in and out (Push, Pop, Push_Multiple, Pop_Multiple), or accessed in place through
+ * contiguous spans of the storage. The span functions let a DMA channel or a driver read or write the elements
+ * directly, for example to send the queued bytes with one DMA transfer:
+ *
+ *  count = Ring_Buffer_Read_Span(&ring, &data);    // Elements from tail up to head or to the end of the storage
+ *  ...transfer count elements from data...
+ *  Ring_Buffer_Consume(&ring, count);              // Free them for the producer
+ *
+ * Memory ordering: the producer writes the element before it publishes the new head, and the consumer reads
+ * the element before it publishes the new tail. RING_BUFFER_BARRIER is placed between the two. On the MSP432
+ * it is a Data Memory Barrier (DMB), which also orders the accesses with respect to the DMA controller.
+ * When RING_BUFFER_HOST is defined, the library can be compiled on a computer, where the barrier is a
+ * sequentially consistent fence and the producer and consumer can be two threads.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdint.h>
+
+#ifdef RING_BUFFER_HOST
+#define RING_BUFFER_BARRIER()           __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#include "msp.h"
+#define RING_BUFFER_BARRIER()           __DMB()
+#endif
+
+/**
+ * @brief Size in bytes of the block that holds head and of the block that holds tail, so that they
+ *        are in different cache lines on a computer. The MSP432 has no data cache, so 4 bytes (no padding) is used.
+ */
+#ifndef RING_BUFFER_CACHE_LINE_SIZE
+#ifdef RING_BUFFER_HOST
+#define RING_BUFFER_CACHE_LINE_SIZE     64
+#else
+#define RING_BUFFER_CACHE_LINE_SIZE     4
+#endif
+#endif
+
+/**
+ * @brief Error codes
+ */
+#define RING_BUFFER_ERROR_CAPACITY      -1  // The capacity is not a power of two
+
+/**
+ * @brief A single-producer single-consumer queue.
+ */
+typedef struct
+{
+    volatile uint32_t head;
+#if RING_BUFFER_CACHE_LINE_SIZE > 4
+    uint8_t head_padding[RING_BUFFER_CACHE_LINE_SIZE - 4];
+#endif
+    volatile uint32_t tail;
+#if RING_BUFFER_CACHE_LINE_SIZE > 4
+    uint8_t tail_padding[RING_BUFFER_CACHE_LINE_SIZE - 4];
+#endif
+    uint8_t *data;                  // Storage of capacity * element_size bytes
+    uint32_t mask;                  // capacity - 1
+    uint32_t element_size;          // Size of an element in bytes
+} Ring_Buffer;
+
+/**
+ * @brief Defines a ring buffer and its storage, checking at compile time that the capacity is a power of two.
+ *        Ring_Buffer_Init does not need to be called.
+ *
+ * Example: RING_BUFFER_DEFINE(Event_Queue, Event, 16);
+ */
+#define RING_BUFFER_DEFINE(name, type, capacity) \
+    typedef char name##_Capacity_Is_A_Power_Of_Two[(((capacity) & ((capacity) - 1)) == 0) ? 1 : -1]; \
+    static type name##_Storage[capacity]; \
+    Ring_Buffer name = {.head = 0, .tail = 0, .data = (uint8_t *)name##_Storage, .mask = (capacity) - 1, .element_size = sizeof(type)}
+
+/**
+ * @brief Initializes an empty ring buffer.
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param storage Pointer to capacity * element_size bytes.
+ * @param element_size Size of an element in bytes.
+ * @param capacity Number of elements (a power of two).
+ *
+ * @return 0 on success, or RING_BUFFER_ERROR_CAPACITY.
+ */
+int Ring_Buffer_Init(Ring_Buffer *ring, void *storage, uint32_t element_size, uint32_t capacity);
+
+/**
+ * @brief Copies one element into the ring buffer (producer).
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param element Pointer to the element.
+ *
+ * @return 1 if the element was pushed, or 0 if the ring buffer is full.
+ */
+uint8_t Ring_Buffer_Push(Ring_Buffer *ring, const void *element);
+
+/**
+ * @brief Copies the oldest element out of the ring buffer (consumer).
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param element Pointer to where the element will be stored.
+ *
+ * @return 1 if an element was popped, or 0 if the ring buffer is empty.
+ */
+uint8_t Ring_Buffer_Pop(Ring_Buffer *ring, void *element);
+
+/**
+ * @brief Copies as many elements as fit into the ring buffer, with one update of head (producer).
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param elements Pointer to the elements.
+ * @param count Number of elements.
+ *
+ * @return Number of elements pushed.
+ */
+uint32_t Ring_Buffer_Push_Multiple(Ring_Buffer *ring, const void *elements, uint32_t count);
+
+/**
+ * @brief Copies up to count of the oldest elements out of the ring buffer, with one update of tail (consumer).
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param elements Pointer to where the elements will be stored.
+ * @param count Maximum number of elements.
+ *
+ * @return Number of elements popped.
+ */
+uint32_t Ring_Buffer_Pop_Multiple(Ring_Buffer *ring, void *elements, uint32_t count);
+
+/**
+ * @brief Returns the free slots that follow head without wrapping around (producer).
+ *        The elements written there are pushed by Ring_Buffer_Commit.
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param span Pointer to where the address of the first free slot will be stored.
+ *
+ * @return Number of contiguous free slots.
+ */
+uint32_t Ring_Buffer_Write_Span(Ring_Buffer *ring, void **span);
+
+/**
+ * @brief Pushes count elements written into the span returned by Ring_Buffer_Write_Span (producer).
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param count Number of elements (up to the size of the span).
+ *
+ * @return None
+ */
+void Ring_Buffer_Commit(Ring_Buffer *ring, uint32_t count);
+
+/**
+ * @brief Returns the oldest elements without wrapping around, without removing them (consumer).
+ *        The elements are removed by Ring_Buffer_Consume.
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param span Pointer to where the address of the oldest element will be stored.
+ *
+ * @return Number of contiguous elements.
+ */
+uint32_t Ring_Buffer_Read_Span(Ring_Buffer *ring, const void **span);
+
+/**
+ * @brief Removes count elements read through the span returned by Ring_Buffer_Read_Span (consumer).
+ *
+ * @param ring Pointer to the ring buffer.
+ * @param count Number of elements (up to the size of the span).
+ *
+ * @return None
+ */
+void Ring_Buffer_Consume(Ring_Buffer *ring, uint32_t count);
+
+/**
+ * @brief Returns the number of elements in the ring buffer. The other side can change it at any time, so the value
+ *        is a lower bound for the consumer (more elements can be pushed) and an upper bound for the producer.
+ *
+ * @param ring Pointer to the ring buffer.
+ *
+ * @return Number of elements.
+ */
+uint32_t Ring_Buffer_Count(const Ring_Buffer *ring);
+
+/**
+ * @brief Returns the number of free slots in the ring buffer (a lower bound for the producer).
+ *
+ * @param ring Pointer to the ring buffer.
+ *
+ * @return Number of free slots.
+ */
+uint32_t Ring_Buffer_Free(const Ring_Buffer *ring);
+
+#endif /* RING_BUFFER_H_ */
@@ -0,0 +1,104 @@
+/**
+ * @file SD_Card.h
+ * @brief Header file for the SD_Card driver.
+ *
+ * This file contains the function definitions for the SD_Card driver.
+ * It reads and writes 512-byte blocks of an SD, SDHC or SDXC card (or microSD card) in SPI mode.
+ * The card is a device on SPI_BUS_B0, so it can share EUSCI_B0 with other SPI_Bus devices.
+ *
+ * The following connections must be made:
+ *  - SD Card VCC           <-->  MSP432 LaunchPad VCC (3.3V)
+ *  - SD Card GND           <-->  MSP432 LaunchPad GND
+ *  - SD Card CS            <-->  Chip-select pin given to SD_Card_Init (for example P2.6)
+ *  - SD Card SCLK          <-->  MSP432 LaunchPad Pin P1.5 (SCLK)
+ *  - SD Card DI (MOSI)     <-->  MSP432 LaunchPad Pin P1.6 (MOSI)
+ *  - SD Card DO (MISO)     <-->  MSP432 LaunchPad Pin P1.7 (MISO), with a pull-up resistor (10k to 3.3V)
+ *
+ * The card is initialized at 400 kHz and then used at SD_CARD_CLOCK_FREQUENCY. Data blocks are transferred
+ * with the EUSCI_B0_SPI DMA backend (refer to SPI_Bus.h). SD_Card_Write_Blocks uses a multiple block write
+ * (CMD25) when more than one block is written, which is much faster than writing the blocks one at a time
+ * because the card can program them together.
+ *
+ * Block numbers are always in units of 512 bytes, also on standard capacity cards which use byte addresses.
+ *
+ * For more information regarding the SPI mode of SD cards, refer to the SD Specifications
+ * Part 1 Physical Layer Simplified Specification, Section 7 (SPI Mode)
+ *
+ * @note Assumes that Clock_Init48MHz() and SPI_Bus_Init(SPI_BUS_B0) have been called.
+ *       The functions must not be called from an interrupt handler.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef SD_CARD_H_
+#define SD_CARD_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/SPI_Bus.h"
+
+/**
+ * @brief Size of a block in bytes
+ */
+#define SD_CARD_BLOCK_SIZE              512
+
+/**
+ * @brief SPI clock frequency in Hz during initialization and after initialization
+ */
+#define SD_CARD_INIT_CLOCK_FREQUENCY    400000
+#define SD_CARD_CLOCK_FREQUENCY         12000000
+
+/**
+ * @brief Error codes
+ */
+#define SD_CARD_ERROR_NO_CARD           -1  // No response to CMD0 (GO_IDLE_STATE)
+#define SD_CARD_ERROR_VOLTAGE           -2  // The card does not accept 2.7 to 3.6 V
+#define SD_CARD_ERROR_TIMEOUT           -3  // The card stayed busy or did not send a data token
+#define SD_CARD_ERROR_COMMAND           -4  // The card returned an error in the R1 response
+#define SD_CARD_ERROR_READ              -5  // The card sent a data error token instead of a block
+#define SD_CARD_ERROR_WRITE             -6  // The card rejected a data block (CRC or write error)
+#define SD_CARD_ERROR_RANGE             -7  // The block number is beyond the end of the card
+#define SD_CARD_ERROR_NOT_READY         -8  // SD_Card_Init has not succeeded
+
+/**
+ * @brief Initializes the chip-select pin and the card, reads the card capacity and raises the clock frequency.
+ *
+ * @param cs_port Port of the active low chip-select pin (1 to 10).
+ * @param cs_bit Bit of the chip-select pin, for example 0x40 for P2.6.
+ *
+ * @return 0 on success, or a negative SD_CARD_ERROR code.
+ */
+int SD_Card_Init(uint8_t cs_port, uint8_t cs_bit);
+
+/**
+ * @brief Returns the number of 512-byte blocks of the card.
+ *
+ * @return Number of blocks, or 0 if SD_Card_Init has not succeeded.
+ */
+uint32_t SD_Card_Get_Block_Count();
+
+/**
+ * @brief Reads one block (CMD17, READ_SINGLE_BLOCK).
+ *
+ * @param block Block number.
+ * @param data Pointer to where the SD_CARD_BLOCK_SIZE bytes will be stored.
+ *
+ * @return 0 on success, or a negative SD_CARD_ERROR code.
+ */
+int SD_Card_Read_Block(uint32_t block, uint8_t *data);
+
+/**
+ * @brief Writes consecutive blocks (CMD24, WRITE_BLOCK, for one block or CMD25, WRITE_MULTIPLE_BLOCK, for more)
+ *        and waits until the card has programmed them.
+ *
+ * @param block Number of the first block.
+ * @param data Pointer to count * SD_CARD_BLOCK_SIZE bytes.
+ * @param count Number of blocks.
+ *
+ * @return 0 on success, or a negative SD_CARD_ERROR code.
+ */
+int SD_Card_Write_Blocks(uint32_t block, const uint8_t *data, uint16_t count);
+
+#endif /* SD_CARD_H_ */
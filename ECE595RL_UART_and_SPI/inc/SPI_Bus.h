@@ -0,0 +1,224 @@
+/**
+ * @file SPI_Bus.h
+ * @brief Header file for the SPI_Bus driver.
+ *
+ * This file contains the function definitions for the SPI_Bus driver.
+ * It lets several SPI devices (for example the Nokia 5110 LCD, an SD card and an external flash)
+ * share the same eUSCI module. Each device has its own GPIO chip-select pin, clock frequency and mode.
+ * Transactions are queued per bus and run in order. The eUSCI module is only reconfigured when
+ * the next transaction is for a different device than the previous one.
+ *
+ *  Bus             Module      Pins                                        Transfers
+ *  ---             ------      ----                                        ---------
+ *  SPI_BUS_A3      EUSCI_A3    P9.5 (SCLK), P9.7 (MOSI)                    Transmit only, run by the DMA interrupt of channel 7
+ *  SPI_BUS_B0      EUSCI_B0    P1.5 (SCLK), P1.6 (MOSI), P1.7 (MISO)       Full-duplex, run by the EUSCIB0 or DMA_INT1 interrupt
+ *
+ * EUSCI_A3 is transmit-only because P9.6 (UCA3SOMI) is the Nokia 5110 LCD D/C line. The EUSCIA3 interrupt vector
+ * belongs to the EUSCI_A_UART driver, so its transactions use DMA (EUSCI_A3_SPI_Write_Start). They are run by
+ * polling only if they are longer than EUSCI_A3_SPI_DMA_MAX_LENGTH or if DMA channel 6 or 7 is used by another
+ * driver. On both buses, the next transaction is started from the interrupt handler as soon as the previous one is
+ * complete. On SPI_BUS_B0, transactions of at least SPI_BUS_DMA_THRESHOLD bytes (and at most
+ * EUSCI_B0_SPI_DMA_MAX_LENGTH) use the EUSCI_B0_SPI DMA backend, and shorter ones the EUSCIB0 interrupt.
+ *
+ * A transaction with SPI_BUS_KEEP_CS leaves the chip-select asserted and reserves the bus: only transactions
+ * for the same device are started until one without SPI_BUS_KEEP_CS is complete. This is used to send a command
+ * and read the response without releasing the chip-select.
+ *
+ * The EUSCI_A3_SPI and EUSCI_B0_SPI functions must not be used directly on a bus that is managed by SPI_Bus.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef SPI_BUS_H_
+#define SPI_BUS_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/EUSCI_A3_SPI.h"
+#include "../inc/EUSCI_B0_SPI.h"
+
+/**
+ * @brief Buses
+ */
+#define SPI_BUS_A3                  0
+#define SPI_BUS_B0                  1
+#define SPI_BUS_NUM_BUSES           2
+
+/**
+ * @brief SPI modes (clock polarity and phase)
+ */
+#define SPI_BUS_MODE_0              0   // CPOL = 0, CPHA = 0
+#define SPI_BUS_MODE_1              1   // CPOL = 0, CPHA = 1
+#define SPI_BUS_MODE_2              2   // CPOL = 1, CPHA = 0
+#define SPI_BUS_MODE_3              3   // CPOL = 1, CPHA = 1
+
+/**
+ * @brief Minimum length of a SPI_BUS_B0 transaction that uses DMA instead of the EUSCIB0 interrupt
+ */
+#define SPI_BUS_DMA_THRESHOLD       32
+
+/**
+ * @brief Transaction flags
+ */
+#define SPI_BUS_KEEP_CS             0x01    // Leave the chip-select asserted after the transaction
+
+/**
+ * @brief Status of a transaction
+ */
+#define SPI_BUS_DONE                0
+#define SPI_BUS_PENDING             1
+
+/**
+ * @brief Error codes
+ */
+#define SPI_BUS_ERROR_BUS           -1
+#define SPI_BUS_ERROR_NO_MISO       -2
+#define SPI_BUS_ERROR_PENDING       -3
+
+/**
+ * @brief An SPI device.
+ */
+typedef struct
+{
+    uint8_t bus;                // SPI_BUS_A3 or SPI_BUS_B0
+    uint8_t cs_port;            // Port of the active low chip-select pin (1 to 10)
+    uint8_t cs_bit;             // Bit of the chip-select pin, for example 0x10 for Px.4, or 0 for no chip-select
+    uint32_t clock_frequency;   // SPI clock frequency in Hz (SMCLK divided by an integer, rounded down)
+    uint8_t mode;               // SPI_BUS_MODE_0 to SPI_BUS_MODE_3
+} SPI_Bus_Device;
+
+/**
+ * @brief A queued transfer to or from one device.
+ *
+ * status must be SPI_BUS_DONE (zero) when the transaction is submitted.
+ * The transaction and its buffers must remain valid until status is SPI_BUS_DONE again.
+ */
+typedef struct SPI_Bus_Transaction
+{
+    const SPI_Bus_Device *device;
+    const uint8_t *tx;          // Bytes to transmit, or 0 to transmit EUSCI_B0_SPI_FILL_BYTE (SPI_BUS_B0 only)
+    uint8_t *rx;                // Where the received bytes are stored, or 0 to discard them. Must be 0 on SPI_BUS_A3.
+    uint16_t length;
+    uint8_t flags;              // SPI_BUS_KEEP_CS or 0
+
+    // Called when the transaction is complete (from the EUSCIB0 interrupt handler on SPI_BUS_B0), or 0 for none.
+    // The function may submit another transaction.
+    void (*callback)(struct SPI_Bus_Transaction *transaction);
+    void *context;              // Not used by SPI_Bus
+
+    volatile int8_t status;     // SPI_BUS_PENDING or SPI_BUS_DONE
+    struct SPI_Bus_Transaction *next;
+} SPI_Bus_Transaction;
+
+/**
+ * @brief Statistics of one bus.
+ */
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t reconfigurations;  // Number of times the clock frequency and mode were loaded for a different device
+} SPI_Bus_Stats;
+
+/**
+ * @brief Initializes a bus. The eUSCI module is configured by the first transaction.
+ *
+ * @param bus SPI_BUS_A3 or SPI_BUS_B0.
+ *
+ * @return None
+ */
+void SPI_Bus_Init(uint8_t bus);
+
+/**
+ * @brief Configures the chip-select pin of a device as a GPIO output and deasserts it (high).
+ *
+ * @param device Pointer to the device. It must remain valid while the device is used.
+ *
+ * @return None
+ */
+void SPI_Bus_Add_Device(const SPI_Bus_Device *device);
+
+/**
+ * @brief Must be called after changing the clock frequency or mode of a device, so that the next transaction reloads them.
+ *
+ * @param device Pointer to the device. No transaction for the device may be in progress.
+ *
+ * @return None
+ */
+void SPI_Bus_Update_Device(const SPI_Bus_Device *device);
+
+/**
+ * @brief Adds a transaction to the queue of its bus and starts it if the bus is idle.
+ *
+ * The function returns as soon as the transaction is queued or started. Its status is SPI_BUS_DONE (and its callback
+ * has been called) when it is complete. A transaction without data, or one that has to be run by polling on
+ * SPI_BUS_A3, is complete when this function returns if the bus was idle.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return 0 on success, or a negative SPI_BUS_ERROR code (SPI_BUS_ERROR_PENDING if the transaction is already queued).
+ */
+int SPI_Bus_Submit(SPI_Bus_Transaction *transaction);
+
+/**
+ * @brief Transfers bytes to and from a device and waits until the transfer is complete.
+ *
+ * This function must not be called from an interrupt handler.
+ *
+ * @param device Pointer to the device.
+ * @param tx Pointer to the bytes to transmit, or 0.
+ * @param rx Pointer to where the received bytes will be stored, or 0.
+ * @param length Number of bytes.
+ *
+ * @return 0 on success, or a negative SPI_BUS_ERROR code.
+ */
+int SPI_Bus_Transfer(const SPI_Bus_Device *device, const uint8_t *tx, uint8_t *rx, uint16_t length);
+
+/**
+ * @brief Same as SPI_Bus_Transfer, but leaves the chip-select asserted (SPI_BUS_KEEP_CS) so that the next
+ *        transfer to the device continues the same burst. The burst ends with SPI_Bus_Release.
+ *
+ * This function must not be called from an interrupt handler.
+ *
+ * @param device Pointer to the device.
+ * @param tx Pointer to the bytes to transmit, or 0.
+ * @param rx Pointer to where the received bytes will be stored, or 0.
+ * @param length Number of bytes.
+ *
+ * @return 0 on success, or a negative SPI_BUS_ERROR code.
+ */
+int SPI_Bus_Transfer_Hold(const SPI_Bus_Device *device, const uint8_t *tx, uint8_t *rx, uint16_t length);
+
+/**
+ * @brief Deasserts the chip-select of a device after SPI_Bus_Transfer_Hold and frees the bus for other devices.
+ *
+ * The release is queued behind the transactions already submitted for the device.
+ * This function must not be called from an interrupt handler.
+ *
+ * @param device Pointer to the device.
+ *
+ * @return None
+ */
+void SPI_Bus_Release(const SPI_Bus_Device *device);
+
+/**
+ * @brief Checks whether a bus has a transaction in progress or queued.
+ *
+ * @param bus SPI_BUS_A3 or SPI_BUS_B0.
+ *
+ * @return 1 if the bus is busy, otherwise 0.
+ */
+uint8_t SPI_Bus_Is_Busy(uint8_t bus);
+
+/**
+ * @brief Returns the statistics of a bus.
+ *
+ * @param bus SPI_BUS_A3 or SPI_BUS_B0.
+ * @param stats Pointer to where the statistics will be stored.
+ *
+ * @return None
+ */
+void SPI_Bus_Get_Stats(uint8_t bus, SPI_Bus_Stats *stats);
+
+#endif /* SPI_BUS_H_ */
@@ -0,0 +1,280 @@
+/**
+ * @file Stream.h
+ * @brief Header file for the Stream library.
+ *
+ * This file contains the function definitions for the Stream library.
+ * A stream is an output device seen through a small table of functions (Stream_Interface), so that the same
+ * formatting code can write to any of them:
+ *
+ *  Sink                        Function                        Buffer
+ *  ----                        --------                        ------
+ *  EUSCI_A0 to EUSCI_A3        EUSCI_A_UART_Get_Stream         Transmit queue of the port
+ *  Nokia 5110 LCD (SPI only)   Nokia5110_Get_Stream            None (characters are drawn as they are written)
+ *  RAM buffer                  Stream_Memory_Init              The buffer
+ *  Null                        Stream_Null_Init                Scratch buffer, the output is only counted
+ *
+ * The formatting functions (Stream_Put_UDec, Stream_Printf, ...) are the only formatting code: the OutUDec,
+ * OutSDec, OutUFix and OutUHex functions of the UART and LCD drivers call them.
+ *
+ * A sink with a buffer returns the free space that follows its write position with get_buffer. A number is then
+ * converted directly into that space and committed, without an intermediate copy. When the sink has no buffer,
+ * or the free space is too small, the text is converted into a local array and passed to write.
+ *
+ * A sink is a structure that starts with a Stream, so that a pointer to it can be passed as a Stream pointer.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+/**
+ * @brief Size of the scratch buffer of a null sink in bytes
+ */
+#define STREAM_NULL_BUFFER_SIZE         64
+
+typedef struct Stream Stream;
+
+/**
+ * @brief Functions implemented by a sink.
+ */
+typedef struct
+{
+    /**
+     * @brief Writes length bytes. Sinks for devices wait for space, RAM sinks drop what does not fit.
+     * @return Number of bytes written.
+     */
+    uint32_t (*write)(Stream *stream, const char *data, uint32_t length);
+
+    /**
+     * @brief Returns the contiguous free space at the write position, or 0 if there is none.
+     *        Can be 0 (no function) for sinks without a buffer.
+     */
+    uint32_t (*get_buffer)(Stream *stream, char **buffer);
+
+    /**
+     * @brief Adds count bytes written into the space returned by get_buffer to the output.
+     */
+    void (*commit)(Stream *stream, uint32_t count);
+
+    /**
+     * @brief Waits until the bytes written so far have left the sink (for example shifted out by the UART).
+     */
+    void (*flush)(Stream *stream);
+} Stream_Interface;
+
+/**
+ * @brief Header of every sink.
+ */
+struct Stream
+{
+    const Stream_Interface *interface;
+};
+
+/**
+ * @brief Sink that writes into a RAM buffer. The text is kept null-terminated.
+ */
+typedef struct
+{
+    Stream stream;
+    char *buffer;
+    uint32_t size;                  // Size of the buffer, including the null terminator
+    uint32_t length;                // Number of characters in the buffer
+    uint32_t dropped;               // Number of characters that did not fit
+} Stream_Memory;
+
+/**
+ * @brief Sink that discards the output, to measure the cost of formatting.
+ */
+typedef struct
+{
+    Stream stream;
+    uint32_t bytes;                 // Number of bytes written
+    char scratch[STREAM_NULL_BUFFER_SIZE];
+} Stream_Null;
+
+/**
+ * @brief Initializes a RAM sink with an empty string.
+ *
+ * @param sink Pointer to the sink.
+ * @param buffer Pointer to the buffer.
+ * @param size Size of the buffer in bytes (at least 1).
+ *
+ * @return Pointer to the stream of the sink.
+ */
+Stream *Stream_Memory_Init(Stream_Memory *sink, char *buffer, uint32_t size);
+
+/**
+ * @brief Empties a RAM sink.
+ *
+ * @param sink Pointer to the sink.
+ *
+ * @return None
+ */
+void Stream_Memory_Clear(Stream_Memory *sink);
+
+/**
+ * @brief Initializes a null sink.
+ *
+ * @param sink Pointer to the sink.
+ *
+ * @return Pointer to the stream of the sink.
+ */
+Stream *Stream_Null_Init(Stream_Null *sink);
+
+/**
+ * @brief Writes length bytes to a stream.
+ *
+ * @param stream Pointer to the stream.
+ * @param data Pointer to the bytes.
+ * @param length Number of bytes.
+ *
+ * @return Number of bytes written.
+ */
+uint32_t Stream_Write(Stream *stream, const char *data, uint32_t length);
+
+/**
+ * @brief Waits until the output of a stream has left the sink.
+ *
+ * @param stream Pointer to the stream.
+ *
+ * @return None
+ */
+void Stream_Flush(Stream *stream);
+
+/**
+ * @brief Writes one character.
+ *
+ * @param stream Pointer to the stream.
+ * @param character The character.
+ *
+ * @return None
+ */
+void Stream_Put_Char(Stream *stream, char character);
+
+/**
+ * @brief Writes a null-terminated string.
+ *
+ * @param stream Pointer to the stream.
+ * @param string Pointer to the string.
+ *
+ * @return None
+ */
+void Stream_Put_String(Stream *stream, const char *string);
+
+/**
+ * @brief Writes an unsigned decimal number, right-justified with spaces to at least width characters.
+ *
+ * @param stream Pointer to the stream.
+ * @param n The number.
+ * @param width Minimum number of characters (0 for no padding).
+ *
+ * @return None
+ */
+void Stream_Put_UDec(Stream *stream, uint32_t n, uint8_t width);
+
+/**
+ * @brief Writes a signed decimal number, right-justified with spaces to at least width characters.
+ *        Negative numbers start with '-'.
+ *
+ * @param stream Pointer to the stream.
+ * @param n The number.
+ * @param width Minimum number of characters (0 for no padding).
+ *
+ * @return None
+ */
+void Stream_Put_SDec(Stream *stream, int32_t n, uint8_t width);
+
+/**
+ * @brief Writes an unsigned fixed-point number in units of 10^-decimals, for example 125 with one decimal
+ *        place as 12.5, right-justified with spaces to at least width characters.
+ *
+ * @param stream Pointer to the stream.
+ * @param n The number.
+ * @param decimals Number of decimal places (0 to 9).
+ * @param width Minimum number of characters (0 for no padding).
+ *
+ * @return None
+ */
+void Stream_Put_UFix(Stream *stream, uint32_t n, uint8_t decimals, uint8_t width);
+
+/**
+ * @brief Writes a signed fixed-point number in units of 10^-decimals, for example -125 with two decimal
+ *        places as -1.25, right-justified with spaces to at least width characters.
+ *
+ * @param stream Pointer to the stream.
+ * @param n The number.
+ * @param decimals Number of decimal places (0 to 9).
+ * @param width Minimum number of characters (0 for no padding).
+ *
+ * @return None
+ */
+void Stream_Put_SFix(Stream *stream, int32_t n, uint8_t decimals, uint8_t width);
+
+/**
+ * @brief Writes an unsigned hexadecimal number with uppercase digits, padded with zeros to at least digits digits.
+ *
+ * @param stream Pointer to the stream.
+ * @param n The number.
+ * @param digits Minimum number of digits (0 or 1 for no padding).
+ *
+ * @return None
+ */
+void Stream_Put_UHex(Stream *stream, uint32_t n, uint8_t digits);
+
+/**
+ * @brief Writes a 16-bit value as two bytes, least significant byte first, for the binary streams of the drivers.
+ *
+ * @param stream Pointer to the stream.
+ * @param value The value.
+ *
+ * @return None
+ */
+void Stream_Put_U16_LE(Stream *stream, uint16_t value);
+
+/**
+ * @brief Writes a 32-bit value as four bytes, least significant byte first, for the binary streams of the drivers.
+ *
+ * @param stream Pointer to the stream.
+ * @param value The value.
+ *
+ * @return None
+ */
+void Stream_Put_U32_LE(Stream *stream, uint32_t value);
+
+/**
+ * @brief Writes formatted text. The following conversions are supported, with an optional '-' (left-justify)
+ *        or '0' (pad with zeros, up to 32 digits) flag, a width, and a precision for %s:
+ *
+ *  %d %i       int32_t in decimal
+ *  %u          uint32_t in decimal
+ *  %x %X       uint32_t in hexadecimal (lowercase or uppercase)
+ *  %c          Character
+ *  %s          Null-terminated string
+ *  %%          '%'
+ *
+ * The l and h length modifiers are accepted and ignored (int and long are 32 bits).
+ *
+ * @param stream Pointer to the stream.
+ * @param format Pointer to the format string.
+ *
+ * @return Number of characters written.
+ */
+uint32_t Stream_Printf(Stream *stream, const char *format, ...);
+
+/**
+ * @brief Same as Stream_Printf, with a va_list.
+ *
+ * @param stream Pointer to the stream.
+ * @param format Pointer to the format string.
+ * @param arguments The arguments.
+ *
+ * @return Number of characters written.
+ */
+uint32_t Stream_VPrintf(Stream *stream, const char *format, va_list arguments);
+
+#endif /* STREAM_H_ */
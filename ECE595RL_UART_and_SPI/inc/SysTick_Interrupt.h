@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "../inc/Interrupt_Priority.h"
 
 // The toggle rate for SysTick_Interrupt in ms
 #define SYSTICK_INT_TOGGLE_RATE_MS 500
@@ -25,7 +26,7 @@
 #define SYSTICK_INT_NUM_CLK_CYCLES 48000
 
 // The priority level of the SysTick interrupt
-#define SYSTICK_INT_PRIORITY 2
+#define SYSTICK_INT_PRIORITY INTERRUPT_PRIORITY_SYSTICK
 
 /**
  * @brief Initializes the SysTick timer with periodic interrupts.
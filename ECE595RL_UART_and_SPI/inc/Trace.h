@@ -0,0 +1,195 @@
+/**
+ * @file Trace.h
+ * @brief Header file for the Trace driver.
+ *
+ * This file contains the function definitions for the Trace driver.
+ * It records events with a DWT cycle counter timestamp into a circular buffer in RAM: interrupt handler entry and exit,
+ * task begin and end, queue post and consume, and markers. When the buffer is full, the oldest events are overwritten.
+ * The host tool tools/trace_to_chrome.py reads the buffer over EUSCI_A0 and converts it into a Chrome trace (JSON)
+ * that shows the timeline in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+ *
+ * The drivers record their events with the TRACE macros, which are empty when TRACE_ENABLE is not defined:
+ *
+ *      void EUSCIB0_IRQHandler(void)
+ *      {
+ *          TRACE_ISR_ENTER(TRACE_ID_EUSCI_B0_SPI);
+ *          ...
+ *          TRACE_ISR_EXIT(TRACE_ID_EUSCI_B0_SPI);
+ *      }
+ *
+ * Each event source has an identifier (TRACE_ID_...) that selects its row in the timeline. The identifiers of the
+ * application start at TRACE_ID_USER and are named with Trace_Set_Name. An event takes about 20 cycles.
+ * The buffer is written with PRIMASK set, so the events can be recorded from any interrupt priority.
+ *
+ * Each event is 8 bytes. The stream has the following layout (multi-byte fields are little-endian):
+ *
+ *  Size        Field
+ *  ----        -----
+ *   2          "TR"
+ *   1          TRACE_STREAM_VERSION
+ *   1          Number of names
+ *   4          Frequency of the cycle counter in Hz
+ *   4          Number of events in the stream
+ *   4          Number of events recorded since Trace_Init (the oldest ones were overwritten)
+ *   2 + n      For each name: identifier, length of the name, followed by the name
+ *   8 * n      Events, oldest first: timestamp (4 bytes), type (1 byte), identifier (1 byte), data (2 bytes)
+ *   2          CRC-16/CCITT (initial value 0xFFFF) of the events
+ *
+ * @note Assumes that Clock_Init48MHz() has been called, and that EUSCI_A0 has been initialized (for example with EUSCI_A0_UART_Init()).
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+// TRACE_ENABLE is not defined here, so the trace points of the drivers cost nothing by default. It has to reach
+// every source file, so the build that uses tracing (USE_TRACE_TIMELINE in SPI_main.c) adds it to the predefined
+// symbols of the project (--define=TRACE_ENABLE).
+
+/**
+ * @brief Frequency of the cycle counter (the CPU clock) in Hz
+ */
+#define TRACE_CPU_FREQUENCY         48000000
+
+/**
+ * @brief Number of events in the buffer. Must be a power of two.
+ */
+#define TRACE_BUFFER_SIZE           1024
+
+/**
+ * @brief Version of the stream format
+ */
+#define TRACE_STREAM_VERSION        1
+
+/**
+ * @brief Command byte sent by the host to read the buffer
+ */
+#define TRACE_CMD_READ              'T'
+
+/**
+ * @brief Types of events
+ */
+#define TRACE_TYPE_ISR_ENTER        1
+#define TRACE_TYPE_ISR_EXIT         2
+#define TRACE_TYPE_TASK_BEGIN       3
+#define TRACE_TYPE_TASK_END         4
+#define TRACE_TYPE_QUEUE_POST       5       // data: number of items in the queue after the post
+#define TRACE_TYPE_QUEUE_CONSUME    6       // data: number of items in the queue after the consume
+#define TRACE_TYPE_MARKER           7       // data: value chosen by the application
+
+/**
+ * @brief Identifiers of the event sources of the drivers
+ */
+#define TRACE_ID_EUSCI_A_UART       0       // EUSCI_A0 to EUSCI_A3 interrupts: TRACE_ID_EUSCI_A_UART + port
+#define TRACE_ID_EUSCI_B0_SPI       4       // EUSCIB0 interrupt
+#define TRACE_ID_DMA                5       // DMA_INT0 to DMA_INT3 interrupts
+#define TRACE_ID_SYSTICK            6       // SysTick_Handler of the application
+#define TRACE_ID_NOKIA5110          7       // Nokia5110_Write_Burst
+#define TRACE_ID_ACTIVE_OBJECT      8       // Dispatch and queue of an active object: TRACE_ID_ACTIVE_OBJECT + priority - 1
+#define TRACE_ID_USER               16
+#define TRACE_MAX_IDS               32
+
+/**
+ * @brief One event of the buffer
+ */
+typedef struct
+{
+    uint32_t timestamp;         // DWT cycle counter
+    uint8_t type;               // TRACE_TYPE_...
+    uint8_t id;                 // TRACE_ID_...
+    uint16_t data;
+} Trace_Event;
+
+#ifdef TRACE_ENABLE
+#define TRACE_ISR_ENTER(id)             Trace_Record(TRACE_TYPE_ISR_ENTER, (id), 0)
+#define TRACE_ISR_EXIT(id)              Trace_Record(TRACE_TYPE_ISR_EXIT, (id), 0)
+#define TRACE_TASK_BEGIN(id)            Trace_Record(TRACE_TYPE_TASK_BEGIN, (id), 0)
+#define TRACE_TASK_END(id)              Trace_Record(TRACE_TYPE_TASK_END, (id), 0)
+#define TRACE_QUEUE_POST(id, count)     Trace_Record(TRACE_TYPE_QUEUE_POST, (id), (count))
+#define TRACE_QUEUE_CONSUME(id, count)  Trace_Record(TRACE_TYPE_QUEUE_CONSUME, (id), (count))
+#define TRACE_MARKER(id, value)         Trace_Record(TRACE_TYPE_MARKER, (id), (value))
+#else
+#define TRACE_ISR_ENTER(id)
+#define TRACE_ISR_EXIT(id)
+#define TRACE_TASK_BEGIN(id)
+#define TRACE_TASK_END(id)
+#define TRACE_QUEUE_POST(id, count)
+#define TRACE_QUEUE_CONSUME(id, count)
+#define TRACE_MARKER(id, value)
+#endif
+
+/**
+ * @brief The Trace_Init function enables the DWT cycle counter, clears the buffer and starts recording.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Init();
+
+/**
+ * @brief The Trace_Start function starts or resumes recording.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Start();
+
+/**
+ * @brief The Trace_Stop function stops recording. The buffer is kept.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Stop();
+
+/**
+ * @brief The Trace_Set_Name function names an identifier in the stream (the drivers' identifiers already have a name).
+ *
+ * @param id    Identifier, from 0 to TRACE_MAX_IDS - 1
+ * @param name  Name shown in the timeline. The string must remain valid.
+ *
+ * @return None
+ */
+void Trace_Set_Name(uint8_t id, const char *name);
+
+/**
+ * @brief The Trace_Record function adds an event to the buffer. It is normally called through the TRACE macros.
+ *
+ * @param type  TRACE_TYPE_...
+ * @param id    TRACE_ID_...
+ * @param data  Value stored with the event
+ *
+ * @return None
+ */
+void Trace_Record(uint8_t type, uint8_t id, uint16_t data);
+
+/**
+ * @brief The Trace_Stream function sends the buffer over EUSCI_A0. Recording must be stopped,
+ *        otherwise the interrupts of EUSCI_A0 fill the buffer while it is sent.
+ *
+ * @param None
+ *
+ * @return Number of bytes sent
+ */
+uint32_t Trace_Stream();
+
+/**
+ * @brief The Trace_Poll function checks, without waiting, whether the host sent TRACE_CMD_READ.
+ *        If so, it stops recording, sends the buffer, clears it and starts recording again.
+ *        It is called from the main loop of the program that is traced.
+ *
+ * @param None
+ *
+ * @return 1 if the buffer was sent, 0 otherwise
+ */
+uint8_t Trace_Poll();
+
+#endif /* TRACE_H_ */
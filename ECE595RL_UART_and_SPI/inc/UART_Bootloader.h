@@ -0,0 +1,207 @@
+/**
+ * @file UART_Bootloader.h
+ * @brief Header file for the UART_Bootloader driver.
+ *
+ * This file contains the function definitions for the UART_Bootloader driver.
+ * It is a resident loader that receives an application image over EUSCI_A0 (USB), programs it into
+ * bank 1 of the MAIN flash memory using the flash controller (FLCTL), verifies it, and jumps to it.
+ *
+ * Bank 1 is split into two slots. Applications always run from the active slot and must be linked for it
+ * with linker/msp432p401r_application.cmd (MAIN origin = 0x00020000, length = UART_BOOTLOADER_IMAGE_SIZE),
+ * then converted to a raw binary with tiobj2bin.
+ * A new image is first written to the staging slot and verified. Only then is it copied to the active slot.
+ * If an upload is interrupted or fails verification, the active slot is not modified and the previous image is
+ * still booted. If the copy itself is interrupted, the next reset finds a valid staging image and copies it again.
+ *
+ *  Slot        Image                       Header sector       Maximum image size
+ *  ----        -----                       -------------       ------------------
+ *  Active      0x00020000 - 0x0002EFFF     0x0002F000          60 KB
+ *  Staging     0x00030000 - 0x0003EFFF     0x0003F000          60 KB
+ *
+ * The loader itself runs from bank 0, so it keeps executing while bank 1 is being erased and programmed.
+ * It is linked with linker/msp432p401r_bootloader.cmd, which limits MAIN to bank 0 (select it as the linker
+ * command file of the UART project instead of UART/msp432p401r.cmd).
+ * The host-side uploader is tools/uart_uploader.py.
+ *
+ * Every host command is sent as a frame:
+ *
+ *  Offset          Size        Field
+ *  ------          ----        -----
+ *   0               1          UART_BOOTLOADER_SOH (0x01)
+ *   1               1          Command
+ *   2               2          Payload length (little-endian)
+ *   4               length     Payload
+ *   4 + length      2          CRC-16/CCITT (initial value 0xFFFF) of the command, length and payload (little-endian)
+ *
+ * The loader answers each frame with UART_BOOTLOADER_ACK or UART_BOOTLOADER_NAK followed by a status byte,
+ * which is 0 or the negated UART_BOOTLOADER_ERROR code. The host retransmits a frame after a NAK or a timeout.
+ *
+ *  Command                         Payload                             Action
+ *  -------                         -------                             ------
+ *  UART_BOOTLOADER_CMD_PING        None                                Checks that the loader is running
+ *  UART_BOOTLOADER_CMD_START       Image length, image CRC-32 (LE)     Erases the staging slot
+ *  UART_BOOTLOADER_CMD_DATA        Offset (LE), up to 256 bytes        Programs a block into the staging slot
+ *  UART_BOOTLOADER_CMD_END         None                                Verifies the image, installs it and boots it
+ *  UART_BOOTLOADER_CMD_BOOT        None                                Boots the active image
+ *
+ * For more information regarding the flash controller, refer to the Flash Controller (FLCTL) section (9)
+ * of the MSP432Pxx Microcontrollers Technical Reference Manual
+ *
+ * @note P1.2 and P1.3 (EUSCI_A0) are used for UART communication via USB.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef UART_BOOTLOADER_H_
+#define UART_BOOTLOADER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/EUSCI_A_UART.h"
+#include "../inc/Clock.h"
+
+/**
+ * @brief Baud rate used by the loader on EUSCI_A0
+ */
+#define UART_BOOTLOADER_BAUD_RATE       460800
+
+/**
+ * @brief Frame and response markers
+ */
+#define UART_BOOTLOADER_SOH             0x01
+#define UART_BOOTLOADER_ACK             0x06
+#define UART_BOOTLOADER_NAK             0x15
+
+/**
+ * @brief Host commands
+ */
+#define UART_BOOTLOADER_CMD_PING        0x50
+#define UART_BOOTLOADER_CMD_START       0x53
+#define UART_BOOTLOADER_CMD_DATA        0x44
+#define UART_BOOTLOADER_CMD_END         0x45
+#define UART_BOOTLOADER_CMD_BOOT        0x42
+
+/**
+ * @brief Maximum number of image bytes in a UART_BOOTLOADER_CMD_DATA frame. The offset and length must be multiples of 4.
+ */
+#define UART_BOOTLOADER_BLOCK_SIZE      256
+
+/**
+ * @brief Slot layout in bank 1 of the MAIN flash memory
+ */
+#define UART_BOOTLOADER_ACTIVE_SLOT     0
+#define UART_BOOTLOADER_STAGING_SLOT    1
+#define UART_BOOTLOADER_SLOT0_ADDRESS   0x00020000
+#define UART_BOOTLOADER_SLOT_SIZE       0x00010000
+#define UART_BOOTLOADER_SECTOR_SIZE     0x00001000
+#define UART_BOOTLOADER_IMAGE_SIZE      (UART_BOOTLOADER_SLOT_SIZE - UART_BOOTLOADER_SECTOR_SIZE)
+
+/**
+ * @brief Value of the magic field of a valid slot header ("BOOT")
+ */
+#define UART_BOOTLOADER_MAGIC           0x544F4F42
+
+/**
+ * @brief Error codes returned by the UART_Bootloader functions. The negated value is sent as the NAK status byte.
+ */
+#define UART_BOOTLOADER_ERROR_CRC       -1
+#define UART_BOOTLOADER_ERROR_FORMAT    -2
+#define UART_BOOTLOADER_ERROR_SEQUENCE  -3
+#define UART_BOOTLOADER_ERROR_ERASE     -4
+#define UART_BOOTLOADER_ERROR_PROGRAM   -5
+#define UART_BOOTLOADER_ERROR_VERIFY    -6
+#define UART_BOOTLOADER_ERROR_NO_IMAGE  -7
+#define UART_BOOTLOADER_ERROR_TIMEOUT   -8
+
+/**
+ * @brief Slot header stored at the start of the last sector of a slot.
+ */
+typedef struct
+{
+    uint32_t magic;         // UART_BOOTLOADER_MAGIC
+    uint32_t length;        // Image length in bytes
+    uint32_t image_crc;     // CRC-32 of the image
+    uint32_t header_crc;    // CRC-32 of the previous fields
+} UART_Bootloader_Header;
+
+/**
+ * @brief Initializes EUSCI_A0 at UART_BOOTLOADER_BAUD_RATE for the loader protocol.
+ *
+ * @return None
+ */
+void UART_Bootloader_Init();
+
+/**
+ * @brief Computes the CRC-32 of a buffer (polynomial 0x04C11DB7, reflected, as used by zlib).
+ *
+ * @param data Pointer to the data.
+ * @param length Number of bytes.
+ *
+ * @return The CRC-32.
+ */
+uint32_t UART_Bootloader_CRC32(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Checks the header and the image CRC of a slot.
+ *
+ * @param slot UART_BOOTLOADER_ACTIVE_SLOT or UART_BOOTLOADER_STAGING_SLOT.
+ *
+ * @return 0 if the slot holds a valid image, otherwise UART_BOOTLOADER_ERROR_NO_IMAGE.
+ */
+int UART_Bootloader_Check_Slot(uint8_t slot);
+
+/**
+ * @brief Copies the image in the staging slot to the active slot.
+ *
+ * The header of the active slot is erased first and written last, so an interrupted copy leaves
+ * the active slot invalid and the staging slot valid, and the copy is repeated at the next reset.
+ *
+ * @return 0 on success, or a negative UART_BOOTLOADER_ERROR code.
+ */
+int UART_Bootloader_Install();
+
+/**
+ * @brief Erases a 4 KB sector of bank 1.
+ *
+ * @param address Start address of the sector.
+ *
+ * @return 0 on success, or UART_BOOTLOADER_ERROR_ERASE.
+ */
+int UART_Bootloader_Erase_Sector(uint32_t address);
+
+/**
+ * @brief Programs words into bank 1 using immediate word programming, and reads them back.
+ *
+ * @param address Destination address (word aligned).
+ * @param data Pointer to the data.
+ * @param length Number of bytes (multiple of 4).
+ *
+ * @return 0 on success, or UART_BOOTLOADER_ERROR_PROGRAM.
+ */
+int UART_Bootloader_Program(uint32_t address, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Starts the application in the active slot.
+ *
+ * This function disables and clears all NVIC interrupts, stops SysTick and EUSCI_A0, points VTOR to the vector
+ * table of the active slot, loads the main stack pointer from the first vector, and branches to the reset handler.
+ *
+ * @return None (does not return)
+ */
+void UART_Bootloader_Boot();
+
+/**
+ * @brief Runs the loader.
+ *
+ * This function answers host frames. If no frame is received within the timeout, the active image is booted
+ * (after installing the staging image if the active slot is not valid). After a successful upload, the new image
+ * is booted. The loader keeps running while no valid image exists.
+ *
+ * @param timeout_ms Time to wait for the first frame in milliseconds, or 0 to wait forever.
+ *
+ * @return None (does not return)
+ */
+void UART_Bootloader_Run(uint32_t timeout_ms);
+
+#endif /* UART_BOOTLOADER_H_ */
@@ -0,0 +1,44 @@
+/**
+ * @file Check.h
+ * @brief Checks shared by the host tests.
+ *
+ * Each test is a single source file that includes this header once. CHECK prints the file, line and
+ * condition of a failed check and counts it, and the test continues. main returns Check_Result, which
+ * prints "<test>: PASS" or "<test>: FAIL".
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <stdio.h>
+
+#define CHECK(condition)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);\
+            Failures++;                                                         \
+        }                                                                       \
+    } while(0)
+
+// Number of failed checks
+static int Failures;
+
+/**
+ * @brief Prints the result of a test.
+ *
+ * @param name Name of the test, for example "test_ring_buffer".
+ *
+ * @return 0 if every check passed, 1 otherwise. Intended as the return value of main.
+ */
+static inline int Check_Result(const char *name)
+{
+    printf("%s: %s\n", name, Failures ? "FAIL" : "PASS");
+    return Failures ? 1 : 0;
+}
+
+#endif /* CHECK_H_ */
@@ -0,0 +1,145 @@
+/**
+ * @file bench_memory_pool.c
+ * @brief Host benchmark of the Memory_Pool library against malloc and free.
+ *
+ * Two patterns are timed with the same sequence of sizes (1 to 512 bytes, as the frames and blocks of the drivers):
+ *  - Pairs: each block is released right after it is allocated.
+ *  - Queue: up to 16 blocks are kept, and the oldest one is released before each allocation, as a queue of frames.
+ *
+ * The result is the time of one allocation and release in nanoseconds. On the MSP432, USE_MEMORY_POOL_TEST
+ * in UART_main.c measures the same in cycles.
+ *
+ * Build and run with make bench in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../inc/Memory_Pool.h"
+
+#define OPERATIONS      20000000
+#define QUEUE_LENGTH    16
+#define NUM_SIZES       1024
+
+static uint32_t Sizes[NUM_SIZES];
+
+static double Now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static double Pool_Pairs()
+{
+    double start = Now();
+    void *block;
+    uint32_t i;
+
+    for (i = 0; i < OPERATIONS; i++)
+    {
+        block = Memory_Pool_Alloc(Sizes[i % NUM_SIZES]);
+        *(volatile uint8_t *)block = (uint8_t)i;
+        Memory_Pool_Release(block);
+    }
+    return (Now() - start) * 1e9 / OPERATIONS;
+}
+
+static double Malloc_Pairs()
+{
+    double start = Now();
+    void *block;
+    uint32_t i;
+
+    for (i = 0; i < OPERATIONS; i++)
+    {
+        block = malloc(Sizes[i % NUM_SIZES]);
+        *(volatile uint8_t *)block = (uint8_t)i;
+        free(block);
+    }
+    return (Now() - start) * 1e9 / OPERATIONS;
+}
+
+static double Pool_Queue()
+{
+    void *queue[QUEUE_LENGTH] = {0};
+    double start = Now();
+    uint32_t i;
+
+    for (i = 0; i < OPERATIONS; i++)
+    {
+        Memory_Pool_Release(queue[i % QUEUE_LENGTH]);
+        queue[i % QUEUE_LENGTH] = Memory_Pool_Alloc(Sizes[i % NUM_SIZES]);
+        *(volatile uint8_t *)queue[i % QUEUE_LENGTH] = (uint8_t)i;
+    }
+    for (i = 0; i < QUEUE_LENGTH; i++)
+    {
+        Memory_Pool_Release(queue[i]);
+    }
+    return (Now() - start) * 1e9 / OPERATIONS;
+}
+
+static double Malloc_Queue()
+{
+    void *queue[QUEUE_LENGTH] = {0};
+    double start = Now();
+    uint32_t i;
+
+    for (i = 0; i < OPERATIONS; i++)
+    {
+        free(queue[i % QUEUE_LENGTH]);
+        queue[i % QUEUE_LENGTH] = malloc(Sizes[i % NUM_SIZES]);
+        *(volatile uint8_t *)queue[i % QUEUE_LENGTH] = (uint8_t)i;
+    }
+    for (i = 0; i < QUEUE_LENGTH; i++)
+    {
+        free(queue[i]);
+    }
+    return (Now() - start) * 1e9 / OPERATIONS;
+}
+
+int main(void)
+{
+    Memory_Pool_Stats stats;
+    uint32_t i;
+    uint8_t c;
+
+    // Mostly small frames, some LCD rows and a few full blocks
+    srand(1);
+    for (i = 0; i < NUM_SIZES; i++)
+    {
+        switch(rand() % 8)
+        {
+            case 0:  Sizes[i] = 257 + rand() % 256; break;
+            case 1:
+            case 2:  Sizes[i] = 33 + rand() % 96; break;
+            default: Sizes[i] = 1 + rand() % 32; break;
+        }
+    }
+
+    Memory_Pool_Init();
+
+    printf("Memory_Pool: %d allocations of 1 to 512 bytes (ns per allocation and release)\n", OPERATIONS);
+    printf("  %-28s %6.1f\n", "Pairs, Memory_Pool", Pool_Pairs());
+    printf("  %-28s %6.1f\n", "Pairs, malloc/free", Malloc_Pairs());
+    printf("  %-28s %6.1f\n", "Queue of 16, Memory_Pool", Pool_Queue());
+    printf("  %-28s %6.1f\n", "Queue of 16, malloc/free", Malloc_Queue());
+
+    for (c = 0; c < MEMORY_POOL_NUM_CLASSES; c++)
+    {
+        Memory_Pool_Get_Stats(c, &stats);
+        printf("  Class %d (%3u bytes): high water %2u of %2u, fallbacks %u, failures %u\n", c,
+               (unsigned)stats.block_size, (unsigned)stats.high_water, (unsigned)stats.block_count,
+               (unsigned)stats.fallbacks, (unsigned)stats.failures);
+        if (stats.failures)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
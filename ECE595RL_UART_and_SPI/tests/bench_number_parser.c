@@ -0,0 +1,165 @@
+/**
+ * @file bench_number_parser.c
+ * @brief Host benchmark of the Number_Parser library against strtoul.
+ *
+ * 64 KB of random unsigned decimal numbers, separated by spaces, commas and line breaks, are parsed three ways:
+ *  - Number_Parser_Parse on lines of up to 16 numbers, as the command lines of the drivers.
+ *  - Number_Parser_Feed one character at a time, as the bytes received by a UART.
+ *  - strtoul on the same lines.
+ *
+ * The result is the rate in MB of text per second. The sums of the values are compared to check the results.
+ *
+ * Build and run with make bench in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../inc/Number_Parser.h"
+
+#define INPUT_SIZE      65536
+#define REPEATS         200
+#define LINE_NUMBERS    16
+
+static char Input[INPUT_SIZE];
+static uint32_t Input_Length;
+static volatile uint32_t Sink;
+
+static double Now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Parses each line of the input with Number_Parser_Parse and returns the sum of the values
+ */
+static uint32_t Parse_Lines()
+{
+    Number_Parser parser;
+    uint32_t values[LINE_NUMBERS];
+    uint32_t sum = 0;
+    uint32_t start = 0;
+    uint32_t end;
+    int32_t count;
+    int32_t i;
+
+    Number_Parser_Init(&parser, NUMBER_PARSER_UNSIGNED, 0);
+    while(start < Input_Length)
+    {
+        for (end = start; Input[end] != '\n'; end++)
+        {
+        }
+        count = Number_Parser_Parse(&parser, &Input[start], end - start, values, LINE_NUMBERS);
+        for (i = 0; i < count; i++)
+        {
+            sum += values[i];
+        }
+        start = end + 1;
+    }
+    return sum;
+}
+
+/**
+ * @brief Feeds the input one character at a time and returns the sum of the values
+ */
+static uint32_t Feed_Characters()
+{
+    Number_Parser parser;
+    uint32_t value;
+    uint32_t sum = 0;
+    uint32_t i;
+
+    Number_Parser_Init(&parser, NUMBER_PARSER_UNSIGNED, 0);
+    for (i = 0; i < Input_Length; i++)
+    {
+        if (Number_Parser_Feed(&parser, Input[i], &value) == NUMBER_PARSER_DONE)
+        {
+            sum += value;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Converts the input with strtoul and returns the sum of the values
+ */
+static uint32_t Strtoul_Lines()
+{
+    const char *next = Input;
+    const char *end = &Input[Input_Length];
+    char *stop;
+    uint32_t sum = 0;
+
+    while(next < end)
+    {
+        sum += (uint32_t)strtoul(next, &stop, 10);
+        next = stop;
+        while((next < end) && ((*next == ' ') || (*next == ',') || (*next == '\n')))
+        {
+            next++;
+        }
+    }
+    return sum;
+}
+
+static double Run(uint32_t (*parse)(void), uint32_t *sum)
+{
+    double start = Now();
+    uint32_t r;
+
+    for (r = 0; r < REPEATS; r++)
+    {
+        *sum = parse();
+    }
+    Sink = *sum;
+    return (double)Input_Length * REPEATS / (Now() - start) / 1e6;
+}
+
+int main(void)
+{
+    uint32_t numbers = 0;
+    uint32_t expected = 0;
+    uint32_t value;
+    uint32_t sum;
+    double rates[3];
+    uint8_t error = 0;
+    int length;
+
+    // Numbers of 1 to 10 digits, 16 per line, up to 64 KB with a line break at the end
+    srand(1);
+    while(1)
+    {
+        value = (uint32_t)rand() >> (rand() % 31);
+        if (Input_Length + 12 >= INPUT_SIZE)
+        {
+            break;
+        }
+        length = sprintf(&Input[Input_Length], "%u", value);
+        Input_Length += length;
+        numbers++;
+        Input[Input_Length++] = ((numbers % LINE_NUMBERS) == 0) ? '\n' : ((numbers % 3) ? ' ' : ',');
+        expected += value;
+    }
+    Input[Input_Length - 1] = '\n';
+
+    rates[0] = Run(Parse_Lines, &sum);
+    error |= (sum != expected);
+    rates[1] = Run(Feed_Characters, &sum);
+    error |= (sum != expected);
+    rates[2] = Run(Strtoul_Lines, &sum);
+    error |= (sum != expected);
+
+    printf("Number_Parser: %u bytes, %u unsigned decimal numbers (MB/s)%s\n", (unsigned)Input_Length,
+           (unsigned)numbers, error ? "  (sum error)" : "");
+    printf("  %-28s %8.1f\n", "Number_Parser_Parse", rates[0]);
+    printf("  %-28s %8.1f\n", "Number_Parser_Feed", rates[1]);
+    printf("  %-28s %8.1f\n", "strtoul", rates[2]);
+
+    return error;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file bench_ring_buffer.c
+ * @brief Host benchmark for the Ring_Buffer library.
+ *
+ * A producer thread and a consumer thread pass 32-bit elements through one queue, first one element at a time
+ * (Push and Pop), then in batches (Push_Multiple and Pop_Multiple) and in place (Write_Span and Read_Span).
+ * The result is the number of elements passed per second. With one CPU, both threads share it and the rate
+ * is limited by the thread switches.
+ *
+ * Build and run with make bench in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include "../inc/Ring_Buffer.h"
+
+#define ELEMENTS        20000000
+#define CAPACITY        1024
+#define BATCH           32
+
+#define MODE_SINGLE     0
+#define MODE_MULTIPLE   1
+#define MODE_SPAN       2
+
+static Ring_Buffer Ring;
+static uint32_t Storage[CAPACITY];
+static int Mode;
+static volatile uint32_t Checksum;
+
+static void *Producer(void *argument)
+{
+    uint32_t batch[BATCH];
+    uint32_t next = 0;
+    uint32_t count;
+    uint32_t i;
+    uint32_t *span;
+
+    while(next < ELEMENTS)
+    {
+        if (Mode == MODE_SINGLE)
+        {
+            count = Ring_Buffer_Push(&Ring, &next);
+        }
+        else if (Mode == MODE_MULTIPLE)
+        {
+            for (i = 0; i < BATCH; i++)
+            {
+                batch[i] = next + i;
+            }
+            count = Ring_Buffer_Push_Multiple(&Ring, batch, BATCH);
+        }
+        else
+        {
+            count = Ring_Buffer_Write_Span(&Ring, (void **)&span);
+            if (count > ELEMENTS - next)
+            {
+                count = ELEMENTS - next;
+            }
+            for (i = 0; i < count; i++)
+            {
+                span[i] = next + i;
+            }
+            Ring_Buffer_Commit(&Ring, count);
+        }
+
+        next += count;
+        if (count == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    return 0;
+}
+
+static void *Consumer(void *argument)
+{
+    uint32_t batch[BATCH];
+    uint32_t received = 0;
+    uint32_t sum = 0;
+    uint32_t count;
+    uint32_t i;
+    const uint32_t *span;
+
+    while(received < ELEMENTS)
+    {
+        if (Mode == MODE_SINGLE)
+        {
+            count = Ring_Buffer_Pop(&Ring, batch);
+            if (count)
+            {
+                sum += batch[0];
+            }
+        }
+        else if (Mode == MODE_MULTIPLE)
+        {
+            count = Ring_Buffer_Pop_Multiple(&Ring, batch, BATCH);
+            for (i = 0; i < count; i++)
+            {
+                sum += batch[i];
+            }
+        }
+        else
+        {
+            count = Ring_Buffer_Read_Span(&Ring, (const void **)&span);
+            for (i = 0; i < count; i++)
+            {
+                sum += span[i];
+            }
+            Ring_Buffer_Consume(&Ring, count);
+        }
+
+        received += count;
+        if (count == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    Checksum = sum;
+    return 0;
+}
+
+static double Run(int mode)
+{
+    pthread_t producer;
+    pthread_t consumer;
+    struct timespec start;
+    struct timespec end;
+    double seconds;
+
+    Mode = mode;
+    Ring_Buffer_Init(&Ring, Storage, sizeof(uint32_t), CAPACITY);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&consumer, 0, Consumer, 0);
+    pthread_create(&producer, 0, Producer, 0);
+    pthread_join(producer, 0);
+    pthread_join(consumer, 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    return ELEMENTS / seconds;
+}
+
+int main(void)
+{
+    // Sum of 0 to ELEMENTS - 1, modulo 2^32
+    uint32_t expected = (uint32_t)((uint64_t)ELEMENTS * (ELEMENTS - 1) / 2);
+    static const char *names[] = {"Push / Pop", "Push_Multiple / Pop_Multiple", "Write_Span / Read_Span"};
+    double rate;
+    int mode;
+
+    printf("Ring_Buffer: %d elements of 4 bytes, capacity %d, batches of %d\n", ELEMENTS, CAPACITY, BATCH);
+    for (mode = MODE_SINGLE; mode <= MODE_SPAN; mode++)
+    {
+        rate = Run(mode);
+        printf("  %-30s %8.1f M elements/s%s\n", names[mode], rate / 1e6, (Checksum == expected) ? "" : "  (checksum error)");
+        if (Checksum != expected)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
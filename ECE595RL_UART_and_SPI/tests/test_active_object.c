@@ -0,0 +1,352 @@
+/**
+ * @file test_active_object.c
+ * @brief Host test for the Active_Object framework, compiled with ACTIVE_OBJECT_HOST.
+ *
+ * The test checks the order of the entry, exit and initial actions of a hierarchical state machine, that the events
+ * of the higher priority active objects are dispatched first, that an event posted to a full queue is dropped and
+ * counted, and the single event and periodic timers. Active_Object_Run_Once and Active_Object_Tick run the events
+ * and the time in a fixed order.
+ *
+ * The active objects stay registered, so each test uses its own priorities.
+ *
+ * Build and run with make in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../inc/Active_Object.h"
+#include "Check.h"
+
+#define SIGNAL_A        (ACTIVE_OBJECT_SIGNAL_USER + 0)
+#define SIGNAL_B        (ACTIVE_OBJECT_SIGNAL_USER + 1)
+#define SIGNAL_C        (ACTIVE_OBJECT_SIGNAL_USER + 2)
+#define SIGNAL_D        (ACTIVE_OBJECT_SIGNAL_USER + 3)
+
+#define MAX_RECORDS     32
+
+// Actions of the state machine, as "S1-ENTRY S11-ENTRY ..."
+static char Log[512];
+
+/**
+ * @brief An active object that records the events it receives
+ */
+typedef struct
+{
+    Active_Object super;
+    uint8_t id;
+    Active_Object_Event records[MAX_RECORDS];
+    uint8_t count;
+} Recorder;
+
+// Order in which the events of all the recorders were dispatched, as the ids of the recorders
+static uint8_t Order[MAX_RECORDS];
+static uint8_t Order_Count;
+
+static void Log_Action(const char *state, const Active_Object_Event *e)
+{
+    static const char *names[] = {"EMPTY", "ENTRY", "EXIT", "INIT"};
+
+    snprintf(&Log[strlen(Log)], sizeof(Log) - strlen(Log), "%s%s-%s", Log[0] ? " " : "", state, names[e->signal]);
+}
+
+/*
+ * Hierarchy of the states:
+ *
+ *  Active_Object_Top
+ *  `- S (initial transition to S11)
+ *     |- S1
+ *     |  `- S11
+ *     `- S2
+ *        `- S21
+ */
+static uint8_t S(Active_Object *me, const Active_Object_Event *e);
+static uint8_t S1(Active_Object *me, const Active_Object_Event *e);
+static uint8_t S11(Active_Object *me, const Active_Object_Event *e);
+static uint8_t S2(Active_Object *me, const Active_Object_Event *e);
+static uint8_t S21(Active_Object *me, const Active_Object_Event *e);
+
+static uint8_t S(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:    Log_Action("S", e); return ACTIVE_OBJECT_HANDLED();
+        case ACTIVE_OBJECT_SIGNAL_EXIT:     Log_Action("S", e); return ACTIVE_OBJECT_HANDLED();
+        case ACTIVE_OBJECT_SIGNAL_INIT:     Log_Action("S", e); return ACTIVE_OBJECT_TRANSITION(S11);
+        case SIGNAL_C:                      return ACTIVE_OBJECT_TRANSITION(S);
+    }
+    return ACTIVE_OBJECT_SUPER(Active_Object_Top);
+}
+
+static uint8_t S1(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:    Log_Action("S1", e); return ACTIVE_OBJECT_HANDLED();
+        case ACTIVE_OBJECT_SIGNAL_EXIT:     Log_Action("S1", e); return ACTIVE_OBJECT_HANDLED();
+        case SIGNAL_A:                      return ACTIVE_OBJECT_TRANSITION(S21);
+    }
+    return ACTIVE_OBJECT_SUPER(S);
+}
+
+static uint8_t S11(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:    Log_Action("S11", e); return ACTIVE_OBJECT_HANDLED();
+        case ACTIVE_OBJECT_SIGNAL_EXIT:     Log_Action("S11", e); return ACTIVE_OBJECT_HANDLED();
+    }
+    return ACTIVE_OBJECT_SUPER(S1);
+}
+
+static uint8_t S2(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:    Log_Action("S2", e); return ACTIVE_OBJECT_HANDLED();
+        case ACTIVE_OBJECT_SIGNAL_EXIT:     Log_Action("S2", e); return ACTIVE_OBJECT_HANDLED();
+        case SIGNAL_A:                      return ACTIVE_OBJECT_TRANSITION(S11);
+    }
+    return ACTIVE_OBJECT_SUPER(S);
+}
+
+static uint8_t S21(Active_Object *me, const Active_Object_Event *e)
+{
+    switch(e->signal)
+    {
+        case ACTIVE_OBJECT_SIGNAL_ENTRY:    Log_Action("S21", e); return ACTIVE_OBJECT_HANDLED();
+        case ACTIVE_OBJECT_SIGNAL_EXIT:     Log_Action("S21", e); return ACTIVE_OBJECT_HANDLED();
+        case SIGNAL_B:                      return ACTIVE_OBJECT_TRANSITION(S21);
+    }
+    return ACTIVE_OBJECT_SUPER(S2);
+}
+
+/**
+ * @brief Single state of the recorders
+ */
+static uint8_t Recording(Active_Object *me, const Active_Object_Event *e)
+{
+    Recorder *recorder = (Recorder *)me;
+
+    if (e->signal >= ACTIVE_OBJECT_SIGNAL_USER)
+    {
+        if (recorder->count < MAX_RECORDS)
+        {
+            recorder->records[recorder->count++] = *e;
+        }
+        if (Order_Count < MAX_RECORDS)
+        {
+            Order[Order_Count++] = recorder->id;
+        }
+        return ACTIVE_OBJECT_HANDLED();
+    }
+    return ACTIVE_OBJECT_SUPER(Active_Object_Top);
+}
+
+static void Start_Recorder(Recorder *recorder, uint8_t id, uint8_t priority, Active_Object_Event *queue, uint8_t length)
+{
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->id = id;
+    CHECK(Active_Object_Start(&recorder->super, priority, queue, length, Recording) == 0);
+}
+
+static uint32_t Run_All()
+{
+    uint32_t count = 0;
+
+    while(Active_Object_Run_Once())
+    {
+        count++;
+    }
+    return count;
+}
+
+static void Test_Entry_Exit_Order()
+{
+    static Active_Object ao;
+    static Active_Object_Event queue[4];
+
+    // Entry of S, then the initial transition of S enters S1 and S11
+    Log[0] = 0;
+    CHECK(Active_Object_Start(&ao, 8, queue, 4, S) == 0);
+    CHECK(strcmp(Log, "S-ENTRY S-INIT S1-ENTRY S11-ENTRY") == 0);
+    CHECK(ao.state == S11);
+
+    // Handled by S1: exit up to the common parent S, then enter down to the target
+    Log[0] = 0;
+    Active_Object_Post(&ao, SIGNAL_A, 0);
+    CHECK(Run_All() == 1);
+    CHECK(strcmp(Log, "S11-EXIT S1-EXIT S2-ENTRY S21-ENTRY") == 0);
+    CHECK(ao.state == S21);
+
+    // A transition to the source state itself exits and enters it again
+    Log[0] = 0;
+    Active_Object_Post(&ao, SIGNAL_B, 0);
+    Run_All();
+    CHECK(strcmp(Log, "S21-EXIT S21-ENTRY") == 0);
+
+    // Handled by S2, above the current state S21
+    Log[0] = 0;
+    Active_Object_Post(&ao, SIGNAL_A, 0);
+    Run_All();
+    CHECK(strcmp(Log, "S21-EXIT S2-EXIT S1-ENTRY S11-ENTRY") == 0);
+    CHECK(ao.state == S11);
+
+    // Handled by the outermost state: everything is exited, then the initial transition is followed again
+    Log[0] = 0;
+    Active_Object_Post(&ao, SIGNAL_C, 0);
+    Run_All();
+    CHECK(strcmp(Log, "S11-EXIT S1-EXIT S-EXIT S-ENTRY S-INIT S1-ENTRY S11-ENTRY") == 0);
+
+    // Ignored by all the states
+    Log[0] = 0;
+    Active_Object_Post(&ao, SIGNAL_D, 0);
+    Run_All();
+    CHECK(Log[0] == 0);
+    CHECK(ao.state == S11);
+}
+
+static void Test_Priority_Order()
+{
+    static Recorder low;
+    static Recorder high;
+    static Active_Object_Event low_queue[8];
+    static Active_Object_Event high_queue[8];
+    static const uint8_t expected[] = {2, 2, 2, 1, 1, 1};
+    Recorder other;
+    uint8_t i;
+
+    Start_Recorder(&low, 1, 1, low_queue, 8);
+    Start_Recorder(&high, 2, 3, high_queue, 8);
+
+    // Priorities out of range or already used
+    CHECK(Active_Object_Start(&other.super, 0, low_queue, 8, Recording) == ACTIVE_OBJECT_ERROR_PRIORITY);
+    CHECK(Active_Object_Start(&other.super, ACTIVE_OBJECT_MAX_PRIORITY + 1, low_queue, 8, Recording)
+          == ACTIVE_OBJECT_ERROR_PRIORITY);
+    CHECK(Active_Object_Start(&other.super, 3, low_queue, 8, Recording) == ACTIVE_OBJECT_ERROR_PRIORITY);
+
+    // The events of the higher priority are all dispatched first, each queue in the order of the posts
+    Order_Count = 0;
+    for (i = 0; i < 3; i++)
+    {
+        Active_Object_Post(&low.super, SIGNAL_A, i);
+        Active_Object_Post(&high.super, SIGNAL_B, 10 + i);
+    }
+    CHECK(Run_All() == 6);
+    CHECK((Order_Count == 6) && (memcmp(Order, expected, sizeof(expected)) == 0));
+    for (i = 0; i < 3; i++)
+    {
+        CHECK(low.records[i].parameter == i);
+        CHECK(high.records[i].parameter == 10 + i);
+    }
+
+    // An event posted to the higher priority in between runs before the rest of the lower priority queue
+    Order_Count = 0;
+    Active_Object_Post(&low.super, SIGNAL_A, 3);
+    Active_Object_Post(&low.super, SIGNAL_A, 4);
+    CHECK(Active_Object_Run_Once() == 1);
+    Active_Object_Post(&high.super, SIGNAL_B, 13);
+    Run_All();
+    CHECK((Order_Count == 3) && (Order[0] == 1) && (Order[1] == 2) && (Order[2] == 1));
+    CHECK(Active_Object_Run_Once() == 0);
+}
+
+static void Test_Queue_Overflow()
+{
+    static Recorder recorder;
+    static Active_Object_Event queue[3];
+    uint16_t i;
+
+    Start_Recorder(&recorder, 3, 4, queue, 3);
+
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 0) == 0);
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 1) == 0);
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 2) == 0);
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 3) == ACTIVE_OBJECT_ERROR_FULL);
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 4) == ACTIVE_OBJECT_ERROR_FULL);
+    CHECK(recorder.super.dropped == 2);
+    CHECK(recorder.super.max_count == 3);
+
+    // One event out makes room for one more, which wraps around the end of the queue
+    CHECK(Active_Object_Run_Once() == 1);
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 5) == 0);
+    CHECK(Active_Object_Post(&recorder.super, SIGNAL_A, 6) == ACTIVE_OBJECT_ERROR_FULL);
+    CHECK(Run_All() == 3);
+
+    CHECK(recorder.count == 4);
+    for (i = 0; i < 3; i++)
+    {
+        CHECK(recorder.records[i].parameter == i);
+    }
+    CHECK(recorder.records[3].parameter == 5);
+    CHECK(recorder.super.dropped == 3);
+    CHECK(recorder.super.count == 0);
+}
+
+static void Test_Timers()
+{
+    static Recorder recorder;
+    static Active_Object_Event queue[8];
+    Active_Object_Timer once;
+    Active_Object_Timer periodic;
+    Active_Object_Timer soon;
+    uint8_t ticks[MAX_RECORDS];
+    uint8_t count = 0;
+    uint8_t tick;
+
+    Start_Recorder(&recorder, 4, 5, queue, 8);
+    Active_Object_Timer_Init(&once, &recorder.super, SIGNAL_A, 1);
+    Active_Object_Timer_Init(&periodic, &recorder.super, SIGNAL_B, 2);
+    Active_Object_Timer_Init(&soon, &recorder.super, SIGNAL_C, 3);
+
+    // A single event after 3 ticks, and a periodic event after 2 ticks then every 5 ticks.
+    // Starting a running timer again restarts it, without adding it twice to the list.
+    Active_Object_Timer_Start(&once, 3, 0);
+    Active_Object_Timer_Start(&periodic, 4, 5);
+    Active_Object_Timer_Start(&periodic, 2, 5);
+
+    // 0 ticks counts as 1 tick
+    Active_Object_Timer_Start(&soon, 0, 0);
+
+    for (tick = 1; tick <= 20; tick++)
+    {
+        Active_Object_Tick();
+        while(Active_Object_Run_Once())
+        {
+            ticks[count++] = tick;
+        }
+        if (tick == 12)
+        {
+            Active_Object_Timer_Stop(&periodic);
+        }
+    }
+
+    CHECK(recorder.count == 5);
+    CHECK((recorder.records[0].signal == SIGNAL_C) && (ticks[0] == 1));
+    CHECK((recorder.records[1].signal == SIGNAL_B) && (ticks[1] == 2));
+    CHECK((recorder.records[2].signal == SIGNAL_A) && (recorder.records[2].parameter == 1) && (ticks[2] == 3));
+    CHECK((recorder.records[3].signal == SIGNAL_B) && (recorder.records[3].parameter == 2) && (ticks[3] == 7));
+    CHECK((recorder.records[4].signal == SIGNAL_B) && (ticks[4] == 12));
+
+    // A stopped timer can be stopped again, and started again
+    Active_Object_Timer_Stop(&periodic);
+    Active_Object_Timer_Start(&once, 2, 0);
+    Active_Object_Tick();
+    CHECK(Run_All() == 0);
+    Active_Object_Tick();
+    CHECK(Run_All() == 1);
+    Active_Object_Tick();
+    CHECK(Run_All() == 0);
+}
+
+int main(void)
+{
+    Test_Entry_Exit_Order();
+    Test_Priority_Order();
+    Test_Queue_Overflow();
+    Test_Timers();
+
+    return Check_Result("test_active_object");
+}
@@ -0,0 +1,386 @@
+/**
+ * @file test_block_log.c
+ * @brief Host test for the Block_Log driver.
+ *
+ * The log is written to a simulated device in RAM. The device can be armed to lose power after a number of blocks:
+ * the write in progress stops in the middle of a block (the rest of that block keeps its old contents) and every
+ * later write fails. The log is then mounted again, as after a reset, and read back with an independent reader
+ * of the format described in inc/Block_Log.h. The test checks that:
+ *  - Every byte read back was appended, in order, and each run starts with BLOCK_LOG_RUN_START.
+ *  - No byte of a completely written block is lost.
+ *  - The next run starts in the block after the recovered end.
+ *
+ * Build and run with make in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../inc/Block_Log.h"
+#include "Check.h"
+
+#define DEVICE_BLOCKS   256
+#define MAX_RUNS        8
+
+static uint8_t Device_Memory[DEVICE_BLOCKS * BLOCK_LOG_BLOCK_SIZE];
+static int Power_Blocks;        // Blocks that can still be written before the power cut, or -1
+static uint16_t Torn_Bytes;     // Bytes of the block in progress written at the power cut
+static uint8_t Power_Lost;
+static uint32_t Durable_Blocks; // Highest block + 1 written completely with a full payload
+
+static int RAM_Read_Block(uint32_t block, uint8_t *data)
+{
+    if (Power_Lost || (block >= DEVICE_BLOCKS))
+    {
+        return -1;
+    }
+    memcpy(data, &Device_Memory[block * BLOCK_LOG_BLOCK_SIZE], BLOCK_LOG_BLOCK_SIZE);
+    return 0;
+}
+
+static int RAM_Write_Blocks(uint32_t block, const uint8_t *data, uint16_t count)
+{
+    uint16_t used;
+
+    if (Power_Lost || ((block + count) > DEVICE_BLOCKS))
+    {
+        return -1;
+    }
+
+    while(count--)
+    {
+        if (Power_Blocks == 0)
+        {
+            memcpy(&Device_Memory[block * BLOCK_LOG_BLOCK_SIZE], data, Torn_Bytes);
+            Power_Lost = 1;
+            return -1;
+        }
+        if (Power_Blocks > 0)
+        {
+            Power_Blocks--;
+        }
+
+        memcpy(&Device_Memory[block * BLOCK_LOG_BLOCK_SIZE], data, BLOCK_LOG_BLOCK_SIZE);
+        used = (data[12] | (data[13] << 8)) & ~BLOCK_LOG_RUN_START;
+        if ((block > 0) && (used == BLOCK_LOG_PAYLOAD_SIZE) && (block + 1 > Durable_Blocks))
+        {
+            Durable_Blocks = block + 1;
+        }
+        block++;
+        data += BLOCK_LOG_BLOCK_SIZE;
+    }
+
+    return 0;
+}
+
+static const Block_Log_Device RAM_Device = {DEVICE_BLOCKS, RAM_Read_Block, RAM_Write_Blocks};
+
+static void Power_On()
+{
+    Power_Blocks = -1;
+    Power_Lost = 0;
+}
+
+static void Power_Cut_After(int blocks, uint16_t torn_bytes)
+{
+    Power_Blocks = blocks;
+    Torn_Bytes = torn_bytes;
+}
+
+/**
+ * @brief The log read back by the reader: the payload of all the runs and the offset where each run starts.
+ */
+typedef struct
+{
+    uint8_t payload[DEVICE_BLOCKS * BLOCK_LOG_PAYLOAD_SIZE];
+    uint32_t length;
+    uint32_t run_offset[MAX_RUNS];
+    int runs;
+} Log_Contents;
+
+static Log_Contents Contents;
+
+static uint16_t Reader_CRC16(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    int bit;
+
+    while(length--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t Reader_U32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/**
+ * @brief Reads the log from the device memory, like tools/block_log_reader.py.
+ */
+static void Read_Log(Log_Contents *contents)
+{
+    const uint8_t *data;
+    uint32_t log_id = Reader_U32(&Device_Memory[4]);
+    uint32_t block;
+    uint16_t used;
+
+    contents->length = 0;
+    contents->runs = 0;
+
+    for (block = 1; block < DEVICE_BLOCKS; block++)
+    {
+        data = &Device_Memory[block * BLOCK_LOG_BLOCK_SIZE];
+        used = (data[12] | (data[13] << 8)) & ~BLOCK_LOG_RUN_START;
+        if ((Reader_U32(&data[0]) != BLOCK_LOG_MAGIC) || (Reader_U32(&data[4]) != log_id)
+            || (Reader_U32(&data[8]) != block) || (used > BLOCK_LOG_PAYLOAD_SIZE)
+            || ((data[14] | (data[15] << 8)) != Reader_CRC16(Reader_CRC16(0xFFFF, data, 14), &data[BLOCK_LOG_HEADER_SIZE], used)))
+        {
+            break;
+        }
+
+        if (data[13] & (BLOCK_LOG_RUN_START >> 8))
+        {
+            if (contents->runs < MAX_RUNS)
+            {
+                contents->run_offset[contents->runs] = contents->length;
+            }
+            contents->runs++;
+        }
+        else if ((block == 1) || (used == 0))
+        {
+            // The first block starts a run, and only the last block of a run may be partly filled
+            contents->runs = -1;
+            return;
+        }
+
+        memcpy(&contents->payload[contents->length], &data[BLOCK_LOG_HEADER_SIZE], used);
+        contents->length += used;
+    }
+}
+
+/**
+ * @brief Byte number i of the stream appended by the tests
+ */
+static uint8_t Stream_Byte(uint32_t i)
+{
+    return (uint8_t)((i * 2654435761u) >> 24);
+}
+
+/**
+ * @brief Appends length bytes of the stream, starting at byte *position, in pieces of random sizes,
+ *        with a flush every few pieces. Stops at the first error. *position is moved past the appended bytes.
+ *
+ * @return 0, or the error of Block_Log_Append or Block_Log_Flush
+ */
+static int Append_Stream(uint32_t *position, uint32_t length)
+{
+    uint8_t piece[1500];
+    uint32_t size;
+    uint32_t i;
+    int result;
+
+    while(length > 0)
+    {
+        size = 1 + (rand() % sizeof(piece));
+        if (size > length)
+        {
+            size = length;
+        }
+        for (i = 0; i < size; i++)
+        {
+            piece[i] = Stream_Byte(*position + i);
+        }
+
+        // The position counts the bytes of a failed call too, since some of them may have reached the device
+        *position += size;
+        length -= size;
+        result = Block_Log_Append(piece, size);
+        if (result < 0)
+        {
+            return result;
+        }
+
+        if ((rand() % 4) == 0)
+        {
+            result = Block_Log_Flush();
+            if (result < 0)
+            {
+                return result;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void Test_Append_And_Mount()
+{
+    Block_Log_Stats stats;
+    uint32_t position = 0;
+    uint32_t i;
+    uint8_t equal = 1;
+
+    Power_On();
+    memset(Device_Memory, 0xFF, sizeof(Device_Memory));
+
+    CHECK(Block_Log_Mount(&RAM_Device) == BLOCK_LOG_ERROR_NO_LOG);
+    CHECK(Block_Log_Append("x", 1) == BLOCK_LOG_ERROR_NOT_MOUNTED);
+
+    CHECK(Block_Log_Format(&RAM_Device) == 0);
+    CHECK(Append_Stream(&position, 20000) == 0);
+    CHECK(Block_Log_Flush() == 0);
+
+    Block_Log_Get_Stats(&stats);
+    CHECK(stats.bytes == 20000);
+    CHECK(stats.buffered == 0);
+    CHECK(stats.blocks == 1 + (20000 + BLOCK_LOG_PAYLOAD_SIZE - 1) / BLOCK_LOG_PAYLOAD_SIZE);
+
+    Read_Log(&Contents);
+    CHECK(Contents.runs == 1);
+    CHECK(Contents.length == 20000);
+    for (i = 0; i < Contents.length; i++)
+    {
+        equal &= (Contents.payload[i] == Stream_Byte(i));
+    }
+    CHECK(equal);
+
+    // A second run starts in the block after the end of the first one
+    CHECK(Block_Log_Mount(&RAM_Device) == 0);
+    Block_Log_Get_Stats(&stats);
+    CHECK(stats.blocks == 1 + (20000 + BLOCK_LOG_PAYLOAD_SIZE - 1) / BLOCK_LOG_PAYLOAD_SIZE);
+    CHECK(Append_Stream(&position, 3000) == 0);
+    CHECK(Block_Log_Flush() == 0);
+
+    Read_Log(&Contents);
+    CHECK(Contents.runs == 2);
+    CHECK(Contents.length == 23000);
+    CHECK(Contents.run_offset[1] == 20000);
+    for (i = 0; i < Contents.length; i++)
+    {
+        equal &= (Contents.payload[i] == Stream_Byte(i));
+    }
+    CHECK(equal);
+
+    // Formatting again starts an empty log, and the blocks of the previous log are not read
+    CHECK(Block_Log_Format(&RAM_Device) == 0);
+    Read_Log(&Contents);
+    CHECK(Contents.runs == 0);
+    CHECK(Contents.length == 0);
+    CHECK(Block_Log_Mount(&RAM_Device) == 0);
+    Block_Log_Get_Stats(&stats);
+    CHECK(stats.blocks == 1);
+}
+
+static void Test_Device_Full()
+{
+    static uint8_t data[DEVICE_BLOCKS * BLOCK_LOG_PAYLOAD_SIZE];
+    Block_Log_Stats stats;
+    uint32_t capacity = (DEVICE_BLOCKS - 1) * BLOCK_LOG_PAYLOAD_SIZE;
+
+    Power_On();
+    memset(Device_Memory, 0xFF, sizeof(Device_Memory));
+
+    CHECK(Block_Log_Format(&RAM_Device) == 0);
+    CHECK(Block_Log_Append(data, capacity - 10) == 0);
+
+    // A record that does not fit is not appended at all
+    CHECK(Block_Log_Append_Record(1, data, 7) == BLOCK_LOG_ERROR_FULL);
+    CHECK(Block_Log_Append_Record(1, data, 6) == 0);
+    CHECK(Block_Log_Append_Record(1, data, 0x10000) == BLOCK_LOG_ERROR_LENGTH);
+    CHECK(Block_Log_Append(data, 1) == BLOCK_LOG_ERROR_FULL);
+    CHECK(Block_Log_Flush() == 0);
+
+    Block_Log_Get_Stats(&stats);
+    CHECK(stats.bytes == capacity);
+    CHECK(stats.blocks == DEVICE_BLOCKS);
+
+    Read_Log(&Contents);
+    CHECK(Contents.length == capacity);
+
+    // Mounting a full log succeeds, but nothing more can be appended
+    CHECK(Block_Log_Mount(&RAM_Device) == 0);
+    CHECK(Block_Log_Append(data, 1) == BLOCK_LOG_ERROR_FULL);
+}
+
+/**
+ * @brief Cuts the power after each number of blocks, with torn blocks of different sizes, then mounts the log again.
+ */
+static void Test_Power_Cut()
+{
+    static const uint16_t torn_sizes[] = {0, 1, 14, 16, 300, BLOCK_LOG_BLOCK_SIZE - 1};
+    Block_Log_Stats stats;
+    uint32_t position;
+    uint32_t first_run;
+    uint32_t i;
+    uint8_t equal;
+    int blocks;
+    int t;
+
+    for (blocks = 0; blocks < 80; blocks++)
+    {
+        for (t = 0; t < (int)(sizeof(torn_sizes) / sizeof(torn_sizes[0])); t++)
+        {
+            srand(blocks * 31 + t);
+            Power_On();
+            memset(Device_Memory, 0xFF, sizeof(Device_Memory));
+            CHECK(Block_Log_Format(&RAM_Device) == 0);
+            Durable_Blocks = 1;
+
+            // Append until the power is lost
+            position = 0;
+            Power_Cut_After(blocks, torn_sizes[t]);
+            CHECK(Append_Stream(&position, 100000) == BLOCK_LOG_ERROR_DEVICE);
+            CHECK(Power_Lost);
+
+            // Reset: the log is mounted again and holds a prefix of the stream, with every durable block
+            Power_On();
+            CHECK(Block_Log_Mount(&RAM_Device) == 0);
+            Read_Log(&Contents);
+            CHECK(Contents.runs <= 1);
+            CHECK(Contents.length >= (Durable_Blocks - 1) * BLOCK_LOG_PAYLOAD_SIZE);
+            CHECK(Contents.length <= position);
+            equal = 1;
+            for (i = 0; i < Contents.length; i++)
+            {
+                equal &= (Contents.payload[i] == Stream_Byte(i));
+            }
+            CHECK(equal);
+            first_run = Contents.length;
+
+            // A new run is appended after the recovered end
+            Block_Log_Get_Stats(&stats);
+            CHECK(stats.blocks == 1 + (first_run + BLOCK_LOG_PAYLOAD_SIZE - 1) / BLOCK_LOG_PAYLOAD_SIZE);
+            position = first_run;
+            CHECK(Append_Stream(&position, 5000) == 0);
+            CHECK(Block_Log_Flush() == 0);
+
+            Read_Log(&Contents);
+            CHECK(Contents.runs == ((first_run > 0) ? 2 : 1));
+            CHECK(Contents.length == first_run + 5000);
+            CHECK(Contents.run_offset[Contents.runs - 1] == first_run);
+            equal = 1;
+            for (i = 0; i < Contents.length; i++)
+            {
+                equal &= (Contents.payload[i] == Stream_Byte(i));
+            }
+            CHECK(equal);
+        }
+    }
+}
+
+int main(void)
+{
+    Test_Append_And_Mount();
+    Test_Device_Full();
+    Test_Power_Cut();
+
+    return Check_Result("test_block_log");
+}
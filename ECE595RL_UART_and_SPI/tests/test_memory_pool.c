@@ -0,0 +1,154 @@
+/**
+ * @file test_memory_pool.c
+ * @brief Host test for the Memory_Pool library, compiled with MEMORY_POOL_HOST and the default size classes.
+ *
+ * The test checks the class chosen for each size, the fallback to a larger class when a class is empty,
+ * exhaustion of all the classes, the reference counts, that releasing a block too many times is ignored,
+ * and that no block is handed out twice.
+ *
+ * Build and run with make in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <string.h>
+#include "../inc/Memory_Pool.h"
+#include "Check.h"
+
+#define TOTAL_BLOCKS    (MEMORY_POOL_CLASS_0_COUNT + MEMORY_POOL_CLASS_1_COUNT + MEMORY_POOL_CLASS_2_COUNT)
+
+static uint32_t In_Use(uint8_t size_class)
+{
+    Memory_Pool_Stats stats;
+
+    Memory_Pool_Get_Stats(size_class, &stats);
+    return stats.in_use;
+}
+
+static void Test_Size_Classes()
+{
+    void *block;
+
+    Memory_Pool_Init();
+
+    block = Memory_Pool_Alloc(0);
+    CHECK(block != 0);
+    CHECK(Memory_Pool_Block_Size(block) == MEMORY_POOL_CLASS_0_SIZE);
+    CHECK(((uintptr_t)block % 8) == 0);
+    Memory_Pool_Release(block);
+
+    block = Memory_Pool_Alloc(MEMORY_POOL_CLASS_0_SIZE + 1);
+    CHECK(Memory_Pool_Block_Size(block) == MEMORY_POOL_CLASS_1_SIZE);
+    Memory_Pool_Release(block);
+
+    block = Memory_Pool_Alloc(MEMORY_POOL_CLASS_2_SIZE);
+    CHECK(Memory_Pool_Block_Size(block) == MEMORY_POOL_CLASS_2_SIZE);
+    Memory_Pool_Release(block);
+
+    CHECK(Memory_Pool_Alloc(MEMORY_POOL_CLASS_2_SIZE + 1) == 0);
+    CHECK(In_Use(0) + In_Use(1) + In_Use(2) == 0);
+}
+
+static void Test_Fallback_And_Exhaustion()
+{
+    static void *blocks[TOTAL_BLOCKS + 1];
+    Memory_Pool_Stats stats;
+    uint32_t count = 0;
+    uint32_t i;
+    uint32_t j;
+    uint8_t distinct = 1;
+
+    Memory_Pool_Init();
+
+    // Small requests use class 0, then fall back to class 1 and class 2
+    while((blocks[count] = Memory_Pool_Alloc(1)) != 0)
+    {
+        memset(blocks[count], (int)count, Memory_Pool_Block_Size(blocks[count]));
+        count++;
+        if (count > TOTAL_BLOCKS)
+        {
+            break;
+        }
+    }
+    CHECK(count == TOTAL_BLOCKS);
+
+    Memory_Pool_Get_Stats(0, &stats);
+    CHECK(stats.in_use == MEMORY_POOL_CLASS_0_COUNT);
+    CHECK(stats.high_water == MEMORY_POOL_CLASS_0_COUNT);
+    CHECK(stats.allocations == MEMORY_POOL_CLASS_0_COUNT);
+    CHECK(stats.fallbacks == MEMORY_POOL_CLASS_1_COUNT + MEMORY_POOL_CLASS_2_COUNT);
+    CHECK(stats.failures == 1);
+    CHECK(In_Use(1) == MEMORY_POOL_CLASS_1_COUNT);
+    CHECK(In_Use(2) == MEMORY_POOL_CLASS_2_COUNT);
+
+    // No block was handed out twice, and no block overlaps another one
+    for (i = 0; i < count; i++)
+    {
+        for (j = i + 1; j < count; j++)
+        {
+            distinct &= (blocks[i] != blocks[j]);
+        }
+        distinct &= (((uint8_t *)blocks[i])[Memory_Pool_Block_Size(blocks[i]) - 1] == (uint8_t)i);
+    }
+    CHECK(distinct);
+
+    // A large request fails, and is counted in its own class
+    CHECK(Memory_Pool_Alloc(MEMORY_POOL_CLASS_2_SIZE) == 0);
+    Memory_Pool_Get_Stats(2, &stats);
+    CHECK(stats.failures == 1);
+
+    // A released block is used again by the next request that fits
+    Memory_Pool_Release(blocks[TOTAL_BLOCKS - 1]);
+    CHECK(Memory_Pool_Alloc(MEMORY_POOL_CLASS_2_SIZE) == blocks[TOTAL_BLOCKS - 1]);
+
+    for (i = 0; i < count; i++)
+    {
+        Memory_Pool_Release(blocks[i]);
+    }
+    CHECK(In_Use(0) + In_Use(1) + In_Use(2) == 0);
+    Memory_Pool_Get_Stats(0, &stats);
+    CHECK(stats.high_water == MEMORY_POOL_CLASS_0_COUNT);
+}
+
+static void Test_References()
+{
+    void *block;
+    void *other;
+
+    Memory_Pool_Init();
+
+    block = Memory_Pool_Alloc(100);
+    CHECK(Memory_Pool_Retain(block) == block);
+    Memory_Pool_Retain(block);
+
+    // The block stays allocated until the last of its three references is released
+    Memory_Pool_Release(block);
+    Memory_Pool_Release(block);
+    CHECK(In_Use(1) == 1);
+    Memory_Pool_Release(block);
+    CHECK(In_Use(1) == 0);
+
+    // Releasing it again is ignored: the free list is not corrupted and the count does not go below 0
+    Memory_Pool_Release(block);
+    Memory_Pool_Release(0);
+    CHECK(In_Use(1) == 0);
+
+    block = Memory_Pool_Alloc(100);
+    other = Memory_Pool_Alloc(100);
+    CHECK(block != other);
+    CHECK(In_Use(1) == 2);
+
+    Memory_Pool_Release(block);
+    Memory_Pool_Release(other);
+    CHECK(In_Use(1) == 0);
+}
+
+int main(void)
+{
+    Test_Size_Classes();
+    Test_Fallback_And_Exhaustion();
+    Test_References();
+
+    return Check_Result("test_memory_pool");
+}
@@ -0,0 +1,429 @@
+/**
+ * @file test_number_parser.c
+ * @brief Fuzz test of the Number_Parser library against strtoull and strtoll.
+ *
+ * Lines of random tokens are generated for each format: valid numbers (with signs, prefixes, leading zeros
+ * and values around the limits of the format) mixed with tokens that hold other characters. Each line is parsed
+ * twice, one character at a time with Number_Parser_Feed and at once with Number_Parser_Parse.
+ *
+ * The reference checks the syntax of each token with a scan of the grammar given in inc/Number_Parser.h and
+ * converts the digits with strtoull or strtoll. A token whose digits exceed the range of the format before its
+ * first invalid character must give NUMBER_PARSER_ERROR_OVERFLOW, because the parser reports the overflow
+ * at the digit that causes it.
+ *
+ * Build and run with make in this directory. The number of lines per format can be given as an argument.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../inc/Number_Parser.h"
+#include "Check.h"
+
+#define MAX_TOKENS          8
+#define MAX_TOKEN_LENGTH    40
+#define MAX_LINE_LENGTH     (MAX_TOKENS * (MAX_TOKEN_LENGTH + 2))
+
+static uint32_t Random_State = 2463534242u;
+
+static uint32_t Random()
+{
+    Random_State ^= Random_State << 13;
+    Random_State ^= Random_State >> 17;
+    Random_State ^= Random_State << 5;
+    return Random_State;
+}
+
+/**
+ * @brief Expected result of one token: NUMBER_PARSER_DONE and a value, or an error code
+ */
+typedef struct
+{
+    int result;
+    uint32_t value;
+} Expected;
+
+static uint8_t Is_Digit_Of(char character, uint8_t base)
+{
+    if (base == 2)
+    {
+        return (character == '0') || (character == '1');
+    }
+    if (base == 16)
+    {
+        return ((character >= '0') && (character <= '9')) || ((character >= 'a') && (character <= 'f'))
+               || ((character >= 'A') && (character <= 'F'));
+    }
+    return (character >= '0') && (character <= '9');
+}
+
+/**
+ * @brief Converts a string of digits with strtoull and checks it against a limit.
+ *
+ * @return 1 if the value is above the limit
+ */
+static uint8_t Exceeds(const char *digits, uint8_t base, uint64_t limit, uint64_t *value)
+{
+    errno = 0;
+    *value = strtoull(digits, 0, base);
+    return (errno == ERANGE) || (*value > limit);
+}
+
+/**
+ * @brief Computes the expected result of a token with the grammar of each format and strtoull / strtoll.
+ */
+static Expected Reference(uint8_t format, uint8_t decimals, const char *token, int length)
+{
+    static const uint8_t bases[5] = {10, 10, 16, 2, 10};
+    uint8_t base = bases[format];
+    char digits[MAX_TOKEN_LENGTH + NUMBER_PARSER_MAX_DECIMALS + 1];
+    char number[MAX_TOKEN_LENGTH + NUMBER_PARSER_MAX_DECIMALS + 2];
+    int num_digits = 0;
+    int integer_digits = 0;
+    int fraction_digits = 0;
+    int prefix = 0;
+    int negative = 0;
+    int point = 0;
+    int i = 0;
+    uint64_t limit;
+    uint64_t magnitude;
+    long long value;
+    Expected expected = {NUMBER_PARSER_ERROR_SYNTAX, 0};
+
+    // Sign: '+' for the decimal formats, '-' for the signed ones
+    if ((i < length) && (base == 10) && ((token[i] == '+')
+        || ((token[i] == '-') && ((format == NUMBER_PARSER_SIGNED) || (format == NUMBER_PARSER_FIXED)))))
+    {
+        negative = (token[i] == '-');
+        i++;
+    }
+
+    // 0x or 0b prefix after a single leading zero
+    if ((length >= 2) && (token[0] == '0')
+        && (((format == NUMBER_PARSER_HEX) && ((token[1] | 0x20) == 'x'))
+            || ((format == NUMBER_PARSER_BINARY) && ((token[1] | 0x20) == 'b'))))
+    {
+        i = 2;
+        prefix = 1;
+    }
+
+    // Digits, and the decimal point of a fixed-point number. Fractional digits beyond the decimals are dropped.
+    for (; i < length; i++)
+    {
+        if (Is_Digit_Of(token[i], base))
+        {
+            if (point)
+            {
+                fraction_digits++;
+                if (fraction_digits > decimals)
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                integer_digits++;
+            }
+            digits[num_digits++] = token[i];
+        }
+        else if ((token[i] == '.') && (format == NUMBER_PARSER_FIXED) && !point)
+        {
+            point = 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+    digits[num_digits] = 0;
+
+    if ((format == NUMBER_PARSER_SIGNED) || (format == NUMBER_PARSER_FIXED))
+    {
+        limit = negative ? 0x80000000u : 0x7FFFFFFFu;
+    }
+    else
+    {
+        limit = 0xFFFFFFFFu;
+    }
+
+    // The digits before the first invalid character overflow first
+    if ((num_digits > 0) && Exceeds(digits, base, limit, &magnitude))
+    {
+        expected.result = NUMBER_PARSER_ERROR_OVERFLOW;
+        return expected;
+    }
+
+    // An invalid character, a sign or a prefix without digits, or a lone decimal point
+    if ((i < length) || ((integer_digits + fraction_digits) == 0) || (prefix && (integer_digits == 0)))
+    {
+        return expected;
+    }
+
+    expected.result = NUMBER_PARSER_DONE;
+    switch(format)
+    {
+        case NUMBER_PARSER_SIGNED:
+        {
+            snprintf(number, sizeof(number), "%s%s", negative ? "-" : "", digits);
+            errno = 0;
+            value = strtoll(number, 0, 10);
+            expected.value = (uint32_t)(int32_t)value;
+            break;
+        }
+        case NUMBER_PARSER_FIXED:
+        {
+            // Append the missing decimal places, then convert the number of units of 10^-decimals
+            while(fraction_digits < decimals)
+            {
+                digits[num_digits++] = '0';
+                fraction_digits++;
+            }
+            digits[num_digits] = 0;
+            snprintf(number, sizeof(number), "%s%s", negative ? "-" : "", digits);
+            errno = 0;
+            value = strtoll(number, 0, 10);
+            if ((errno == ERANGE) || (value > 0x7FFFFFFFLL) || (value < -0x80000000LL))
+            {
+                expected.result = NUMBER_PARSER_ERROR_OVERFLOW;
+            }
+            expected.value = (uint32_t)(int32_t)value;
+            break;
+        }
+        default:
+        {
+            expected.value = (uint32_t)strtoull(digits, 0, base);
+            break;
+        }
+    }
+
+    return expected;
+}
+
+/**
+ * @brief Appends a random token to a line and returns its length
+ */
+static int Generate_Token(uint8_t format, char *token)
+{
+    static const char *alphabet = "0123456789abcdefABCDEFxXbB+-.gZ_/";
+    static const char *limits[] = {
+        "4294967295", "4294967296", "2147483647", "2147483648", "2147483649", "99999999999",
+        "FFFFFFFF", "100000000", "11111111111111111111111111111111", "111111111111111111111111111111111",
+        "0000000000000000000000042", "21474836.47", "21474836.48", "214748.3648", "-0"
+    };
+    static const char *digit_sets[5] = {"0123456789", "0123456789", "0123456789abcdefABCDEF", "01", "0123456789"};
+    const char *digit_set = digit_sets[format];
+    int set_length = strlen(digit_set);
+    int length = 0;
+    int count;
+    int i;
+
+    switch(Random() % 8)
+    {
+        case 0:
+        {
+            // Random characters
+            count = 1 + Random() % 12;
+            for (i = 0; i < count; i++)
+            {
+                token[length++] = alphabet[Random() % strlen(alphabet)];
+            }
+            break;
+        }
+        case 1:
+        {
+            // Values around the limits, possibly with a sign or a wrong last character
+            strcpy(token, limits[Random() % (sizeof(limits) / sizeof(limits[0]))]);
+            length = strlen(token);
+            if ((Random() % 4) == 0)
+            {
+                memmove(&token[1], token, length + 1);
+                token[0] = "+-"[Random() % 2];
+                length++;
+            }
+            if ((Random() % 8) == 0)
+            {
+                token[length - 1] = alphabet[Random() % strlen(alphabet)];
+            }
+            break;
+        }
+        default:
+        {
+            // A number of the format: sign, prefix, digits and decimal point
+            if ((Random() % 4) == 0)
+            {
+                token[length++] = "+-"[Random() % 2];
+            }
+            if (((format == NUMBER_PARSER_HEX) || (format == NUMBER_PARSER_BINARY)) && ((Random() % 2) == 0))
+            {
+                token[length++] = '0';
+                token[length++] = (format == NUMBER_PARSER_HEX) ? "xX"[Random() % 2] : "bB"[Random() % 2];
+            }
+            count = Random() % ((format == NUMBER_PARSER_BINARY) ? 34 : 12);
+            for (i = 0; i < count; i++)
+            {
+                token[length++] = digit_set[Random() % set_length];
+            }
+            if ((format == NUMBER_PARSER_FIXED) && ((Random() % 2) == 0))
+            {
+                token[length++] = '.';
+                count = Random() % 12;
+                for (i = 0; i < count; i++)
+                {
+                    token[length++] = digit_set[Random() % set_length];
+                }
+            }
+            if (length == 0)
+            {
+                token[length++] = digit_set[Random() % set_length];
+            }
+            break;
+        }
+    }
+
+    return length;
+}
+
+/**
+ * @brief Generates lines of tokens for one format and compares both parsing modes with the reference.
+ */
+static void Fuzz(uint8_t format, uint8_t decimals, uint32_t lines)
+{
+    static const char delimiters[] = " ,;\t\r\n";
+    Number_Parser parser;
+    char line[MAX_LINE_LENGTH];
+    Expected expected[MAX_TOKENS];
+    uint32_t values[MAX_TOKENS];
+    uint32_t value;
+    int32_t count;
+    int num_tokens;
+    int length;
+    int token_length;
+    int results;
+    int result;
+    int first_error;
+    int mismatches = 0;
+    int t;
+    int i;
+
+    CHECK(Number_Parser_Init(&parser, format, decimals) == 0);
+
+    while(lines--)
+    {
+        // Build a line of tokens separated by one or more delimiters
+        num_tokens = 1 + Random() % MAX_TOKENS;
+        length = 0;
+        first_error = -1;
+        for (t = 0; t < num_tokens; t++)
+        {
+            token_length = Generate_Token(format, &line[length]);
+            expected[t] = Reference(format, decimals, &line[length], token_length);
+            if ((first_error < 0) && (expected[t].result != NUMBER_PARSER_DONE))
+            {
+                first_error = t;
+            }
+            length += token_length;
+            do
+            {
+                line[length++] = delimiters[Random() % (sizeof(delimiters) - 1)];
+            } while((Random() % 4) == 0);
+        }
+
+        // One character at a time: each token gives one value or one error
+        results = 0;
+        for (i = 0; i < length; i++)
+        {
+            result = Number_Parser_Feed(&parser, line[i], &value);
+            if (result == NUMBER_PARSER_MORE)
+            {
+                continue;
+            }
+            if ((results >= num_tokens) || (result != expected[results].result)
+                || ((result == NUMBER_PARSER_DONE) && (value != expected[results].value)))
+            {
+                mismatches++;
+                if ((mismatches <= 10) && (results < num_tokens))
+                {
+                    printf("format %d: feed mismatch in \"%.*s\" at token %d: %d %u, expected %d %u\n", format, length - 1,
+                           line, results, result, value, expected[results].result, expected[results].value);
+                }
+            }
+            results++;
+        }
+        if (results != num_tokens)
+        {
+            mismatches++;
+        }
+
+        // The whole line at once: the values up to the first error, then the error
+        count = Number_Parser_Parse(&parser, line, length, values, MAX_TOKENS);
+        if (first_error >= 0)
+        {
+            if (count != expected[first_error].result)
+            {
+                mismatches++;
+            }
+        }
+        else if (count != num_tokens)
+        {
+            mismatches++;
+        }
+        for (t = 0; (t < num_tokens) && (t != first_error); t++)
+        {
+            if (values[t] != expected[t].value)
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    CHECK(mismatches == 0);
+}
+
+static void Test_Examples()
+{
+    Number_Parser parser;
+    uint32_t values[4];
+
+    CHECK(Number_Parser_Init(&parser, NUMBER_PARSER_FIXED, NUMBER_PARSER_MAX_DECIMALS + 1) == NUMBER_PARSER_ERROR_FORMAT);
+    CHECK(Number_Parser_Init(&parser, NUMBER_PARSER_FIXED + 1, 0) == NUMBER_PARSER_ERROR_FORMAT);
+
+    Number_Parser_Init(&parser, NUMBER_PARSER_FIXED, 3);
+    CHECK(Number_Parser_Parse(&parser, "12.5,-0.0019 .5", 15, values, 4) == 3);
+    CHECK(values[0] == 12500);
+    CHECK((int32_t)values[1] == -1);
+    CHECK(values[2] == 500);
+
+    Number_Parser_Init(&parser, NUMBER_PARSER_SIGNED, 0);
+    CHECK(Number_Parser_Parse(&parser, "-2147483648 2147483648", 22, values, 4) == NUMBER_PARSER_ERROR_OVERFLOW);
+    CHECK(values[0] == 0x80000000);
+
+    // Parsing stops at max_values, and the rest of the line is dropped
+    Number_Parser_Init(&parser, NUMBER_PARSER_HEX, 0);
+    CHECK(Number_Parser_Parse(&parser, "0x1F ff 7", 9, values, 2) == 2);
+    CHECK(values[0] == 0x1F);
+    CHECK(values[1] == 0xFF);
+    CHECK(Number_Parser_Parse(&parser, "0x", 2, values, 2) == NUMBER_PARSER_ERROR_SYNTAX);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t lines = (argc > 1) ? strtoul(argv[1], 0, 10) : 40000;
+    uint8_t decimals;
+
+    Test_Examples();
+
+    Fuzz(NUMBER_PARSER_UNSIGNED, 0, lines);
+    Fuzz(NUMBER_PARSER_SIGNED, 0, lines);
+    Fuzz(NUMBER_PARSER_HEX, 0, lines);
+    Fuzz(NUMBER_PARSER_BINARY, 0, lines);
+    for (decimals = 0; decimals <= NUMBER_PARSER_MAX_DECIMALS; decimals++)
+    {
+        Fuzz(NUMBER_PARSER_FIXED, decimals, lines / 4);
+    }
+
+    return Check_Result("test_number_parser");
+}
@@ -0,0 +1,129 @@
+/**
+ * @file test_register_fields.c
+ * @brief Host test for the Register_Fields macros.
+ *
+ * The register values built by the drivers from named fields are compared with the hexadecimal literals
+ * they replaced: 0xAD83 (EUSCI_A3_SPI_Init), 0x2981 (EUSCI_A3_SPI and EUSCI_B0_SPI), 0x2101 (EUSCI_B2_SPI_Slave),
+ * 0x00A1 (EUSCI_A_UART), 0x20100255 (CS->CTL1) and 0x01610000 (the bits set in CS->CTL2 by Clock_Init48MHz).
+ * msp.h is not available on the host, so the field definitions used are copied from msp432p401r.h.
+ *
+ * Building with -DREGISTER_FIELDS_OUT_OF_RANGE must fail, because a value does not fit in its field.
+ * The Makefile checks this before it builds the test.
+ *
+ * Build and run with make in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include "../inc/Register_Fields.h"
+#include "Check.h"
+
+// Field definitions from msp432p401r.h
+#define EUSCI_A_CTLW0_SWRST         ((uint16_t)0x0001)
+#define EUSCI_A_CTLW0_STEM          ((uint16_t)0x0002)
+#define EUSCI_A_CTLW0_RXEIE         ((uint16_t)0x0020)
+#define EUSCI_A_CTLW0_SSEL_OFS      (6)
+#define EUSCI_A_CTLW0_SSEL_MASK     ((uint16_t)0x00C0)
+#define EUSCI_A_CTLW0_SYNC          ((uint16_t)0x0100)
+#define EUSCI_A_CTLW0_MODE_OFS      (9)
+#define EUSCI_A_CTLW0_MODE_MASK     ((uint16_t)0x0600)
+#define EUSCI_A_CTLW0_MST           ((uint16_t)0x0800)
+#define EUSCI_A_CTLW0_MSB           ((uint16_t)0x2000)
+#define EUSCI_A_CTLW0_CKPH          ((uint16_t)0x8000)
+#define EUSCI_A_MCTLW_OS16          ((uint16_t)0x0001)
+#define EUSCI_A_MCTLW_BRF_OFS       (4)
+#define EUSCI_A_MCTLW_BRF_MASK      ((uint16_t)0x00F0)
+#define EUSCI_A_MCTLW_BRS_OFS       (8)
+#define EUSCI_A_MCTLW_BRS_MASK      ((uint16_t)0xFF00)
+#define EUSCI_B_CTLW0_SWRST         ((uint16_t)0x0001)
+#define EUSCI_B_CTLW0_SSEL_OFS      (6)
+#define EUSCI_B_CTLW0_SSEL_MASK     ((uint16_t)0x00C0)
+#define EUSCI_B_CTLW0_SYNC          ((uint16_t)0x0100)
+#define EUSCI_B_CTLW0_MODE_OFS      (9)
+#define EUSCI_B_CTLW0_MODE_MASK     ((uint16_t)0x0600)
+#define EUSCI_B_CTLW0_MST           ((uint16_t)0x0800)
+#define EUSCI_B_CTLW0_MSB           ((uint16_t)0x2000)
+#define CS_CTL1_SELM_OFS            (0)
+#define CS_CTL1_SELM_MASK           ((uint32_t)0x00000007)
+#define CS_CTL1_SELS_OFS            (4)
+#define CS_CTL1_SELS_MASK           ((uint32_t)0x00000070)
+#define CS_CTL1_SELA_OFS            (8)
+#define CS_CTL1_SELA_MASK           ((uint32_t)0x00000700)
+#define CS_CTL1_DIVHS_OFS           (20)
+#define CS_CTL1_DIVHS_MASK          ((uint32_t)0x00700000)
+#define CS_CTL1_DIVS_OFS            (28)
+#define CS_CTL1_DIVS_MASK           ((uint32_t)0x70000000)
+#define CS_CTL2_HFXTDRIVE           ((uint32_t)0x00010000)
+#define CS_CTL2_HFXTFREQ_OFS        (20)
+#define CS_CTL2_HFXTFREQ_MASK       ((uint32_t)0x00700000)
+#define CS_CTL2_HFXT_EN             ((uint32_t)0x01000000)
+#define CS_CTL2_HFXTBYPASS          ((uint32_t)0x02000000)
+
+// The values must be constant expressions, as in the drivers
+static const uint16_t A3_SPI_CTLW0 = EUSCI_A_CTLW0_CKPH | EUSCI_A_CTLW0_MSB | EUSCI_A_CTLW0_MST
+                                     | REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 2) | EUSCI_A_CTLW0_SYNC
+                                     | REGISTER_FIELD(EUSCI_A_CTLW0_SSEL, 2) | EUSCI_A_CTLW0_STEM | EUSCI_A_CTLW0_SWRST;
+
+static const uint32_t CS_CTL1 = REGISTER_FIELD(CS_CTL1_DIVS, 2) | REGISTER_FIELD(CS_CTL1_DIVHS, 1)
+                                | REGISTER_FIELD(CS_CTL1_SELA, 2) | REGISTER_FIELD(CS_CTL1_SELS, 5)
+                                | REGISTER_FIELD(CS_CTL1_SELM, 5);
+
+#ifdef REGISTER_FIELDS_OUT_OF_RANGE
+static const uint16_t Out_Of_Range = REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 4);
+#endif
+
+static void Test_EUSCI()
+{
+    uint16_t ctlw0;
+
+    CHECK(A3_SPI_CTLW0 == 0xAD83);
+
+    ctlw0 = EUSCI_A_CTLW0_MSB | EUSCI_A_CTLW0_MST | REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 0) | EUSCI_A_CTLW0_SYNC
+            | REGISTER_FIELD(EUSCI_A_CTLW0_SSEL, 2) | EUSCI_A_CTLW0_SWRST;
+    CHECK(ctlw0 == 0x2981);
+
+    ctlw0 = EUSCI_B_CTLW0_MSB | EUSCI_B_CTLW0_MST | REGISTER_FIELD(EUSCI_B_CTLW0_MODE, 0) | EUSCI_B_CTLW0_SYNC
+            | REGISTER_FIELD(EUSCI_B_CTLW0_SSEL, 2) | EUSCI_B_CTLW0_SWRST;
+    CHECK(ctlw0 == 0x2981);
+
+    ctlw0 = EUSCI_B_CTLW0_MSB | REGISTER_FIELD(EUSCI_B_CTLW0_MODE, 0) | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_SWRST;
+    CHECK(ctlw0 == 0x2101);
+
+    ctlw0 = REGISTER_FIELD(EUSCI_A_CTLW0_MODE, 0) | REGISTER_FIELD(EUSCI_A_CTLW0_SSEL, 2) | EUSCI_A_CTLW0_RXEIE
+            | EUSCI_A_CTLW0_SWRST;
+    CHECK(ctlw0 == 0x00A1);
+}
+
+static void Test_CS()
+{
+    volatile uint32_t ctl2 = 0x0273000F;
+
+    CHECK(CS_CTL1 == 0x20100255);
+
+    // Clock_Init48MHz sets 0x01610000 and clears HFXTFREQ and HFXTBYPASS, keeping the other bits
+    CHECK((REGISTER_FIELD(CS_CTL2_HFXTFREQ, 6) | CS_CTL2_HFXTDRIVE | CS_CTL2_HFXT_EN) == 0x01610000);
+    REGISTER_MODIFY(ctl2, CS_CTL2_HFXTFREQ_MASK | CS_CTL2_HFXTBYPASS,
+                    REGISTER_FIELD(CS_CTL2_HFXTFREQ, 6) | CS_CTL2_HFXTDRIVE | CS_CTL2_HFXT_EN);
+    CHECK(ctl2 == 0x0163000F);
+}
+
+static void Test_Run_Time_Values()
+{
+    volatile uint32_t ucbrs = 0x1B5;
+    volatile uint32_t n = 0x25;
+
+    // The modulation register of EUSCI_A_UART_Init: bits that do not fit are dropped
+    CHECK((REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRS, ucbrs) | REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRF, n % 16)
+           | EUSCI_A_MCTLW_OS16) == 0xB551);
+    CHECK(REGISTER_FIELD_VALUE(EUSCI_A_MCTLW_BRF, n) == 0x0050);
+}
+
+int main(void)
+{
+    Test_EUSCI();
+    Test_CS();
+    Test_Run_Time_Values();
+
+    return Check_Result("test_register_fields");
+}
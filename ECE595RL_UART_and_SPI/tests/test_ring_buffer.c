@@ -0,0 +1,258 @@
+/**
+ * @file test_ring_buffer.c
+ * @brief Host test for the Ring_Buffer library.
+ *
+ * The first tests check the queue from one thread: capacity, full and empty, wrap-around of the storage
+ * and of the 32-bit indexes, and the spans. The stress test then runs a producer thread and a consumer thread
+ * on the same queue. Both rotate through all the push and pop functions and the consumer checks that it
+ * receives every element exactly once, in order.
+ *
+ * Build and run with make in this directory.
+ *
+ * @author Michael Granberry
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "../inc/Ring_Buffer.h"
+#include "Check.h"
+
+#define STRESS_ELEMENTS     3000000
+#define STRESS_CAPACITY     64
+#define MAX_BATCH           23
+
+static void Test_Init()
+{
+    Ring_Buffer ring;
+    uint32_t storage[8];
+
+    CHECK(Ring_Buffer_Init(&ring, storage, sizeof(uint32_t), 6) == RING_BUFFER_ERROR_CAPACITY);
+    CHECK(Ring_Buffer_Init(&ring, storage, sizeof(uint32_t), 0) == RING_BUFFER_ERROR_CAPACITY);
+    CHECK(Ring_Buffer_Init(&ring, storage, sizeof(uint32_t), 8) == 0);
+    CHECK(Ring_Buffer_Count(&ring) == 0);
+    CHECK(Ring_Buffer_Free(&ring) == 8);
+}
+
+RING_BUFFER_DEFINE(Defined_Ring, uint16_t, 4);
+
+static void Test_Full_And_Empty()
+{
+    uint16_t value;
+    uint16_t i;
+
+    // Every slot can be used
+    for (i = 0; i < 4; i++)
+    {
+        CHECK(Ring_Buffer_Push(&Defined_Ring, &i) == 1);
+    }
+    CHECK(Ring_Buffer_Push(&Defined_Ring, &i) == 0);
+    CHECK(Ring_Buffer_Count(&Defined_Ring) == 4);
+    CHECK(Ring_Buffer_Free(&Defined_Ring) == 0);
+
+    for (i = 0; i < 4; i++)
+    {
+        CHECK(Ring_Buffer_Pop(&Defined_Ring, &value) == 1);
+        CHECK(value == i);
+    }
+    CHECK(Ring_Buffer_Pop(&Defined_Ring, &value) == 0);
+    CHECK(Ring_Buffer_Count(&Defined_Ring) == 0);
+}
+
+static void Test_Wrap_Around()
+{
+    Ring_Buffer ring;
+    uint8_t storage[8 * 3];
+    uint8_t in[10 * 3];
+    uint8_t out[10 * 3];
+    const void *read_span;
+    void *write_span;
+    int i;
+
+    for (i = 0; i < (int)sizeof(in); i++)
+    {
+        in[i] = (uint8_t)(i + 1);
+    }
+
+    // Start close to the wrap-around of the 32-bit indexes, with elements of 3 bytes
+    Ring_Buffer_Init(&ring, storage, 3, 8);
+    ring.head = 0xFFFFFFFD;
+    ring.tail = 0xFFFFFFFD;
+
+    CHECK(Ring_Buffer_Push_Multiple(&ring, in, 10) == 8);
+    CHECK(Ring_Buffer_Count(&ring) == 8);
+    CHECK(Ring_Buffer_Pop_Multiple(&ring, out, 10) == 8);
+    CHECK(memcmp(in, out, 8 * 3) == 0);
+    CHECK(ring.head == 5);
+
+    // The spans stop at the end of the storage: 3 slots are left after position 5
+    CHECK(Ring_Buffer_Write_Span(&ring, &write_span) == 3);
+    CHECK(write_span == &storage[5 * 3]);
+    memcpy(write_span, in, 2 * 3);
+    Ring_Buffer_Commit(&ring, 2);
+    CHECK(Ring_Buffer_Write_Span(&ring, &write_span) == 1);
+    Ring_Buffer_Commit(&ring, 0);
+
+    CHECK(Ring_Buffer_Read_Span(&ring, &read_span) == 2);
+    CHECK(memcmp(read_span, in, 2 * 3) == 0);
+    Ring_Buffer_Consume(&ring, 1);
+    CHECK(Ring_Buffer_Count(&ring) == 1);
+
+    // The free slots before tail are returned once head wraps around the storage
+    CHECK(Ring_Buffer_Push_Multiple(&ring, in, 1) == 1);
+    CHECK(Ring_Buffer_Write_Span(&ring, &write_span) == 6);
+    CHECK(write_span == &storage[0]);
+}
+
+static Ring_Buffer Stress_Ring;
+static uint32_t Stress_Storage[STRESS_CAPACITY];
+static volatile int Stress_Errors;
+
+static void *Producer(void *argument)
+{
+    uint32_t next = 0;
+    uint32_t batch[MAX_BATCH];
+    uint32_t count;
+    uint32_t pushed;
+    uint32_t i;
+    uint32_t *span;
+    int mode = 0;
+
+    while(next < STRESS_ELEMENTS)
+    {
+        count = 1 + (next % MAX_BATCH);
+        if (count > STRESS_ELEMENTS - next)
+        {
+            count = STRESS_ELEMENTS - next;
+        }
+
+        switch(mode)
+        {
+            case 0:
+            {
+                pushed = Ring_Buffer_Push(&Stress_Ring, &next);
+                break;
+            }
+            case 1:
+            {
+                for (i = 0; i < count; i++)
+                {
+                    batch[i] = next + i;
+                }
+                pushed = Ring_Buffer_Push_Multiple(&Stress_Ring, batch, count);
+                break;
+            }
+            default:
+            {
+                pushed = Ring_Buffer_Write_Span(&Stress_Ring, (void **)&span);
+                if (pushed > count)
+                {
+                    pushed = count;
+                }
+                for (i = 0; i < pushed; i++)
+                {
+                    span[i] = next + i;
+                }
+                Ring_Buffer_Commit(&Stress_Ring, pushed);
+                break;
+            }
+        }
+
+        next += pushed;
+        mode = (mode + 1) % 3;
+        if (pushed == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    return 0;
+}
+
+static void *Consumer(void *argument)
+{
+    uint32_t expected = 0;
+    uint32_t batch[MAX_BATCH];
+    uint32_t popped;
+    uint32_t i;
+    const uint32_t *span;
+    int mode = 0;
+
+    while(expected < STRESS_ELEMENTS)
+    {
+        switch(mode)
+        {
+            case 0:
+            {
+                popped = Ring_Buffer_Pop(&Stress_Ring, batch);
+                break;
+            }
+            case 1:
+            {
+                popped = Ring_Buffer_Pop_Multiple(&Stress_Ring, batch, 1 + (expected % MAX_BATCH));
+                break;
+            }
+            default:
+            {
+                popped = Ring_Buffer_Read_Span(&Stress_Ring, (const void **)&span);
+                for (i = 0; i < popped; i++)
+                {
+                    batch[i % MAX_BATCH] = span[i];
+                    if (span[i] != expected + i)
+                    {
+                        Stress_Errors++;
+                    }
+                }
+                Ring_Buffer_Consume(&Stress_Ring, popped);
+                expected += popped;
+                popped = 0;
+                break;
+            }
+        }
+
+        for (i = 0; i < popped; i++)
+        {
+            if (batch[i] != expected + i)
+            {
+                Stress_Errors++;
+            }
+        }
+        expected += popped;
+        mode = (mode + 1) % 3;
+        if (Ring_Buffer_Count(&Stress_Ring) == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    return 0;
+}
+
+static void Test_Two_Threads()
+{
+    pthread_t producer;
+    pthread_t consumer;
+
+    CHECK(Ring_Buffer_Init(&Stress_Ring, Stress_Storage, sizeof(uint32_t), STRESS_CAPACITY) == 0);
+    Stress_Errors = 0;
+
+    pthread_create(&consumer, 0, Consumer, 0);
+    pthread_create(&producer, 0, Producer, 0);
+    pthread_join(producer, 0);
+    pthread_join(consumer, 0);
+
+    CHECK(Stress_Errors == 0);
+    CHECK(Stress_Ring.head == STRESS_ELEMENTS);
+    CHECK(Stress_Ring.tail == STRESS_ELEMENTS);
+}
+
+int main(void)
+{
+    Test_Init();
+    Test_Full_And_Empty();
+    Test_Wrap_Around();
+    Test_Two_Threads();
+
+    return Check_Result("test_ring_buffer");
+}
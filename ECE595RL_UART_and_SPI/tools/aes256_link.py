@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+Host-side reference implementation of the AES256_Link frame format.
+
+The frame layout and CCM parameters match inc/AES256_Link.h:
+    sync (0x7E) | length | nonce (13) | ciphertext (length) | tag (8)
+
+Usage:
+    aes256_link.py vectors                      Print test vectors for the FIPS-197 key
+    aes256_link.py seal <hex payload> [counter] Print the frame for a payload
+    aes256_link.py open <hex frame>             Verify and decrypt a frame
+
+The key and salt default to the values used by AES256_Link_Benchmark() and can be
+overridden with --key and --salt (hex strings).
+
+Only the Python standard library is used, so this file also serves as an
+independent AES-256 implementation for checking the firmware.
+
+@author Michael Granberry
+"""
+
+import argparse
+import sys
+
+SYNC = 0x7E
+NONCE_LENGTH = 13
+SALT_LENGTH = 5
+TAG_LENGTH = 8
+MAX_PAYLOAD = 240
+
+DEFAULT_KEY = bytes(range(32))
+DEFAULT_SALT = bytes([0x52, 0x53, 0x4C, 0x4B, 0x01])
+
+
+def _build_sbox():
+    sbox = [0] * 256
+    p = q = 1
+    while True:
+        # Multiply p by 3 and divide q by 3 in GF(2^8)
+        p = p ^ ((p << 1) & 0xFF) ^ (0x1B if p & 0x80 else 0)
+        q ^= q << 1
+        q ^= q << 2
+        q ^= q << 4
+        q &= 0xFF
+        if q & 0x80:
+            q ^= 0x09
+        x = q ^ (q << 1 | q >> 7) ^ (q << 2 | q >> 6) ^ (q << 3 | q >> 5) ^ (q << 4 | q >> 4)
+        sbox[p] = (x ^ 0x63) & 0xFF
+        if p == 1:
+            break
+    sbox[0] = 0x63
+    return sbox
+
+
+SBOX = _build_sbox()
+
+
+def _xtime(x):
+    return ((x << 1) ^ (0x1B if x & 0x80 else 0)) & 0xFF
+
+
+class AES256:
+    def __init__(self, key):
+        if len(key) != 32:
+            raise ValueError("key must be 32 bytes")
+        words = [list(key[4 * i:4 * i + 4]) for i in range(8)]
+        rcon = 1
+        for i in range(8, 60):
+            temp = list(words[i - 1])
+            if i % 8 == 0:
+                temp = [SBOX[temp[1]] ^ rcon, SBOX[temp[2]], SBOX[temp[3]], SBOX[temp[0]]]
+                rcon = _xtime(rcon)
+            elif i % 8 == 4:
+                temp = [SBOX[b] for b in temp]
+            words.append([a ^ b for a, b in zip(words[i - 8], temp)])
+        self.round_keys = [sum(words[4 * r:4 * r + 4], []) for r in range(15)]
+
+    def encrypt_block(self, block):
+        s = [b ^ k for b, k in zip(block, self.round_keys[0])]
+        for r in range(1, 15):
+            t = [SBOX[s[(i + 4 * (i & 3)) & 15]] for i in range(16)]
+            if r < 14:
+                for c in range(0, 16, 4):
+                    a0, a1, a2, a3 = t[c:c + 4]
+                    al = a0 ^ a1 ^ a2 ^ a3
+                    t[c:c + 4] = [a0 ^ al ^ _xtime(a0 ^ a1), a1 ^ al ^ _xtime(a1 ^ a2),
+                                  a2 ^ al ^ _xtime(a2 ^ a3), a3 ^ al ^ _xtime(a3 ^ a0)]
+            s = [b ^ k for b, k in zip(t, self.round_keys[r])]
+        return bytes(s)
+
+
+def _ccm(aes, nonce, payload):
+    """Returns (CTR-encrypted payload, encrypted tag) for CCM with M = 8, L = 2."""
+    length = len(payload)
+    b0 = bytes([0x19]) + nonce + length.to_bytes(2, "big")
+    mac = aes.encrypt_block(b0)
+    for offset in range(0, length, 16):
+        block = payload[offset:offset + 16].ljust(16, b"\x00")
+        mac = aes.encrypt_block(bytes(a ^ b for a, b in zip(mac, block)))
+    keystream = b"".join(aes.encrypt_block(bytes([0x01]) + nonce + i.to_bytes(2, "big"))
+                         for i in range((length + 15) // 16 + 1))
+    body = bytes(a ^ b for a, b in zip(payload, keystream[16:]))
+    tag = bytes(a ^ b for a, b in zip(mac[:TAG_LENGTH], keystream[:TAG_LENGTH]))
+    return body, tag
+
+
+def seal(key, salt, counter, payload):
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload too long")
+    nonce = salt + counter.to_bytes(8, "big")
+    body, tag = _ccm(AES256(key), nonce, payload)
+    return bytes([SYNC, len(payload)]) + nonce + body + tag
+
+
+def open_frame(key, frame):
+    if len(frame) < 2 + NONCE_LENGTH + TAG_LENGTH or frame[0] != SYNC:
+        raise ValueError("bad frame format")
+    length = frame[1]
+    if len(frame) != 2 + NONCE_LENGTH + length + TAG_LENGTH:
+        raise ValueError("bad frame length")
+    nonce = frame[2:2 + NONCE_LENGTH]
+    aes = AES256(key)
+    # CTR decryption is the same operation as encryption, and the MAC is computed over the plaintext
+    payload, _ = _ccm(aes, nonce, frame[15:15 + length])
+    _, tag = _ccm(aes, nonce, payload)
+    if tag != frame[15 + length:]:
+        raise ValueError("tag mismatch")
+    return int.from_bytes(nonce[SALT_LENGTH:], "big"), payload
+
+
+def _c_array(name, data):
+    rows = [", ".join("0x%02X" % b for b in data[i:i + 16]) for i in range(0, len(data), 16)]
+    return "static const uint8_t %s[%d] = {\n    %s\n};" % (name, len(data), ",\n    ".join(rows))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--key", default=DEFAULT_KEY.hex())
+    parser.add_argument("--salt", default=DEFAULT_SALT.hex())
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("vectors")
+    p_seal = sub.add_parser("seal")
+    p_seal.add_argument("payload")
+    p_seal.add_argument("counter", nargs="?", type=int, default=0)
+    p_open = sub.add_parser("open")
+    p_open.add_argument("frame")
+    args = parser.parse_args()
+
+    key = bytes.fromhex(args.key)
+    salt = bytes.fromhex(args.salt)
+
+    if args.command == "vectors":
+        fips = AES256(DEFAULT_KEY).encrypt_block(bytes.fromhex("00112233445566778899aabbccddeeff"))
+        print("// FIPS-197 C.3 ciphertext: %s" % fips.hex())
+        for length in (0, 1, 16, 17, MAX_PAYLOAD):
+            frame = seal(key, salt, 0, bytes(i & 0xFF for i in range(length)))
+            print(_c_array("Frame_%d" % length, frame))
+    elif args.command == "seal":
+        print(seal(key, salt, args.counter, bytes.fromhex(args.payload)).hex())
+    else:
+        try:
+            counter, payload = open_frame(key, bytes.fromhex(args.frame))
+        except ValueError as error:
+            print("error: %s" % error)
+            return 1
+        print("counter %d: %s" % (counter, payload.hex()))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+Reader for logs written by the Block_Log driver (USE_SD_LOGGER in SPI_main.c).
+
+Reads a card image (or the card itself, for example /dev/sdb or \\\\.\\PhysicalDrive1, with read permission)
+block by block until the end of the log, checks the block headers described in inc/Block_Log.h and
+prints the records of each run as CSV. Only the blocks of the log are read, not the whole card.
+
+Usage:
+    block_log_reader.py /dev/sdb --decode 1:<IIII --decode 2:<II > log.csv
+    block_log_reader.py card.img --raw payload.bin
+
+--decode TYPE:FORMAT unpacks the data of the records of that type with a struct format
+(for example <IIII for four little-endian 32-bit integers). Other records are printed in hexadecimal.
+
+Only the Python standard library is used.
+
+@author Michael Granberry
+"""
+
+import argparse
+import binascii
+import csv
+import struct
+import sys
+
+BLOCK_SIZE = 512
+HEADER_SIZE = 16
+PAYLOAD_SIZE = BLOCK_SIZE - HEADER_SIZE
+MAGIC = 0x474F4C42
+RUN_START = 0x8000
+RECORD_SYNC = 0xA5
+RECORD_HEADER_SIZE = 4
+
+
+def check_block(block, log_id, index):
+    """Returns (run_start, payload) for a block of the log, or None if the block does not belong to the log."""
+    if len(block) < BLOCK_SIZE:
+        return None
+    magic, block_log_id, block_index, used, crc = struct.unpack("<IIIHH", block[:HEADER_SIZE])
+    run_start = bool(used & RUN_START)
+    used &= ~RUN_START
+    if magic != MAGIC or block_index != index or used > PAYLOAD_SIZE:
+        return None
+    if log_id is not None and block_log_id != log_id:
+        return None
+    if binascii.crc_hqx(block[:14] + block[HEADER_SIZE:HEADER_SIZE + used], 0xFFFF) != crc:
+        return None
+    return run_start, block[HEADER_SIZE:HEADER_SIZE + used]
+
+
+def read_log(image):
+    """Returns the log_id and the payload of each run of the log stored in a file object."""
+    header = image.read(BLOCK_SIZE)
+    if check_block(header, None, 0) is None:
+        raise ValueError("block 0 does not hold a log header")
+    log_id = struct.unpack_from("<I", header, 4)[0]
+
+    runs = []
+    index = 1
+    while True:
+        block = check_block(image.read(BLOCK_SIZE), log_id, index)
+        if block is None:
+            break
+        run_start, data = block
+        if run_start or not runs:
+            runs.append(bytearray())
+        runs[-1] += data
+        index += 1
+    return log_id, [bytes(run) for run in runs]
+
+
+def records(payload):
+    """Yields (offset, type, data) for each record of a run. A record cut off at the end of the run is ignored."""
+    offset = 0
+    while offset + RECORD_HEADER_SIZE <= len(payload):
+        sync, record_type, length = struct.unpack_from("<BBH", payload, offset)
+        if sync != RECORD_SYNC:
+            raise ValueError("missing record sync byte at offset %d" % offset)
+        start = offset + RECORD_HEADER_SIZE
+        if start + length > len(payload):
+            break
+        yield offset, record_type, payload[start:start + length]
+        offset = start + length
+
+
+def parse_decode(text):
+    record_type, _, fmt = text.partition(":")
+    return int(record_type, 0), struct.Struct(fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", help="card image or block device")
+    parser.add_argument("--raw", help="save the payload of all runs to this file instead of printing the records")
+    parser.add_argument("--decode", type=parse_decode, action="append", default=[], metavar="TYPE:FORMAT")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as image:
+        log_id, runs = read_log(image)
+    print("log %d: %d runs, %d bytes" % (log_id, len(runs), sum(len(run) for run in runs)), file=sys.stderr)
+
+    if args.raw:
+        with open(args.raw, "wb") as output:
+            output.write(b"".join(runs))
+        return 0
+
+    decoders = dict(args.decode)
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["run", "offset", "type", "data"])
+    for run, payload in enumerate(runs):
+        for offset, record_type, data in records(payload):
+            decoder = decoders.get(record_type)
+            if decoder is not None and decoder.size == len(data):
+                writer.writerow([run, offset, record_type] + list(decoder.unpack(data)))
+            else:
+                writer.writerow([run, offset, record_type, data.hex()])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+Host-side tool for the Logic_Analyzer driver.
+
+Requests a capture from the LaunchPad over EUSCI_A0 (or reads a saved stream) and converts
+the run-length encoded samples into a Value Change Dump (VCD) file for PulseView or GTKWave.
+The stream format is described in inc/Logic_Analyzer.h.
+
+Usage:
+    logic_analyzer.py capture /dev/ttyACM0 -o capture.vcd [--raw capture.bin]
+    logic_analyzer.py convert capture.bin -o capture.vcd
+
+Only the Python standard library is used.
+
+@author Michael Granberry
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+
+from uart_uploader import SerialPort
+
+CMD_CAPTURE = b"C"
+STREAM_VERSION = 1
+BAUD_RATE = 115200
+
+ERRORS = {1: "invalid configuration", 2: "trigger timeout", 3: "sample rate too high for the number of channels"}
+
+
+class Capture:
+    def __init__(self, sample_rate, trigger_index, names, samples):
+        self.sample_rate = sample_rate
+        self.trigger_index = trigger_index
+        self.names = names
+        self.samples = samples
+
+
+def decode(read):
+    """Decodes a stream. read(n) must return exactly n bytes or raise EOFError."""
+    if read(2) != b"LA":
+        raise ValueError("missing stream header")
+    version, num_channels = read(2)
+    if version != STREAM_VERSION:
+        raise ValueError("unsupported stream version %d" % version)
+    sample_rate, sample_count, trigger_index = struct.unpack("<III", read(12))
+    names = [read(read(1)[0]).decode("ascii") for _ in range(num_channels)]
+
+    if sample_count == 0:
+        status = read(1)[0]
+        raise ValueError("capture failed: %s" % ERRORS.get(status, "error %d" % status))
+
+    samples = bytearray()
+    runs = bytearray()
+    while len(samples) < sample_count:
+        value = read(1)
+        run = 0
+        shift = 0
+        encoded = bytearray(value)
+        while True:
+            byte = read(1)
+            encoded += byte
+            run |= (byte[0] & 0x7F) << shift
+            shift += 7
+            if not byte[0] & 0x80:
+                break
+        runs += encoded
+        samples += value * (run + 1)
+
+    crc = struct.unpack("<H", read(2))[0]
+    if crc != binascii.crc_hqx(bytes(runs), 0xFFFF):
+        raise ValueError("CRC mismatch")
+    if len(samples) != sample_count:
+        raise ValueError("run lengths add up to %d samples instead of %d" % (len(samples), sample_count))
+
+    print("%d samples at %d Hz, %d channels, compressed %d bytes to %d"
+          % (sample_count, sample_rate, num_channels, sample_count, len(runs)))
+    return Capture(sample_rate, trigger_index, names, bytes(samples))
+
+
+def write_vcd(capture, output):
+    period_ns = 1e9 / capture.sample_rate
+    ids = [chr(ord("!") + i) for i in range(len(capture.names))]
+
+    output.write("$comment Logic_Analyzer capture, trigger at sample %d $end\n" % capture.trigger_index)
+    output.write("$timescale 1 ns $end\n")
+    output.write("$scope module msp432 $end\n")
+    for name, ident in zip(capture.names, ids):
+        output.write("$var wire 1 %s %s $end\n" % (ident, name))
+    output.write("$upscope $end\n$enddefinitions $end\n")
+
+    previous = None
+    for index, sample in enumerate(capture.samples):
+        if sample == previous:
+            continue
+        output.write("#%d\n" % round(index * period_ns))
+        for bit, ident in enumerate(ids):
+            if previous is None or (sample ^ previous) & (1 << bit):
+                output.write("%d%s\n" % ((sample >> bit) & 1, ident))
+        previous = sample
+    output.write("#%d\n" % round(len(capture.samples) * period_ns))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_capture = sub.add_parser("capture")
+    p_capture.add_argument("port")
+    p_capture.add_argument("-o", "--output", required=True)
+    p_capture.add_argument("--raw", help="also save the raw stream")
+    p_capture.add_argument("--baud", type=int, default=BAUD_RATE)
+    p_capture.add_argument("--timeout", type=float, default=30.0, help="seconds to wait for the trigger")
+    p_convert = sub.add_parser("convert")
+    p_convert.add_argument("input")
+    p_convert.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    raw = bytearray()
+    if args.command == "capture":
+        port = SerialPort(args.port, args.baud)
+        port.flush_input()
+        port.write(CMD_CAPTURE)
+        timeout = [args.timeout]
+
+        def read(length):
+            data = port.read(length, timeout[0])
+            if len(data) != length:
+                raise EOFError("stream ended early")
+            # Only the wait for the trigger can be long
+            timeout[0] = 2.0
+            raw.extend(data)
+            return data
+    else:
+        with open(args.input, "rb") as f:
+            stream = f.read()
+        position = [0]
+
+        def read(length):
+            data = stream[position[0]:position[0] + length]
+            if len(data) != length:
+                raise EOFError("stream ended early")
+            position[0] += length
+            return data
+
+    try:
+        capture = decode(read)
+    except (ValueError, EOFError) as error:
+        print("error: %s" % error)
+        return 1
+    finally:
+        if args.command == "capture" and args.raw:
+            with open(args.raw, "wb") as f:
+                f.write(raw)
+
+    with open(args.output, "w") as f:
+        write_vcd(capture, f)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
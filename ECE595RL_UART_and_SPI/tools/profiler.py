@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+"""
+Host-side tool for the Profiler driver.
+
+Reads the PC (and LR) histograms from the LaunchPad over EUSCI_A0 (or from a saved stream) and adds up the
+buckets of each function of the ELF file built by Code Composer Studio (for example Debug/SPI.out)
+into a flat profile. The stream format is described in inc/Profiler.h.
+
+Usage:
+    profiler.py capture /dev/ttyACM0 --elf Debug/SPI.out [--raw profile.bin]
+    profiler.py report profile.bin --elf Debug/SPI.out
+
+A bucket that is shared by two functions is split between them in proportion to the bytes of the bucket
+that each one covers, so the counts of functions shorter than a bucket are estimates.
+The LR profile counts the return addresses: for a function that does not call other functions
+(for example a busy-wait loop), it shows the callers.
+
+Only the Python standard library is used.
+
+@author Michael Granberry
+"""
+
+import argparse
+import binascii
+import bisect
+import struct
+import sys
+
+from uart_uploader import SerialPort
+
+CMD_READ = b"P"
+STREAM_VERSION = 1
+BAUD_RATE = 115200
+
+FLAG_LR = 0x01
+FLAG_SATURATED = 0x02
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+
+class Profile:
+    def __init__(self, bucket_shift, flags, code_start, num_buckets, sample_rate, samples, outside, pc, lr):
+        self.bucket_shift = bucket_shift
+        self.flags = flags
+        self.code_start = code_start
+        self.num_buckets = num_buckets
+        self.sample_rate = sample_rate
+        self.samples = samples
+        self.outside = outside
+        self.pc = pc
+        self.lr = lr
+
+
+def decode(read):
+    """Decodes a stream. read(n) must return exactly n bytes or raise EOFError."""
+    if read(2) != b"PF":
+        raise ValueError("missing stream header")
+    version, bucket_shift, flags = read(3)
+    if version != STREAM_VERSION:
+        raise ValueError("unsupported stream version %d" % version)
+    code_start, num_buckets, sample_rate, samples, outside = struct.unpack("<IIIII", read(20))
+
+    entries = bytearray()
+
+    def read_histogram():
+        histogram = {}
+        while True:
+            data = read(2)
+            entries.extend(data)
+            index = struct.unpack("<H", data)[0]
+            if index == 0xFFFF:
+                return histogram
+            data = read(2)
+            entries.extend(data)
+            if index >= num_buckets:
+                raise ValueError("bucket %d out of range" % index)
+            histogram[index] = struct.unpack("<H", data)[0]
+
+    pc = read_histogram()
+    lr = read_histogram() if flags & FLAG_LR else None
+
+    crc = struct.unpack("<H", read(2))[0]
+    if crc != binascii.crc_hqx(bytes(entries), 0xFFFF):
+        raise ValueError("CRC mismatch")
+
+    return Profile(bucket_shift, flags, code_start, num_buckets, sample_rate, samples, outside, pc, lr)
+
+
+def read_functions(path):
+    """Returns the functions of an ELF32 little-endian file as a sorted list of (start, end, name)."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("%s is not a 32-bit little-endian ELF file" % path)
+
+    shoff, = struct.unpack_from("<I", elf, 32)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 46)
+    sections = [struct.unpack_from("<IIIIIIIIII", elf, shoff + i * shentsize) for i in range(shnum)]
+
+    functions = {}
+    for section in sections:
+        if section[1] != SHT_SYMTAB:
+            continue
+        offset, size, link, entsize = section[4], section[5], section[6], section[9]
+        strtab = sections[link][4]
+        for position in range(offset, offset + size, entsize):
+            name_offset, value, length, info = struct.unpack_from("<IIIB", elf, position)
+            if (info & 0x0F) != STT_FUNC:
+                continue
+            end = elf.index(b"\0", strtab + name_offset)
+            name = elf[strtab + name_offset:end].decode("ascii", "replace")
+            # Bit 0 of the address of a Thumb function is set
+            start = value & ~1
+            if start not in functions or (length and not functions[start][0]):
+                functions[start] = (length, name)
+
+    starts = sorted(functions)
+    result = []
+    for i, start in enumerate(starts):
+        length, name = functions[start]
+        # Functions written in assembly may have no size: they end where the next one starts
+        if length == 0:
+            length = (starts[i + 1] - start) if i + 1 < len(starts) else 2
+        result.append((start, start + length, name))
+    return result
+
+
+def attribute(histogram, profile, functions):
+    """Splits the bucket counts between the functions that cover each bucket. Returns {name: samples}."""
+    totals = {}
+    starts = [function[0] for function in functions]
+    bucket_size = 1 << profile.bucket_shift
+
+    for index, count in histogram.items():
+        low = profile.code_start + (index << profile.bucket_shift)
+        high = low + bucket_size
+        shares = []
+        i = max(bisect.bisect_right(starts, low) - 1, 0)
+        while i < len(functions) and functions[i][0] < high:
+            start, end, name = functions[i]
+            overlap = min(end, high) - max(start, low)
+            if overlap > 0:
+                shares.append((name, overlap))
+            i += 1
+
+        covered = sum(overlap for _, overlap in shares)
+        if covered == 0:
+            totals["?? 0x%08X" % low] = totals.get("?? 0x%08X" % low, 0) + count
+            continue
+        for name, overlap in shares:
+            totals[name] = totals.get(name, 0) + count * overlap / covered
+    return totals
+
+
+def print_flat_profile(title, totals, total, limit):
+    print()
+    print(title)
+    print("     %       samples  function")
+    for name, count in sorted(totals.items(), key=lambda item: -item[1])[:limit]:
+        print("%6.2f %11.1f  %s" % (100.0 * count / total, count, name))
+
+
+def report(profile, functions, limit):
+    total = profile.samples
+    if total == 0:
+        print("no samples")
+        return
+
+    print("%d samples at %d Hz (%.1f s), %d outside of the code range, %d-byte buckets"
+          % (total, profile.sample_rate, total / profile.sample_rate, profile.outside, 1 << profile.bucket_shift))
+    if profile.flags & FLAG_SATURATED:
+        print("sampling stopped early because a bucket reached 65535")
+
+    print_flat_profile("Flat profile (PC)", attribute(profile.pc, profile, functions), total, limit)
+    if profile.lr is not None:
+        print_flat_profile("Return addresses (LR)", attribute(profile.lr, profile, functions), total, limit)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_capture = sub.add_parser("capture")
+    p_capture.add_argument("port")
+    p_capture.add_argument("--elf", required=True)
+    p_capture.add_argument("--raw", help="also save the raw stream")
+    p_capture.add_argument("--baud", type=int, default=BAUD_RATE)
+    p_capture.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for the start of the stream")
+    p_report = sub.add_parser("report")
+    p_report.add_argument("input")
+    p_report.add_argument("--elf", required=True)
+    for p in (p_capture, p_report):
+        p.add_argument("--limit", type=int, default=30, help="number of functions to print")
+    args = parser.parse_args()
+
+    raw = bytearray()
+    if args.command == "capture":
+        port = SerialPort(args.port, args.baud)
+        port.flush_input()
+        port.write(CMD_READ)
+        timeout = [args.timeout]
+
+        def read(length):
+            data = port.read(length, timeout[0])
+            if len(data) != length:
+                raise EOFError("stream ended early")
+            # Only the first read waits for the main loop of the program to poll the command
+            timeout[0] = 2.0
+            raw.extend(data)
+            return data
+    else:
+        with open(args.input, "rb") as f:
+            stream = f.read()
+        position = [0]
+
+        def read(length):
+            data = stream[position[0]:position[0] + length]
+            if len(data) != length:
+                raise EOFError("stream ended early")
+            position[0] += length
+            return data
+
+    try:
+        profile = decode(read)
+        functions = read_functions(args.elf)
+    except (ValueError, EOFError, OSError) as error:
+        print("error: %s" % error)
+        return 1
+    finally:
+        if args.command == "capture" and args.raw:
+            with open(args.raw, "wb") as f:
+                f.write(raw)
+
+    report(profile, functions, args.limit)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
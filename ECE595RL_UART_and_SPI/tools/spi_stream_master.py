@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+SPI master for the EUSCI_B2_SPI_Slave stream demo (USE_SPI_SLAVE_STREAM in SPI_main.c).
+
+Runs on a Linux single-board computer with the spidev driver. Each transaction holds a 32-bit
+sequence number, a random payload and a CRC-16/CCITT (initial value 0xFFFF), all little-endian.
+The slave answers on MISO with the last sequence number it received, its CRC error count and the
+number of lost sequence numbers, so the report printed at the end comes from both sides of the link.
+
+The LaunchPad needs EUSCI_B2_SPI_SLAVE_SETUP_TIME_US (5 us) between a CS edge and the next SCLK
+or CS edge. Set the chip-select setup delay of the SPI controller (for example spi-cs-setup-delay-ns
+in the device tree) or use --gap to add time between transactions.
+
+Usage:
+    spi_stream_master.py /dev/spidev0.0 --speed 4000000 --length 1024 --count 10000
+
+Only the Python standard library is used.
+
+@author Michael Granberry
+"""
+
+import argparse
+import binascii
+import ctypes
+import fcntl
+import os
+import struct
+import sys
+import time
+
+# ioctl request numbers from linux/spi/spidev.h
+SPI_IOC_WR_MODE = 0x40016B01
+SPI_IOC_WR_MAX_SPEED_HZ = 0x40046B04
+SPI_IOC_MESSAGE_1 = 0x40206B00
+
+MAX_LENGTH = 1024
+OVERHEAD = 6
+
+
+class SpiIocTransfer(ctypes.Structure):
+    _fields_ = [
+        ("tx_buf", ctypes.c_uint64),
+        ("rx_buf", ctypes.c_uint64),
+        ("len", ctypes.c_uint32),
+        ("speed_hz", ctypes.c_uint32),
+        ("delay_usecs", ctypes.c_uint16),
+        ("bits_per_word", ctypes.c_uint8),
+        ("cs_change", ctypes.c_uint8),
+        ("tx_nbits", ctypes.c_uint8),
+        ("rx_nbits", ctypes.c_uint8),
+        ("word_delay_usecs", ctypes.c_uint8),
+        ("pad", ctypes.c_uint8),
+    ]
+
+
+class SpiDev:
+    def __init__(self, path, speed, mode):
+        self.fd = os.open(path, os.O_RDWR)
+        self.speed = speed
+        fcntl.ioctl(self.fd, SPI_IOC_WR_MODE, struct.pack("B", mode))
+        fcntl.ioctl(self.fd, SPI_IOC_WR_MAX_SPEED_HZ, struct.pack("I", speed))
+
+    def transfer(self, data):
+        tx = ctypes.create_string_buffer(bytes(data), len(data))
+        rx = ctypes.create_string_buffer(len(data))
+        xfer = SpiIocTransfer(tx_buf=ctypes.addressof(tx), rx_buf=ctypes.addressof(rx), len=len(data),
+                              speed_hz=self.speed, bits_per_word=8)
+        fcntl.ioctl(self.fd, SPI_IOC_MESSAGE_1, xfer)
+        return rx.raw
+
+    def close(self):
+        os.close(self.fd)
+
+
+def make_frame(sequence, length):
+    body = struct.pack("<I", sequence) + os.urandom(length - OVERHEAD)
+    return body + struct.pack("<H", binascii.crc_hqx(body, 0xFFFF))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("device")
+    parser.add_argument("--speed", type=int, default=4000000, help="SPI clock frequency in Hz")
+    parser.add_argument("--mode", type=int, default=0, choices=range(4))
+    parser.add_argument("--length", type=int, default=MAX_LENGTH, help="bytes per transaction")
+    parser.add_argument("--count", type=int, default=1000, help="number of transactions")
+    parser.add_argument("--gap", type=float, default=0.0, help="seconds between transactions")
+    args = parser.parse_args()
+
+    if not OVERHEAD <= args.length <= MAX_LENGTH:
+        parser.error("length must be between %d and %d" % (OVERHEAD, MAX_LENGTH))
+
+    spi = SpiDev(args.device, args.speed, args.mode)
+    response = b""
+    start = time.monotonic()
+    try:
+        for sequence in range(args.count):
+            response = spi.transfer(make_frame(sequence, args.length))
+            if args.gap:
+                time.sleep(args.gap)
+        # One more transaction to read the response to the last frame
+        time.sleep(0.01)
+        elapsed = time.monotonic() - start
+        response = spi.transfer(bytes(13))
+    finally:
+        spi.close()
+
+    total = args.count * args.length
+    print("%d transactions, %d bytes in %.2f s: %.0f B/s (%.1f%% of %d bit/s)"
+          % (args.count, total, elapsed, total / elapsed, 100.0 * total * 8 / elapsed / args.speed, args.speed))
+
+    if response[:1] != b"S":
+        print("error: no response from the slave")
+        return 1
+    last, crc_errors, lost = struct.unpack("<III", response[1:13])
+    print("slave: last sequence %d, %d CRC errors, %d lost" % (last, crc_errors, lost))
+    return 0 if (last == args.count - 1 and crc_errors == 0 and lost == 0) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+Host-side tool for the Trace driver.
+
+Reads the event buffer from the LaunchPad over EUSCI_A0 (or reads a saved stream) and converts it into
+a Chrome trace (JSON) that can be opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+The stream format is described in inc/Trace.h.
+
+Usage:
+    trace_to_chrome.py capture /dev/ttyACM0 -o trace.json [--raw trace.bin]
+    trace_to_chrome.py convert trace.bin -o trace.json
+
+Each identifier gets its own row: interrupt handlers and tasks are shown as slices, queue posts and
+consumes as a counter of the number of items in the queue, and markers as instant events with their value.
+The timestamps are unwrapped, so a trace may be longer than one turn of the 32-bit cycle counter
+(89 s at 48 MHz) as long as two consecutive events are less than one turn apart.
+
+Only the Python standard library is used.
+
+@author Michael Granberry
+"""
+
+import argparse
+import binascii
+import json
+import struct
+import sys
+
+from uart_uploader import SerialPort
+
+CMD_READ = b"T"
+STREAM_VERSION = 1
+BAUD_RATE = 115200
+EVENT_SIZE = 8
+
+ISR_ENTER, ISR_EXIT, TASK_BEGIN, TASK_END, QUEUE_POST, QUEUE_CONSUME, MARKER = range(1, 8)
+
+
+class Trace:
+    def __init__(self, frequency, total, names, events):
+        self.frequency = frequency
+        self.total = total
+        self.names = names
+        self.events = events
+
+
+def decode(read):
+    """Decodes a stream. read(n) must return exactly n bytes or raise EOFError."""
+    if read(2) != b"TR":
+        raise ValueError("missing stream header")
+    version, num_names = read(2)
+    if version != STREAM_VERSION:
+        raise ValueError("unsupported stream version %d" % version)
+    frequency, count, total = struct.unpack("<III", read(12))
+
+    names = {}
+    for _ in range(num_names):
+        ident, length = read(2)
+        names[ident] = read(length).decode("ascii", "replace")
+
+    data = read(count * EVENT_SIZE)
+    crc = struct.unpack("<H", read(2))[0]
+    if crc != binascii.crc_hqx(data, 0xFFFF):
+        raise ValueError("CRC mismatch")
+
+    events = [struct.unpack_from("<IBBH", data, i * EVENT_SIZE) for i in range(count)]
+    print("%d events, %d older events overwritten" % (count, total - count))
+    return Trace(frequency, total, names, events)
+
+
+def to_chrome(trace):
+    """Returns the Chrome trace events of a Trace."""
+    us_per_cycle = 1e6 / trace.frequency
+    output = [{"ph": "M", "pid": 0, "name": "process_name", "args": {"name": "MSP432"}}]
+    depth = {}
+    used = set()
+
+    start = trace.events[0][0] if trace.events else 0
+    previous = start
+    offset = 0
+    for timestamp, kind, ident, data in trace.events:
+        # Unwrap the 32-bit cycle counter
+        if timestamp < previous:
+            offset += 1 << 32
+        previous = timestamp
+        ts = (timestamp + offset - start) * us_per_cycle
+        name = trace.names.get(ident, "ID %d" % ident)
+        used.add(ident)
+
+        if kind in (ISR_ENTER, TASK_BEGIN):
+            depth[ident] = depth.get(ident, 0) + 1
+            category = "isr" if kind == ISR_ENTER else "task"
+            output.append({"ph": "B", "pid": 0, "tid": ident, "ts": ts, "name": name, "cat": category})
+        elif kind in (ISR_EXIT, TASK_END):
+            # The beginning of the first slices may have been overwritten
+            if depth.get(ident, 0) == 0:
+                continue
+            depth[ident] -= 1
+            output.append({"ph": "E", "pid": 0, "tid": ident, "ts": ts})
+        elif kind in (QUEUE_POST, QUEUE_CONSUME):
+            output.append({"ph": "C", "pid": 0, "tid": ident, "ts": ts, "name": name + " queue",
+                           "args": {"items": data}})
+            output.append({"ph": "i", "pid": 0, "tid": ident, "ts": ts, "s": "t", "cat": "queue",
+                           "name": "post" if kind == QUEUE_POST else "consume", "args": {"items": data}})
+        elif kind == MARKER:
+            output.append({"ph": "i", "pid": 0, "tid": ident, "ts": ts, "s": "t", "cat": "marker",
+                           "name": name, "args": {"value": data}})
+        else:
+            raise ValueError("unknown event type %d" % kind)
+
+    for ident in sorted(used):
+        output.append({"ph": "M", "pid": 0, "tid": ident, "name": "thread_name",
+                       "args": {"name": trace.names.get(ident, "ID %d" % ident)}})
+        output.append({"ph": "M", "pid": 0, "tid": ident, "name": "thread_sort_index", "args": {"sort_index": ident}})
+
+    return {"traceEvents": output, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_capture = sub.add_parser("capture")
+    p_capture.add_argument("port")
+    p_capture.add_argument("-o", "--output", required=True)
+    p_capture.add_argument("--raw", help="also save the raw stream")
+    p_capture.add_argument("--baud", type=int, default=BAUD_RATE)
+    p_capture.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for the start of the stream")
+    p_convert = sub.add_parser("convert")
+    p_convert.add_argument("input")
+    p_convert.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    raw = bytearray()
+    if args.command == "capture":
+        port = SerialPort(args.port, args.baud)
+        port.flush_input()
+        port.write(CMD_READ)
+
+        # The program may still be sending its own output: skip it until the header
+        window = b""
+        while window != b"TR":
+            byte = port.read(1, args.timeout)
+            if not byte:
+                print("error: no answer")
+                return 1
+            window = (window + byte)[-2:]
+        raw.extend(b"TR")
+        header = [b"TR"]
+
+        def read(length):
+            if header:
+                return header.pop()
+            data = port.read(length, 2.0)
+            if len(data) != length:
+                raise EOFError("stream ended early")
+            raw.extend(data)
+            return data
+    else:
+        with open(args.input, "rb") as f:
+            stream = f.read()
+        position = [0]
+
+        def read(length):
+            data = stream[position[0]:position[0] + length]
+            if len(data) != length:
+                raise EOFError("stream ended early")
+            position[0] += length
+            return data
+
+    try:
+        trace = decode(read)
+    except (ValueError, EOFError) as error:
+        print("error: %s" % error)
+        return 1
+    finally:
+        if args.command == "capture" and args.raw:
+            with open(args.raw, "wb") as f:
+                f.write(raw)
+
+    with open(args.output, "w") as f:
+        json.dump(to_chrome(trace), f)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Host-side uploader for the UART_Bootloader driver.
+
+The protocol matches inc/UART_Bootloader.h:
+    frame    = SOH (0x01) | command | length (LE16) | payload | CRC-16/CCITT (LE16)
+    response = ACK (0x06) or NAK (0x15) | status
+
+Usage:
+    uart_uploader.py /dev/ttyACM0 app.bin       Upload an image and boot it
+    uart_uploader.py /dev/ttyACM0 --boot        Boot the active image without uploading
+
+The image is a raw binary linked for the active slot with linker/msp432p401r_application.cmd
+(MAIN origin 0x00020000, see the slot table in inc/UART_Bootloader.h), for example produced by
+tiobj2bin. Reset the LaunchPad (or hold Button 1 while resetting) before running this script;
+it pings the loader until it answers.
+
+Only the Python standard library is used (termios), so this script runs on Linux and macOS.
+
+@author Michael Granberry
+"""
+
+import argparse
+import binascii
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+SOH = 0x01
+ACK = 0x06
+NAK = 0x15
+
+CMD_PING = 0x50
+CMD_START = 0x53
+CMD_DATA = 0x44
+CMD_END = 0x45
+CMD_BOOT = 0x42
+
+BLOCK_SIZE = 256
+ACTIVE_SLOT_ADDRESS = 0x00020000
+IMAGE_SIZE = 0xF000
+BAUD_RATE = 460800
+
+ERRORS = {1: "CRC", 2: "FORMAT", 3: "SEQUENCE", 4: "ERASE", 5: "PROGRAM", 6: "VERIFY", 7: "NO_IMAGE", 8: "TIMEOUT"}
+
+
+class SerialPort:
+    def __init__(self, path, baud_rate):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        attrs = termios.tcgetattr(self.fd)
+        speed = getattr(termios, "B%d" % baud_rate)
+        # Raw mode: 8N1, no flow control, no echo, no character translation
+        attrs[0] = 0
+        attrs[1] = 0
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0
+        attrs[4] = speed
+        attrs[5] = speed
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+
+    def write(self, data):
+        os.write(self.fd, data)
+
+    def read(self, length, timeout):
+        data = b""
+        deadline = time.monotonic() + timeout
+        while len(data) < length:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0 or not select.select([self.fd], [], [], remaining)[0]:
+                break
+            data += os.read(self.fd, length - len(data))
+        return data
+
+    def flush_input(self):
+        termios.tcflush(self.fd, termios.TCIFLUSH)
+
+
+def build_frame(command, payload=b""):
+    body = bytes([command]) + struct.pack("<H", len(payload)) + payload
+    return bytes([SOH]) + body + struct.pack("<H", binascii.crc_hqx(body, 0xFFFF))
+
+
+def transact(port, command, payload=b"", timeout=0.5, retries=5):
+    """Sends a frame until it is acknowledged. START and END erase flash, so they use a longer timeout."""
+    frame = build_frame(command, payload)
+    status = None
+    for _ in range(retries):
+        port.flush_input()
+        port.write(frame)
+        response = port.read(2, timeout)
+        if len(response) == 2 and response[0] == ACK:
+            return
+        if len(response) == 2 and response[0] == NAK:
+            status = response[1]
+            # Only transmission errors are worth retrying
+            if status not in (1, 2):
+                break
+    raise RuntimeError("command 0x%02X failed: %s" % (command, ERRORS.get(status, "no response")))
+
+
+def wait_for_loader(port, timeout):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        port.flush_input()
+        port.write(build_frame(CMD_PING))
+        response = port.read(2, 0.05)
+        if response == bytes([ACK, 0]):
+            return
+    raise RuntimeError("no response from the loader (reset the board and retry)")
+
+
+def upload(port, image):
+    # Pad to a whole number of words with the erased flash value
+    image += b"\xFF" * (-len(image) % 4)
+    if len(image) > IMAGE_SIZE:
+        raise RuntimeError("image is %d bytes, the slot holds %d" % (len(image), IMAGE_SIZE))
+    reset_handler = struct.unpack_from("<I", image, 4)[0]
+    if not ACTIVE_SLOT_ADDRESS <= reset_handler < ACTIVE_SLOT_ADDRESS + len(image):
+        raise RuntimeError("reset handler 0x%08X is outside the active slot, relink the image at 0x%08X"
+                           % (reset_handler, ACTIVE_SLOT_ADDRESS))
+
+    transact(port, CMD_START, struct.pack("<II", len(image), binascii.crc32(image)), timeout=10.0)
+
+    start = time.monotonic()
+    for offset in range(0, len(image), BLOCK_SIZE):
+        transact(port, CMD_DATA, struct.pack("<I", offset) + image[offset:offset + BLOCK_SIZE])
+        sys.stdout.write("\r%6d / %d bytes" % (min(offset + BLOCK_SIZE, len(image)), len(image)))
+        sys.stdout.flush()
+    elapsed = time.monotonic() - start
+
+    transact(port, CMD_END, timeout=10.0)
+    print("\nUploaded %d bytes in %.2f s (%.1f KB/s), booting" % (len(image), elapsed, len(image) / elapsed / 1024))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("image", nargs="?")
+    parser.add_argument("--baud", type=int, default=BAUD_RATE)
+    parser.add_argument("--boot", action="store_true")
+    parser.add_argument("--wait", type=float, default=10.0, help="seconds to wait for the loader")
+    args = parser.parse_args()
+
+    if not args.boot and args.image is None:
+        parser.error("an image is required unless --boot is given")
+
+    port = SerialPort(args.port, args.baud)
+    try:
+        wait_for_loader(port, args.wait)
+        if args.boot:
+            transact(port, CMD_BOOT)
+            print("Booting the active image")
+        else:
+            with open(args.image, "rb") as f:
+                upload(port, f.read())
+    except RuntimeError as error:
+        print("error: %s" % error)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())